@@ -23,18 +23,20 @@ void BindVar(py::module* m) {
 void BindPrimitiveT(py::module* m) {
   py::enum_<primitive_t>(*m, "primitive_t")  //
 #define __(type__) .value(#type__, primitive_t::type__)
-      __(unk)      //
-      __(uint8)    //
-      __(uint16)   //
-      __(int32)    //
-      __(uint64)   //
-      __(int8)     //
-      __(int16)    //
-      __(int32)    //
-      __(int64)    //
-      __(float32)  //
-      __(float64)  //
-      __(boolean)  //
+      __(unk)       //
+      __(uint8)     //
+      __(uint16)    //
+      __(int32)     //
+      __(uint64)    //
+      __(int8)      //
+      __(int16)     //
+      __(int32)     //
+      __(int64)     //
+      __(float32)   //
+      __(float64)   //
+      __(float16)   //
+      __(bfloat16)  //
+      __(boolean)   //
       __(void_);
 #undef __
 }
@@ -70,7 +72,7 @@ void BindBuilder(py::module* m) {
   py::class_<Builder>(*m, "Builder")
       .def(py::init<>())              //
       .def("build", &Builder::Build)  //
-      .def("to_c_source_code", &Builder::ToCSourceCode);
+      .def("to_c_source_code", &Builder::ToCSourceCode, py::arg("expr"), py::arg("prefix"), py::arg("num_shards") = 1);
 }
 
 void BindExpr(py::module* m) {
@@ -37,13 +37,15 @@ target = '''
 #include <stdio.h>
 
 typedef bool cinn_boolean_t;
-typedef char cinn_int8_t;
+typedef signed char cinn_int8_t;
 typedef int cinn_int32_t;
 typedef long long cinn_int64_t;
 typedef unsigned char cinn_uint8_t;
 typedef unsigned int cinn_uint32_t;
 typedef unsigned long long cinn_uint64_t;
 typedef float cinn_float32_t;
+typedef unsigned short cinn_float16_t;
+typedef unsigned short cinn_bfloat16_t;
 
 #define cinn_min(a,b) ((a)<(b) ? (a) : (b))
 #define cinn_max(a,b) ((a)>(b) ? (a) : (b))
@@ -0,0 +1,49 @@
+#include "cinn/autotuner/conv2d_tuner.h"
+#include <glog/logging.h>
+#include "cinn/utils/logging.h"
+
+namespace cinn {
+namespace autotuner {
+
+Conv2dAlgorithmTuner::Conv2dAlgorithmTuner(const std::vector<choices_t>& candidates, evaluator_t evaluator)
+    : candidates_(candidates), evaluator_(evaluator) {
+  for (auto& layer : candidates_) CHECK(!layer.empty()) << "no candidate algorithm for a layer";
+  CHECK(evaluator_);
+}
+
+Conv2dAlgorithmTuner::choices_t Conv2dAlgorithmTuner::Tune(int rounds) {
+  LOG_INDENT(0);
+  choices_t best;
+  for (auto& layer : candidates_) best.push_back(layer.front());
+  best_time_ = Evaluate(best);
+
+  for (int round = 0; round < rounds; round++) {
+    bool improved = false;
+    for (int i = 0; i < candidates_.size(); i++) {
+      for (auto algorithm : candidates_[i]) {
+        choices_t choices = best;
+        choices[i] = algorithm;
+        double time = Evaluate(choices);
+        if (time < best_time_) {
+          CINN_DEBUG(2) << "layer " << i << " chooses algorithm " << static_cast<int>(algorithm) << ", " << time;
+          best = choices;
+          best_time_ = time;
+          improved = true;
+        }
+      }
+    }
+    if (!improved) break;
+  }
+  return best;
+}
+
+double Conv2dAlgorithmTuner::Evaluate(const choices_t& choices) {
+  auto it = cache_.find(choices);
+  if (it != cache_.end()) return it->second;
+  double time = evaluator_(choices);
+  cache_.emplace(choices, time);
+  return time;
+}
+
+}  // namespace autotuner
+}  // namespace cinn
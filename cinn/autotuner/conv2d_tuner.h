@@ -0,0 +1,63 @@
+#pragma once
+
+#include <functional>
+#include <map>
+#include <vector>
+#include "cinn/hlir/instruction_layer/conv2d_op.h"
+
+namespace cinn {
+namespace autotuner {
+
+/**
+ * Conv2dAlgorithmTuner chooses the algorithm of each convolution in a network, direct, im2col or Winograd, by
+ * measuring the whole network.
+ *
+ * The caller builds, compiles and times the network with the algorithms of the layers, such as by CCompiler. The tuner
+ * starts from the first candidate of each layer, and visits the layers one by one, tries all the candidates of a layer
+ * with the others fixed and keeps the fastest. The measurements are cached, so each combination is evaluated once.
+ *
+ * Usage:
+ *
+ *     Conv2dAlgorithmTuner tuner({Conv2dCandidateAlgorithms(param0, w0_shape),
+ *                                 Conv2dCandidateAlgorithms(param1, w1_shape)},
+ *                                [&](const Conv2dAlgorithmTuner::choices_t& algorithms) { return Run(algorithms); });
+ *     auto algorithms = tuner.Tune();
+ */
+class Conv2dAlgorithmTuner {
+ public:
+  using Algorithm = hlir::instruction_layer::Conv2dParam::Algorithm;
+  //! An algorithm for each layer.
+  using choices_t = std::vector<Algorithm>;
+  //! Return the time to run the network with the algorithms.
+  using evaluator_t = std::function<double(const choices_t&)>;
+
+  /**
+   * @param candidates the candidate algorithms of each layer, see Conv2dCandidateAlgorithms.
+   * @param evaluator evaluates the network with the algorithms.
+   */
+  Conv2dAlgorithmTuner(const std::vector<choices_t>& candidates, evaluator_t evaluator);
+
+  /**
+   * Search the algorithms.
+   * @param rounds the number of the passes over the layers, the search stops early if a pass improves nothing.
+   * @return the fastest algorithms found.
+   */
+  choices_t Tune(int rounds = 2);
+
+  //! The time of the fastest algorithms found.
+  double best_time() const { return best_time_; }
+
+  //! The number of the combinations evaluated.
+  int num_evaluations() const { return cache_.size(); }
+
+ private:
+  double Evaluate(const choices_t& choices);
+
+  std::vector<choices_t> candidates_;
+  evaluator_t evaluator_;
+  std::map<choices_t, double> cache_;
+  double best_time_{};
+};
+
+}  // namespace autotuner
+}  // namespace cinn
@@ -0,0 +1,46 @@
+#include "cinn/autotuner/conv2d_tuner.h"
+#include <gtest/gtest.h>
+
+namespace cinn {
+namespace autotuner {
+
+using Algorithm = Conv2dAlgorithmTuner::Algorithm;
+
+TEST(Conv2dAlgorithmTuner, candidates) {
+  hlir::instruction_layer::Conv2dParam param;
+  ASSERT_EQ(hlir::instruction_layer::Conv2dCandidateAlgorithms(param, {16, 8, 3, 3}).size(), 3UL);
+  // Winograd only applies to stride 1.
+  param.strides = {2, 2};
+  ASSERT_EQ(hlir::instruction_layer::Conv2dCandidateAlgorithms(param, {16, 8, 3, 3}).size(), 2UL);
+}
+
+TEST(Conv2dAlgorithmTuner, basic) {
+  // The time of each algorithm of each layer, the layers are independent.
+  std::vector<std::map<Algorithm, double>> costs({
+      {{Algorithm::kDirect, 3.}, {Algorithm::kIm2Col, 2.}, {Algorithm::kWinograd, 1.}},
+      {{Algorithm::kDirect, 1.}, {Algorithm::kIm2Col, 2.}},
+      {{Algorithm::kDirect, 5.}, {Algorithm::kIm2Col, 4.}, {Algorithm::kWinograd, 6.}},
+  });
+  std::vector<Conv2dAlgorithmTuner::choices_t> candidates;
+  for (auto& layer : costs) {
+    candidates.emplace_back();
+    for (auto& item : layer) candidates.back().push_back(item.first);
+  }
+
+  int num_calls = 0;
+  Conv2dAlgorithmTuner tuner(candidates, [&](const Conv2dAlgorithmTuner::choices_t& choices) {
+    num_calls++;
+    double time = 0;
+    for (int i = 0; i < choices.size(); i++) time += costs[i].at(choices[i]);
+    return time;
+  });
+
+  auto best = tuner.Tune();
+  ASSERT_EQ(best, Conv2dAlgorithmTuner::choices_t({Algorithm::kWinograd, Algorithm::kDirect, Algorithm::kIm2Col}));
+  ASSERT_EQ(tuner.best_time(), 6.);
+  // The combinations evaluated are cached.
+  ASSERT_EQ(num_calls, tuner.num_evaluations());
+}
+
+}  // namespace autotuner
+}  // namespace cinn
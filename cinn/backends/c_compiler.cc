@@ -0,0 +1,446 @@
+#include "cinn/backends/c_compiler.h"
+#include <dlfcn.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <thread>  // NOLINT
+#include "cinn/backends/code_gen_c.h"
+#include "cinn/core/cinn_context.h"
+#include "cinn/core/optimize/optimizer.h"
+#include "cinn/ir/ir_helper.h"
+#include "cinn/utils/parallel.h"
+#include "cinn/utils/string.h"
+
+namespace cinn {
+namespace backends {
+
+namespace {
+
+// The name of the function appended to the source to resolve the generated functions.
+const char *kLookupSymbol = "cinn_lookup_symbol";
+
+std::string ReadFile(const std::string &path) {
+  std::ifstream file(path, std::ios::binary);
+  CHECK(file.is_open()) << "failed to open file " << path;
+  std::stringstream ss;
+  ss << file.rdbuf();
+  return ss.str();
+}
+
+void WriteFile(const std::string &path, const std::string &data) {
+  std::ofstream file(path, std::ios::binary);
+  CHECK(file.is_open()) << "failed to open file " << path;
+  file.write(data.data(), data.size());
+}
+
+std::vector<std::string> FeatureNames(const Target &target) {
+  std::vector<std::string> names;
+  std::stringstream ss(target.features_str());
+  std::string name;
+  while (std::getline(ss, name, ',')) names.push_back(name);
+  return names;
+}
+
+std::string LevelFlags(const IsaLevel &level) {
+  std::vector<std::string> flags;
+  for (auto &name : FeatureNames(level.target)) flags.push_back("-m" + name);
+  return Concat(flags, " ");
+}
+
+//! The condition to check the CPU supports the features of a level, in the generated code.
+std::string LevelCondition(const IsaLevel &level) {
+  std::vector<std::string> checks;
+  for (auto &name : FeatureNames(level.target)) {
+    // GCC doesn't know f16c in __builtin_cpu_supports before version 11, all the CPUs with AVX2 support it.
+    if (name == "f16c") continue;
+    checks.push_back(StringFormat("__builtin_cpu_supports(\"%s\")", name.c_str()));
+  }
+  return checks.empty() ? "true" : Concat(checks, " && ");
+}
+
+//! Run a command and get its output, empty if it fails.
+std::string CommandOutput(const std::string &cmd) {
+  FILE *pipe = popen(cmd.c_str(), "r");
+  if (!pipe) return "";
+  std::string output;
+  char buffer[256];
+  while (size_t n = fread(buffer, 1, sizeof(buffer), pipe)) output.append(buffer, n);
+  return pclose(pipe) == 0 ? output : "";
+}
+
+//! Append the function to resolve the generated functions by names.
+void PrintLookupFunction(const std::vector<std::string> &names, std::ostream &os) {
+  os << "#include <string.h>\n";
+  os << "extern \"C\" void* " << kLookupSymbol << "(const char* name) {\n";
+  for (auto &name : names) {
+    os << StringFormat("  if (strcmp(name, \"%s\") == 0) return reinterpret_cast<void*>(&%s);\n",
+                       name.c_str(),
+                       name.c_str());
+  }
+  os << "  return 0;\n";
+  os << "}\n";
+}
+
+//! The names of the functions in an expression, in the order they are defined.
+std::vector<std::string> FunctionNames(const ir::Expr &expr) {
+  std::vector<std::string> names;
+  std::set<std::string> visited;
+  for (auto &fn : ir::CollectExprNode<ir::Function>(expr)) {
+    auto &name = fn.As<ir::Function>()->name();
+    if (visited.insert(name).second) names.push_back(name);
+  }
+  return names;
+}
+
+//! The parameters of a generated function and the arguments to forward them, such as "cinn_float32_t* A" and "A".
+void FunctionSignature(const ir::Function &fn, std::string *parameters, std::string *arguments) {
+  std::vector<std::string> params, args;
+  auto collect = [&](const Expr &x) {
+    CHECK(x.is_var() || x.is_tensor());
+    auto name = x.is_var() ? x.As<ir::Var>()->name() : x.As<ir::Tensor>()->name();
+    params.push_back(StringFormat("cinn_%s_t* %s", ptype_to_str(x.ptype()).c_str(), name.c_str()));
+    args.push_back(name);
+  };
+  for (auto &x : fn.inputs) collect(x);
+  for (auto &x : fn.outputs) collect(x);
+  *parameters = Concat(params, ", ");
+  *arguments = Concat(args, ", ");
+}
+
+//! Split an optimized expression to the global data and the functions.
+void SplitSections(const ir::Expr &expr, ir::Expr *data_section, ir::Expr *functions) {
+  if (auto *module = expr.As<ir::Module>()) {
+    *data_section = module->global_data_section;
+    *functions = module->function_section;
+  } else {
+    *data_section = ir::Expr();
+    *functions = expr;
+  }
+}
+
+}  // namespace
+
+const std::vector<IsaLevel> &X86IsaLevels() {
+  using F = Target::Feature;
+  auto make = [](const std::string &name, const std::vector<F> &features) {
+    Target target(Target::OS::Linux, Target::Arch::X86, Target::Bits::k64);
+    for (auto feature : features) target.set_feature(feature);
+    return IsaLevel{name, target};
+  };
+  static std::vector<IsaLevel> levels({
+      make("sse42", {F::kSSE42}),
+      make("avx2", {F::kSSE42, F::kAVX, F::kAVX2, F::kFMA, F::kF16C}),
+      make("avx512",
+           {F::kSSE42,
+            F::kAVX,
+            F::kAVX2,
+            F::kFMA,
+            F::kF16C,
+            F::kAVX512F,
+            F::kAVX512BW,
+            F::kAVX512VL,
+            F::kAVX512DQ}),
+  });
+  return levels;
+}
+
+CModule::~CModule() {
+  if (handle_) dlclose(handle_);
+  for (auto &file : files_) unlink(file.c_str());
+}
+
+void *CModule::Lookup(const std::string &name) { return lookup_(name.c_str()); }
+
+CCompiler::CCompiler(const Options &options, KernelCache *cache) : options_(options), cache_(cache) {
+#ifdef CINN_EXECUTION_DIR
+  // The generated code includes simd.h, and calls the functions defined in simd.cc.
+  options_.include_dirs.push_back(CINN_EXECUTION_DIR);
+  options_.sources.push_back(std::string(CINN_EXECUTION_DIR) + "/simd.cc");
+#endif
+}
+
+std::string CCompiler::BaseCommand(const std::string &arch_flags) const {
+  std::string cmd = options_.compiler + " -std=c++11 -fPIC " + options_.opt_flags;
+  if (!arch_flags.empty()) cmd += " " + arch_flags;
+  if (options_.openmp) cmd += " -fopenmp";
+  if (!options_.extra_flags.empty()) cmd += " " + options_.extra_flags;
+  for (auto &dir : options_.include_dirs) cmd += " -I" + dir;
+  return cmd;
+}
+
+std::string CCompiler::command() const {
+  std::string cmd = BaseCommand(options_.arch_flags) + " -shared";
+  for (auto &source : options_.sources) cmd += " " + source;
+  return cmd;
+}
+
+std::string CCompiler::GenerateSource(const ir::Expr &expr) const {
+  // The passes rewrite the expression, keep the original one for the other backends.
+  ir::Expr copied = ir::IRDeepCopy(expr);
+  C_CodeGen gen(/*is source*/ true);
+  gen(copied);
+
+  std::stringstream os;
+  os << gen.compiled_code() << "\n";
+  PrintLookupFunction(FunctionNames(copied), os);
+  return os.str();
+}
+
+void CCompiler::CompileShards(const ir::Expr &expr, const std::string &prefix, CModule *module) const {
+  auto add_file = [&](const std::string &path) {
+    if (!options_.keep_files) module->files_.push_back(path);
+    return path;
+  };
+
+  auto slash = prefix.find_last_of('/');
+  auto header_name = (slash == std::string::npos ? prefix : prefix.substr(slash + 1)) + ".h";
+  auto source = GenerateShardedC(expr, options_.num_shards, header_name);
+  WriteFile(add_file(prefix + ".h"), source.header);
+
+  // The lookup function is defined with the global data, the header declares all the functions.
+  std::stringstream data;
+  data << source.data << "\n";
+  PrintLookupFunction(FunctionNames(expr), data);
+
+  std::vector<std::string> units({data.str()});
+  units.insert(units.end(), source.shards.begin(), source.shards.end());
+  std::vector<std::string> unit_prefixes;
+  for (size_t i = 0; i < units.size(); i++) {
+    unit_prefixes.push_back(i == 0 ? prefix + "_data" : StringFormat("%s_%d", prefix.c_str(), static_cast<int>(i - 1)));
+    add_file(unit_prefixes.back() + ".cc");
+    add_file(unit_prefixes.back() + ".o");
+    add_file(unit_prefixes.back() + ".log");
+  }
+
+  // No more compiler processes than the cores, each of them takes a core and much memory.
+  int num_threads = std::min<int>(units.size(), std::max(1U, std::thread::hardware_concurrency()));
+  ParallelFor(units.size(), num_threads, [&](int i) {
+    auto &unit_prefix = unit_prefixes[i];
+    WriteFile(unit_prefix + ".cc", units[i]);
+    RunCommand(StringFormat("%s -c %s.cc -o %s.o",
+                            BaseCommand(options_.arch_flags).c_str(),
+                            unit_prefix.c_str(),
+                            unit_prefix.c_str()),
+               unit_prefix + ".log");
+  });
+
+  std::string cmd = BaseCommand(options_.arch_flags) + " -shared";
+  for (auto &unit_prefix : unit_prefixes) cmd += " " + unit_prefix + ".o";
+  for (auto &source_file : options_.sources) cmd += " " + source_file;
+  RunCommand(StringFormat("%s -o %s", cmd.c_str(), module->library_path_.c_str()), add_file(prefix + ".log"));
+}
+
+std::unique_ptr<CModule> CCompiler::CreateModule(const std::string &name, std::string *prefix) {
+  std::unique_ptr<CModule> module(new CModule);
+  // dlopen returns the loaded library if the path is the same, so each compilation has its own files.
+  *prefix = StringFormat(
+      "%s/%s_%d_%d", options_.work_dir.c_str(), name.c_str(), static_cast<int>(getpid()), counter_++);
+  module->library_path_ = *prefix + ".so";
+  if (!options_.keep_files) module->files_.push_back(module->library_path_);
+  return module;
+}
+
+void CCompiler::RunCommand(const std::string &cmd, const std::string &log_path) const {
+  std::string full_cmd = StringFormat("%s > %s 2>&1", cmd.c_str(), log_path.c_str());
+  LOG(INFO) << "compile: " << full_cmd;
+  CHECK_EQ(std::system(full_cmd.c_str()), 0) << "failed to run " << cmd << ":\n" << ReadFile(log_path);
+}
+
+void CCompiler::Load(CModule *module) const {
+  module->handle_ = dlopen(module->library_path_.c_str(), RTLD_NOW | RTLD_LOCAL);
+  CHECK(module->handle_) << "failed to load " << module->library_path_ << ": " << dlerror();
+  module->lookup_ = reinterpret_cast<void *(*)(const char *)>(dlsym(module->handle_, kLookupSymbol));
+  CHECK(module->lookup_) << "symbol " << kLookupSymbol << " not exists in " << module->library_path_;
+}
+
+std::string CCompiler::CacheOptions(const std::string &cmd) {
+  if (compiler_version_.empty()) {
+    compiler_version_ = CommandOutput(options_.compiler + " --version 2>/dev/null");
+    CHECK(!compiler_version_.empty()) << "failed to get the version of the compiler " << options_.compiler;
+  }
+  std::string options = cmd + "\n" + compiler_version_;
+  options += "cpu: " + Target::HostCPUName() + "\n";
+  options += "features: " + Target::Host().features_str() + "\n";
+  // The strict floating-point mode disables the FMA contraction and the vector accumulation of IrOptimizer.
+  options += StringFormat("strict_fp: %d\n", static_cast<int>(GlobalContext().strict_fp()));
+  return options;
+}
+
+std::unique_ptr<CModule> CCompiler::Compile(const ir::Expr &expr, const std::string &name) {
+  CHECK(expr.valid());
+  std::string prefix;
+  auto module = CreateModule(name, &prefix);
+
+  std::string key;
+  std::string library;
+  if (cache_) {
+    key = KernelCache::Key(expr, CacheOptions(command()));
+    module->from_cache_ = cache_->Load(key, &library);
+  }
+
+  if (module->from_cache_) {
+    WriteFile(module->library_path_, library);
+  } else if (options_.num_shards > 1) {
+    CompileShards(expr, prefix, module.get());
+    if (cache_) cache_->Store(key, ReadFile(module->library_path_));
+  } else {
+    std::string source_path = prefix + ".cc";
+    std::string log_path = prefix + ".log";
+    if (!options_.keep_files) {
+      module->files_.push_back(source_path);
+      module->files_.push_back(log_path);
+    }
+    WriteFile(source_path, GenerateSource(expr));
+
+    RunCommand(StringFormat("%s %s -o %s", command().c_str(), source_path.c_str(), module->library_path_.c_str()),
+               log_path);
+
+    if (cache_) cache_->Store(key, ReadFile(module->library_path_));
+  }
+
+  Load(module.get());
+  return module;
+}
+
+std::unique_ptr<CModule> CCompiler::CompileMultiVersion(const std::function<ir::Expr(const Target &)> &generator,
+                                                        const std::string &name,
+                                                        const std::vector<IsaLevel> &levels) {
+  CHECK(!levels.empty());
+  std::string prefix;
+  auto module = CreateModule(name, &prefix);
+
+  std::vector<ir::Expr> exprs;
+  std::string key_options = BaseCommand("");
+  for (auto &level : levels) {
+    exprs.push_back(generator(level.target));
+    CHECK(exprs.back().valid()) << "no IR generated for " << level.name;
+    key_options += " " + level.name + ":" + LevelFlags(level) + ":" + KernelCache::Key(exprs.back(), "");
+  }
+
+  std::string key;
+  std::string library;
+  if (cache_) {
+    key = KernelCache::Key(exprs.front(), CacheOptions(key_options));
+    module->from_cache_ = cache_->Load(key, &library);
+  }
+  if (module->from_cache_) {
+    WriteFile(module->library_path_, library);
+    Load(module.get());
+    return module;
+  }
+
+  auto add_file = [&](const std::string &path) {
+    if (!options_.keep_files) module->files_.push_back(path);
+    return path;
+  };
+
+  // Compile the functions of each level with the flags of the level, in a namespace to distinguish the versions.
+  ir::Expr data_section;
+  std::vector<std::string> fn_names;
+  std::map<std::string, const ir::Function *> fns;
+  std::vector<std::string> objects;
+  for (size_t i = 0; i < levels.size(); i++) {
+    auto &level = levels[i];
+    IrOptimizer optimizer;
+    optimizer(&exprs[i]);
+
+    ir::Expr version_data, functions;
+    SplitSections(exprs[i], &version_data, &functions);
+    if (i == 0) {
+      data_section = version_data;
+      fn_names = FunctionNames(functions);
+      for (auto &fn : ir::CollectExprNode<ir::Function>(functions)) {
+        fns.emplace(fn.As<ir::Function>()->name(), fn.As<ir::Function>());
+      }
+    } else {
+      CHECK(FunctionNames(functions) == fn_names) << "the versions should define the same functions";
+    }
+
+    std::stringstream os;
+    os << C_CodeGen::Prelude();
+    if (data_section.valid()) os << DeclareGlobalDataAsC(data_section) << "\n";
+    os << "namespace cinn_" << level.name << " {\n\n";
+    // The SIMD math functions called by the kernels are compiled with the instruction set of the level too.
+    os << "#include <simd.cc>\n\n";
+    C_CodeGen gen;
+    gen.Print(functions);
+    os << gen.compiled_code();
+    os << "\n\n}  // namespace cinn_" << level.name << "\n";
+
+    std::string level_prefix = prefix + "_" + level.name;
+    std::string source_path = add_file(level_prefix + ".cc");
+    std::string object_path = add_file(level_prefix + ".o");
+    WriteFile(source_path, os.str());
+    RunCommand(StringFormat(
+                   "%s -c %s -o %s", BaseCommand(LevelFlags(level)).c_str(), source_path.c_str(), object_path.c_str()),
+               add_file(level_prefix + ".log"));
+    objects.push_back(object_path);
+  }
+
+  // The dispatcher defines the global data, and forwards each function to the version selected when it is loaded.
+  std::stringstream os;
+  os << C_CodeGen::Prelude();
+  if (data_section.valid()) {
+    C_CodeGen gen;
+    gen.Print(data_section);
+    os << gen.compiled_code() << "\n\n";
+  }
+
+  std::map<std::string, std::pair<std::string, std::string>> signatures;
+  for (auto &fn_name : fn_names) {
+    FunctionSignature(*fns[fn_name], &signatures[fn_name].first, &signatures[fn_name].second);
+  }
+  for (auto &level : levels) {
+    os << "namespace cinn_" << level.name << " {\n";
+    for (auto &fn_name : fn_names) os << "void " << fn_name << " (" << signatures[fn_name].first << ");\n";
+    os << "}  // namespace cinn_" << level.name << "\n";
+  }
+
+  os << "\nstatic int cinn_select_version() {\n";
+  os << "  __builtin_cpu_init();\n";
+  for (size_t i = levels.size() - 1; i > 0; i--) {
+    os << "  if (" << LevelCondition(levels[i]) << ") return " << i << ";\n";
+  }
+  os << "  return 0;\n";
+  os << "}\n";
+  os << "static const int cinn_version = cinn_select_version();\n\n";
+
+  for (auto &fn_name : fn_names) {
+    os << "void " << fn_name << " (" << signatures[fn_name].first << ") {\n";
+    os << "  switch (cinn_version) {\n";
+    for (size_t i = levels.size() - 1; i > 0; i--) {
+      os << StringFormat("    case %d: return cinn_%s::%s(%s);\n",
+                         static_cast<int>(i),
+                         levels[i].name.c_str(),
+                         fn_name.c_str(),
+                         signatures[fn_name].second.c_str());
+    }
+    os << StringFormat("    default: return cinn_%s::%s(%s);\n",
+                       levels.front().name.c_str(),
+                       fn_name.c_str(),
+                       signatures[fn_name].second.c_str());
+    os << "  }\n";
+    os << "}\n\n";
+  }
+  PrintLookupFunction(fn_names, os);
+
+  std::string source_path = add_file(prefix + ".cc");
+  WriteFile(source_path, os.str());
+  // The dispatcher and the other sources run on any CPU, they are compiled for the lowest level.
+  std::string cmd = BaseCommand(LevelFlags(levels.front())) + " -shared " + source_path;
+  for (auto &object : objects) cmd += " " + object;
+  for (auto &source : options_.sources) cmd += " " + source;
+  RunCommand(StringFormat("%s -o %s", cmd.c_str(), module->library_path_.c_str()), add_file(prefix + ".log"));
+
+  if (cache_) cache_->Store(key, ReadFile(module->library_path_));
+  Load(module.get());
+  return module;
+}
+
+}  // namespace backends
+}  // namespace cinn
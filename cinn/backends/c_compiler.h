@@ -0,0 +1,175 @@
+#pragma once
+#include <glog/logging.h>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "cinn/backends/kernel_cache.h"
+#include "cinn/ir/ir.h"
+#include "cinn/target.h"
+
+namespace cinn {
+namespace backends {
+
+/**
+ * A shared library compiled from the C source code generated by C_CodeGen, and loaded into the current process.
+ *
+ * The library and its files are removed when the CModule is destroyed.
+ */
+class CModule {
+ public:
+  ~CModule();
+
+  //! Get the address of a function, nullptr if not exists.
+  void* Lookup(const std::string& name);
+
+  //! Get a function with type FnT, such as `void (*)(float*, float*)`.
+  template <typename FnT>
+  FnT GetFunction(const std::string& name) {
+    void* address = Lookup(name);
+    CHECK(address) << "function " << name << " not exists";
+    return reinterpret_cast<FnT>(address);
+  }
+
+  //! The path of the shared library.
+  const std::string& library_path() const { return library_path_; }
+
+  //! Tell whether the library is loaded from the cache.
+  bool from_cache() const { return from_cache_; }
+
+ private:
+  friend class CCompiler;
+  CModule() = default;
+
+  void* handle_{};
+  // Resolve the functions by names, generated by the CCompiler in the library.
+  void* (*lookup_)(const char*){};
+  std::string library_path_;
+  std::vector<std::string> files_;
+  bool from_cache_{false};
+};
+
+/**
+ * An instruction set the kernels are compiled for, by CCompiler::CompileMultiVersion.
+ */
+struct IsaLevel {
+  //! The name, the functions of the level are in the namespace cinn_<name>.
+  std::string name;
+  //! The features of the level, the code is compiled with -m<feature> for each of them.
+  Target target;
+};
+
+//! The x86 instruction set levels, SSE4.2, AVX2 and AVX-512, from the lowest to the highest.
+const std::vector<IsaLevel>& X86IsaLevels();
+
+/**
+ * CCompiler compiles an IR module or function to a shared library with the system C++ compiler, and loads it with
+ * dlopen. It runs the generated code without LLVM, and is fast enough to evaluate the candidates of the autotuner.
+ *
+ * Usage:
+ *
+ *     CCompiler compiler;
+ *     auto module = compiler.Compile(builder.Build(network));
+ *     module->GetFunction<void (*)(float*)>("set_input_x")(x);
+ *     module->GetFunction<void (*)()>("main_")();
+ *
+ * The generated functions have C++ linkage, the compiler appends a function to the source to resolve them by names.
+ */
+class CCompiler {
+ public:
+  struct Options {
+    //! The compiler command.
+    std::string compiler{"c++"};
+    //! The optimization flags.
+    std::string opt_flags{"-O3"};
+    //! The instruction set flags, the code is tuned for the host CPU. The multi-versioned code uses the flags of each
+    //! instruction set level instead.
+    std::string arch_flags{"-march=native"};
+    //! Compile with -fopenmp.
+    bool openmp{false};
+    //! The other flags.
+    std::string extra_flags;
+    //! The directories to search the headers, the one of simd.h is added.
+    std::vector<std::string> include_dirs;
+    //! The other source files compiled into the library, simd.cc is added, it defines the SIMD math functions.
+    std::vector<std::string> sources;
+    //! The directory to write the source files and the libraries.
+    std::string work_dir{"/tmp"};
+    //! Keep the source files and the libraries, for debug.
+    bool keep_files{false};
+    //! Split the generated functions to this number of translation units, and compile them in parallel on up to the
+    //! number of the cores. It speeds up the compilation of the large networks, the global data is compiled in a unit
+    //! of its own.
+    int num_shards{1};
+  };
+
+  /**
+   * @param options the compile options.
+   * @param cache the cache of the libraries, nullptr to disable the cache.
+   */
+  explicit CCompiler(const Options& options = Options(), KernelCache* cache = nullptr);
+
+  /**
+   * Compile an expression, an ir::Module or an ir::Function.
+   * @param expr the expression to compile, it is not changed.
+   * @param name the prefix of the names of the files.
+   */
+  std::unique_ptr<CModule> Compile(const ir::Expr& expr, const std::string& name = "cinn_module");
+
+  /**
+   * Compile a version of the kernels for each instruction set level, and a dispatcher that selects the highest level
+   * the CPU supports when the library is loaded.
+   *
+   * The versions share the global data, such as the weights, and each version of a function has the signature of the
+   * generated one, so the library is used in the same way as the one compiled by Compile.
+   *
+   * @param generator build the IR for the target of a level, for example it vectorizes the stages by the vector width
+   * of the target. The IR supports the SIMD data up to 256 bits, the AVX-512 level vectorizes by 8 and leaves the
+   * wider instructions to the C compiler. All the versions should have the same data and functions.
+   * @param name the prefix of the names of the files.
+   * @param levels the instruction set levels, the first one is the fallback and is selected without checking the CPU.
+   */
+  std::unique_ptr<CModule> CompileMultiVersion(const std::function<ir::Expr(const Target&)>& generator,
+                                               const std::string& name = "cinn_module",
+                                               const std::vector<IsaLevel>& levels = X86IsaLevels());
+
+  //! The compile command, without the generated source and the output files.
+  std::string command() const;
+
+  const Options& options() const { return options_; }
+
+ private:
+  //! Generate the C source code, with the function to resolve the symbols appended.
+  std::string GenerateSource(const ir::Expr& expr) const;
+
+  //! Compile the source code split by GenerateShardedC to the library of the module, the units in parallel.
+  void CompileShards(const ir::Expr& expr, const std::string& prefix, CModule* module) const;
+
+  //! The command to compile with the instruction set flags `arch_flags`, without the output type and the files.
+  std::string BaseCommand(const std::string& arch_flags) const;
+
+  //! Create a CModule with the file prefix unique in the process.
+  std::unique_ptr<CModule> CreateModule(const std::string& name, std::string* prefix);
+
+  //! Run a compile command, the output is written to `log_path` and shown if it fails.
+  void RunCommand(const std::string& cmd, const std::string& log_path) const;
+
+  //! Load the library of the module, and resolve the lookup function.
+  void Load(CModule* module) const;
+
+  /**
+   * The options of the key of a library in the cache, the compile command `cmd` with the things it depends on but
+   * doesn't name: the host CPU and its features resolved by -march=native, the version of the compiler, and the flags
+   * of the global context that change the generated code.
+   */
+  std::string CacheOptions(const std::string& cmd);
+
+  Options options_;
+  KernelCache* cache_{};
+  int counter_{};
+  //! The output of `compiler --version`, got when a key is computed the first time.
+  std::string compiler_version_;
+};
+
+}  // namespace backends
+}  // namespace cinn
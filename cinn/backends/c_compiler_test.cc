@@ -0,0 +1,191 @@
+#include "cinn/backends/c_compiler.h"
+#include <gtest/gtest.h>
+#include <unistd.h>
+#include <vector>
+#include "cinn/backends/code_gen_c.h"
+#include "cinn/core/function.h"
+#include "cinn/core/optimize/use_passes.h"
+#include "cinn/ir/ir.h"
+#include "cinn/ir/ops_overload.h"
+#include "cinn/utils/string.h"
+
+namespace cinn {
+namespace backends {
+
+using cs = std::vector<ir::Constant>;
+
+TEST(CCompiler, vectorized_function) {
+  SetGlobalContext(new CINNContext);
+
+  ir::Constant M("M", 64);
+  ir::Var i("i");
+  Expr A(cs({M}), primitive_t::float32, "A");
+  Expr B(cs({M}), primitive_t::float32, "B");
+  Expr C(cs({M}), primitive_t::float32, "C");
+
+  Function fn("fn");
+  {
+    Stage s0 = fn.AddStage(C[i].Assign(A[i] * 2.f + B[i]));
+    s0.Vectorize(8);
+
+    fn.Inputs({A, B});
+    fn.Outputs({C});
+    fn.EndDefinition();
+  }
+
+  CCompiler compiler;
+  auto module = compiler.Compile(Expr(fn), "vectorized_function");
+  auto fn_func = module->GetFunction<void (*)(float*, float*, float*)>("fn");
+
+  // The generated code assumes the buffers are aligned.
+  float* a = static_cast<float*>(aligned_alloc(64, 64 * sizeof(float)));
+  float* b = static_cast<float*>(aligned_alloc(64, 64 * sizeof(float)));
+  float* c = static_cast<float*>(aligned_alloc(64, 64 * sizeof(float)));
+  for (int i = 0; i < 64; i++) {
+    a[i] = i;
+    b[i] = 1.f;
+  }
+  fn_func(a, b, c);
+
+  for (int i = 0; i < 64; i++) {
+    ASSERT_NEAR(c[i], 2.f * i + 1.f, 1e-5);
+  }
+  EXPECT_FALSE(module->Lookup("not_exists"));
+
+  free(a);
+  free(b);
+  free(c);
+}
+
+TEST(CCompiler, cache) {
+  SetGlobalContext(new CINNContext);
+
+  ir::Constant M("M", 16);
+  ir::Var i("i");
+  Expr A(cs({M}), primitive_t::float32, "A");
+  Expr B(cs({M}), primitive_t::float32, "B");
+
+  Function fn("scale");
+  {
+    fn.AddStage(B[i].Assign(A[i] * 3.f));
+    fn.Inputs({A});
+    fn.Outputs({B});
+    fn.EndDefinition();
+  }
+
+  KernelCache cache(StringFormat("/tmp/cinn_c_compiler_cache_%d", static_cast<int>(getpid())));
+  cache.Clear();
+  CCompiler::Options options;
+  options.opt_flags = "-O2";
+  CCompiler compiler(options, &cache);
+
+  std::vector<float> a(16, 2.f), b(16, 0.f);
+  for (int round = 0; round < 2; round++) {
+    auto module = compiler.Compile(Expr(fn), "scale");
+    // The second compilation loads the library built by the first one.
+    EXPECT_EQ(module->from_cache(), round == 1);
+    module->GetFunction<void (*)(float*, float*)>("scale")(a.data(), b.data());
+    for (float x : b) ASSERT_EQ(x, 6.f);
+  }
+
+  EXPECT_EQ(cache.hits(), 1UL);
+  EXPECT_EQ(cache.misses(), 1UL);
+
+  // The strict floating-point mode changes the generated code, the library is compiled again.
+  GlobalContext().set_strict_fp(true);
+  EXPECT_FALSE(compiler.Compile(Expr(fn), "scale")->from_cache());
+  GlobalContext().set_strict_fp(false);
+  EXPECT_EQ(cache.misses(), 2UL);
+  cache.Clear();
+}
+
+TEST(CCompiler, multi_version) {
+  ir::Constant M("M", 64);
+  ir::Var i("i");
+
+  // Each level vectorizes the stage by its vector width.
+  auto generator = [&](const Target& target) {
+    SetGlobalContext(new CINNContext);
+    Expr A(cs({M}), primitive_t::float32, "A");
+    Expr B(cs({M}), primitive_t::float32, "B");
+
+    Function fn("fn");
+    Stage s0 = fn.AddStage(B[i].Assign(A[i] * 2.f + 1.f));
+    s0.Vectorize(target.vector_width());
+    fn.Inputs({A});
+    fn.Outputs({B});
+    fn.EndDefinition();
+    return Expr(fn);
+  };
+
+  CCompiler compiler;
+  auto module = compiler.CompileMultiVersion(generator, "multi_version");
+  auto fn_func = module->GetFunction<void (*)(float*, float*)>("fn");
+
+  float* a = static_cast<float*>(aligned_alloc(64, 64 * sizeof(float)));
+  float* b = static_cast<float*>(aligned_alloc(64, 64 * sizeof(float)));
+  for (int i = 0; i < 64; i++) a[i] = i;
+  fn_func(a, b);
+  for (int i = 0; i < 64; i++) {
+    ASSERT_NEAR(b[i], 2.f * i + 1.f, 1e-5);
+  }
+
+  free(a);
+  free(b);
+}
+
+TEST(CCompiler, sharded) {
+  SetGlobalContext(new CINNContext);
+
+  ir::Constant M("M", 16);
+  ir::Var i("i");
+  Expr A(cs({M}), primitive_t::float32, "A");
+  Expr B(cs({M}), primitive_t::float32, "B");
+  Expr C(cs({M}), primitive_t::float32, "C");
+
+  Function scale("scale");
+  {
+    scale.AddStage(B[i].Assign(A[i] * 3.f));
+    scale.Inputs({A});
+    scale.Outputs({B});
+    scale.EndDefinition();
+  }
+  Function add("add");
+  {
+    add.AddStage(C[i].Assign(A[i] + B[i]));
+    add.Inputs({A, B});
+    add.Outputs({C});
+    add.EndDefinition();
+  }
+  auto expr = ir::Block::make({scale.ir_function(), add.ir_function()});
+
+  // More shards than the functions, each function is in a unit of its own.
+  auto source = GenerateShardedC(expr, 4, "sharded.h");
+  ASSERT_EQ(source.shards.size(), 2UL);
+  EXPECT_NE(source.header.find("void scale (cinn_float32_t* A, cinn_float32_t* B);"), std::string::npos);
+  EXPECT_NE(source.header.find("void add (cinn_float32_t* A, cinn_float32_t* B, cinn_float32_t* C);"),
+            std::string::npos);
+  for (auto& shard : source.shards) EXPECT_EQ(shard.find("#include \"sharded.h\""), 0UL);
+
+  CCompiler::Options options;
+  options.num_shards = 2;
+  CCompiler compiler(options);
+  auto module = compiler.Compile(expr, "sharded");
+
+  std::vector<float> a(16, 2.f), b(16, 0.f), c(16, 0.f);
+  module->GetFunction<void (*)(float*, float*)>("scale")(a.data(), b.data());
+  module->GetFunction<void (*)(float*, float*, float*)>("add")(a.data(), b.data(), c.data());
+  for (float x : c) ASSERT_EQ(x, 8.f);
+}
+
+TEST(CCompiler, isa_levels) {
+  // The lower levels are subsets of the higher ones.
+  auto& levels = X86IsaLevels();
+  for (size_t i = 1; i < levels.size(); i++) {
+    auto lower = levels[i - 1].target.features();
+    EXPECT_EQ(levels[i].target.features() & lower, lower);
+  }
+}
+
+}  // namespace backends
+}  // namespace cinn
@@ -1,5 +1,7 @@
 #include "cinn/backends/code_gen_c.h"
+#include <algorithm>
 #include <fstream>
+#include <set>
 #include <string>
 #include <vector>
 #include "cinn/backends/x86_simd.h"
@@ -14,6 +16,27 @@
 namespace cinn {
 namespace backends {
 
+// The buffers created by the generated code are aligned to the cache line.
+static const int kBufferAlignment = 64;
+// The buffers passed to the generated functions should be aligned to the widest SIMD data(256 bits).
+static const int kArgumentAlignment = 32;
+
+//! Quote a string as a C string literal.
+static std::string CStringLiteral(const std::string &s) {
+  std::string literal = "\"";
+  for (char c : s) {
+    if (c == '"' || c == '\\') {
+      literal += '\\';
+      literal += c;
+    } else if (c == '\n') {
+      literal += "\\n";
+    } else {
+      literal += c;
+    }
+  }
+  return literal + "\"";
+}
+
 void C_CodeGen::PrintHeader() {
   os_ << "#include <immintrin.h>\n";
   os_ << "#include <math.h>\n";
@@ -21,13 +44,15 @@ void C_CodeGen::PrintHeader() {
   os_ << "#include <stdio.h>\n";
   os_ << "\n";
   os_ << "typedef bool cinn_boolean_t;\n";
-  os_ << "typedef char cinn_int8_t;\n";
+  os_ << "typedef signed char cinn_int8_t;\n";
   os_ << "typedef int cinn_int32_t;\n";
   os_ << "typedef long long cinn_int64_t;\n";
   os_ << "typedef unsigned char cinn_uint8_t;\n";
   os_ << "typedef unsigned int cinn_uint32_t;\n";
   os_ << "typedef unsigned long long cinn_uint64_t;\n";
   os_ << "typedef float cinn_float32_t;\n";
+  os_ << "typedef unsigned short cinn_float16_t;\n";
+  os_ << "typedef unsigned short cinn_bfloat16_t;\n";
   os_ << "\n";
   os_ << "#define cinn_min(a,b) ((a)<(b) ? (a) : (b))\n";
   os_ << "#define cinn_max(a,b) ((a)>(b) ? (a) : (b))\n";
@@ -61,6 +86,14 @@ void C_CodeGen::Visit(const ir::For *op) {
   os_ << ") {";
   Println();
 
+  // The iterator takes the values of init + n * inc, it is a multiple of their common divisor.
+  auto iterator_name = op->iterator.name();
+  auto origin_divisor = iterator_divisors_.find(iterator_name);
+  bool has_origin_divisor = origin_divisor != iterator_divisors_.end();
+  int64_t divisor = has_origin_divisor ? origin_divisor->second : 0;
+  iterator_divisors_[iterator_name] =
+      ir::ExprKnownDivisor(ir::Add::make(op->iter_init, op->iter_inc), iterator_divisors_);
+
   indent_right();
   //@{ a block
   Print(op->body);
@@ -68,10 +101,29 @@ void C_CodeGen::Visit(const ir::For *op) {
   //@}
   indent_left();
 
+  if (has_origin_divisor) {
+    iterator_divisors_[iterator_name] = divisor;
+  } else {
+    iterator_divisors_.erase(iterator_name);
+  }
+
   PrintIndent();
   os_ << "}";
 }
 
+bool C_CodeGen::IsAlignedAccess(const ir::Expr &address, composite_t ctype) const {
+  std::vector<std::string> ids;
+  auto *identity = address.As<ir::Identity>();
+  Expr reference = identity ? identity->GetTrimedExpr(&ids) : address;
+  if (!reference.is_reference() || reference.ptype() != primitive_t::float32) return false;
+
+  int vector_bytes = ctype == composite_t::simd256 ? 32 : 16;
+  CHECK_LE(vector_bytes, kArgumentAlignment);
+  // All the buffers are at least aligned to kArgumentAlignment, so only the offset matters.
+  int64_t offset_divisor = ir::ReferenceOffsetDivisor(reference, iterator_divisors_);
+  return offset_divisor * sizeof(float) % vector_bytes == 0;
+}
+
 void C_CodeGen::Visit(const ir::Function *op) {
   // input arguments
   std::vector<std::string> arguments;
@@ -100,6 +152,25 @@ void C_CodeGen::Visit(const ir::Function *op) {
     Println();
 
     indent_right();
+    // Tell the C compiler the alignment of the buffers if the body accesses memory with SIMD.
+    if (!ir::CollectExprNode<ir::SIMDOpr>(op->body).empty()) {
+      std::set<std::string> hinted;
+      auto hint_alignment = [&](const Expr &x) {
+        if (!x.is_tensor() || hinted.count(x.As<ir::Tensor>()->name())) return;
+        auto &name = x.As<ir::Tensor>()->name();
+        auto type = StringFormat("cinn_%s_t*", ptype_to_str(x.ptype()).c_str());
+        PrintIndent();
+        os_ << StringFormat("%s = (%s) __builtin_assume_aligned(%s, %d);",
+                            name.c_str(),
+                            type.c_str(),
+                            name.c_str(),
+                            kArgumentAlignment);
+        Println();
+        hinted.insert(name);
+      };
+      for (auto &x : op->inputs) hint_alignment(x);
+      for (auto &x : op->outputs) hint_alignment(x);
+    }
     //@{ a block
     PrintIndent();
     Print(op->body);
@@ -142,6 +213,12 @@ void C_CodeGen::operator()(const ir::Expr &expr) {
   PrintFileGuardFooter();
 }
 
+std::string C_CodeGen::Prelude() {
+  C_CodeGen gen;
+  gen.PrintHeader();
+  return gen.compiled_code();
+}
+
 void C_CodeGen::WriteToFile(const std::string &path) const {
   CINN_DEBUG(0) << "Write " << path;
   std::ofstream file(path);
@@ -181,6 +258,116 @@ void CompileAsC(const ir::Expr &expr, const std::string &header_file, const std:
   }
 }
 
+ShardedCSource GenerateShardedC(const ir::Expr &expr, int num_shards, const std::string &header_name) {
+  CHECK_GT(num_shards, 0);
+  ir::Expr copied = ir::IRDeepCopy(expr);
+  IrOptimizer optimizer;
+  optimizer(&copied);
+
+  ir::Expr data_section, functions = copied;
+  if (auto *module = copied.As<ir::Module>()) {
+    data_section = module->global_data_section;
+    functions = module->function_section;
+  }
+
+  // Print the functions one by one, the marks between them are dropped.
+  std::vector<std::string> fn_codes;
+  std::set<std::string> fn_names;
+  std::stringstream prototypes;
+  for (auto &fn : ir::CollectExprNode<ir::Function>(functions)) {
+    if (!fn_names.insert(fn.As<ir::Function>()->name()).second) continue;
+    C_CodeGen gen;
+    gen.Print(fn);
+    fn_codes.push_back(gen.compiled_code());
+    C_CodeGen header_gen(/*is source*/ false);
+    header_gen.Print(fn);
+    prototypes << header_gen.compiled_code();
+  }
+
+  ShardedCSource result;
+  {
+    std::stringstream os;
+    os << "#ifndef CINN_FILE_\n";
+    os << "#define CINN_FILE_\n";
+    os << C_CodeGen::Prelude();
+    if (data_section.valid()) os << DeclareGlobalDataAsC(data_section) << "\n";
+    os << prototypes.str();
+    os << "\n#endif  // CINN_FILE_\n";
+    result.header = os.str();
+  }
+
+  auto include = StringFormat("#include \"%s\"\n\n", header_name.c_str());
+  result.data = include;
+  if (data_section.valid()) {
+    C_CodeGen gen;
+    gen.Print(data_section);
+    result.data += gen.compiled_code() + "\n";
+  }
+
+  // Each function goes to the shard with the least code, in the order they are defined, so the shards take similar
+  // time to compile and the result is stable.
+  num_shards = std::min<int>(num_shards, fn_codes.size());
+  std::vector<size_t> shard_sizes(num_shards, 0);
+  result.shards.assign(num_shards, include);
+  for (auto &code : fn_codes) {
+    int shard = std::min_element(shard_sizes.begin(), shard_sizes.end()) - shard_sizes.begin();
+    shard_sizes[shard] += code.size();
+    result.shards[shard] += code + "\n\n";
+  }
+  return result;
+}
+
+std::vector<std::string> CompileAsShardedC(const ir::Expr &expr, const std::string &prefix, int num_shards) {
+  CHECK(!prefix.empty()) << "prefix of the files is empty";
+  auto write = [](const std::string &path, const std::string &code) {
+    CINN_DEBUG(0) << "Write " << path;
+    std::ofstream file(path);
+    CHECK(file.is_open()) << "failed to open file " << path;
+    file << code;
+  };
+
+  auto slash = prefix.find_last_of('/');
+  auto header_name = (slash == std::string::npos ? prefix : prefix.substr(slash + 1)) + ".h";
+  auto source = GenerateShardedC(expr, num_shards, header_name);
+
+  std::vector<std::string> paths({prefix + "_data.cc"});
+  write(prefix + ".h", source.header);
+  write(paths.front(), source.data);
+  for (size_t i = 0; i < source.shards.size(); i++) {
+    paths.push_back(StringFormat("%s_%d.cc", prefix.c_str(), static_cast<int>(i)));
+    write(paths.back(), source.shards[i]);
+  }
+  return paths;
+}
+
+std::string DeclareGlobalDataAsC(const ir::Expr &data_section) {
+  std::stringstream os;
+  for (auto &expr : ir::CollectExprNode<ir::BufferOpr>(data_section)) {
+    auto *op = expr.As<ir::BufferOpr>();
+    auto type = StringFormat("cinn_%s_t", ptype_to_str(op->ptype()).c_str());
+    switch (op->operation) {
+      case ir::BufferOpr::Opr::kCreateAssign:
+        os << "extern " << type << " " << op->name << "[];\n";
+        break;
+      case ir::BufferOpr::Opr::kCreate:
+      case ir::BufferOpr::Opr::kCreateInArena:
+      case ir::BufferOpr::Opr::kMapFile:
+        os << "extern " << type << "* " << op->name << ";\n";
+        break;
+      default:
+        break;
+    }
+  }
+  // The conditional variables of the CallOnce blocks.
+  for (auto &expr : ir::CollectExprNode<ir::Let>(data_section)) {
+    auto *op = expr.As<ir::Let>();
+    os << StringFormat("extern cinn_%s_t %s;\n",
+                       ptype_to_str(op->a.ptype()).c_str(),
+                       op->a.As<ir::Var>()->name().c_str());
+  }
+  return os.str();
+}
+
 void C_CodeGen::Visit(const ir::Let *op) {
   auto simd = [&](composite_t ctype) {
     switch (ctype) {
@@ -229,9 +416,14 @@ void C_CodeGen::PrintPType(primitive_t ptype) {
 
     __(float64);
     __(float32);
+    __(float16);
+    __(bfloat16);
+    __(int8);
     __(int32);
     __(int64);
     __(uint8);
+    __(uint32);
+    __(uint64);
     __(boolean);
     default:
       LOG(FATAL) << "Unsupported type " << ptype;
@@ -246,6 +438,7 @@ void C_CodeGen::Visit(const ir::SIMDOpr *op) {
     x86_simd = &x86::x86_256_simd;
   }
   CHECK(x86_simd) << "not supported vector width: " << op->vector_width;
+  composite_t ctype = op->vector_width == 4 ? composite_t::simd128 : composite_t::simd256;
 
   switch (op->opr) {
     case ir::SIMDOpr::Opr::kAdd:
@@ -267,19 +460,42 @@ void C_CodeGen::Visit(const ir::SIMDOpr *op) {
       os_ << x86_simd->max_ps();
       break;
     case ir::SIMDOpr::Opr::kStore:
-      os_ << x86_simd->store_ps();
+      os_ << (IsAlignedAccess(op->a, ctype) ? x86_simd->store_ps() : x86_simd->storeu_ps());
       break;
     case ir::SIMDOpr::Opr::kLoad:
-      os_ << x86_simd->load_ps();
+      os_ << (IsAlignedAccess(op->a, ctype) ? x86_simd->load_ps() : x86_simd->loadu_ps());
+      break;
+    case ir::SIMDOpr::Opr::kFma:
+      os_ << x86_simd->fmadd_ps();
+      break;
+    case ir::SIMDOpr::Opr::kExp:
+      os_ << x86_simd->exp_ps();
+      break;
+    case ir::SIMDOpr::Opr::kTanh:
+      os_ << x86_simd->tanh_ps();
+      break;
+    case ir::SIMDOpr::Opr::kSigmoid:
+      os_ << x86_simd->sigmoid_ps();
+      break;
+    case ir::SIMDOpr::Opr::kGather:
+      os_ << x86_simd->gather_ps();
       break;
     default:
       LOG(FATAL) << "not supported " << op->opr;
   }
 
-  if (op->opr == ir::SIMDOpr::Opr::kLoad) {
+  if (!op->b.valid()) {
     os_ << "(";
     Print(op->a);
     os_ << ")";
+  } else if (op->opr == ir::SIMDOpr::Opr::kFma) {
+    os_ << "(";
+    Print(op->a);
+    os_ << ", ";
+    Print(op->b);
+    os_ << ", ";
+    Print(op->c);
+    os_ << ")";
   } else {
     os_ << "(";
     Print(op->a);
@@ -311,13 +527,21 @@ void C_CodeGen::Visit(const ir::Cast *op) {
         NOT_IMPLEMENT
     }
 
-    std::string opr = x86::PrintCastOpr(*op, simd);
+    std::string opr = x86::PrintCastOpr(*op, simd, ir::NodeTy::Add, IsAlignedAccess(op->expr, ctype));
     os_ << opr << "(";
     Print(op->expr);
     os_ << ")";
     return;
   }
 
+  // The half precision floats are stored as integers, they are widened by the runtime functions.
+  if (op->is_primitive() && op->ptype() == primitive_t::float32 && is_half_float(op->expr.ptype())) {
+    os_ << "cinn_" << op->expr.ptype() << "_to_float32(";
+    Print(op->expr);
+    os_ << ")";
+    return;
+  }
+
   switch (op->ctype()) {
     case composite_t::primitive:
       os_ << "(";
@@ -342,6 +566,9 @@ std::string GetDataRepr(const ir::BufferOpr *op) {
       return Concat(ToString(op->assigned_data.get<std::vector<int8_t>>()), ",");
     case primitive_t::uint8:
       return Concat(ToString(op->assigned_data.get<std::vector<uint8_t>>()), ",");
+    case primitive_t::float16:
+    case primitive_t::bfloat16:
+      return Concat(ToString(op->assigned_data.get<std::vector<uint16_t>>()), ",");
     default:
       LOG(FATAL) << "Not supported ptype: " << op->ptype();
   }
@@ -356,8 +583,16 @@ void C_CodeGen::Visit(const ir::BufferOpr *op) {
       os_ << " = ";
       os_ << " (";
       PrintPType(op->ptype());
-      os_ << "*) malloc(";
-      Print(op->size);
+      os_ << "*) aligned_alloc(" << kBufferAlignment << ", ";
+      // The size should be a multiple of the alignment.
+      if (op->size.is_int_imm()) {
+        int64_t size = op->size.As<ir::IntImm>()->val();
+        os_ << (size + kBufferAlignment - 1) / kBufferAlignment * kBufferAlignment;
+      } else {
+        os_ << "((";
+        Print(op->size);
+        os_ << " + " << kBufferAlignment - 1 << ") / " << kBufferAlignment << " * " << kBufferAlignment << ")";
+      }
       os_ << ");";
       break;
 
@@ -365,11 +600,38 @@ void C_CodeGen::Visit(const ir::BufferOpr *op) {
       PrintPType(op->ptype());
       os_ << " ";
       os_ << op->name;
-      os_ << "[] = {";
+      os_ << "[] __attribute__((aligned(" << kBufferAlignment << "))) = {";
       os_ << GetDataRepr(op);
       os_ << "};";
       break;
 
+    case ir::BufferOpr::Opr::kCreateInArena:
+      PrintPType(op->ptype());
+      os_ << "* ";
+      os_ << op->name;
+      os_ << " = ";
+      os_ << " (";
+      PrintPType(op->ptype());
+      os_ << "*) (";
+      os_ << op->arena;
+      os_ << " + ";
+      Print(op->offset);
+      os_ << ");";
+      break;
+
+    case ir::BufferOpr::Opr::kMapFile:
+      // Mapped by the runtime when the program is loaded, it aborts if the file doesn't have the size.
+      PrintPType(op->ptype());
+      os_ << "* ";
+      os_ << op->name;
+      os_ << " = ";
+      os_ << " (";
+      PrintPType(op->ptype());
+      os_ << "*) cinn_map_file(" << CStringLiteral(op->path) << ", ";
+      Print(op->size);
+      os_ << ");";
+      break;
+
     case ir::BufferOpr::Opr::kDestroy:
       os_ << "free " << op->name << ";";
       break;
@@ -395,6 +657,12 @@ void C_CodeGen::Visit(const ir::Min *op) {
   os_ << ")";
 }
 
+void C_CodeGen::Visit(const ir::Sigmoid *op) {
+  os_ << "(1.f / (1.f + expf(-";
+  Print(op->a);
+  os_ << ")))";
+}
+
 void C_CodeGen::Visit(const ir::Assign *op) { VisitAssignX(op); }
 void C_CodeGen::Visit(const ir::SumAssign *op) { VisitAssignX(op); }
 void C_CodeGen::Visit(const ir::SubAssign *op) { VisitAssignX(op); }
@@ -1,4 +1,7 @@
 #pragma once
+#include <map>
+#include <string>
+#include <vector>
 #include "cinn/backends/x86_simd.h"
 #include "cinn/core/optimize/optimizer.h"
 #include "cinn/core/optimize/vectorize_utils.h"
@@ -45,6 +48,9 @@ class C_CodeGen : public ir::IRPrinter {
    */
   void WriteToFile(const std::string& path) const;
 
+  //! Get the code the generated source starts with, the includes, the type definitions and the macros.
+  static std::string Prelude();
+
   //! Get the source code of the implementation of all functions.
   std::string compiled_code() const {
     if (compiled_code_.empty()) compiled_code_ = ss_.str();
@@ -73,6 +79,7 @@ class C_CodeGen : public ir::IRPrinter {
   void Visit(const ir::Cast* op) override;
   void Visit(const ir::Max* op) override;
   void Visit(const ir::Min* op) override;
+  void Visit(const ir::Sigmoid* op) override;
   void Visit(const ir::Assign* op) override;
   void Visit(const ir::SumAssign* op) override;
   void Visit(const ir::SubAssign* op) override;
@@ -82,8 +89,10 @@ class C_CodeGen : public ir::IRPrinter {
 
   template <typename AssignT>
   void VisitAssignX(const AssignT* op) {
-    if (optimize::IsSimdData(op->a) && optimize::IsSimdData(op->b)) {
-      os_ << x86::GlobalX86SIMD(op->b.ctype()).store_ps();
+    // A SIMD variable such as a vector accumulator is assigned directly, only the memory is stored to.
+    if (optimize::IsSimdData(op->a) && optimize::IsSimdData(op->b) && !op->a.is_var()) {
+      auto& simd = x86::GlobalX86SIMD(op->b.ctype());
+      os_ << (IsAlignedAccess(op->a, op->b.ctype()) ? simd.store_ps() : simd.storeu_ps());
       os_ << "(&";
       Print(op->a);
       os_ << ", ";
@@ -131,12 +140,17 @@ class C_CodeGen : public ir::IRPrinter {
 
   void Visit(const ir::Reference* op) override;
 
+  //! Tell whether the address accessed by the SIMD load or store is proven to be aligned to the SIMD width.
+  bool IsAlignedAccess(const ir::Expr& address, composite_t ctype) const;
+
   static const char* simd_128_type;
   static const std::vector<std::string> simd_128_intrics;
 
  private:
   //! We record the last block to help preappend some let expression of temporary variables.
   ir::Block* last_block_{};
+  //! The known divisors of the iterators of the loops being visited.
+  std::map<std::string, int64_t> iterator_divisors_;
 };
 
 /**
@@ -147,5 +161,41 @@ class C_CodeGen : public ir::IRPrinter {
  */
 void CompileAsC(const ir::Expr& expr, const std::string& header_file, const std::string& source_file);
 
+/**
+ * The C source code of a program split to multiple translation units, so that the C compiler builds them in parallel.
+ *
+ * All the units include the header, it declares the global data and the functions. The global data is defined in a
+ * unit of its own, and the functions are distributed to the shards by the size of their code.
+ */
+struct ShardedCSource {
+  //! The header shared by all the units.
+  std::string header;
+  //! The unit defines the global data, such as the weights and the buffers.
+  std::string data;
+  //! The units define the functions.
+  std::vector<std::string> shards;
+};
+
+/**
+ * @brief Generate the C source code of an expression as multiple translation units.
+ * @param expr the expression, an ir::Module or the functions. It is not changed, the optimized copy is printed.
+ * @param num_shards the maximum number of the units of the functions, less units are generated if there are less
+ * functions.
+ * @param header_name the name of the header the units include, it should be in the same directory as the units.
+ */
+ShardedCSource GenerateShardedC(const ir::Expr& expr, int num_shards, const std::string& header_name);
+
+/**
+ * @brief Generate the C source code as multiple translation units, and write them to disk.
+ *
+ * The files are `<prefix>.h`, `<prefix>_data.cc` and `<prefix>_<i>.cc` for each shard.
+ *
+ * @return the paths of the source files.
+ */
+std::vector<std::string> CompileAsShardedC(const ir::Expr& expr, const std::string& prefix, int num_shards);
+
+//! Declare the global data defined in a data section as extern, for the units use them but don't define them.
+std::string DeclareGlobalDataAsC(const ir::Expr& data_section);
+
 }  // namespace backends
 }  // namespace cinn
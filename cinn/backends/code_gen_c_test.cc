@@ -44,13 +44,15 @@ TEST(code_gen_c, easy) {
 #include <stdio.h>
 
 typedef bool cinn_boolean_t;
-typedef char cinn_int8_t;
+typedef signed char cinn_int8_t;
 typedef int cinn_int32_t;
 typedef long long cinn_int64_t;
 typedef unsigned char cinn_uint8_t;
 typedef unsigned int cinn_uint32_t;
 typedef unsigned long long cinn_uint64_t;
 typedef float cinn_float32_t;
+typedef unsigned short cinn_float16_t;
+typedef unsigned short cinn_bfloat16_t;
 
 #define cinn_min(a,b) ((a)<(b) ? (a) : (b))
 #define cinn_max(a,b) ((a)>(b) ? (a) : (b))
@@ -69,6 +71,15 @@ void fn0 (cinn_float32_t* A, cinn_float32_t* A) {
   EXPECT_EQ(log, target);
 }
 
+TEST(code_gen_c, map_file_path) {
+  backends::C_CodeGen code_gen;
+  code_gen.Print(ir::BufferOpr::make_map_file("/tmp/a \"b\"\\c.bin", Expr(64), "cinn_weights"));
+
+  std::string code = code_gen.compiled_code();
+  LOG(INFO) << "generated code: \n" << code;
+  EXPECT_NE(code.find(R"ROC(cinn_map_file("/tmp/a \"b\"\\c.bin", 64);)ROC"), std::string::npos);
+}
+
 TEST(cpp_code_gen, basic) {
   SetGlobalContext(new CINNContext);
 
@@ -109,13 +120,15 @@ TEST(cpp_code_gen, basic) {
 #include <stdio.h>
 
 typedef bool cinn_boolean_t;
-typedef char cinn_int8_t;
+typedef signed char cinn_int8_t;
 typedef int cinn_int32_t;
 typedef long long cinn_int64_t;
 typedef unsigned char cinn_uint8_t;
 typedef unsigned int cinn_uint32_t;
 typedef unsigned long long cinn_uint64_t;
 typedef float cinn_float32_t;
+typedef unsigned short cinn_float16_t;
+typedef unsigned short cinn_bfloat16_t;
 
 #define cinn_min(a,b) ((a)<(b) ? (a) : (b))
 #define cinn_max(a,b) ((a)>(b) ? (a) : (b))
@@ -158,13 +171,15 @@ void fn (cinn_float32_t* A, cinn_float32_t* B, cinn_float32_t* C) {
 #include <stdio.h>
 
 typedef bool cinn_boolean_t;
-typedef char cinn_int8_t;
+typedef signed char cinn_int8_t;
 typedef int cinn_int32_t;
 typedef long long cinn_int64_t;
 typedef unsigned char cinn_uint8_t;
 typedef unsigned int cinn_uint32_t;
 typedef unsigned long long cinn_uint64_t;
 typedef float cinn_float32_t;
+typedef unsigned short cinn_float16_t;
+typedef unsigned short cinn_bfloat16_t;
 
 #define cinn_min(a,b) ((a)<(b) ? (a) : (b))
 #define cinn_max(a,b) ((a)>(b) ? (a) : (b))
@@ -1,12 +1,77 @@
 #include "cinn/backends/code_gen_llvm.h"
 #include <glog/logging.h>
+#include <llvm/IR/Intrinsics.h>
 #include "cinn/core/function.h"
+#include "cinn/core/optimize/vectorize_utils.h"
 #include "cinn/ir/ir.h"
+#include "cinn/ir/ir_helper.h"
 #include "cinn/ir/ir_printer.h"
 #include "cinn/utils/logging.h"
+#include "cinn/utils/string.h"
 
 namespace cinn {
 namespace backends {
+
+namespace {
+
+// The buffers created by the generated code are aligned to the cache line.
+const int kBufferAlignment = 64;
+
+bool IsUnsigned(primitive_t ptype) {
+  return ptype == primitive_t::uint8 || ptype == primitive_t::uint16 || ptype == primitive_t::uint32 ||
+         ptype == primitive_t::uint64 || ptype == primitive_t::boolean;
+}
+
+int VectorWidth(composite_t ctype) {
+  switch (ctype) {
+    case composite_t::simd128:
+      return 4;
+    case composite_t::simd256:
+      return 8;
+    default:
+      LOG(FATAL) << "not a SIMD type: " << ctype;
+  }
+  return 0;
+}
+
+//! Remove the Identity wrappers of an expression, and tell whether one of them marks it as an address.
+ir::Expr TrimIdentity(const ir::Expr &expr, bool *is_address) {
+  *is_address = false;
+  ir::Expr result = expr;
+  while (auto *identity = result.As<ir::Identity>()) {
+    if (identity->marked_as_address()) *is_address = true;
+    result = identity->expr;
+  }
+  return result;
+}
+
+std::string ArgumentName(const ir::Expr &arg) {
+  CHECK(arg.is_var() || arg.is_tensor());
+  return arg.is_var() ? arg.As<ir::Var>()->name() : arg.As<ir::Tensor>()->name();
+}
+
+//! Get the assigned data of a buffer as a LLVM constant array.
+llvm::Constant *GetDataArray(llvm::LLVMContext &ctx, const ir::BufferOpr &op) {
+  switch (op.ptype()) {
+    case primitive_t::float32:
+      return llvm::ConstantDataArray::get(ctx, llvm::ArrayRef<float>(op.assigned_data.get<std::vector<float>>()));
+    case primitive_t::int8: {
+      auto &data = op.assigned_data.get<std::vector<int8_t>>();
+      std::vector<uint8_t> bytes(data.begin(), data.end());
+      return llvm::ConstantDataArray::get(ctx, llvm::ArrayRef<uint8_t>(bytes));
+    }
+    case primitive_t::float16:
+    case primitive_t::bfloat16:
+      return llvm::ConstantDataArray::get(ctx,
+                                          llvm::ArrayRef<uint16_t>(op.assigned_data.get<std::vector<uint16_t>>()));
+    default:
+      LOG(FATAL) << "Not supported ptype: " << op.ptype();
+  }
+  return nullptr;
+}
+
+}  // namespace
+
 void CodeGenLLVM::Visit(const ir::IntImm *op) {
   switch (op->ptype()) {
     case primitive_t::int8:
@@ -19,7 +84,7 @@ void CodeGenLLVM::Visit(const ir::IntImm *op) {
       value_ = llvm::ConstantInt::getSigned(i32_t, op->val());
       break;
     case primitive_t::int64:
-      value_ = llvm::ConstantInt::getSigned(i16_t, op->val());
+      value_ = llvm::ConstantInt::getSigned(i64_t, op->val());
       break;
     default:
       LOG(FATAL) << "not supported type " << op->ptype();
@@ -39,6 +104,8 @@ void CodeGenLLVM::Visit(const ir::FloatImm *op) {
   }
 }
 
+void CodeGenLLVM::Visit(const ir::BoolImm *op) { value_ = llvm::ConstantInt::get(i1_t, op->val); }
+
 void CodeGenLLVM::Visit(const ir::Add *op) {
   if (is_float(op->ptype())) {
     value_ = builder_->CreateFAdd(Codegen(op->a), Codegen(op->b));
@@ -87,14 +154,47 @@ void CodeGenLLVM::Visit(const ir::Mod *op) {
   }
 }
 
+void CodeGenLLVM::Visit(const ir::Minus *op) {
+  auto *a = Codegen(op->a);
+  value_ = a->getType()->isFPOrFPVectorTy() ? builder_->CreateFNeg(a) : builder_->CreateNeg(a);
+}
+
+void CodeGenLLVM::Visit(const ir::Not *op) { value_ = builder_->CreateNot(Codegen(op->a)); }
+
+void CodeGenLLVM::Visit(const ir::Exp *op) {
+  auto *a = Codegen(op->a);
+  auto *exp = llvm::Intrinsic::getDeclaration(module_, llvm::Intrinsic::exp, {a->getType()});
+  value_ = builder_->CreateCall(exp, {a});
+}
+
+void CodeGenLLVM::Visit(const ir::Sqrt *op) {
+  auto *a = Codegen(op->a);
+  auto *sqrt = llvm::Intrinsic::getDeclaration(module_, llvm::Intrinsic::sqrt, {a->getType()});
+  value_ = builder_->CreateCall(sqrt, {a});
+}
+
+void CodeGenLLVM::Visit(const ir::Tanh *op) { value_ = CallMathFunction("tanh", Codegen(op->a)); }
+
+void CodeGenLLVM::Visit(const ir::Sigmoid *op) {
+  auto *a = Codegen(op->a);
+  auto *exp = llvm::Intrinsic::getDeclaration(module_, llvm::Intrinsic::exp, {a->getType()});
+  auto *one = llvm::ConstantFP::get(a->getType(), 1.);
+  // 1 / (1 + exp(-x))
+  value_ = builder_->CreateFDiv(one, builder_->CreateFAdd(one, builder_->CreateCall(exp, {builder_->CreateFNeg(a)})));
+}
+
 void CodeGenLLVM::Visit(const ir::Min *op) {
-  auto cond = ir::LT::make(op->a, op->b);
-  value_ = builder_->CreateSelect(Codegen(cond), Codegen(op->a), Codegen(op->b));
+  auto *a = Codegen(op->a);
+  auto *b = Codegen(op->b);
+  auto *cond = is_float(op->a.ptype()) ? builder_->CreateFCmpOLT(a, b) : builder_->CreateICmpSLT(a, b);
+  value_ = builder_->CreateSelect(cond, a, b);
 }
 
 void CodeGenLLVM::Visit(const ir::Max *op) {
-  auto cond = ir::GT::make(op->a, op->b);
-  value_ = builder_->CreateSelect(Codegen(cond), Codegen(op->a), Codegen(op->b));
+  auto *a = Codegen(op->a);
+  auto *b = Codegen(op->b);
+  auto *cond = is_float(op->a.ptype()) ? builder_->CreateFCmpOGT(a, b) : builder_->CreateICmpSGT(a, b);
+  value_ = builder_->CreateSelect(cond, a, b);
 }
 
 void CodeGenLLVM::Visit(const ir::NE *op) {
@@ -160,26 +260,51 @@ llvm::Value *CodeGenLLVM::Codegen(const ir::Expr &e) {
   return value_;
 }
 
+llvm::Type *CodeGenLLVM::ElementType(primitive_t ptype) const {
+  switch (ptype) {
+    case primitive_t::boolean:
+      return i1_t;
+    case primitive_t::int8:
+    case primitive_t::uint8:
+      return i8_t;
+    case primitive_t::int16:
+    case primitive_t::uint16:
+    case primitive_t::float16:
+    case primitive_t::bfloat16:
+      return i16_t;
+    case primitive_t::int32:
+    case primitive_t::uint32:
+      return i32_t;
+    case primitive_t::int64:
+    case primitive_t::uint64:
+      return i64_t;
+    case primitive_t::float32:
+      return f32_t;
+    case primitive_t::float64:
+      return f64_t;
+    case primitive_t::void_:
+      return void_t;
+    default:
+      LOG(FATAL) << "not supported type " << ptype;
+  }
+  return nullptr;
+}
+
 llvm::Function *CodeGenLLVM::CreateFunctionPrototype(const ir::Function *op) {
   // collect arguments
-  std::vector<llvm::Type *> args(op->inputs.size() + op->outputs.size(), f32ptr_t);
-  std::vector<Expr> _args;
-  for (size_t i = 0; i < args.size(); i++) {
-    _args.push_back((i < op->inputs.size()) ? op->inputs[i] : op->outputs[i - op->inputs.size()]);
-  }
+  std::vector<Expr> _args(op->inputs.begin(), op->inputs.end());
+  _args.insert(_args.end(), op->outputs.begin(), op->outputs.end());
+  std::vector<llvm::Type *> args;
+  for (auto &arg : _args) args.push_back(ElementType(arg.ptype())->getPointerTo());
 
   // void fn(float* a, float* b...)
-  llvm::FunctionType *function_type = llvm::FunctionType::get(llvm::Type::getVoidTy(*ctx_), args, false);
+  llvm::FunctionType *function_type = llvm::FunctionType::get(void_t, args, false);
   llvm::Function *function =
       llvm::Function::Create(function_type, llvm::Function::ExternalLinkage, op->name(), module_);
 
   int i = 0;
   for (auto &f_arg : function->args()) {
-    auto &arg = _args[i];
-    CHECK(arg.is_tensor());
-    auto name = arg.As<ir::Tensor>()->name();
-
-    f_arg.setName(name);
+    f_arg.setName(ArgumentName(_args[i++]));
   }
 
   return function;
@@ -187,10 +312,9 @@ llvm::Function *CodeGenLLVM::CreateFunctionPrototype(const ir::Function *op) {
 
 void CodeGenLLVM::Visit(const ir::Function *op) {
   LOG(INFO) << "to visit funciton";
+  // The function might be declared by the module to call it before the definition.
   llvm::Function *function = module_->getFunction(op->name());
-  CHECK(!function);
-  // if (function) return;
-  function = CreateFunctionPrototype(op);
+  if (!function) function = CreateFunctionPrototype(op);
   CHECK(function);
   CHECK(function->empty()) << "function " << op->name() << " is redefined";
 
@@ -198,24 +322,14 @@ void CodeGenLLVM::Visit(const ir::Function *op) {
   builder_->SetInsertPoint(block);
 
   // prepare arguments
-  std::vector<Expr> args(op->inputs.size() + op->outputs.size());
-  auto *f_args = function->arg_begin();
-  for (int i = 0; i < args.size(); i++) {
-    std::string arg_name;
-    if (i < op->inputs.size()) {
-      CHECK(op->inputs[i].is_tensor());
-      LOG(INFO) << "called " << op->inputs[i].As<ir::Tensor>()->name();
-      f_args[i].setName(op->inputs[i].As<ir::Tensor>()->name());
-    } else {
-      CHECK(op->outputs[i - op->inputs.size()].is_tensor());
-      LOG(INFO) << "called " << op->outputs[i - op->inputs.size()].As<ir::Tensor>()->name();
-      f_args[i].setName(op->outputs[i - op->inputs.size()].As<ir::Tensor>()->name());
-    }
-
-    LOG(INFO) << "collect fn args: " << f_args[i].getName().str();
-    fn_args_[f_args[i].getName()] = &f_args[i];
+  fn_args_.clear();
+  for (auto &f_arg : function->args()) {
+    LOG(INFO) << "collect fn args: " << f_arg.getName().str();
+    fn_args_[f_arg.getName()] = &f_arg;
   }
 
+  // The local variables are only visible in this function.
+  auto global_vars = vars_;
   function_ = function;
 
   // prepare body.
@@ -228,39 +342,106 @@ void CodeGenLLVM::Visit(const ir::Function *op) {
   // void
   builder_->CreateRet(nullptr);
 
-  // LOG(INFO) << "function: ";
-  // llvm::outs() << "function: \n";
-  // function->print(llvm::outs());
-  // llvm::outs().flush();
-  llvm::outs() << "******* verify function: ********"
-               << "\n";
-  llvm::verifyFunction(*function_, &llvm::outs());
-  llvm::outs().flush();
+  std::string errors;
+  llvm::raw_string_ostream os(errors);
+  CHECK(!llvm::verifyFunction(*function_, &os)) << "invalid function " << op->name() << ": " << os.str();
+
+  vars_ = global_vars;
+  fn_args_.clear();
+  function_ = nullptr;
 }
 
-void CodeGenLLVM::Visit(const ir::Assign *op) {
-  // LHS should be a referenced tensor.
-  CHECK(op->a.is_reference());
-  const ir::Reference *ref = op->a.As<ir::Reference>();
-  CHECK(ref->target.is_tensor());
+void CodeGenLLVM::Visit(const ir::Module *op) {
+  // Declare all the functions first, the main function calls the others.
+  if (op->function_section.valid()) {
+    for (auto &fn : ir::CollectExprNode<ir::Function>(op->function_section)) {
+      if (!module_->getFunction(fn.As<ir::Function>()->name())) CreateFunctionPrototype(fn.As<ir::Function>());
+    }
+  }
 
-  auto *lhs_array = Codegen(ref->target);
-  CHECK_EQ(ref->iterators.size(), 1UL);
-  auto *lhs_index = Codegen(ref->iterators.front());
+  if (op->global_data_section.valid()) Visit(&op->global_data_section);
+  if (op->function_section.valid()) Visit(&op->function_section);
+}
+
+void CodeGenLLVM::Visit(const ir::Assign *op) { EmitAssign(op->a, op->b, ir::NodeTy::Assign); }
+void CodeGenLLVM::Visit(const ir::SumAssign *op) { EmitAssign(op->a, op->b, ir::NodeTy::SumAssign); }
+void CodeGenLLVM::Visit(const ir::SubAssign *op) { EmitAssign(op->a, op->b, ir::NodeTy::SubAssign); }
+void CodeGenLLVM::Visit(const ir::MulAssign *op) { EmitAssign(op->a, op->b, ir::NodeTy::MulAssign); }
+void CodeGenLLVM::Visit(const ir::DivAssign *op) { EmitAssign(op->a, op->b, ir::NodeTy::DivAssign); }
+
+void CodeGenLLVM::EmitAssign(const ir::Expr &a, const ir::Expr &b, ir::NodeTy type) {
+  auto *rhs_value = Codegen(b);
+  auto *lhs_ptr = Address(a);
+
+  if (rhs_value->getType()->isVectorTy() && !a.is_var()) {
+    if (optimize::IsSimdData(a)) {
+      // Store the vector to the memory.
+      lhs_ptr = builder_->CreateBitCast(lhs_ptr, rhs_value->getType()->getPointerTo());
+      unsigned align = primitive_bytes(b.ptype());
+      if (type != ir::NodeTy::Assign) {
+        rhs_value = EmitAssignOpr(builder_->CreateAlignedLoad(lhs_ptr, align), rhs_value, type);
+      }
+      builder_->CreateAlignedStore(rhs_value, lhs_ptr, align);
+      return;
+    }
+    // A scalar is assigned the sum of a vector, such as the result of a vector accumulator.
+    rhs_value = ReduceAdd(rhs_value);
+  }
+
+  if (type != ir::NodeTy::Assign) {
+    rhs_value = EmitAssignOpr(builder_->CreateLoad(lhs_ptr), rhs_value, type);
+  }
+  builder_->CreateStore(rhs_value, lhs_ptr);
+}
+
+llvm::Value *CodeGenLLVM::EmitAssignOpr(llvm::Value *origin, llvm::Value *value, ir::NodeTy type) {
+  bool is_fp = origin->getType()->isFPOrFPVectorTy();
+  switch (type) {
+    case ir::NodeTy::SumAssign:
+      return is_fp ? builder_->CreateFAdd(origin, value) : builder_->CreateAdd(origin, value);
+    case ir::NodeTy::SubAssign:
+      return is_fp ? builder_->CreateFSub(origin, value) : builder_->CreateSub(origin, value);
+    case ir::NodeTy::MulAssign:
+      return is_fp ? builder_->CreateFMul(origin, value) : builder_->CreateMul(origin, value);
+    case ir::NodeTy::DivAssign:
+      return is_fp ? builder_->CreateFDiv(origin, value) : builder_->CreateSDiv(origin, value);
+    default:
+      LOG(FATAL) << "not a compound assignment: " << type;
+  }
+  return nullptr;
+}
 
-  auto *lhs_ptr = builder_->CreateGEP(lhs_array, lhs_index, "p");
-  auto *rhs_value = Codegen(op->b);
+void CodeGenLLVM::Visit(const ir::Let *op) {
+  CHECK(op->a.is_var());
+  auto *var = op->a.As<ir::Var>();
+  // A reference variable is bound to the memory of the element.
+  if (var->is_reference()) {
+    vars_[var->name()] = Address(op->b);
+    return;
+  }
 
-  auto *store = builder_->CreateStore(rhs_value, lhs_ptr);
+  auto *value = Codegen(op->b);
+  if (!function_) {
+    auto *init = llvm::dyn_cast<llvm::Constant>(value);
+    CHECK(init) << "global variable " << var->name() << " should be initialized by a constant";
+    vars_[var->name()] = new llvm::GlobalVariable(
+        *module_, value->getType(), false /*is constant*/, llvm::GlobalValue::InternalLinkage, init, var->name());
+  } else {
+    auto *alloca = CreateEntryAlloca(value->getType(), nullptr, var->name());
+    builder_->CreateStore(value, alloca);
+    vars_[var->name()] = alloca;
+  }
 }
 
 void CodeGenLLVM::Visit(const ir::Constant *op) {
-  // TODO(Superjomn) consider the i8, i16, and i64, so is the float points.
+  CHECK(op->value_set()) << "constant " << op->name() << " has no value";
   if (op->is_integer()) {
-    value_ = llvm::ConstantInt::getSigned(i32_t, op->As<int>());
-  } else if (op->is_float()) {
-    value_ = llvm::ConstantInt::getSigned(f32_t, op->As<float>());
-  } else if (op->is_boolean()) {
+    value_ = llvm::ConstantInt::getSigned(ElementType(op->ptype()), op->int_val());
+  } else if (op->ptype() == primitive_t::float32) {
+    value_ = llvm::ConstantFP::get(f32_t, op->As<float>());
+  } else if (op->ptype() == primitive_t::float64) {
+    value_ = llvm::ConstantFP::get(f64_t, op->As<double>());
+  } else {
     LOG(FATAL) << "not supported type " << op->ptype();
   }
 }
@@ -272,23 +453,43 @@ void CodeGenLLVM::Visit(const ir::Block *op) {
   }
 }
 
+void CodeGenLLVM::Visit(const ir::Statement *op) { Visit(&op->expr); }
+
 void CodeGenLLVM::Visit(const ir::Tensor *op) {
-  CHECK(fn_args_.count(op->name())) << "fn_arg " << op->name() << "not exists";
-  value_ = fn_args_[op->name()];
-  value_->print(llvm::outs());
+  if (fn_args_.count(op->name())) {
+    value_ = fn_args_[op->name()];
+  } else {
+    CHECK(buffers_.count(op->name())) << "fn_arg or buffer " << op->name() << " not exists";
+    value_ = buffers_[op->name()];
+  }
 }
 
 // read a reference.
 void CodeGenLLVM::Visit(const ir::Reference *op) { ReadTensorElement(*op); }
 
-void CodeGenLLVM::ReadTensorElement(const ir::Reference &ref) {
+void CodeGenLLVM::ReadTensorElement(const ir::Reference &ref) { value_ = builder_->CreateLoad(ReferenceAddress(ref)); }
+
+llvm::Value *CodeGenLLVM::ReferenceAddress(const ir::Reference &ref) {
   auto *array_ptr = Codegen(ref.target);
   CHECK_EQ(ref.iterators.size(), 1UL) << "the indices should be an absolute offset";
   auto *index = Codegen(ref.iterators.front());
+  return builder_->CreateGEP(array_ptr, index);
+}
+
+llvm::Value *CodeGenLLVM::Address(const ir::Expr &expr) {
+  bool is_address;
+  ir::Expr trimed = TrimIdentity(expr, &is_address);
+  if (trimed.is_reference()) return ReferenceAddress(*trimed.As<ir::Reference>());
+  if (trimed.is_var() && vars_.count(trimed.As<ir::Var>()->name())) return vars_[trimed.As<ir::Var>()->name()];
+  // The buffers, their addresses are the values.
+  return Codegen(trimed);
+}
 
-  auto *offset = builder_->CreateGEP(array_ptr, index);
-  auto *element = builder_->CreateLoad(offset, false);
-  value_ = element;
+void CodeGenLLVM::Visit(const ir::Identity *op) {
+  bool is_address;
+  ir::Expr expr = TrimIdentity(op->expr, &is_address);
+  is_address |= op->marked_as_address();
+  value_ = is_address ? Address(expr) : Codegen(expr);
 }
 
 void CodeGenLLVM::Visit(const ir::For *op) {
@@ -298,42 +499,31 @@ void CodeGenLLVM::Visit(const ir::For *op) {
   CINN_DEBUG(0) << "init: " << ir::Dump(op->iter_init);
   CINN_DEBUG(0) << "cond: " << ir::Dump(op->iter_cond);
 
-  llvm::BasicBlock *entry_bb = llvm::BasicBlock::Create(*ctx_, "entry", function_);
   llvm::BasicBlock *cond_bb = llvm::BasicBlock::Create(*ctx_, "cond", function_);
   llvm::BasicBlock *loop_bb = llvm::BasicBlock::Create(*ctx_, "loop", function_);
   llvm::BasicBlock *inc_bb = llvm::BasicBlock::Create(*ctx_, "inc", function_);
   llvm::BasicBlock *after_bb = llvm::BasicBlock::Create(*ctx_, "afterloop", function_);
 
-  builder_->CreateBr(entry_bb);  // terminal the previous block.
-  builder_->SetInsertPoint(entry_bb);
-  llvm::Value *i_ptr = builder_->CreateAlloca(i32_t);
-  {
-    // llvm::kprintf(module_, builder_, "I am in %s", "entry block");
-    // prepare entry block --
-    // int i
-    for_iterator_vars_[op->iterator.name()] = i_ptr;
+  // int i = init, allocated in the entry block so that the nested loops don't grow the stack.
+  auto *init = Codegen(op->iter_init);
+  llvm::Value *i_ptr = CreateEntryAlloca(init->getType(), nullptr, op->iterator.name());
+  builder_->CreateStore(init, i_ptr);
 
-    // i = 0;
-    auto *init = Codegen(op->iter_init);
-    builder_->CreateStore(init, i_ptr);
-  }
+  // The iterator might shadow a variable with the same name.
+  const auto &name = op->iterator.name();
+  auto shadowed = vars_.find(name);
+  llvm::Value *shadowed_var = shadowed == vars_.end() ? nullptr : shadowed->second;
+  vars_[name] = i_ptr;
 
-  builder_->CreateBr(cond_bb);
+  builder_->CreateBr(cond_bb);  // terminal the previous block.
   {
     builder_->SetInsertPoint(cond_bb);
-    // cond bb
-    llvm::Value *i = builder_->CreateLoad(i_ptr);
-    for_iterator_vars_[op->iterator.name()] = i;
     llvm::Value *cond = Codegen(op->iter_cond);
     builder_->CreateCondBr(cond, loop_bb, after_bb);
   }
 
-  // builder_->CreateBr(loop_bb);
   {
     builder_->SetInsertPoint(loop_bb);
-
-    auto *load = builder_->CreateLoad(i_ptr);
-    // llvm::kprintf(module_, builder_, "loop %d\n", load);
     // visit body
     Visit(&op->body);
   }
@@ -348,13 +538,370 @@ void CodeGenLLVM::Visit(const ir::For *op) {
   }
 
   builder_->CreateBr(cond_bb);
-  { builder_->SetInsertPoint(after_bb); }
+  builder_->SetInsertPoint(after_bb);
+
+  if (shadowed_var) {
+    vars_[name] = shadowed_var;
+  } else {
+    vars_.erase(name);
+  }
+}
+
+void CodeGenLLVM::Visit(const ir::IfThenElse *op) {
+  auto *cond = Codegen(op->condition);
+  if (!cond->getType()->isIntegerTy(1)) {
+    cond = builder_->CreateICmpNE(cond, llvm::Constant::getNullValue(cond->getType()));
+  }
+
+  llvm::BasicBlock *then_bb = llvm::BasicBlock::Create(*ctx_, "then", function_);
+  llvm::BasicBlock *else_bb = op->false_block.valid() ? llvm::BasicBlock::Create(*ctx_, "else", function_) : nullptr;
+  llvm::BasicBlock *after_bb = llvm::BasicBlock::Create(*ctx_, "afterif", function_);
+  builder_->CreateCondBr(cond, then_bb, else_bb ? else_bb : after_bb);
+
+  builder_->SetInsertPoint(then_bb);
+  Visit(&op->true_block);
+  builder_->CreateBr(after_bb);
+
+  if (else_bb) {
+    builder_->SetInsertPoint(else_bb);
+    Visit(&op->false_block);
+    builder_->CreateBr(after_bb);
+  }
+
+  builder_->SetInsertPoint(after_bb);
+}
+
+void CodeGenLLVM::Visit(const ir::CallOnce *op) {
+  // The conditional variable is created by the module if the call_once_process pass has run.
+  if (!vars_.count(op->cond_var_name)) {
+    vars_[op->cond_var_name] = new llvm::GlobalVariable(*module_,
+                                                        i1_t,
+                                                        false /*is constant*/,
+                                                        llvm::GlobalValue::InternalLinkage,
+                                                        llvm::ConstantInt::getTrue(*ctx_),
+                                                        op->cond_var_name);
+  }
+  auto *cond_var = vars_[op->cond_var_name];
+
+  llvm::BasicBlock *then_bb = llvm::BasicBlock::Create(*ctx_, "call_once", function_);
+  llvm::BasicBlock *after_bb = llvm::BasicBlock::Create(*ctx_, "after_call_once", function_);
+  builder_->CreateCondBr(builder_->CreateLoad(cond_var), then_bb, after_bb);
+
+  builder_->SetInsertPoint(then_bb);
+  Visit(&op->block);
+  builder_->CreateStore(llvm::ConstantInt::getFalse(*ctx_), cond_var);
+  builder_->CreateBr(after_bb);
+
+  builder_->SetInsertPoint(after_bb);
 }
 
 void CodeGenLLVM::Visit(const ir::Var *op) {
-  CHECK(for_iterator_vars_.count(op->name()));
-  auto *loop_var = for_iterator_vars_[op->name()];
-  value_ = loop_var;
+  auto var = vars_.find(op->name());
+  if (var != vars_.end()) {
+    value_ = builder_->CreateLoad(var->second, op->name());
+  } else if (fn_args_.count(op->name())) {
+    value_ = fn_args_[op->name()];
+  } else {
+    CHECK(buffers_.count(op->name())) << "variable " << op->name() << " not exists";
+    value_ = buffers_[op->name()];
+  }
+}
+
+void CodeGenLLVM::Visit(const ir::Call *op) {
+  std::vector<llvm::Value *> args;
+  for (auto &arg : op->arguments) args.push_back(Codegen(arg));
+
+  if (op->caller == "cinn_copy") {
+    // cinn_copy(source, target, bytes)
+    CHECK_EQ(args.size(), 3UL);
+    value_ = builder_->CreateMemCpy(args[1], 1, args[0], 1, args[2]);
+    return;
+  }
+
+  std::vector<llvm::Type *> arg_types;
+  for (auto *arg : args) arg_types.push_back(arg->getType());
+  value_ = builder_->CreateCall(GetOrDeclareFunction(op->caller, void_t, arg_types), args);
+}
+
+void CodeGenLLVM::Visit(const ir::Allocate *op) {
+  auto *size = Codegen(op->size);
+  buffers_[op->buffer_name] = CreateEntryAlloca(ElementType(op->dtype), size, op->buffer_name);
+}
+
+void CodeGenLLVM::Visit(const ir::Array *op) {
+  if (!buffers_.count(op->name)) {
+    buffers_[op->name] = CreateEntryAlloca(ElementType(op->ptype()), Codegen(op->size), op->name);
+  }
+  value_ = buffers_[op->name];
+}
+
+void CodeGenLLVM::Visit(const ir::BufferOpr *op) {
+  switch (op->operation) {
+    case ir::BufferOpr::Opr::kCreate:
+      if (function_) {
+        CHECK(op->size.is_int_imm()) << "buffer " << op->name << " should have a constant size";
+        int64_t bytes = op->size.As<ir::IntImm>()->val();
+        int64_t size = (bytes + primitive_bytes(op->ptype()) - 1) / primitive_bytes(op->ptype());
+        auto *alloca = CreateEntryAlloca(ElementType(op->ptype()), llvm::ConstantInt::get(i64_t, size), op->name);
+        alloca->setAlignment(kBufferAlignment);
+        buffers_[op->name] = alloca;
+      } else {
+        CreateGlobalBuffer(*op);
+      }
+      break;
+
+    case ir::BufferOpr::Opr::kCreateAssign:
+      CreateGlobalBuffer(*op);
+      break;
+
+    case ir::BufferOpr::Opr::kCreateInArena: {
+      CHECK(buffers_.count(op->arena)) << "arena " << op->arena << " not exists";
+      auto *address = builder_->CreateInBoundsGEP(buffers_[op->arena], Codegen(op->offset));
+      buffers_[op->name] = builder_->CreateBitCast(address, ElementType(op->ptype())->getPointerTo());
+      CHECK(function_ || llvm::isa<llvm::Constant>(buffers_[op->name]))
+          << "global buffer " << op->name << " should have a constant offset";
+    } break;
+
+    case ir::BufferOpr::Opr::kMapFile:
+      LOG(FATAL) << "the LLVM backend doesn't map " << op->path << ", build the weights in the module to JIT it";
+      break;
+
+    case ir::BufferOpr::Opr::kDestroy:
+      // The buffers are global variables or on the stack, nothing to free.
+      break;
+
+    case ir::BufferOpr::Opr::kReference:
+      CHECK(buffers_.count(op->name)) << "buffer " << op->name << " not exists";
+      value_ = buffers_[op->name];
+      break;
+  }
+}
+
+void CodeGenLLVM::CreateGlobalBuffer(const ir::BufferOpr &op) {
+  llvm::Constant *init{};
+  llvm::ArrayType *type{};
+  if (op.is_create_assign()) {
+    init = GetDataArray(*ctx_, op);
+    type = llvm::cast<llvm::ArrayType>(init->getType());
+  } else {
+    CHECK(op.size.is_int_imm()) << "global buffer " << op.name << " should have a constant size";
+    int64_t bytes = op.size.As<ir::IntImm>()->val();
+    int64_t size = (bytes + primitive_bytes(op.ptype()) - 1) / primitive_bytes(op.ptype());
+    type = llvm::ArrayType::get(ElementType(op.ptype()), size);
+    init = llvm::ConstantAggregateZero::get(type);
+  }
+
+  // The weights are never written, make them constant to help the optimization.
+  auto *global = new llvm::GlobalVariable(
+      *module_, type, op.is_create_assign() /*is constant*/, llvm::GlobalValue::InternalLinkage, init, op.name);
+  global->setAlignment(kBufferAlignment);
+
+  llvm::Constant *zero = llvm::ConstantInt::get(i32_t, 0);
+  buffers_[op.name] =
+      llvm::ConstantExpr::getInBoundsGetElementPtr(type, global, llvm::ArrayRef<llvm::Constant *>{zero, zero});
+}
+
+void CodeGenLLVM::Visit(const ir::Cast *op) {
+  if (op->is_simd()) {
+    int vector_width = VectorWidth(op->ctype());
+    bool is_address;
+    ir::Expr expr = TrimIdentity(op->expr, &is_address);
+    if (is_address) {
+      value_ = LoadVector(Address(expr), expr.ptype(), vector_width);
+    } else if (op->expr.is_simd()) {
+      value_ = Codegen(op->expr);
+    } else {
+      value_ = Broadcast(CastScalar(Codegen(op->expr), op->expr.ptype(), op->ptype()), vector_width);
+    }
+    return;
+  }
+
+  if (op->expr.is_simd()) {
+    // Reduce a vector to a scalar, as the C backend does.
+    value_ = ReduceAdd(Codegen(op->expr));
+    return;
+  }
+
+  value_ = CastScalar(Codegen(op->expr), op->expr.ptype(), op->ptype());
+}
+
+llvm::Value *CodeGenLLVM::CastScalar(llvm::Value *value, primitive_t from, primitive_t to) {
+  if (from == to) return value;
+
+  if (is_half_float(from)) {
+    CHECK(to == primitive_t::float32) << "half precision float can only be cast to float32";
+    if (from == primitive_t::float16) return builder_->CreateFPExt(builder_->CreateBitCast(value, f16_t), f32_t);
+    // The bfloat16 is the upper half of a float32.
+    return builder_->CreateBitCast(builder_->CreateShl(builder_->CreateZExt(value, i32_t), 16), f32_t);
+  }
+  CHECK(!is_half_float(to)) << "not supported cast from " << from << " to " << to;
+
+  auto *type = ElementType(to);
+  if (is_float(from) && is_float(to)) return builder_->CreateFPCast(value, type);
+  if (is_float(from)) return IsUnsigned(to) ? builder_->CreateFPToUI(value, type) : builder_->CreateFPToSI(value, type);
+  if (is_float(to)) return IsUnsigned(from) ? builder_->CreateUIToFP(value, type) : builder_->CreateSIToFP(value, type);
+  if (to == primitive_t::boolean) return builder_->CreateICmpNE(value, llvm::Constant::getNullValue(value->getType()));
+  return builder_->CreateIntCast(value, type, !IsUnsigned(from));
+}
+
+llvm::Value *CodeGenLLVM::LoadVector(llvm::Value *address, primitive_t ptype, int vector_width) {
+  auto *type = llvm::VectorType::get(ElementType(ptype), vector_width);
+  unsigned align = primitive_bytes(ptype);
+  auto *vector = builder_->CreateAlignedLoad(builder_->CreateBitCast(address, type->getPointerTo()), align);
+
+  auto *f32_vector_t = llvm::VectorType::get(f32_t, vector_width);
+  switch (ptype) {
+    case primitive_t::float16:
+      return builder_->CreateFPExt(builder_->CreateBitCast(vector, llvm::VectorType::get(f16_t, vector_width)),
+                                   f32_vector_t);
+    case primitive_t::bfloat16:
+      return builder_->CreateBitCast(
+          builder_->CreateShl(builder_->CreateZExt(vector, llvm::VectorType::get(i32_t, vector_width)), 16),
+          f32_vector_t);
+    default:
+      return vector;
+  }
+}
+
+llvm::Value *CodeGenLLVM::Broadcast(llvm::Value *scalar, int vector_width) {
+  return builder_->CreateVectorSplat(vector_width, scalar);
+}
+
+llvm::Value *CodeGenLLVM::ReduceAdd(llvm::Value *vector) {
+  int vector_width = vector->getType()->getVectorNumElements();
+  bool is_fp = vector->getType()->isFPOrFPVectorTy();
+  llvm::Value *sum = builder_->CreateExtractElement(vector, builder_->getInt32(0));
+  for (int i = 1; i < vector_width; i++) {
+    auto *x = builder_->CreateExtractElement(vector, builder_->getInt32(i));
+    sum = is_fp ? builder_->CreateFAdd(sum, x) : builder_->CreateAdd(sum, x);
+  }
+  return sum;
+}
+
+llvm::Value *CodeGenLLVM::MapElements(llvm::Value *vector, const std::function<llvm::Value *(llvm::Value *)> &fn) {
+  int vector_width = vector->getType()->getVectorNumElements();
+  llvm::Value *result = llvm::UndefValue::get(vector->getType());
+  for (int i = 0; i < vector_width; i++) {
+    auto *x = builder_->CreateExtractElement(vector, builder_->getInt32(i));
+    result = builder_->CreateInsertElement(result, fn(x), builder_->getInt32(i));
+  }
+  return result;
+}
+
+llvm::Value *CodeGenLLVM::CallMathFunction(const std::string &name, llvm::Value *x) {
+  if (x->getType()->isVectorTy()) {
+    return MapElements(x, [&](llvm::Value *e) { return CallMathFunction(name, e); });
+  }
+  CHECK(x->getType()->isFloatTy() || x->getType()->isDoubleTy());
+  // tanhf for float, tanh for double.
+  std::string fn_name = x->getType()->isFloatTy() ? name + "f" : name;
+  return builder_->CreateCall(GetOrDeclareFunction(fn_name, x->getType(), {x->getType()}), {x});
+}
+
+void CodeGenLLVM::Visit(const ir::SIMDOpr *op) {
+  switch (op->opr) {
+    case ir::SIMDOpr::Opr::kAdd:
+      value_ = builder_->CreateFAdd(Codegen(op->a), Codegen(op->b));
+      break;
+    case ir::SIMDOpr::Opr::kSub:
+      value_ = builder_->CreateFSub(Codegen(op->a), Codegen(op->b));
+      break;
+    case ir::SIMDOpr::Opr::kMul:
+      value_ = builder_->CreateFMul(Codegen(op->a), Codegen(op->b));
+      break;
+    case ir::SIMDOpr::Opr::kDiv:
+      value_ = builder_->CreateFDiv(Codegen(op->a), Codegen(op->b));
+      break;
+    case ir::SIMDOpr::Opr::kMax: {
+      auto *a = Codegen(op->a);
+      auto *b = Codegen(op->b);
+      value_ = builder_->CreateSelect(builder_->CreateFCmpOGT(a, b), a, b);
+    } break;
+    case ir::SIMDOpr::Opr::kMin: {
+      auto *a = Codegen(op->a);
+      auto *b = Codegen(op->b);
+      value_ = builder_->CreateSelect(builder_->CreateFCmpOLT(a, b), a, b);
+    } break;
+    case ir::SIMDOpr::Opr::kLoad: {
+      bool is_address;
+      ir::Expr address = TrimIdentity(op->a, &is_address);
+      value_ = LoadVector(Address(address), address.ptype(), op->vector_width);
+    } break;
+    case ir::SIMDOpr::Opr::kStore: {
+      auto *value = Codegen(op->b);
+      auto *address = builder_->CreateBitCast(Address(op->a), value->getType()->getPointerTo());
+      value_ = builder_->CreateAlignedStore(value, address, primitive_bytes(op->b.ptype()));
+    } break;
+    case ir::SIMDOpr::Opr::kReduceAdd:
+      value_ = ReduceAdd(Codegen(op->a));
+      break;
+    case ir::SIMDOpr::Opr::kReduceMul: {
+      auto *vector = Codegen(op->a);
+      value_ = builder_->CreateExtractElement(vector, builder_->getInt32(0));
+      for (int i = 1; i < op->vector_width; i++) {
+        value_ = builder_->CreateFMul(value_, builder_->CreateExtractElement(vector, builder_->getInt32(i)));
+      }
+    } break;
+    case ir::SIMDOpr::Opr::kFma: {
+      // The backend emits a FMA instruction if the CPU supports.
+      auto *a = Codegen(op->a);
+      auto *b = Codegen(op->b);
+      auto *c = Codegen(op->c);
+      auto *fmuladd = llvm::Intrinsic::getDeclaration(module_, llvm::Intrinsic::fmuladd, {a->getType()});
+      value_ = builder_->CreateCall(fmuladd, {a, b, c});
+    } break;
+    case ir::SIMDOpr::Opr::kExp: {
+      auto *a = Codegen(op->a);
+      auto *exp = llvm::Intrinsic::getDeclaration(module_, llvm::Intrinsic::exp, {a->getType()});
+      value_ = builder_->CreateCall(exp, {a});
+    } break;
+    case ir::SIMDOpr::Opr::kTanh:
+      value_ = CallMathFunction("tanh", Codegen(op->a));
+      break;
+    case ir::SIMDOpr::Opr::kSigmoid: {
+      auto *a = Codegen(op->a);
+      auto *exp = llvm::Intrinsic::getDeclaration(module_, llvm::Intrinsic::exp, {a->getType()});
+      auto *one = llvm::ConstantFP::get(a->getType(), 1.);
+      value_ =
+          builder_->CreateFDiv(one, builder_->CreateFAdd(one, builder_->CreateCall(exp, {builder_->CreateFNeg(a)})));
+    } break;
+    case ir::SIMDOpr::Opr::kGather: {
+      // Load a[0], a[stride], a[2 * stride] ... one by one.
+      bool is_address;
+      ir::Expr address = TrimIdentity(op->a, &is_address);
+      auto *base = Address(address);
+      CHECK(op->b.is_int_imm()) << "the stride of gather should be a constant";
+      int64_t stride = op->b.As<ir::IntImm>()->val();
+      auto *vector_type = llvm::VectorType::get(ElementType(address.ptype()), op->vector_width);
+      llvm::Value *result = llvm::UndefValue::get(vector_type);
+      for (int i = 0; i < op->vector_width; i++) {
+        auto *element = builder_->CreateLoad(builder_->CreateGEP(base, builder_->getInt64(i * stride)));
+        result = builder_->CreateInsertElement(result, element, builder_->getInt32(i));
+      }
+      value_ = result;
+    } break;
+    default:
+      LOG(FATAL) << "not supported " << op->opr;
+  }
+}
+
+llvm::AllocaInst *CodeGenLLVM::CreateEntryAlloca(llvm::Type *type, llvm::Value *size, const std::string &name) {
+  CHECK(function_) << "stack variable " << name << " should be created in a function";
+  // A variable sized memory is allocated where it is defined.
+  if (size && !llvm::isa<llvm::Constant>(size)) return builder_->CreateAlloca(type, size, name);
+  auto &entry = function_->getEntryBlock();
+  llvm::IRBuilder<> builder(&entry, entry.begin());
+  return builder.CreateAlloca(type, size, name);
+}
+
+llvm::Function *CodeGenLLVM::GetOrDeclareFunction(const std::string &name,
+                                                   llvm::Type *ret,
+                                                   const std::vector<llvm::Type *> &args) {
+  llvm::Function *function = module_->getFunction(name);
+  if (function) return function;
+  // The external functions are resolved in the process, such as the functions of the C library.
+  auto *function_type = llvm::FunctionType::get(ret, args, false);
+  return llvm::Function::Create(function_type, llvm::Function::ExternalLinkage, name, module_);
 }
 
 CodeGenLLVM::CodeGenLLVM(Target target, llvm::LLVMContext &ctx, llvm::Module *module)
@@ -367,6 +914,7 @@ CodeGenLLVM::CodeGenLLVM(Target target, llvm::LLVMContext &ctx, llvm::Module *mo
 
   // element type
   void_t = llvm::Type::getVoidTy(*ctx_);
+  i1_t = llvm::Type::getInt1Ty(*ctx_);
   i8_t = llvm::Type::getInt8Ty(*ctx_);
   i16_t = llvm::Type::getInt16Ty(*ctx_);
   i32_t = llvm::Type::getInt32Ty(*ctx_);
@@ -376,10 +924,10 @@ CodeGenLLVM::CodeGenLLVM(Target target, llvm::LLVMContext &ctx, llvm::Module *mo
   f64_t = llvm::Type::getDoubleTy(*ctx_);
 
   // pointer type
-  f16ptr_t = llvm::Type::getFloatPtrTy(*ctx_, 16);
-  f32ptr_t = llvm::Type::getFloatPtrTy(*ctx_, 32);
-  f64ptr_t = llvm::Type::getFloatPtrTy(*ctx_, 64);
-  i32ptr_t = llvm::Type::getInt32Ty(*ctx_);
+  f16ptr_t = llvm::Type::getHalfPtrTy(*ctx_);
+  f32ptr_t = llvm::Type::getFloatPtrTy(*ctx_);
+  f64ptr_t = llvm::Type::getDoublePtrTy(*ctx_);
+  i32ptr_t = llvm::Type::getInt32PtrTy(*ctx_);
 
   builder_ = new llvm::IRBuilder<>(*ctx_);
 }
@@ -1,8 +1,12 @@
 #pragma once
 #include <glog/logging.h>
 #include <gtest/gtest_prod.h>
+#include <functional>
 #include <iostream>
+#include <map>
 #include <memory>
+#include <string>
+#include <vector>
 #include "cinn/backends/llvm_headers.h"
 #include "cinn/ir/ir_printer.h"
 #include "cinn/target.h"
@@ -12,6 +16,16 @@ namespace backends {
 
 /**
  * @brief Code generator for LLVM.
+ *
+ * It lowers the whole CINN IR to LLVM IR, including:
+ *
+ * - ir::Module, the global buffers become the global variables of the LLVM module, and each ir::Function becomes a
+ *   function of the module,
+ * - the buffers created in functions(Allocate, Array) become the stack memory,
+ * - the SIMD operations become the operations on the LLVM vector types, the LLVM backend selects the instructions for
+ *   the target CPU.
+ *
+ * The IR should be optimized by the IrOptimizer first, so that each Reference has an absolute offset.
  */
 class CodeGenLLVM : public ir::IRPrinter {
   llvm::LLVMContext *ctx_{};
@@ -33,9 +47,16 @@ class CodeGenLLVM : public ir::IRPrinter {
 
   void Visit(const ir::Mod *op) override;
 
-  void Visit(const ir::Minus *op) override { IRPrinter::Visit(op); }
+  void Visit(const ir::Minus *op) override;
 
-  void Visit(const ir::Exp *op) override { IRPrinter::Visit(op); }
+  void Visit(const ir::Not *op) override;
+
+  void Visit(const ir::Exp *op) override;
+  void Visit(const ir::Sqrt *op) override;
+
+  void Visit(const ir::Tanh *op) override;
+
+  void Visit(const ir::Sigmoid *op) override;
 
   void Visit(const ir::Min *op) override;
 
@@ -47,7 +68,7 @@ class CodeGenLLVM : public ir::IRPrinter {
 
   void Visit(const ir::For *op) override;
 
-  void Visit(const ir::IfThenElse *op) override { IRPrinter::Visit(op); }
+  void Visit(const ir::IfThenElse *op) override;
 
   void Visit(const ir::GT *op) override;
 
@@ -67,6 +88,8 @@ class CodeGenLLVM : public ir::IRPrinter {
 
   void Visit(const ir::FloatImm *op) override;
 
+  void Visit(const ir::BoolImm *op) override;
+
   void Visit(const ir::Tensor *op) override;
 
   void Visit(const ir::Constant *op) override;
@@ -75,18 +98,46 @@ class CodeGenLLVM : public ir::IRPrinter {
 
   void Visit(const ir::Reference *op) override;
 
-  void Visit(const ir::Call *op) override { IRPrinter::Visit(op); }
+  void Visit(const ir::Call *op) override;
 
   void Visit(const ir::Assign *op) override;
 
+  void Visit(const ir::SumAssign *op) override;
+
+  void Visit(const ir::SubAssign *op) override;
+
+  void Visit(const ir::MulAssign *op) override;
+
+  void Visit(const ir::DivAssign *op) override;
+
+  void Visit(const ir::Let *op) override;
+
   void Visit(const ir::Function *op) override;
 
-  void Visit(const ir::Allocate *op) override { IRPrinter::Visit(op); }
+  void Visit(const ir::Statement *op) override;
+
+  void Visit(const ir::Allocate *op) override;
+
+  void Visit(const ir::Mark *op) override {}
+
+  void Visit(const ir::BufferOpr *op) override;
+
+  void Visit(const ir::Array *op) override;
+
+  void Visit(const ir::Cast *op) override;
+
+  void Visit(const ir::SIMDOpr *op) override;
+
+  void Visit(const ir::Identity *op) override;
+
+  void Visit(const ir::CallOnce *op) override;
+
+  void Visit(const ir::Module *op) override;
 
  protected:
   /** Some useful llvm types */
   // @{
-  llvm::Type *void_t, *i8_t, *i16_t, *i32_t, *i64_t, *f16_t, *f32_t, *f64_t;
+  llvm::Type *void_t, *i1_t, *i8_t, *i16_t, *i32_t, *i64_t, *f16_t, *f32_t, *f64_t;
   llvm::Type *f16ptr_t, *f32ptr_t, *f64ptr_t, *i32ptr_t;
   // @}
 
@@ -101,6 +152,50 @@ class CodeGenLLVM : public ir::IRPrinter {
 
   void ReadTensorElement(const ir::Reference &ref);
 
+  //! Get the type of an element of primitive_t in memory, the half precision floats are stored as i16.
+  llvm::Type *ElementType(primitive_t ptype) const;
+
+  //! Get the address of the element a Reference points to.
+  llvm::Value *ReferenceAddress(const ir::Reference &ref);
+
+  //! Get the address of an expression, a Reference or a Var bound to memory.
+  llvm::Value *Address(const ir::Expr &expr);
+
+  //! Create a stack variable in the entry block of the current function, so that it is allocated only once.
+  llvm::AllocaInst *CreateEntryAlloca(llvm::Type *type, llvm::Value *size, const std::string &name);
+
+  //! Get a function of the module, declare an external one if not exists.
+  llvm::Function *GetOrDeclareFunction(const std::string &name,
+                                       llvm::Type *ret,
+                                       const std::vector<llvm::Type *> &args);
+
+  //! Cast a scalar value of type `from` to the primitive_t `to`.
+  llvm::Value *CastScalar(llvm::Value *value, primitive_t from, primitive_t to);
+
+  //! Load a vector of `vector_width` elements from `address`, the half precision floats are widened to floats.
+  llvm::Value *LoadVector(llvm::Value *address, primitive_t ptype, int vector_width);
+
+  //! Broadcast a scalar to a vector.
+  llvm::Value *Broadcast(llvm::Value *scalar, int vector_width);
+
+  //! Sum up all the elements of a vector.
+  llvm::Value *ReduceAdd(llvm::Value *vector);
+
+  //! Apply a scalar math function such as tanhf to each element of a vector.
+  llvm::Value *MapElements(llvm::Value *vector, const std::function<llvm::Value *(llvm::Value *)> &fn);
+
+  //! Call a math function of the C library on a scalar float.
+  llvm::Value *CallMathFunction(const std::string &name, llvm::Value *x);
+
+  //! Emit the code of an assignment, `type` is Assign or one of the compound assignments such as SumAssign.
+  void EmitAssign(const ir::Expr &a, const ir::Expr &b, ir::NodeTy type);
+
+  //! Combine the destination and the value of a compound assignment.
+  llvm::Value *EmitAssignOpr(llvm::Value *origin, llvm::Value *value, ir::NodeTy type);
+
+  //! Create a buffer as a global variable, initialized with the assigned data if any.
+  void CreateGlobalBuffer(const ir::BufferOpr &op);
+
  private:
   Target target_{};
 
@@ -110,9 +205,11 @@ class CodeGenLLVM : public ir::IRPrinter {
   llvm::Value *value_{};
 
   // function arguments.
-  std::map<std::string, llvm::Argument *> fn_args_;
-  // name to llvm pointer.
-  std::map<std::string, llvm::Value *> for_iterator_vars_;
+  std::map<std::string, llvm::Value *> fn_args_;
+  // name to the memory of the variables, such as the for iterators, the local variables and the global variables.
+  std::map<std::string, llvm::Value *> vars_;
+  // name to the address of the first element of the buffers.
+  std::map<std::string, llvm::Value *> buffers_;
 
   FRIEND_TEST(code_gen_llvm, basic);
   FRIEND_TEST(code_gen_llvm, array);
@@ -0,0 +1,110 @@
+#include "cinn/backends/jit_module.h"
+#include <glog/logging.h>
+#include "cinn/core/cinn_context.h"
+#include "cinn/core/optimize/optimizer.h"
+#include "cinn/core/optimize/use_passes.h"
+#include "cinn/ir/ir_helper.h"
+#include "cinn/target.h"
+#include "cinn/utils/string.h"
+
+namespace cinn {
+namespace backends {
+
+namespace {
+
+/**
+ * Adapt KernelCache to the object cache of LLVM. The modules are identified by their keys in KernelCache.
+ *
+ * The cached object is loaded before the JIT compiles the module, so that a hit skips the code generation too.
+ */
+class JitObjectCache : public llvm::ObjectCache {
+ public:
+  JitObjectCache(KernelCache *cache, const std::string &object) : cache_(cache), object_(object) {}
+
+  void notifyObjectCompiled(const llvm::Module *module, llvm::MemoryBufferRef object) override {
+    cache_->Store(module->getModuleIdentifier(), std::string(object.getBufferStart(), object.getBufferSize()));
+  }
+
+  std::unique_ptr<llvm::MemoryBuffer> getObject(const llvm::Module *module) override {
+    if (object_.empty()) return nullptr;
+    return llvm::MemoryBuffer::getMemBufferCopy(object_, module->getModuleIdentifier());
+  }
+
+ private:
+  KernelCache *cache_;
+  std::string object_;
+};
+
+/**
+ * The options that change the object code, the code is compiled for the host CPU. The key is computed before the IR
+ * passes run, so the flags of the global context that change their output are included too.
+ */
+std::string HostCompileOptions() {
+  std::string options = StringFormat(
+      "%s %s O3", llvm::sys::getProcessTriple().c_str(), llvm::sys::getHostCPUName().str().c_str());
+  for (auto &feature : llvm::orc::KaleidoscopeJIT::HostCPUFeatures()) options += " " + feature;
+  // The FMA contraction and the vector accumulation are disabled in the strict floating-point mode.
+  if (GlobalContext().strict_fp()) options += " strict_fp";
+  return options;
+}
+
+}  // namespace
+
+std::unique_ptr<JitModule> JitModule::Create(const ir::Expr &expr, const std::string &name, KernelCache *cache) {
+  CHECK(expr.valid());
+  std::unique_ptr<JitModule> result(new JitModule);
+  result->context_.reset(new llvm::LLVMContext);
+
+  // The modules are identified by their keys in the cache.
+  std::string module_name = name;
+  if (cache) {
+    module_name = KernelCache::Key(expr, HostCompileOptions());
+    std::string object;
+    result->from_cache_ = cache->Load(module_name, &object);
+    result->object_cache_.reset(new JitObjectCache(cache, object));
+
+    if (result->from_cache_) {
+      // An empty module, the JIT gets its object from the cache.
+      std::unique_ptr<llvm::Module> module(new llvm::Module(module_name, *result->context_));
+      result->jit_ = CreateJIT(module.get(), result->object_cache_.get());
+      result->jit_->addModule(std::move(module));
+      return result;
+    }
+  }
+
+  std::unique_ptr<llvm::Module> module(new llvm::Module(module_name, *result->context_));
+
+  // The passes rewrite the expression, keep the original one for the other backends.
+  ir::Expr copied = ir::IRDeepCopy(expr);
+  IrOptimizer optimizer;
+  optimizer(&copied);
+
+  // The data layout of the JIT should be set before the code generation.
+  result->jit_ = CreateJIT(module.get(), result->object_cache_.get());
+
+  Target target;
+  CodeGenLLVM gen(target, *result->context_, module.get());
+  gen.Visit(&copied);
+
+  std::string errors;
+  llvm::raw_string_ostream os(errors);
+  CHECK(!llvm::verifyModule(*module, &os)) << "invalid module " << name << ": " << os.str();
+
+  OptimizeModule(module.get(), &result->jit_->getTargetMachine());
+
+  llvm::raw_string_ostream ir_os(result->llvm_ir_);
+  module->print(ir_os, nullptr);
+  ir_os.flush();
+
+  result->jit_->addModule(std::move(module));
+  return result;
+}
+
+void *JitModule::Lookup(const std::string &name) {
+  auto symbol = jit_->findSymbol(name);
+  if (!symbol) return nullptr;
+  return reinterpret_cast<void *>(llvm::cantFail(symbol.getAddress()));
+}
+
+}  // namespace backends
+}  // namespace cinn
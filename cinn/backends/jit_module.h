@@ -0,0 +1,71 @@
+#pragma once
+#include <memory>
+#include <string>
+#include "cinn/backends/code_gen_llvm.h"
+#include "cinn/backends/kernel_cache.h"
+#include "cinn/backends/llvm_jit.h"
+#include "cinn/ir/ir.h"
+
+namespace cinn {
+namespace backends {
+
+/**
+ * JitModule compiles an IR module or function to native code in the current process, and hands back the callable
+ * function pointers.
+ *
+ * The IR is optimized by the IrOptimizer, lowered by CodeGenLLVM, optimized by the LLVM O3 pipeline for the host CPU,
+ * and compiled by the LLVM JIT. No C compiler or file is involved.
+ *
+ * Usage:
+ *
+ *     auto module = JitModule::Create(builder.Build(network));
+ *     auto set_input_x = module->GetFunction<void (*)(float*)>("set_input_x");
+ *     auto main = module->GetFunction<void (*)()>("main_");
+ *
+ * The memory of the compiled code, including the global buffers, lives as long as the JitModule.
+ *
+ * With a KernelCache, the object code is cached on the disk, keyed by the IR and the host CPU. A later build of the same
+ * IR loads the object code and skips the IR passes and the LLVM compilation.
+ */
+class JitModule {
+ public:
+  /**
+   * Compile an expression, an ir::Module or an ir::Function.
+   * @param expr the expression to compile, it is not changed.
+   * @param name the name of the LLVM module.
+   * @param cache the cache of the object code, nullptr to disable the cache.
+   */
+  static std::unique_ptr<JitModule> Create(const ir::Expr& expr,
+                                           const std::string& name = "cinn_module",
+                                           KernelCache* cache = nullptr);
+
+  //! Get the address of a function, nullptr if not exists.
+  void* Lookup(const std::string& name);
+
+  //! Get a function with type FnT, such as `void (*)(float*, float*)`.
+  template <typename FnT>
+  FnT GetFunction(const std::string& name) {
+    void* address = Lookup(name);
+    CHECK(address) << "function " << name << " not exists";
+    return reinterpret_cast<FnT>(address);
+  }
+
+  //! The optimized LLVM IR, for debug, empty if the code is loaded from the cache.
+  const std::string& llvm_ir() const { return llvm_ir_; }
+
+  //! Tell whether the code is loaded from the cache.
+  bool from_cache() const { return from_cache_; }
+
+ private:
+  JitModule() = default;
+
+  // The context and the object cache should outlive the JIT, which holds the compiled modules.
+  std::unique_ptr<llvm::LLVMContext> context_;
+  std::unique_ptr<llvm::ObjectCache> object_cache_;
+  std::unique_ptr<llvm::orc::KaleidoscopeJIT> jit_;
+  std::string llvm_ir_;
+  bool from_cache_{false};
+};
+
+}  // namespace backends
+}  // namespace cinn
@@ -0,0 +1,144 @@
+#include "cinn/backends/jit_module.h"
+#include <gtest/gtest.h>
+#include <unistd.h>
+#include <vector>
+#include "cinn/core/function.h"
+#include "cinn/ir/ir.h"
+#include "cinn/ir/ops_overload.h"
+#include "cinn/utils/string.h"
+
+namespace cinn {
+namespace backends {
+
+using cs = std::vector<ir::Constant>;
+
+TEST(jit_module, vectorized_function) {
+  SetGlobalContext(new CINNContext);
+
+  ir::Constant M("M", 64);
+  ir::Var i("i");
+  Expr A(cs({M}), primitive_t::float32, "A");
+  Expr B(cs({M}), primitive_t::float32, "B");
+  Expr C(cs({M}), primitive_t::float32, "C");
+
+  Function fn("fn");
+  {
+    Stage s0 = fn.AddStage(C[i].Assign(A[i] * 2.f + B[i]));
+    s0.Vectorize(8);
+
+    fn.Inputs({A, B});
+    fn.Outputs({C});
+    fn.EndDefinition();
+  }
+
+  auto module = JitModule::Create(Expr(fn));
+  LOG(INFO) << "llvm ir:\n" << module->llvm_ir();
+
+  auto fn_func = module->GetFunction<void (*)(float*, float*, float*)>("fn");
+  std::vector<float> a(64), b(64), c(64, 0.f);
+  for (int i = 0; i < 64; i++) {
+    a[i] = i;
+    b[i] = 1.f;
+  }
+  fn_func(a.data(), b.data(), c.data());
+
+  for (int i = 0; i < 64; i++) {
+    ASSERT_NEAR(c[i], 2.f * i + 1.f, 1e-5);
+  }
+  EXPECT_FALSE(module->Lookup("not_exists"));
+}
+
+TEST(jit_module, module) {
+  SetGlobalContext(new CINNContext);
+
+  Target target;
+  ir::Constant M("M", 4);
+  ir::Var i("i");
+  Expr x(cs({M}), primitive_t::float32, "x");
+  Expr w(cs({M}), primitive_t::float32, "w");
+  Expr y(cs({M}), primitive_t::float32, "y");
+
+  // The buffers: y = x * w, w is a constant weight.
+  auto weight = ir::BufferOpr::make(target, Expr(16), ir::BufferOpr::Opr::kCreateAssign, primitive_t::float32, "w");
+  weight.As<ir::BufferOpr>()->assigned_data.set<std::vector<float>>({1.f, 2.f, 3.f, 4.f});
+  auto data_section = ir::Block::make({weight,
+                                       ir::BufferOpr::make(target, Expr(16), ir::BufferOpr::Opr::kCreate,
+                                                           primitive_t::float32, "x"),
+                                       ir::BufferOpr::make(target, Expr(16), ir::BufferOpr::Opr::kCreate,
+                                                           primitive_t::float32, "y")});
+
+  Function fn("mul");
+  {
+    fn.AddStage(y[i].Assign(x[i] * w[i]));
+    fn.Inputs({x, w});
+    fn.Outputs({y});
+    fn.EndDefinition();
+  }
+
+  Expr x_("x_", primitive_t::float32);
+  Expr y_("y_", primitive_t::float32);
+  auto set_input = ir::Function::make(
+      "set_input_x", {x_}, {}, ir::Block::make({ir::Call::make("cinn_copy", {x_, Expr(std::string("x")), Expr(16)})}));
+  auto get_output = ir::Function::make(
+      "get_output_y", {y_}, {}, ir::Block::make({ir::Call::make("cinn_copy", {Expr(std::string("y")), y_, Expr(16)})}));
+  auto main_fn = ir::Function::make("main_", {}, {}, ir::Block::make({ir::Call::make("mul", {x, w, y})}));
+
+  Expr fn_expr(fn);
+  auto function_section = ir::Block::make({fn_expr, set_input, get_output, main_fn});
+
+  auto module = JitModule::Create(ir::Module::make(data_section, function_section));
+  LOG(INFO) << "llvm ir:\n" << module->llvm_ir();
+
+  std::vector<float> input({1.f, 1.f, 2.f, 2.f}), output(4, 0.f);
+  module->GetFunction<void (*)(float*)>("set_input_x")(input.data());
+  module->GetFunction<void (*)()>("main_")();
+  module->GetFunction<void (*)(float*)>("get_output_y")(output.data());
+
+  EXPECT_EQ(output, std::vector<float>({1.f, 2.f, 6.f, 8.f}));
+}
+
+TEST(jit_module, kernel_cache) {
+  SetGlobalContext(new CINNContext);
+
+  ir::Constant M("M", 16);
+  ir::Var i("i");
+  Expr A(cs({M}), primitive_t::float32, "A");
+  Expr B(cs({M}), primitive_t::float32, "B");
+
+  Function fn("scale");
+  {
+    fn.AddStage(B[i].Assign(A[i] * 3.f));
+    fn.Inputs({A});
+    fn.Outputs({B});
+    fn.EndDefinition();
+  }
+
+  KernelCache cache(StringFormat("/tmp/cinn_jit_module_cache_%d", static_cast<int>(getpid())));
+  cache.Clear();
+
+  std::vector<float> a(16, 2.f), b(16, 0.f);
+  for (int round = 0; round < 2; round++) {
+    auto module = JitModule::Create(Expr(fn), "scale", &cache);
+    // The second build loads the object code compiled by the first one.
+    EXPECT_EQ(module->from_cache(), round == 1);
+    module->GetFunction<void (*)(float*, float*)>("scale")(a.data(), b.data());
+    for (float x : b) ASSERT_EQ(x, 6.f);
+  }
+
+  EXPECT_EQ(cache.hits(), 1UL);
+  EXPECT_EQ(cache.misses(), 1UL);
+
+  // The strict floating-point mode disables the FMA contraction, the code is compiled again.
+  GlobalContext().set_strict_fp(true);
+  auto strict = JitModule::Create(Expr(fn), "scale", &cache);
+  EXPECT_FALSE(strict->from_cache());
+  strict->GetFunction<void (*)(float*, float*)>("scale")(a.data(), b.data());
+  for (float x : b) ASSERT_EQ(x, 6.f);
+  GlobalContext().set_strict_fp(false);
+
+  EXPECT_EQ(cache.misses(), 2UL);
+  cache.Clear();
+}
+
+}  // namespace backends
+}  // namespace cinn
@@ -0,0 +1,182 @@
+#include "cinn/backends/kernel_cache.h"
+#include <dirent.h>
+#include <glog/logging.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utime.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include "cinn/ir/ir_helper.h"
+#include "cinn/ir/ir_printer.h"
+#include "cinn/utils/string.h"
+
+namespace cinn {
+namespace backends {
+
+namespace {
+
+// The extension of the entry files.
+const char *kEntrySuffix = ".bin";
+// Change it when the format of the compiled code changes, to invalidate the old entries.
+const char *kCacheVersion = "cinn-kernel-cache-v1";
+
+//! The 64-bit FNV-1a hash, stable across the processes and the compilers.
+uint64_t Fnv1a(const void *data, size_t size, uint64_t hash = 14695981039346656037UL) {
+  auto *bytes = static_cast<const uint8_t *>(data);
+  for (size_t i = 0; i < size; i++) {
+    hash ^= bytes[i];
+    hash *= 1099511628211UL;
+  }
+  return hash;
+}
+
+template <typename T>
+uint64_t HashVector(const Any &data, uint64_t hash) {
+  auto &vec = data.get<std::vector<T>>();
+  return Fnv1a(vec.data(), vec.size() * sizeof(T), hash);
+}
+
+bool EndsWith(const std::string &s, const std::string &suffix) {
+  return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+struct Entry {
+  std::string path;
+  uint64_t size;
+  // The last used time in nanoseconds.
+  int64_t mtime;
+};
+
+std::vector<Entry> ListEntries(const std::string &dir) {
+  std::vector<Entry> entries;
+  DIR *d = opendir(dir.c_str());
+  if (!d) return entries;
+  while (auto *item = readdir(d)) {
+    std::string name = item->d_name;
+    if (!EndsWith(name, kEntrySuffix)) continue;
+    std::string path = dir + "/" + name;
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) continue;
+    // The modification time is updated when the entry is used, the access time might be disabled by the file system.
+    int64_t mtime = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000L + st.st_mtim.tv_nsec;
+    entries.push_back(Entry{path, static_cast<uint64_t>(st.st_size), mtime});
+  }
+  closedir(d);
+  return entries;
+}
+
+}  // namespace
+
+KernelCache::KernelCache(const std::string &dir, uint64_t max_bytes) : dir_(dir), max_bytes_(max_bytes) {
+  CHECK(!dir.empty());
+  // Create the directories level by level.
+  for (size_t pos = dir.find('/', 1);; pos = dir.find('/', pos + 1)) {
+    std::string sub = dir.substr(0, pos);
+    if (mkdir(sub.c_str(), 0755) != 0) {
+      CHECK_EQ(errno, EEXIST) << "failed to create the directory " << sub;
+    }
+    if (pos == std::string::npos) break;
+  }
+}
+
+std::string KernelCache::Key(const ir::Expr &expr, const std::string &options) {
+  CHECK(expr.valid());
+  std::string repr = StringFormat("%s\n%s\n", kCacheVersion, options.c_str()) + ir::Dump(expr);
+  uint64_t hash = Fnv1a(repr.data(), repr.size());
+
+  // The data of the weights is not printed.
+  for (auto &buffer : ir::CollectExprNode<ir::BufferOpr>(expr)) {
+    auto *op = buffer.As<ir::BufferOpr>();
+    if (!op->is_create_assign()) continue;
+    switch (op->ptype()) {
+      case primitive_t::float32:
+        hash = HashVector<float>(op->assigned_data, hash);
+        break;
+      case primitive_t::int8:
+        hash = HashVector<int8_t>(op->assigned_data, hash);
+        break;
+      case primitive_t::float16:
+      case primitive_t::bfloat16:
+        hash = HashVector<uint16_t>(op->assigned_data, hash);
+        break;
+      default:
+        LOG(FATAL) << "Not supported ptype: " << op->ptype();
+    }
+  }
+
+  std::stringstream ss;
+  ss << std::hex << hash;
+  return ss.str();
+}
+
+std::string KernelCache::Path(const std::string &key) const { return dir_ + "/" + key + kEntrySuffix; }
+
+bool KernelCache::Contains(const std::string &key) const { return access(Path(key).c_str(), R_OK) == 0; }
+
+bool KernelCache::Load(const std::string &key, std::string *data) {
+  CHECK(data);
+  std::ifstream file(Path(key), std::ios::binary);
+  if (!file.is_open()) {
+    misses_++;
+    return false;
+  }
+  std::stringstream ss;
+  ss << file.rdbuf();
+  *data = ss.str();
+  hits_++;
+  // Mark the entry as recently used.
+  utime(Path(key).c_str(), nullptr);
+  return true;
+}
+
+void KernelCache::Store(const std::string &key, const std::string &data) {
+  // The temporary file is unique across the processes and the threads storing the same entry, the entry is replaced
+  // atomically by the rename.
+  std::string tmp = Path(key) + ".tmp.XXXXXX";
+  int fd = mkstemp(&tmp[0]);
+  CHECK_GE(fd, 0) << "failed to create file " << tmp << ", errno " << errno;
+  // mkstemp creates the file readable by the owner only.
+  fchmod(fd, 0644);
+  for (size_t written = 0; written < data.size();) {
+    ssize_t n = write(fd, data.data() + written, data.size() - written);
+    if (n < 0 && errno == EINTR) continue;
+    CHECK_GT(n, 0) << "failed to write file " << tmp << ", errno " << errno;
+    written += n;
+  }
+  CHECK_EQ(close(fd), 0) << "failed to close file " << tmp;
+  CHECK_EQ(rename(tmp.c_str(), Path(key).c_str()), 0) << "failed to store the entry " << key;
+  Evict();
+}
+
+void KernelCache::Evict() {
+  auto entries = ListEntries(dir_);
+  uint64_t total = 0;
+  for (auto &entry : entries) total += entry.size;
+  if (total <= max_bytes_) return;
+
+  std::sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) { return a.mtime < b.mtime; });
+  for (auto &entry : entries) {
+    if (total <= max_bytes_) break;
+    if (unlink(entry.path.c_str()) == 0) {
+      total -= entry.size;
+      evictions_++;
+    }
+  }
+}
+
+void KernelCache::Clear() {
+  for (auto &entry : ListEntries(dir_)) unlink(entry.path.c_str());
+}
+
+uint64_t KernelCache::size() const {
+  uint64_t total = 0;
+  for (auto &entry : ListEntries(dir_)) total += entry.size;
+  return total;
+}
+
+}  // namespace backends
+}  // namespace cinn
@@ -0,0 +1,70 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include "cinn/ir/ir.h"
+
+namespace cinn {
+namespace backends {
+
+/**
+ * KernelCache is a persistent cache of the compiled code, such as the object files or the shared libraries, stored in
+ * a directory on the disk.
+ *
+ * An entry is keyed by a structural hash of the final IR, the target and the compile options, see Key. The code of a
+ * program is compiled only once, the later builds load it from the cache and skip the backend compilation.
+ *
+ * The total size of the entries is bounded, the least recently used ones are evicted when a new entry is stored. The
+ * cache can be shared by multiple processes, an entry is written to a temporary file and renamed to make it visible
+ * atomically.
+ */
+class KernelCache {
+ public:
+  /**
+   * @param dir the directory of the cache, created if not exists.
+   * @param max_bytes the max total size of the entries.
+   */
+  explicit KernelCache(const std::string& dir, uint64_t max_bytes = 1UL << 30);
+
+  /**
+   * Compute the key of a program.
+   * @param expr the final IR, the assigned data of the buffers such as the weights are included.
+   * @param options the target and the compile options that affect the compiled code.
+   */
+  static std::string Key(const ir::Expr& expr, const std::string& options);
+
+  //! Load the data of an entry, return false if not exists.
+  bool Load(const std::string& key, std::string* data);
+
+  //! Store an entry, and evict the least recently used ones if the cache is full.
+  void Store(const std::string& key, const std::string& data);
+
+  //! Tell whether an entry exists, the counters are not changed.
+  bool Contains(const std::string& key) const;
+
+  //! Get the path of the file of an entry.
+  std::string Path(const std::string& key) const;
+
+  //! Remove all the entries.
+  void Clear();
+
+  //! Total size of the entries in bytes.
+  uint64_t size() const;
+
+  uint64_t hits() const { return hits_; }
+  uint64_t misses() const { return misses_; }
+  uint64_t evictions() const { return evictions_; }
+  const std::string& dir() const { return dir_; }
+
+ private:
+  //! Remove the least recently used entries until the total size is no more than max_bytes_.
+  void Evict();
+
+  std::string dir_;
+  uint64_t max_bytes_;
+  uint64_t hits_{};
+  uint64_t misses_{};
+  uint64_t evictions_{};
+};
+
+}  // namespace backends
+}  // namespace cinn
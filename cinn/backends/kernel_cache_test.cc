@@ -0,0 +1,99 @@
+#include "cinn/backends/kernel_cache.h"
+#include <gtest/gtest.h>
+#include <unistd.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include "cinn/target.h"
+#include "cinn/utils/string.h"
+
+namespace cinn {
+namespace backends {
+
+static std::string TempCacheDir(const std::string& name) {
+  return StringFormat("/tmp/cinn_kernel_cache_%s_%d", name.c_str(), static_cast<int>(getpid()));
+}
+
+TEST(KernelCache, load_store) {
+  KernelCache cache(TempCacheDir("load_store"));
+  cache.Clear();
+
+  std::string data;
+  EXPECT_FALSE(cache.Load("fn0", &data));
+  cache.Store("fn0", std::string("\x7f" "ELF\0code", 9));
+  EXPECT_TRUE(cache.Contains("fn0"));
+  ASSERT_TRUE(cache.Load("fn0", &data));
+  EXPECT_EQ(data, std::string("\x7f" "ELF\0code", 9));
+
+  EXPECT_EQ(cache.hits(), 1UL);
+  EXPECT_EQ(cache.misses(), 1UL);
+  EXPECT_EQ(cache.size(), 9UL);
+
+  // The entries persist across the instances.
+  KernelCache other(cache.dir());
+  EXPECT_TRUE(other.Load("fn0", &data));
+  cache.Clear();
+}
+
+TEST(KernelCache, evict_least_recently_used) {
+  KernelCache cache(TempCacheDir("evict"), 300);
+  cache.Clear();
+
+  std::string data(100, 'x');
+  cache.Store("a", data);
+  cache.Store("b", data);
+  cache.Store("c", data);
+  // Use a, so b is the least recently used one.
+  ASSERT_TRUE(cache.Load("a", &data));
+  cache.Store("d", data);
+
+  EXPECT_EQ(cache.evictions(), 1UL);
+  EXPECT_TRUE(cache.Contains("a"));
+  EXPECT_FALSE(cache.Contains("b"));
+  EXPECT_TRUE(cache.Contains("c"));
+  EXPECT_TRUE(cache.Contains("d"));
+  EXPECT_LE(cache.size(), 300UL);
+  cache.Clear();
+}
+
+TEST(KernelCache, store_concurrently) {
+  const std::string dir = TempCacheDir("concurrent");
+  KernelCache(dir).Clear();
+
+  // The threads store the same entry with their own caches, as the processes sharing a directory do.
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; i++) {
+    threads.emplace_back([&dir, i] {
+      KernelCache cache(dir);
+      for (int j = 0; j < 20; j++) cache.Store("fn0", std::string(1000, 'a' + i));
+    });
+  }
+  for (auto& thread : threads) thread.join();
+
+  KernelCache cache(dir);
+  std::string data;
+  ASSERT_TRUE(cache.Load("fn0", &data));
+  ASSERT_EQ(data.size(), 1000UL);
+  EXPECT_EQ(data, std::string(1000, data[0]));
+  // A single entry is kept.
+  EXPECT_EQ(cache.size(), 1000UL);
+  cache.Clear();
+}
+
+TEST(KernelCache, key) {
+  Target target;
+  auto weight = [&](float x) {
+    auto expr = ir::BufferOpr::make(target, Expr(8), ir::BufferOpr::Opr::kCreateAssign, primitive_t::float32, "w");
+    expr.As<ir::BufferOpr>()->assigned_data.set<std::vector<float>>({1.f, x});
+    return ir::Block::make({expr});
+  };
+
+  auto key = KernelCache::Key(weight(2.f), "O3");
+  EXPECT_EQ(key, KernelCache::Key(weight(2.f), "O3"));
+  // Both the data of the weights and the options change the compiled code.
+  EXPECT_NE(key, KernelCache::Key(weight(3.f), "O3"));
+  EXPECT_NE(key, KernelCache::Key(weight(2.f), "O2"));
+}
+
+}  // namespace backends
+}  // namespace cinn
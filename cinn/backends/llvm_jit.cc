@@ -1,4 +1,9 @@
 #include "cinn/backends/llvm_jit.h"
+#include <glog/logging.h>
+#include <llvm/Analysis/TargetTransformInfo.h>
+#include <llvm/IR/LegacyPassManager.h>
+#include <llvm/Transforms/IPO.h>
+#include <llvm/Transforms/IPO/PassManagerBuilder.h>
 
 namespace llvm {
 namespace orc {
@@ -24,6 +29,17 @@ void KaleidoscopeJIT::removeModule(KaleidoscopeJIT::ModuleHandleT H) {
   cantFail(CompileLayer.removeModule(H));
 }
 
+std::vector<std::string> KaleidoscopeJIT::HostCPUFeatures() {
+  std::vector<std::string> features;
+  StringMap<bool> host_features;
+  if (sys::getHostCPUFeatures(host_features)) {
+    for (auto &feature : host_features) {
+      features.push_back((feature.second ? "+" : "-") + feature.first().str());
+    }
+  }
+  return features;
+}
+
 std::string KaleidoscopeJIT::mangle(const std::string &Name) {
   std::string MangledName;
   {
@@ -39,14 +55,15 @@ std::string KaleidoscopeJIT::mangle(const std::string &Name) {
 namespace cinn {
 namespace backends {
 
-std::unique_ptr<llvm::orc::KaleidoscopeJIT> CreateJIT(llvm::Module *module) {
+std::unique_ptr<llvm::orc::KaleidoscopeJIT> CreateJIT(llvm::Module *module, llvm::ObjectCache *cache) {
   llvm::InitializeNativeTarget();
   llvm::InitializeNativeTargetAsmPrinter();
   llvm::InitializeNativeTargetAsmParser();
 
-  std::unique_ptr<llvm::orc::KaleidoscopeJIT> jit(new llvm::orc::KaleidoscopeJIT);
+  std::unique_ptr<llvm::orc::KaleidoscopeJIT> jit(new llvm::orc::KaleidoscopeJIT(cache));
 
   module->setDataLayout(jit->getTargetMachine().createDataLayout());
+  module->setTargetTriple(jit->getTargetMachine().getTargetTriple().str());
 
   // Create a new pass manager attached to it.
   auto fpm = llvm::make_unique<llvm::legacy::FunctionPassManager>(module);
@@ -74,5 +91,42 @@ std::unique_ptr<llvm::orc::KaleidoscopeJIT> CreateJIT(llvm::Module *module) {
 
   return jit;
 }
+
+void OptimizeModule(llvm::Module *module, llvm::TargetMachine *tm, int opt_level) {
+  CHECK(module);
+  CHECK(tm);
+  CHECK(opt_level >= 0 && opt_level <= 3) << "invalid optimization level " << opt_level;
+
+  // Tell the passes the target CPU, so that the vectorizers use its widest vector registers.
+  std::string cpu = tm->getTargetCPU().str();
+  std::string features = tm->getTargetFeatureString().str();
+  for (auto &fn : *module) {
+    if (fn.isDeclaration()) continue;
+    fn.addFnAttr("target-cpu", cpu);
+    fn.addFnAttr("target-features", features);
+  }
+
+  llvm::legacy::FunctionPassManager fpm(module);
+  llvm::legacy::PassManager mpm;
+  fpm.add(llvm::createTargetTransformInfoWrapperPass(tm->getTargetIRAnalysis()));
+  mpm.add(llvm::createTargetTransformInfoWrapperPass(tm->getTargetIRAnalysis()));
+
+  llvm::PassManagerBuilder builder;
+  builder.OptLevel = opt_level;
+  builder.SizeLevel = 0;
+  builder.LoopVectorize = opt_level > 1;
+  builder.SLPVectorize = opt_level > 1;
+  builder.Inliner = llvm::createFunctionInliningPass(opt_level, 0, false);
+  tm->adjustPassManager(builder);
+
+  builder.populateFunctionPassManager(fpm);
+  builder.populateModulePassManager(mpm);
+
+  fpm.doInitialization();
+  for (auto &fn : *module) fpm.run(fn);
+  fpm.doFinalization();
+  mpm.run(*module);
+}
+
 }  // namespace backends
 }  // namespace cinn
@@ -24,6 +24,7 @@
 #include "llvm/ADT/iterator_range.h"
 #include "llvm/ExecutionEngine/ExecutionEngine.h"
 #include "llvm/ExecutionEngine/JITSymbol.h"
+#include "llvm/ExecutionEngine/ObjectCache.h"
 #include "llvm/ExecutionEngine/Orc/CompileUtils.h"
 #include "llvm/ExecutionEngine/Orc/IRCompileLayer.h"
 #include "llvm/ExecutionEngine/Orc/LambdaResolver.h"
@@ -34,6 +35,7 @@
 #include "llvm/IR/DataLayout.h"
 #include "llvm/IR/Mangler.h"
 #include "llvm/Support/DynamicLibrary.h"
+#include "llvm/Support/Host.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Target/TargetMachine.h"
 #include "llvm/Transforms/Scalar/GVN.h"
@@ -47,16 +49,23 @@ class KaleidoscopeJIT {
   using CompileLayerT = IRCompileLayer<ObjLayerT, SimpleCompiler>;
   using ModuleHandleT = CompileLayerT::ModuleHandleT;
 
-  KaleidoscopeJIT()
-      : TM(EngineBuilder().selectTarget()),
+  /**
+   * The code is generated for the host CPU, with all its features such as AVX2 and FMA enabled.
+   * @param cache the cache of the object code, the compilation of a module is skipped if its object is cached.
+   */
+  explicit KaleidoscopeJIT(ObjectCache *cache = nullptr)
+      : TM(EngineBuilder().setMCPU(sys::getHostCPUName()).setMAttrs(HostCPUFeatures()).selectTarget()),
         DL(TM->createDataLayout()),
         ObjectLayer([]() { return std::make_shared<SectionMemoryManager>(); }),
-        CompileLayer(ObjectLayer, SimpleCompiler(*TM)) {
+        CompileLayer(ObjectLayer, SimpleCompiler(*TM, cache)) {
     llvm::sys::DynamicLibrary::LoadLibraryPermanently(nullptr);
   }
 
   TargetMachine &getTargetMachine() { return *TM; }
 
+  //! Get the features of the host CPU, such as "+avx2".
+  static std::vector<std::string> HostCPUFeatures();
+
   ModuleHandleT addModule(std::unique_ptr<Module> M);
 
   void removeModule(ModuleHandleT H);
@@ -115,7 +124,15 @@ class KaleidoscopeJIT {
 namespace cinn {
 namespace backends {
 
-std::unique_ptr<llvm::orc::KaleidoscopeJIT> CreateJIT(llvm::Module *module);
+std::unique_ptr<llvm::orc::KaleidoscopeJIT> CreateJIT(llvm::Module *module, llvm::ObjectCache *cache = nullptr);
+
+/**
+ * Optimize a module with the O3 pipeline of LLVM, including the loop and SLP vectorizers, tuned for the target machine.
+ * @param module the module to optimize.
+ * @param tm the target machine the module is compiled for, such as the one of the JIT.
+ * @param opt_level the optimization level, in [0, 3].
+ */
+void OptimizeModule(llvm::Module *module, llvm::TargetMachine *tm, int opt_level = 3);
 
 }  // namespace backends
 
@@ -11,14 +11,14 @@ std::array<std::string, 4> X86SIMD::m128_dtypes{{
     "__m128",   // floats
     "__m128d",  // doubles
     "__m128i",  // ints
-    "__m128u",  // unsigned ints
+    "__m128i",  // unsigned ints
 }};
 
 std::array<std::string, 4> X86SIMD::m256_dtypes{{
     "__m256",    // floats
-    "__m2568d",  // doubles
-    "__m2568i",  // ints
-    "__m2568u",  // unsigned ints
+    "__m256d",   // doubles
+    "__m256i",   // ints
+    "__m256i",   // unsigned ints
 }};
 
 std::array<std::string, 6> X86SIMD::m128_math_op{{
@@ -39,15 +39,24 @@ std::array<std::string, 6> X86SIMD::m256_math_op{{
     "_mm256_min_ps",  // min
 }};
 
-std::array<std::string, 2> X86SIMD::m128_io_op{{
-    "_mm_load_ps",   //
-    "_mm_store_ps",  //
+std::array<std::string, 7> X86SIMD::m128_io_op{{
+    "_mm_load_ps",         //
+    "_mm_store_ps",        //
+    "_m128_gather_ps",     //
+    "_mm_loadu_ps",        //
+    "_mm_storeu_ps",       //
+    "_m128_load_ph_ps",    //
+    "_m128_load_bf16_ps",  //
 }};
 
-std::array<std::string, 2> X86SIMD::m256_io_op{{
-    "_mm256_load_ps",   //
-    "_mm256_store_ps",  //
-
+std::array<std::string, 7> X86SIMD::m256_io_op{{
+    "_mm256_load_ps",      //
+    "_mm256_store_ps",     //
+    "_m256_gather_ps",     //
+    "_mm256_loadu_ps",     //
+    "_mm256_storeu_ps",    //
+    "_m256_load_ph_ps",    //
+    "_m256_load_bf16_ps",  //
 }};
 
 std::array<std::string, 2> X86SIMD::m128_set1_op{{
@@ -72,6 +81,28 @@ std::array<std::string, 4> X86SIMD::m256_custom_reduce_op{{
     "_m256_custom_reduce_div",  //
 }};
 
+std::array<std::string, 2> X86SIMD::m128_fma_op{{
+    "_mm_fmadd_ps",  // a * b + c
+    "_mm_fmsub_ps",  // a * b - c
+}};
+std::array<std::string, 2> X86SIMD::m256_fma_op{{
+    "_mm256_fmadd_ps",  // a * b + c
+    "_mm256_fmsub_ps",  // a * b - c
+}};
+
+std::array<std::string, 4> X86SIMD::m128_math_func{{
+    "_m128_exp_ps",      //
+    "_m128_log_ps",      //
+    "_m128_tanh_ps",     //
+    "_m128_sigmoid_ps",  //
+}};
+std::array<std::string, 4> X86SIMD::m256_math_func{{
+    "_m256_exp_ps",      //
+    "_m256_log_ps",      //
+    "_m256_tanh_ps",     //
+    "_m256_sigmoid_ps",  //
+}};
+
 X86SIMD::X86SIMD(X86SIMD::Bits bits) {
   switch (bits) {
     case Bits::k128:
@@ -80,6 +111,8 @@ X86SIMD::X86SIMD(X86SIMD::Bits bits) {
       set1_arr_ = m128_set1_op.data();
       io_arr_ = m128_io_op.data();
       custom_reduce_arr_ = m128_custom_reduce_op.data();
+      fma_arr_ = m128_fma_op.data();
+      math_func_arr_ = m128_math_func.data();
       break;
     case Bits::k256:
       dtypes_arr_ = m256_dtypes.data();
@@ -87,6 +120,8 @@ X86SIMD::X86SIMD(X86SIMD::Bits bits) {
       set1_arr_ = m256_set1_op.data();
       io_arr_ = m256_io_op.data();
       custom_reduce_arr_ = m256_custom_reduce_op.data();
+      fma_arr_ = m256_fma_op.data();
+      math_func_arr_ = m256_math_func.data();
       break;
       break;
     default:
@@ -107,21 +142,24 @@ void RefineExprWithSIMDSupport(ir::Expr *expr) {
 
 bool IsCastSIMDReleated(const ir::Cast &cast) { return cast.is_simd() || cast.expr.is_simd(); }
 
-std::string PrintCastOpr(const ir::Cast &cast, X86SIMD *simd, ir::NodeTy reduce_opr) {
+std::string PrintCastOpr(const ir::Cast &cast, X86SIMD *simd, ir::NodeTy reduce_opr, bool aligned) {
   if (cast.is_simd()) {
     CHECK(cast.expr.is_primitive()) << cast.expr;
     std::vector<std::string> ids;
     auto identity = cast.expr.As<ir::Identity>();
     Expr arg = identity ? identity->GetTrimedExpr(&ids) : cast.expr;
 
-    CHECK(arg.ptype() == primitive_t::float32) << "just support fp32";
-
     bool is_pointer = Found(ids, std::string(expr_ids::reference_address));
+    // The half precision data is widened to floats when loaded.
+    if (is_pointer && arg.ptype() == primitive_t::float16) return simd->load_ph_ps();
+    if (is_pointer && arg.ptype() == primitive_t::bfloat16) return simd->load_bf16_ps();
+
+    CHECK(arg.ptype() == primitive_t::float32) << "just support fp32";
 
     if (!is_pointer)
       return simd->set1_ps();
     else
-      return simd->load_ps();
+      return aligned ? simd->load_ps() : simd->loadu_ps();
 
   } else if (cast.is_primitive() && cast.expr.is_simd()) {
     std::string opr_repr;
@@ -22,9 +22,9 @@ class X86SIMD {
   static std::array<std::string, 6> m128_math_op;
   static std::array<std::string, 6> m256_math_op;
 
-  // store load operators
-  static std::array<std::string, 2> m128_io_op;
-  static std::array<std::string, 2> m256_io_op;
+  // store load operators, the gather is implemented in cinn/execution/simd.h
+  static std::array<std::string, 7> m128_io_op;
+  static std::array<std::string, 7> m256_io_op;
 
   // set1
   static std::array<std::string, 2> m128_set1_op;
@@ -34,11 +34,21 @@ class X86SIMD {
   static std::array<std::string, 4> m128_custom_reduce_op;
   static std::array<std::string, 4> m256_custom_reduce_op;
 
+  // fused multiply-add
+  static std::array<std::string, 2> m128_fma_op;
+  static std::array<std::string, 2> m256_fma_op;
+
+  // math functions, implemented in cinn/execution/simd.h
+  static std::array<std::string, 4> m128_math_func;
+  static std::array<std::string, 4> m256_math_func;
+
   std::string* dtypes_arr_{};
   std::string* ops_arr_{};
   std::string* io_arr_{};
   std::string* set1_arr_{};
   std::string* custom_reduce_arr_{};
+  std::string* fma_arr_{};
+  std::string* math_func_arr_{};
 
  public:
   enum Bits {
@@ -63,6 +73,14 @@ class X86SIMD {
 
   std::string load_ps() const { return io_arr_[0]; }
   std::string store_ps() const { return io_arr_[1]; }
+  // load with a constant stride between the elements
+  std::string gather_ps() const { return io_arr_[2]; }
+  // load and store without the alignment requirement
+  std::string loadu_ps() const { return io_arr_[3]; }
+  std::string storeu_ps() const { return io_arr_[4]; }
+  // load the float16 or bfloat16 data and widen to floats
+  std::string load_ph_ps() const { return io_arr_[5]; }
+  std::string load_bf16_ps() const { return io_arr_[6]; }
 
   std::string set1_ps() const { return set1_arr_[0]; }
   std::string set1_pd() const { return set1_arr_[1]; }
@@ -72,6 +90,16 @@ class X86SIMD {
   std::string custom_reduce_mul_ps() const { return custom_reduce_arr_[2]; }
   std::string custom_reduce_div_ps() const { return custom_reduce_arr_[3]; }
 
+  // a * b + c
+  std::string fmadd_ps() const { return fma_arr_[0]; }
+  // a * b - c
+  std::string fmsub_ps() const { return fma_arr_[1]; }
+
+  std::string exp_ps() const { return math_func_arr_[0]; }
+  std::string log_ps() const { return math_func_arr_[1]; }
+  std::string tanh_ps() const { return math_func_arr_[2]; }
+  std::string sigmoid_ps() const { return math_func_arr_[3]; }
+
  private:
   int bits_;
 };
@@ -88,7 +116,14 @@ const X86SIMD& GlobalX86SIMD(composite_t type);
 void RefineExprWithSIMDSupport(ir::Expr* expr);
 
 bool IsCastSIMDReleated(const ir::Cast& cast);
-std::string PrintCastOpr(const ir::Cast& cast, X86SIMD* simd, ir::NodeTy reduce_opr = ir::NodeTy::Add);
+/**
+ * Get the operator to cast between the primitive and SIMD data.
+ * @param aligned whether the address loaded from is aligned to the SIMD width.
+ */
+std::string PrintCastOpr(const ir::Cast& cast,
+                         X86SIMD* simd,
+                         ir::NodeTy reduce_opr = ir::NodeTy::Add,
+                         bool aligned = true);
 
 }  // namespace x86
 }  // namespace backends
@@ -5,6 +5,24 @@ namespace cinn {
 
 std::unique_ptr<CINNContext> _g_cinn_context;
 
+namespace {
+
+// The name generator of the innermost NameScope of the current thread.
+thread_local NameGenerator *scoped_name_generator{};
+
+}  // namespace
+
+NameScope::NameScope(const std::string &prefix) : generator_(new NameGenerator(prefix)) {
+  parent_ = scoped_name_generator;
+  scoped_name_generator = generator_.get();
+}
+
+NameScope::~NameScope() { scoped_name_generator = parent_; }
+
+NameGenerator &CINNContext::name_generator() {
+  return scoped_name_generator ? *scoped_name_generator : name_generator_;
+}
+
 void SetGlobalContext(CINNContext *context) {
   CHECK(context);
   _g_cinn_context.reset(context);
@@ -7,6 +7,7 @@
 #include <isl/cpp.h>
 #include <map>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <set>
 #include <string>
 #include <vector>
@@ -36,7 +37,10 @@ class Generator {
 
   Stage GetComputationByNode(isl_ast_node* node);
 
-  size_t num_stages() const { return stages_.size(); }
+  size_t num_stages() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stages_.size();
+  }
 
   ~Generator();
 
@@ -45,6 +49,8 @@ class Generator {
 
   isl::ctx ctx_{nullptr};
   std::map<std::string, Stage*> stages_;
+  // Guard the stages, the functions are compiled by multiple threads, see CINNContext::set_compile_threads.
+  mutable std::mutex mutex_;
 
   friend class CINNContext;
 };
@@ -58,16 +64,57 @@ struct OnceCallStageRegistry {
   std::set<std::string> stages_;
 };
 
+/**
+ * NameScope makes the names generated in the current thread unique in a scope, such as a function compiled in a worker
+ * thread. The names are prefixed with the scope and numbered from 0, so they don't depend on the order the scopes run.
+ *
+ * Usage:
+ *
+ *     {
+ *       NameScope scope("func0_");
+ *       GlobalContext().name_generator().NewTmpVar();  // func0_tmp0
+ *     }
+ */
+class NameScope {
+ public:
+  explicit NameScope(const std::string& prefix);
+  ~NameScope();
+
+ private:
+  std::unique_ptr<NameGenerator> generator_;
+  NameGenerator* parent_{};
+};
+
 class CINNContext {
  public:
-  NameGenerator& name_generator() { return name_generator_; }
+  //! Get the name generator, the one of the NameScope of the current thread if any.
+  NameGenerator& name_generator();
   Generator& generator() { return generator_; }
   OnceCallStageRegistry& once_call_registry() { return once_call_registry_; }
 
+  //! Forbid the optimizations that change the floating-point rounding, such as the FMA contraction.
+  void set_strict_fp(bool x) { strict_fp_ = x; }
+  bool strict_fp() const { return strict_fp_; }
+
+  //! Fold the initializations into the reductions and remove the dead stores when a Function ends its definition.
+  void set_eliminate_redundant_stages(bool x) { eliminate_redundant_stages_ = x; }
+  bool eliminate_redundant_stages() const { return eliminate_redundant_stages_; }
+
+  /**
+   * Set the number of the threads to compile the functions of a graph, 1 to compile them one by one. Each thread has
+   * its own isl context, and the names generated for a function are scoped by the function name, so the generated code
+   * is the same whatever the number of the threads is.
+   */
+  void set_compile_threads(int x) { compile_threads_ = x; }
+  int compile_threads() const { return compile_threads_; }
+
  private:
   NameGenerator name_generator_;
   Generator generator_;
   OnceCallStageRegistry once_call_registry_;
+  bool strict_fp_{false};
+  bool eliminate_redundant_stages_{false};
+  int compile_threads_{1};
 };
 
 extern std::unique_ptr<CINNContext> _g_cinn_context;
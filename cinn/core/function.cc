@@ -91,6 +91,12 @@ void Function::ComputeStageFlows() {
   }
 }
 
+void Function::SwitchIslContext(const std::shared_ptr<isl_ctx>& ctx) {
+  for (auto& stage : data_->stages) stage.SwitchIslContext(ctx.get());
+  data_->ctx = ctx.get();
+  data_->ctx_holder = ctx;
+}
+
 Stage Function::AddStage(const Stage& stage) {
   data_->stages.push_back(stage);
   return stage;
@@ -2,11 +2,13 @@
 #include <gtest/gtest_prod.h>
 #include <isl/cpp.h>
 #include <map>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 #include "cinn/core/buffer.h"
 #include "cinn/core/stage.h"
+#include "cinn/core/stage_dataflow.h"
 #include "cinn/ir/ir.h"
 #include "cinn/utils/isl_utils.h"
 
@@ -158,6 +160,9 @@ class Snippet {
  */
 struct Function {
   struct Data {
+    //! Hold the isl context the function is compiled in, declared first to be released after the isl objects.
+    std::shared_ptr<isl_ctx> ctx_holder;
+
     //! Name of the function, should be unique across the compile context.
     std::string name;
 
@@ -273,8 +278,10 @@ struct Function {
    */
   void EndDefinition() {
     data_->transformed_expr = Expr();
+    if (GlobalContext().eliminate_redundant_stages()) EliminateRedundantStages(&data_->stages, data_->outputs);
     BuildSnippets();
     data_->ir_function = ir::Function::make(name(), data_->inputs, data_->outputs, ComputeTransformedExpr());
+    data_->ir_function.As<ir::Function>()->ctx_holder = data_->ctx_holder;
     data_->end_definition = true;
   }
 
@@ -289,6 +296,13 @@ struct Function {
 
   void BuildSnippets(bool end_snippet = true);
 
+  /**
+   * Move the stages to another isl context, to compile the function in another thread. The function and its
+   * ir::Function hold the context while alive, since their snippets and expressions keep the isl objects created in
+   * the context.
+   */
+  void SwitchIslContext(const std::shared_ptr<isl_ctx>& ctx);
+
   // void PreAppendStage(const Stage& stage);
 
   //! Compute the dependence relations between the stages, we treat the WAR, WAW, RAW as dependencies.
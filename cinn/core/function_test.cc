@@ -168,6 +168,132 @@ TEST(Function, syntax) {
   LOG(INFO) << "matmul_fn: \n" << matmul_fn.ir_function();
 }
 
+TEST(Function, eliminate_redundant_stages) {
+  SetGlobalContext(new CINNContext);
+  GlobalContext().set_eliminate_redundant_stages(true);
+
+  Constant M(20), K(10), N(30);
+  Expr A(cs({M, K}), primitive_t::float32, "A");
+  Expr B(cs({K, N}), primitive_t::float32, "B");
+  Expr C(cs({M, N}), primitive_t::float32, "C");
+  Expr D(cs({M, N}), primitive_t::float32, "D");
+
+  Var m("m"), k("k"), n("n");
+
+  Function fn("matmul");
+  {
+    // overwritten by s3 before being read.
+    auto s0 = fn.AddStage(D[m][n].Assign(Expr(1.f)));
+    auto s1 = fn.AddStage(C[m][n].Assign(Expr(0.f)));
+    auto s2 = fn.AddStage(C[m][n] += A[m][k] * B[k][n]);
+    auto s3 = fn.AddStage(D[m][n].Assign(C[m][n] * 2.f));
+
+    fn.Inputs({A, B});
+    fn.Outputs({D});
+    fn.EndDefinition();
+  }
+
+  LOG(INFO) << "matmul: \n" << fn.ir_function();
+
+  auto& stages = fn.stages();
+  ASSERT_EQ(stages.size(), 3UL);
+
+  // The initialization computes the first iteration of the reduction.
+  ASSERT_TRUE(stages[0].expr().is_assign());
+  EXPECT_EQ(ir::CollectExprNode<ir::Reference>(stages[0].expr()).size(), 3UL);
+
+  // The reduction skips the first iteration.
+  ASSERT_TRUE(stages[1].expr().is_sum_assign());
+  int k_pos = isl_set_find_dim_by_name(stages[1].iterator_domain().get(), isl_dim_set, "k");
+  ASSERT_GE(k_pos, 0);
+  isl::set first = isl::manage(isl_set_fix_si(stages[1].iterator_domain().copy(), isl_dim_set, k_pos, 0));
+  EXPECT_TRUE(first.is_empty());
+  EXPECT_FALSE(stages[1].iterator_domain().is_empty());
+}
+
+TEST(Function, eliminate_redundant_stages_vectorized) {
+  SetGlobalContext(new CINNContext);
+  GlobalContext().set_eliminate_redundant_stages(true);
+
+  Constant M(20), K(16), N(30);
+  Expr A(cs({M, K}), primitive_t::float32, "A");
+  Expr B(cs({K, N}), primitive_t::float32, "B");
+  Expr C(cs({M, N}), primitive_t::float32, "C");
+
+  Var m("m"), k("k"), n("n");
+
+  Function fn("matmul");
+  {
+    auto s0 = fn.AddStage(C[m][n].Assign(Expr(0.f)));
+    auto s1 = fn.AddStage(C[m][n] += A[m][k] * B[k][n]);
+    s1.Vectorize(4);
+
+    fn.Inputs({A, B});
+    fn.Outputs({C});
+    fn.EndDefinition();
+  }
+
+  LOG(INFO) << "matmul: \n" << fn.ir_function();
+
+  auto& stages = fn.stages();
+  ASSERT_EQ(stages.size(), 2UL);
+
+  // The whole first vector of the reduction is folded into the initialization.
+  ASSERT_TRUE(stages[0].expr().is_assign());
+  EXPECT_EQ(ir::CollectExprNode<ir::Reference>(stages[0].expr()).size(), 9UL);
+
+  int k_pos = isl_set_find_dim_by_name(stages[1].iterator_domain().get(), isl_dim_set, "k");
+  ASSERT_GE(k_pos, 0);
+  isl::set last_folded = isl::manage(isl_set_fix_si(stages[1].iterator_domain().copy(), isl_dim_set, k_pos, 3));
+  isl::set first = isl::manage(isl_set_fix_si(stages[1].iterator_domain().copy(), isl_dim_set, k_pos, 4));
+  EXPECT_TRUE(last_folded.is_empty());
+  EXPECT_FALSE(first.is_empty());
+}
+
+TEST(Function, eliminate_redundant_stages_bias) {
+  SetGlobalContext(new CINNContext);
+  GlobalContext().set_eliminate_redundant_stages(true);
+
+  Constant M(20), K(10), N(30);
+  Expr A(cs({M, K}), primitive_t::float32, "A");
+  Expr B(cs({K, N}), primitive_t::float32, "B");
+  Expr bias(cs({N}), primitive_t::float32, "bias");
+  Expr C(cs({M, N}), primitive_t::float32, "C");
+  Expr D(cs({M, N}), primitive_t::float32, "D");
+
+  Var m("m"), k("k"), n("n");
+
+  // The FC layer, the temporary C is not written any more.
+  Function fn("fc");
+  {
+    auto s0 = fn.AddStage(C[m][n].Assign(Expr(0.f)));
+    auto s1 = fn.AddStage(C[m][n] += A[m][k] * B[k][n]);
+    auto s2 = fn.AddStage(D[m][n].Assign(C[m][n] + bias[n]));
+    s1.FuseWith(s0);
+    s2.FuseWith(s1);
+
+    fn.Inputs({A, B, bias});
+    fn.Outputs({D});
+    fn.EndDefinition();
+  }
+
+  LOG(INFO) << "fc: \n" << fn.ir_function();
+
+  auto& stages = fn.stages();
+  ASSERT_EQ(stages.size(), 2UL);
+  for (auto& stage : stages) {
+    for (auto& ref : ir::CollectExprNode<ir::Reference>(stage.expr())) {
+      EXPECT_NE(ref.As<ir::Reference>()->target.As<ir::Tensor>()->name(), "C");
+    }
+  }
+
+  // D = bias[n] + A[m][0] * B[0][n]
+  ASSERT_TRUE(stages[0].expr().is_assign());
+  EXPECT_EQ(ir::CollectExprNode<ir::Reference>(stages[0].expr()).size(), 4UL);
+  ASSERT_TRUE(stages[1].expr().is_sum_assign());
+  EXPECT_TRUE(stages[1].stages_fuse_with().count(stages[0].name()));
+}
+
 TEST(Function, any_constant) {
   SetGlobalContext(new CINNContext);
 
@@ -0,0 +1,81 @@
+/**
+ * The fma_contract pass fuses the vectorized multiplications and additions into FMA operations.
+ *
+ * For example:
+ *
+ *     simd_add_8(simd_mul_8(a, b), c)
+ *
+ * will be contracted to
+ *
+ *     simd_fma_8(a, b, c)
+ *
+ * An `acc += a * b` in a vectorized loop is stored as `acc = acc + a * b` by the vectorizer, so it is contracted too.
+ *
+ * The fused operation rounds only once, so the result might differ from the original one in the last bit, set
+ * `CINNContext::set_strict_fp(true)` to disable this pass.
+ */
+#include "cinn/core/cinn_context.h"
+#include "cinn/core/optimize/pass.h"
+#include "cinn/core/optimize/pass_registry.h"
+#include "cinn/ir/ir_helper.h"
+#include "cinn/ir/ir_mutator.h"
+#include "cinn/ir/ir_printer.h"
+#include "cinn/utils/logging.h"
+
+namespace cinn {
+
+namespace {
+
+struct FmaContractMutator : public ir::IRMutator {
+  int num_contracted{0};
+
+  void Visit(const Expr* op, Expr* expr) override { IRMutator::Visit(op, expr); }
+
+  void Visit(const ir::SIMDOpr* op, Expr* expr) override {
+    // Contract the inner operations first.
+    IRMutator::Visit(op, expr);
+
+    auto* node = expr->As<ir::SIMDOpr>();
+    if (node->opr != ir::SIMDOpr::Opr::kAdd) return;
+
+    auto is_mul = [&](const Expr& x) {
+      auto* mul = x.As<ir::SIMDOpr>();
+      return mul && mul->opr == ir::SIMDOpr::Opr::kMul && mul->vector_width == node->vector_width;
+    };
+
+    Expr mul, addend;
+    if (is_mul(node->a)) {
+      mul = node->a;
+      addend = node->b;
+    } else if (is_mul(node->b)) {
+      mul = node->b;
+      addend = node->a;
+    } else {
+      return;
+    }
+
+    auto* mul_node = mul.As<ir::SIMDOpr>();
+    CINN_DEBUG(3) << "contract " << *expr;
+    expr->Reset(ir::SIMDOpr::make_fma(node->vector_width, mul_node->a, mul_node->b, addend));
+    num_contracted++;
+  }
+};
+
+}  // namespace
+
+class FmaContractPass : public Pass<ir::Expr> {
+ public:
+  explicit FmaContractPass(const std::string& name) : Pass(name) {}
+
+  void Impl(ir::Expr* expr) override {
+    if (GlobalContext().strict_fp()) return;
+
+    FmaContractMutator mutator;
+    mutator.Visit(expr, expr);
+    CINN_DEBUG(2) << "contracted " << mutator.num_contracted << " FMAs";
+  }
+};
+
+}  // namespace cinn
+
+REGISTER_IR_PASS(fma_contract, cinn::FmaContractPass);
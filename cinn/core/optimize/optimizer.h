@@ -48,10 +48,13 @@ class IrOptimizer : public Optimizer<ir::Expr> {
                       "vectorize",                   //
                       "indices_to_absolute_offset",  //
                       "nested_block_clean",          //
+                      "vector_accumulate",           //
+                      "fma_contract",                //
                       "display_program",             //
                       //"temp_variable_fold",          //
-                      "unroll",  //
-                                 //"display_program",  //
+                      "unroll",                      //
+                      "register_promote",            //
+                      //"display_program",  //
                   })
       : Optimizer(passes) {}
 };
@@ -3,6 +3,7 @@
 #include "cinn/core/optimize/pass_registry.h"
 #include "cinn/core/optimize/use_passes.h"
 #include "cinn/core/stage.h"
+#include "cinn/ir/ir_helper.h"
 #include "cinn/ir/ir_printer.h"
 
 namespace cinn {
@@ -25,4 +26,166 @@ TEST(Optimizer_pass, indices_to_absolute_offset) {
   ASSERT_EQ(log, target);
 }
 
+TEST(Optimizer_pass, fma_contract) {
+  SetGlobalContext(new CINNContext);
+
+  ir::Constant N(30), M(40);
+  Expr A({N, M}, primitive_t::float32, "A");
+  Expr B({N, M}, primitive_t::float32, "B");
+  Expr C({N, M}, primitive_t::float32, "C");
+  ir::Var i, j;
+
+  auto to_simd = [](Expr x) { return ir::Cast::make(x, x.ptype(), composite_t::simd256); };
+  auto mul = ir::SIMDOpr::make(8, ir::SIMDOpr::Opr::kMul, to_simd(A[i][j]), to_simd(B[i][j]));
+  auto expr = ir::SIMDOpr::make(8, ir::SIMDOpr::Opr::kAdd, to_simd(C[i][j]), mul);
+
+  auto* pass = PassRegistry<ir::Expr>::Global().GetPass("fma_contract");
+  ASSERT_TRUE(pass);
+
+  {
+    auto strict = ir::IRDeepCopy(expr);
+    GlobalContext().set_strict_fp(true);
+    pass->Run(&strict);
+    ASSERT_EQ(strict.As<ir::SIMDOpr>()->opr, ir::SIMDOpr::Opr::kAdd);
+    GlobalContext().set_strict_fp(false);
+  }
+
+  pass->Run(&expr);
+  auto* fma = expr.As<ir::SIMDOpr>();
+  ASSERT_TRUE(fma);
+  ASSERT_EQ(fma->opr, ir::SIMDOpr::Opr::kFma);
+  ASSERT_TRUE(ir::IREquals(fma->c, to_simd(C[i][j])));
+}
+
+TEST(Optimizer_pass, vector_accumulate) {
+  SetGlobalContext(new CINNContext);
+
+  ir::Constant N(30), M(64);
+  Expr A({N, M}, primitive_t::float32, "A");
+  Expr B({M}, primitive_t::float32, "B");
+  Expr C({N}, primitive_t::float32, "C");
+  ir::Var i, k;
+
+  auto to_simd = [](Expr x) { return ir::Cast::make(x, x.ptype(), composite_t::simd256); };
+  auto mul = ir::SIMDOpr::make(8, ir::SIMDOpr::Opr::kMul, to_simd(A[i][k]), to_simd(B[k]));
+  auto reduce = ir::SumAssign::make(C[i], mul);
+  auto forloop = ir::For::make(Expr(0), Expr(k) < Expr(64), Expr(8), ir::Block::make({reduce}), k);
+  auto expr = ir::Block::make({forloop});
+
+  auto* pass = PassRegistry<ir::Expr>::Global().GetPass("vector_accumulate");
+  ASSERT_TRUE(pass);
+  pass->Run(&expr);
+  LOG(INFO) << "ir: " << ir::Dump(expr);
+
+  // let acc = 0; for { acc = acc + mul; } C[i] += acc;
+  auto& body = expr.As<ir::Block>()->body;
+  ASSERT_EQ(body.size(), 3UL);
+  ASSERT_TRUE(body[0].As<ir::Let>());
+  ASSERT_TRUE(body[1].is_for_());
+  auto* store = body[2].As<ir::SumAssign>();
+  ASSERT_TRUE(store);
+  ASSERT_TRUE(store->b.is_var());
+  ASSERT_TRUE(store->b.is_simd());
+
+  auto& for_body = body[1].As<ir::For>()->body.As<ir::Block>()->body;
+  ASSERT_EQ(for_body.size(), 1UL);
+  auto* acc = for_body[0].As<ir::Assign>();
+  ASSERT_TRUE(acc);
+  ASSERT_TRUE(acc->a.is_var());
+  ASSERT_EQ(acc->b.As<ir::SIMDOpr>()->opr, ir::SIMDOpr::Opr::kAdd);
+}
+
+TEST(Optimizer_pass, register_promote) {
+  SetGlobalContext(new CINNContext);
+
+  ir::Constant N(30), M(64);
+  Expr A({N, M}, primitive_t::float32, "A");
+  Expr B({M, N}, primitive_t::float32, "B");
+  Expr C({N, N}, primitive_t::float32, "C");
+  ir::Var i, j, k;
+
+  auto reduce = ir::SumAssign::make(C[i][j], A[i][k] * B[k][j]);
+  auto forloop = ir::For::make(Expr(0), Expr(k) < Expr(64), Expr(1), ir::Block::make({reduce}), k);
+  auto expr = ir::Block::make({forloop});
+
+  auto* pass = PassRegistry<ir::Expr>::Global().GetPass("register_promote");
+  ASSERT_TRUE(pass);
+  pass->Run(&expr);
+  LOG(INFO) << "ir: " << ir::Dump(expr);
+
+  // let tmp = C[i, j]; for { tmp += A[i, k] * B[k, j]; } C[i, j] = tmp;
+  auto& body = expr.As<ir::Block>()->body;
+  ASSERT_EQ(body.size(), 3UL);
+  ASSERT_TRUE(body[0].As<ir::Let>());
+  ASSERT_TRUE(body[1].is_for_());
+  auto* store = body[2].As<ir::Assign>();
+  ASSERT_TRUE(store);
+  ASSERT_TRUE(store->a.is_reference());
+  ASSERT_TRUE(store->b.is_var());
+
+  auto& for_body = body[1].As<ir::For>()->body.As<ir::Block>()->body;
+  auto* acc = for_body[0].As<ir::SumAssign>();
+  ASSERT_TRUE(acc);
+  ASSERT_TRUE(acc->a.is_var());
+}
+
+TEST(Optimizer_pass, register_promote_unrolled_tile) {
+  SetGlobalContext(new CINNContext);
+
+  ir::Constant N(30), M(64);
+  Expr A({N, M}, primitive_t::float32, "A");
+  Expr B({M, N}, primitive_t::float32, "B");
+  Expr C({N, N}, primitive_t::float32, "C");
+  ir::Var i, j, k;
+
+  // The 2x2 register tile unrolled, the four accumulators are distinct elements of C.
+  std::vector<Expr> body;
+  for (int di = 0; di < 2; di++) {
+    for (int dj = 0; dj < 2; dj++) {
+      auto row = [&] { return Expr(i) * Expr(2) + Expr(di); };
+      auto col = [&] { return Expr(j) * Expr(2) + Expr(dj); };
+      body.push_back(ir::SumAssign::make(C[row()][col()], A[row()][k] * B[k][col()]));
+    }
+  }
+  auto forloop = ir::For::make(Expr(0), Expr(k) < Expr(64), Expr(1), ir::Block::make(std::move(body)), k);
+  auto expr = ir::Block::make({forloop});
+
+  auto* pass = PassRegistry<ir::Expr>::Global().GetPass("register_promote");
+  ASSERT_TRUE(pass);
+  pass->Run(&expr);
+  LOG(INFO) << "ir: " << ir::Dump(expr);
+
+  // 4 loads, the loop and 4 stores.
+  auto& block = expr.As<ir::Block>()->body;
+  ASSERT_EQ(block.size(), 9UL);
+  for (int t = 0; t < 4; t++) {
+    ASSERT_TRUE(block[t].As<ir::Let>());
+    ASSERT_TRUE(block[5 + t].As<ir::Assign>());
+  }
+  auto& for_body = block[4].As<ir::For>()->body.As<ir::Block>()->body;
+  ASSERT_EQ(for_body.size(), 4UL);
+  for (auto& e : for_body) {
+    ASSERT_TRUE(e.As<ir::SumAssign>()->a.is_var());
+  }
+}
+
+TEST(Optimizer_pass, register_promote_aliased) {
+  SetGlobalContext(new CINNContext);
+
+  ir::Constant N(30), M(64);
+  Expr A({N, M}, primitive_t::float32, "A");
+  Expr C({N, N}, primitive_t::float32, "C");
+  ir::Var i, j, k;
+
+  // C[i, j] and C[j, i] might be the same element, neither is promoted.
+  auto acc0 = ir::SumAssign::make(C[i][j], A[i][k]);
+  auto acc1 = ir::SumAssign::make(C[j][i], A[j][k]);
+  auto forloop = ir::For::make(Expr(0), Expr(k) < Expr(64), Expr(1), ir::Block::make({acc0, acc1}), k);
+  auto expr = ir::Block::make({forloop});
+
+  auto* pass = PassRegistry<ir::Expr>::Global().GetPass("register_promote");
+  pass->Run(&expr);
+  ASSERT_EQ(expr.As<ir::Block>()->body.size(), 1UL);
+}
+
 }  // namespace cinn
@@ -0,0 +1,222 @@
+/**
+ * The register_promote pass replaces the tensor elements accumulated in a loop with local scalar variables.
+ *
+ * The generated code such as
+ *
+ *     for (k, 0, 64) {
+ *       C[i, j] += A[i, k] * B[k, j];
+ *     }
+ *
+ * reads and writes C in memory on every iteration, and the C compiler can hardly promote it to a register for the
+ * possible aliasing between C and A, B. This pass rewrites it to
+ *
+ *     let tmp0 = C[i, j];
+ *     for (k, 0, 64) {
+ *       tmp0 += A[i, k] * B[k, j];
+ *     }
+ *     C[i, j] = tmp0;
+ *
+ * It runs after the unroll pass, so the MxN accumulators of an unrolled register tile in the reduction loop are all
+ * promoted to the local variables.
+ */
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include "cinn/core/cinn_context.h"
+#include "cinn/core/optimize/pass.h"
+#include "cinn/core/optimize/pass_registry.h"
+#include "cinn/ir/ir_helper.h"
+#include "cinn/ir/ir_mutator.h"
+#include "cinn/ir/ir_printer.h"
+#include "cinn/utils/logging.h"
+
+namespace cinn {
+
+namespace {
+
+//! Collect the accesses to the tensors in a loop.
+struct AccessCollector : public ir::IRMutator {
+  //! The destinations of the compound assignments, which are the candidates to promote.
+  std::map<std::string, Expr> accumulations;
+  //! The distinct elements of each tensor accessed.
+  std::map<std::string, std::map<std::string, Expr>> elements;
+  //! The tensors whose address is taken, such as by a SIMD load or store.
+  std::set<std::string> address_taken;
+  //! The variables defined in the loop, including the iterators and the temporary variables.
+  std::set<std::string> local_vars;
+  bool has_call{false};
+
+  void Visit(const Expr* op, Expr* expr) override { IRMutator::Visit(op, expr); }
+
+  void Visit(const ir::SumAssign* op, Expr* expr) override { VisitAccumulation(op, expr); }
+  void Visit(const ir::SubAssign* op, Expr* expr) override { VisitAccumulation(op, expr); }
+  void Visit(const ir::MulAssign* op, Expr* expr) override { VisitAccumulation(op, expr); }
+  void Visit(const ir::DivAssign* op, Expr* expr) override { VisitAccumulation(op, expr); }
+
+  void Visit(const ir::Reference* op, Expr* expr) override {
+    auto target = ir::Dump(op->target);
+    elements[target].emplace(ir::Dump(*expr), *expr);
+    if (in_identity_) address_taken.insert(target);
+    IRMutator::Visit(op, expr);
+  }
+
+  void Visit(const ir::Identity* op, Expr* expr) override {
+    bool in_identity = in_identity_;
+    in_identity_ = true;
+    IRMutator::Visit(op, expr);
+    in_identity_ = in_identity;
+  }
+
+  void Visit(const ir::For* op, Expr* expr) override {
+    local_vars.insert(op->iterator.name());
+    IRMutator::Visit(op, expr);
+  }
+
+  void Visit(const ir::Let* op, Expr* expr) override {
+    if (op->a.is_var()) local_vars.insert(op->a.As<ir::Var>()->name());
+    IRMutator::Visit(op, expr);
+  }
+
+  void Visit(const ir::Call* op, Expr* expr) override {
+    has_call = true;
+    IRMutator::Visit(op, expr);
+  }
+
+ private:
+  template <typename AssignT>
+  void VisitAccumulation(const AssignT* op, Expr* expr) {
+    if (op->a.is_reference() && op->a.is_primitive()) {
+      accumulations.emplace(ir::Dump(op->a), op->a);
+    }
+    IRMutator::Visit(op, expr);
+  }
+
+  bool in_identity_{false};
+};
+
+//! Split an index to a base expression and a constant offset, e.g. (i * 2) + 1 to (i * 2, 1).
+std::pair<std::string, int64_t> SplitConstantOffset(const Expr& index) {
+  if (index.is_int_imm()) return std::make_pair(std::string(), index.As<ir::IntImm>()->val());
+  if (index.is_add()) {
+    auto* add = index.As<ir::Add>();
+    if (add->b.is_int_imm()) return std::make_pair(ir::Dump(add->a), add->b.As<ir::IntImm>()->val());
+    if (add->a.is_int_imm()) return std::make_pair(ir::Dump(add->b), add->a.As<ir::IntImm>()->val());
+  }
+  if (index.is_sub() && index.As<ir::Sub>()->b.is_int_imm()) {
+    return std::make_pair(ir::Dump(index.As<ir::Sub>()->a), -index.As<ir::Sub>()->b.As<ir::IntImm>()->val());
+  }
+  return std::make_pair(ir::Dump(index), int64_t(0));
+}
+
+//! Tell whether two elements of a tensor are never the same one, some index of them differ by a nonzero constant.
+bool ProvablyDistinct(const Expr& a, const Expr& b) {
+  auto& x = a.As<ir::Reference>()->iterators;
+  auto& y = b.As<ir::Reference>()->iterators;
+  if (x.size() != y.size()) return false;
+  for (size_t i = 0; i < x.size(); i++) {
+    auto u = SplitConstantOffset(x[i]);
+    auto v = SplitConstantOffset(y[i]);
+    if (u.first == v.first && u.second != v.second) return true;
+  }
+  return false;
+}
+
+//! Replace an element of a tensor with a variable.
+struct ElementReplacer : public ir::IRMutator {
+  std::string element;
+  ir::Var var;
+
+  ElementReplacer(const std::string& element, const ir::Var& var) : element(element), var(var) {}
+
+  void Visit(const Expr* op, Expr* expr) override { IRMutator::Visit(op, expr); }
+
+  void Visit(const ir::Reference* op, Expr* expr) override {
+    if (ir::Dump(*expr) == element) {
+      expr->Reset(Expr(var));
+    } else {
+      IRMutator::Visit(op, expr);
+    }
+  }
+};
+
+struct RegisterPromoteMutator : public ir::IRMutator {
+  int num_promoted{0};
+
+  void Visit(const Expr* op, Expr* expr) override { IRMutator::Visit(op, expr); }
+
+  void Visit(const ir::Block* op, Expr* expr) override {
+    // Promote in the inner loops first, so that the loads and stores are hoisted out of the nested loops.
+    IRMutator::Visit(op, expr);
+
+    auto* block = expr->As<ir::Block>();
+    std::vector<Expr> body;
+    for (auto& e : block->body) {
+      std::vector<Expr> loads, stores;
+      if (e.is_for_()) Promote(&e, &loads, &stores);
+      body.insert(body.end(), loads.begin(), loads.end());
+      body.push_back(e);
+      body.insert(body.end(), stores.begin(), stores.end());
+    }
+    block->body = std::move(body);
+  }
+
+ private:
+  void Promote(Expr* for_expr, std::vector<Expr>* loads, std::vector<Expr>* stores) {
+    AccessCollector collector;
+    collector.Visit(for_expr, for_expr);
+    // A function call might access the tensors in memory.
+    if (collector.has_call) return;
+
+    auto& for_body = for_expr->As<ir::For>()->body;
+    for (auto& item : collector.accumulations) {
+      const std::string& element = item.first;
+      const Expr& reference = item.second;
+      auto target = ir::Dump(reference.As<ir::Reference>()->target);
+
+      // The element should be invariant in the loop, and never aliased by the other elements of the tensor accessed in
+      // the loop, such as the other accumulators of an unrolled register tile.
+      if (collector.address_taken.count(target)) continue;
+      if (!IsInvariant(collector, reference)) continue;
+      bool aliased = false;
+      for (auto& other : collector.elements[target]) {
+        if (other.first == element) continue;
+        if (!IsInvariant(collector, other.second) || !ProvablyDistinct(reference, other.second)) aliased = true;
+      }
+      if (aliased) continue;
+
+      ir::Var var(GlobalContext().name_generator().NewTmpVar(), reference.ptype());
+      CINN_DEBUG(3) << "promote " << element << " to " << var.name();
+      loads->push_back(ir::Let::make(Expr(var), ir::IRDeepCopy(reference)));
+      stores->push_back(ir::Assign::make(ir::IRDeepCopy(reference), Expr(var)));
+
+      ElementReplacer replacer(element, var);
+      replacer.Visit(&for_body, &for_body);
+      num_promoted++;
+    }
+  }
+
+  static bool IsInvariant(const AccessCollector& collector, const Expr& reference) {
+    for (auto* var : ir::CollectVarsFromExpr(reference)) {
+      if (collector.local_vars.count(var->name())) return false;
+    }
+    return true;
+  }
+};
+
+}  // namespace
+
+class RegisterPromotePass : public Pass<ir::Expr> {
+ public:
+  explicit RegisterPromotePass(const std::string& name) : Pass(name) {}
+
+  void Impl(ir::Expr* expr) override {
+    RegisterPromoteMutator mutator;
+    mutator.Visit(expr, expr);
+    CINN_DEBUG(2) << "promoted " << mutator.num_promoted << " elements to registers";
+  }
+};
+
+}  // namespace cinn
+
+REGISTER_IR_PASS(register_promote, cinn::RegisterPromotePass);
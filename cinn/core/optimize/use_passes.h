@@ -5,7 +5,10 @@ USE_IR_PASS(nested_block_clean);
 USE_IR_PASS(indices_to_absolute_offset);
 USE_IR_PASS(fold_reference_indices);
 USE_IR_PASS(vectorize);
+USE_IR_PASS(vector_accumulate);
+USE_IR_PASS(fma_contract);
 USE_IR_PASS(display_program);
 USE_IR_PASS(call_once_process);
 USE_IR_PASS(temp_variable_fold);
 USE_IR_PASS(unroll);
+USE_IR_PASS(register_promote);
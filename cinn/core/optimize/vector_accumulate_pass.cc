@@ -0,0 +1,132 @@
+/**
+ * The vector_accumulate pass keeps the vectorized reductions in vector registers across the reduction loop.
+ *
+ * When the reduction axis is vectorized, the vectorizer emits a horizontal reduction on every iteration, e.g.
+ *
+ *     for (k, 0, 64, 8) {
+ *       C[i] += simd_mul_8(A[i, k], B[k]);
+ *     }
+ *
+ * which is lowered to `C[i] += _m256_custom_reduce_add(...)` in the loop. This pass rewrites it to
+ *
+ *     let acc = simd_set1_8(0);
+ *     for (k, 0, 64, 8) {
+ *       acc = simd_add_8(acc, simd_mul_8(A[i, k], B[k]));
+ *     }
+ *     C[i] += acc;
+ *
+ * so that the horizontal reduction runs only once after the loop, and the fma_contract pass can fuse the body to an FMA.
+ *
+ * The additions are reassociated, set `CINNContext::set_strict_fp(true)` to disable this pass.
+ */
+#include <map>
+#include <set>
+#include "cinn/core/cinn_context.h"
+#include "cinn/core/optimize/pass.h"
+#include "cinn/core/optimize/pass_registry.h"
+#include "cinn/ir/ir_helper.h"
+#include "cinn/ir/ir_mutator.h"
+#include "cinn/ir/ir_printer.h"
+#include "cinn/utils/logging.h"
+
+namespace cinn {
+
+namespace {
+
+struct VectorAccumulateMutator : public ir::IRMutator {
+  int num_accumulators{0};
+
+  void Visit(const Expr* op, Expr* expr) override { IRMutator::Visit(op, expr); }
+
+  void Visit(const ir::Block* op, Expr* expr) override {
+    // Process the inner loops first, so that an accumulator can be hoisted out of the nested loops.
+    IRMutator::Visit(op, expr);
+
+    auto* block = expr->As<ir::Block>();
+    std::vector<Expr> body;
+    for (auto& e : block->body) {
+      std::vector<Expr> lets, stores;
+      if (e.is_for_()) HoistAccumulators(&e, &lets, &stores);
+      body.insert(body.end(), lets.begin(), lets.end());
+      body.push_back(e);
+      body.insert(body.end(), stores.begin(), stores.end());
+    }
+    block->body = std::move(body);
+  }
+
+ private:
+  //! Replace the reductions in the for-loop with vector accumulators, and collect the expressions to declare them
+  //! before the loop and to reduce them after the loop.
+  void HoistAccumulators(Expr* for_expr, std::vector<Expr>* lets, std::vector<Expr>* stores) {
+    auto* for_ = for_expr->As<ir::For>();
+    auto* for_block = for_->body.As<ir::Block>();
+    if (!for_block) return;
+
+    // Count the statements referencing each tensor, the reduction target should not be accessed by the others.
+    std::map<std::string, int> target_counter;
+    for (auto& e : for_block->body) {
+      std::set<std::string> targets;
+      for (auto& ref : ir::CollectExprNode<ir::Reference>(e)) {
+        targets.insert(ir::Dump(ref.As<ir::Reference>()->target));
+      }
+      for (auto& target : targets) target_counter[target]++;
+    }
+
+    for (auto& e : for_block->body) {
+      if (!IsVectorReduction(e, for_->iterator, target_counter)) continue;
+      auto* op = e.As<ir::SumAssign>();
+
+      ir::Var acc(GlobalContext().name_generator().NewTmpVar(), op->b.ptype());
+      acc.set_ctype(op->b.ctype());
+      int vector_width = op->b.ctype() == composite_t::simd128 ? 4 : 8;
+
+      lets->push_back(ir::Let::make(Expr(acc), ir::Cast::make(Expr(0.f), op->b.ptype(), op->b.ctype())));
+      stores->push_back(ir::SumAssign::make(op->a, Expr(acc)));
+      CINN_DEBUG(3) << "accumulate " << e << " to " << acc.name();
+      e = ir::Assign::make(Expr(acc), ir::SIMDOpr::make(vector_width, ir::SIMDOpr::Opr::kAdd, Expr(acc), op->b));
+      num_accumulators++;
+    }
+  }
+
+  //! Tell whether the expression is a `C[i] += simd` with the destination invariant in the loop.
+  static bool IsVectorReduction(const Expr& expr,
+                                const ir::Var& iterator,
+                                const std::map<std::string, int>& target_counter) {
+    auto* op = expr.As<ir::SumAssign>();
+    if (!op) return false;
+    if (!op->b.is_simd() || op->b.ptype() != primitive_t::float32) return false;
+    if (op->b.ctype() != composite_t::simd128 && op->b.ctype() != composite_t::simd256) return false;
+
+    auto* ref = op->a.As<ir::Reference>();
+    if (!ref || !op->a.is_primitive()) return false;
+    for (auto* var : ir::CollectVarsFromExpr(op->a)) {
+      if (var->name() == iterator.name()) return false;
+    }
+
+    auto target = ir::Dump(ref->target);
+    if (target_counter.at(target) != 1) return false;
+    for (auto& other : ir::CollectExprNode<ir::Reference>(op->b)) {
+      if (ir::Dump(other.As<ir::Reference>()->target) == target) return false;
+    }
+    return true;
+  }
+};
+
+}  // namespace
+
+class VectorAccumulatePass : public Pass<ir::Expr> {
+ public:
+  explicit VectorAccumulatePass(const std::string& name) : Pass(name) {}
+
+  void Impl(ir::Expr* expr) override {
+    if (GlobalContext().strict_fp()) return;
+
+    VectorAccumulateMutator mutator;
+    mutator.Visit(expr, expr);
+    CINN_DEBUG(2) << "hoisted " << mutator.num_accumulators << " vector accumulators";
+  }
+};
+
+}  // namespace cinn
+
+REGISTER_IR_PASS(vector_accumulate, cinn::VectorAccumulatePass);
@@ -63,6 +63,14 @@ void CastSimdBasicExprOprArgument(ir::Expr *expr) {
 
 namespace {
 
+//! Tell whether the expression widens a float16 or bfloat16 reference to float32, it is vectorized as a widening load.
+bool IsHalfPrecisionLoad(const Expr &expr) {
+  auto *cast = expr.As<ir::Cast>();
+  if (!cast || cast->ctype() != composite_t::primitive || cast->ptype() != primitive_t::float32) return false;
+  return cast->expr.is_reference() &&
+         (cast->expr.ptype() == primitive_t::float16 || cast->expr.ptype() == primitive_t::bfloat16);
+}
+
 struct VectorizeOperationsMutator : public ir::IRMutator {
   int vector_width;
   ir::Expr iterator;
@@ -114,6 +122,21 @@ struct VectorizeOperationsMutator : public ir::IRMutator {
     ir::IRMutator::Visit(&node->b, &node->b);
     DoVectorize(expr);
   }
+  void Visit(const ir::Exp *op, ir::Expr *expr) override {
+    auto *node = expr->As<ir::Exp>();
+    ir::IRMutator::Visit(&node->a, &node->a);
+    DoVectorize(expr);
+  }
+  void Visit(const ir::Tanh *op, ir::Expr *expr) override {
+    auto *node = expr->As<ir::Tanh>();
+    ir::IRMutator::Visit(&node->a, &node->a);
+    DoVectorize(expr);
+  }
+  void Visit(const ir::Sigmoid *op, ir::Expr *expr) override {
+    auto *node = expr->As<ir::Sigmoid>();
+    ir::IRMutator::Visit(&node->a, &node->a);
+    DoVectorize(expr);
+  }
 
   void Visit(const ir::Assign *op, ir::Expr *expr) override { VisitAssign(op, expr); }
   void Visit(const ir::SumAssign *op, ir::Expr *expr) override { VisitAssign(op, expr); }
@@ -125,7 +148,7 @@ struct VectorizeOperationsMutator : public ir::IRMutator {
   void Visit(const ir::SIMDOpr *op, ir::Expr *expr) override {
     auto *node = expr->As<ir::SIMDOpr>();
     Visit(&node->a, &node->a);
-    Visit(&node->b, &node->b);
+    if (node->b.valid()) Visit(&node->b, &node->b);
   }
 
   template <typename AssignT>
@@ -136,40 +159,83 @@ struct VectorizeOperationsMutator : public ir::IRMutator {
       Visit(&store->b, &store->b);
 
       Expr a = ir::Identity::make(op->a, expr_ids::reference_address);
-      Expr simd_store = ir::SIMDOpr::make_store(vector_width, a, store->b);
+      Expr value = store->b;
+      // The compound assignments read the destination too, e.g. `C[i] += x` is stored as `C[i] = C[i] + x`.
+      if (expr->type() != ir::NodeTy::Assign) {
+        Expr origin = CastArgumentToSimd(ir::IRDeepCopy(op->a));
+        value = ir::SIMDOpr::make(vector_width, AssignToSimdOpr(expr->type()), origin, CastArgumentToSimd(value));
+      }
+      Expr simd_store = ir::SIMDOpr::make_store(vector_width, a, value);
       expr->Reset(simd_store);
     } else {
       ir::IRMutator::Visit(op, expr);
     }
   }
 
+  //! Get the SIMD operation a compound assignment applies to its destination.
+  static ir::SIMDOpr::Opr AssignToSimdOpr(ir::NodeTy type) {
+    switch (type) {
+      case ir::NodeTy::SumAssign:
+        return ir::SIMDOpr::Opr::kAdd;
+      case ir::NodeTy::SubAssign:
+        return ir::SIMDOpr::Opr::kSub;
+      case ir::NodeTy::MulAssign:
+        return ir::SIMDOpr::Opr::kMul;
+      case ir::NodeTy::DivAssign:
+        return ir::SIMDOpr::Opr::kDiv;
+      default:
+        LOG(FATAL) << "not a compound assignment: " << type;
+    }
+  }
+
+  //! Make an argument a SIMD data, a reference will be loaded and a scalar will be broadcasted.
+  ir::Expr CastArgumentToSimd(ir::Expr a) {
+    if (IsHalfPrecisionLoad(a)) {
+      // A contiguous half precision reference is loaded and widened, an invariant one is widened and broadcasted.
+      Expr reference = a.As<ir::Cast>()->expr;
+      int stride;
+      CHECK(ReferenceIteratorStride(reference, iterator, &stride));
+      if (stride == 1) {
+        return ir::Cast::make(ir::Identity::make(reference, expr_ids::reference_address),
+                              primitive_t::float32,
+                              ToSimdType(vector_width));
+      }
+      CHECK_EQ(stride, 0);
+      return ir::Cast::make(a, primitive_t::float32, ToSimdType(vector_width));
+    }
+    if (!a.is_simd()) {
+      int stride;
+      if (a.is_reference() && ReferenceIteratorStride(a, iterator, &stride) && stride != 1) {
+        // A reference not contiguous in the iterator is gathered, and one invariant in it is broadcasted.
+        if (stride != 0) {
+          return ir::SIMDOpr::make_gather(
+              vector_width, ir::Identity::make(a, expr_ids::reference_address), Expr(stride));
+        }
+      } else if (BasicExprVarsCanPassToSIMD(a, iterator)) {
+        if (a.is_reference()) {
+          a.Reset(ir::Identity::make(a, expr_ids::reference_address));
+        } else if (a.is_var() || a.is_float_imm() || a.is_int_imm()) {  // scalar
+        } else {
+          NOT_IMPLEMENT
+        }
+      }
+      return ir::Cast::make(a, a.ptype(), ToSimdType(vector_width));
+    }
+    return a;
+  }
+
   void DoVectorize(Expr *expr) {
     LOG_INDENT(6);
     CINN_DEBUG(2) << "*********** Vectorize " << *expr;
     CHECK_GT(vector_width, 1);
     LOG(INFO) << "to vectorize expr: " << *expr;
 
-    auto cast_argument_to_simd = [&](ir::Expr a, composite_t simd_type, ir::Expr iterator) -> ir::Expr {
-      if (!a.is_simd()) {
-        if (BasicExprVarsCanPassToSIMD(a, iterator)) {
-          if (a.is_reference()) {
-            a.Reset(ir::Identity::make(a, expr_ids::reference_address));
-          } else if (a.is_var() || a.is_float_imm() || a.is_int_imm()) {  // scalar
-          } else {
-            NOT_IMPLEMENT
-          }
-        }
-        return ir::Cast::make(a, a.ptype(), simd_type);
-      }
-      return a;
-    };
-
     switch (expr->type()) {
 #define __(op__)                                                                   \
   case ir::NodeTy::op__: {                                                         \
     auto *op = expr->As<ir::op__>();                                               \
-    auto a = cast_argument_to_simd(op->a, ToSimdType(vector_width), iterator);     \
-    auto b = cast_argument_to_simd(op->b, ToSimdType(vector_width), iterator);     \
+    auto a = CastArgumentToSimd(op->a);                                            \
+    auto b = CastArgumentToSimd(op->b);                                            \
     expr->Reset(ir::SIMDOpr::make(vector_width, ir::SIMDOpr::Opr::k##op__, a, b)); \
   } break;
       __(Add)
@@ -178,6 +244,16 @@ struct VectorizeOperationsMutator : public ir::IRMutator {
       __(Div)
       __(Max)
       __(Min)
+#undef __
+#define __(op__)                                                                     \
+  case ir::NodeTy::op__: {                                                           \
+    auto *op = expr->As<ir::op__>();                                                 \
+    auto a = CastArgumentToSimd(op->a);                                              \
+    expr->Reset(ir::SIMDOpr::make_math(vector_width, ir::SIMDOpr::Opr::k##op__, a)); \
+  } break;
+      __(Exp)
+      __(Tanh)
+      __(Sigmoid)
 #undef __
       default:
         LOG(ERROR) << "unsupported " << expr->type();
@@ -209,6 +285,9 @@ bool BasicExprContainsOnlySIMDReleatedOpr(const Expr &expr) {
                                        ir::NodeTy::Div,
                                        ir::NodeTy::Max,
                                        ir::NodeTy::Min,
+                                       ir::NodeTy::Exp,
+                                       ir::NodeTy::Tanh,
+                                       ir::NodeTy::Sigmoid,
                                        ir::NodeTy::Assign,
                                        ir::NodeTy::SumAssign,
                                        ir::NodeTy::SubAssign,
@@ -223,6 +302,7 @@ bool BasicExprContainsOnlySIMDReleatedOpr(const Expr &expr) {
         case ir::NodeTy::FloatImm:
           return;
       }
+      if (IsHalfPrecisionLoad(*op)) return;
 
       if (!supported_ops.count(op->type())) {
         CINN_DEBUG(2) << "detect SIMD not supported operation: " << *op;
@@ -243,13 +323,42 @@ bool BasicExprContainsOnlySIMDReleatedOpr(const Expr &expr) {
   return visitor.result;
 }
 
+namespace {
+
+//! Tell whether an index is an affine combination of the variables, only those have the strides by the coefficients.
+bool IsAffineIndex(const Expr &expr) {
+  switch (expr.type()) {
+    case ir::NodeTy::Var:
+    case ir::NodeTy::IntImm:
+      return true;
+    case ir::NodeTy::Add:
+      return IsAffineIndex(expr.As<ir::Add>()->a) && IsAffineIndex(expr.As<ir::Add>()->b);
+    case ir::NodeTy::Sub:
+      return IsAffineIndex(expr.As<ir::Sub>()->a) && IsAffineIndex(expr.As<ir::Sub>()->b);
+    case ir::NodeTy::Mul: {
+      auto *mul = expr.As<ir::Mul>();
+      // The product of two variables is not affine, the coefficient check rejects it.
+      return IsAffineIndex(mul->a) && IsAffineIndex(mul->b);
+    }
+    default:
+      // Such as an indirect index A[idx[i]], whose value is unknown.
+      return false;
+  }
+}
+
+}  // namespace
+
 bool BasicExprVarsCanPassToSIMD(const Expr &basic_expr, const Expr &iterator) {
   CHECK(ir::CollectExprNode<ir::Block>(basic_expr).empty()) << "not a basic expression";
 
   auto refs = ir::CollectExprNode<ir::Reference>(basic_expr);
   for (auto &ref_expr : refs) {
-    // check the positions but the last one
     auto *ref = ref_expr.As<ir::Reference>();
+    // An indirect or non-affine index is neither contiguous nor invariant in the iterator for sure.
+    for (auto &index : ref->iterators) {
+      if (!IsAffineIndex(index)) return false;
+    }
+    // check the positions but the last one
     for (int i = 0; i < ref->iterators.size() - 1; i++) {
       if (ir::IREquals(ref->iterators[i], iterator)) {
         return false;
@@ -261,6 +370,133 @@ bool BasicExprVarsCanPassToSIMD(const Expr &basic_expr, const Expr &iterator) {
   return true;
 }
 
+bool ReferenceIteratorStride(const Expr &expr, const Expr &iterator, int *stride) {
+  auto *reference = expr.As<ir::Reference>();
+  CHECK(reference);
+  if (!reference->target.is_tensor()) return false;
+  auto &dims = reference->target.As<ir::Tensor>()->dims();
+  if (dims.size() != reference->iterators.size()) return false;
+
+  // The offset of A[i0][i1]...[in] is i0 * dim1 * ... * dimn + ... + in in the row-major layout.
+  int offset_stride = 0;
+  int dim_stride = 1;
+  for (int i = reference->iterators.size() - 1; i >= 0; i--) {
+    int coefficient;
+    if (!IsAffineIndex(reference->iterators[i])) return false;
+    if (!ir::BasicExprVarCoefficient(reference->iterators[i], iterator, &coefficient)) return false;
+    offset_stride += coefficient * dim_stride;
+    if (i > 0) {
+      if (!dims[i].value_set() || !dims[i].is_integer()) return false;
+      dim_stride *= dims[i].int_val();
+    }
+  }
+
+  *stride = offset_stride;
+  return true;
+}
+
+bool BasicExprVarsCanGatherToSIMD(const Expr &basic_expr, const Expr &iterator, int *num_gathers) {
+  CHECK(ir::CollectExprNode<ir::Block>(basic_expr).empty()) << "not a basic expression";
+
+  Expr dest;
+  switch (basic_expr.type()) {
+#define __(op__)                             \
+  case ir::NodeTy::op__:                     \
+    dest = basic_expr.As<ir::op__>()->a;     \
+    break;
+    __(Assign)
+    __(SumAssign)
+    __(SubAssign)
+    __(MulAssign)
+    __(DivAssign)
+#undef __
+    default:
+      break;
+  }
+
+  int stride;
+  // There is no scatter, the destination should be contiguous or invariant in the iterator.
+  if (dest.valid() && dest.is_reference()) {
+    if (!ReferenceIteratorStride(dest, iterator, &stride) || (stride != 0 && stride != 1)) return false;
+  }
+
+  *num_gathers = 0;
+  for (auto &ref_expr : ir::CollectExprNode<ir::Reference>(basic_expr)) {
+    if (!ReferenceIteratorStride(ref_expr, iterator, &stride)) return false;
+    if (stride != 0 && stride != 1) (*num_gathers)++;
+  }
+  return true;
+}
+
+namespace {
+
+//! Count the operations and memory accesses in a basic expression, the indices of references are not counted.
+struct OperationCounter : public ir::IRVisitor {
+  int num_operations{0};
+  int num_references{0};
+
+  void Visit(const Expr *op) override {
+    switch (op->type()) {
+      case ir::NodeTy::Add:
+      case ir::NodeTy::Sub:
+      case ir::NodeTy::Mul:
+      case ir::NodeTy::Div:
+      case ir::NodeTy::Max:
+      case ir::NodeTy::Min:
+      case ir::NodeTy::Exp:
+      case ir::NodeTy::Tanh:
+      case ir::NodeTy::Sigmoid:
+      case ir::NodeTy::SumAssign:
+      case ir::NodeTy::SubAssign:
+      case ir::NodeTy::MulAssign:
+      case ir::NodeTy::DivAssign:
+        num_operations++;
+        break;
+      default:
+        break;
+    }
+    IRVisitor::Visit(op);
+  }
+
+  void Visit(const ir::Reference *op) override { num_references++; }
+};
+
+/**
+ * Tell whether the vectorized loop is faster than the scalar one when some references need gathers.
+ *
+ * The cost is estimated as the number of instructions, a gather costs about two scalar loads per lane on the AVX2
+ * processors, and an element is inserted into the vector by a load and a shuffle without AVX2, so a loop only moving
+ * the gathered data, such as a transpose, stays scalar.
+ */
+bool GatherIsProfitable(const Expr &block, int vector_width, int num_gathers) {
+  const int gather_lane_cost = 2;
+
+  OperationCounter counter;
+  counter.Visit(&block);
+  int vector_cost = counter.num_operations + counter.num_references - num_gathers +
+                    num_gathers * gather_lane_cost * vector_width;
+  int scalar_cost = vector_width * (counter.num_operations + counter.num_references);
+  CINN_DEBUG(3) << "vectorize cost " << vector_cost << " vs scalar cost " << scalar_cost;
+  return vector_cost < scalar_cost;
+}
+
+}  // namespace
+
+namespace {
+
+//! The half precision references are only widened by the contiguous loads, there is no gather for them.
+bool HalfPrecisionLoadsContiguous(const Expr &basic_expr, const Expr &iterator) {
+  for (auto &cast : ir::CollectExprNode<ir::Cast>(basic_expr)) {
+    if (!IsHalfPrecisionLoad(cast)) continue;
+    int stride;
+    if (!ReferenceIteratorStride(cast.As<ir::Cast>()->expr, iterator, &stride)) return false;
+    if (stride != 0 && stride != 1) return false;
+  }
+  return true;
+}
+
+}  // namespace
+
 bool Vectorizable(const Expr &expr, const std::set<int> &vectorize_widths, int *vector_width) {
   LOG_INDENT(0);
 
@@ -278,6 +514,7 @@ bool Vectorizable(const Expr &expr, const std::set<int> &vectorize_widths, int *
 
   // check all the expressions in the for-block can represented by SIMD operations.
   auto *for_ = expr.As<ir::For>();
+  int num_gathers = 0;
   for (auto &basic_expr : for_->body.As<ir::Block>()->body) {
     if (!BasicExprContainsOnlySIMDReleatedOpr(basic_expr)) {
       CINN_DEBUG(3) << "fail, detect operation that can't represent by SIMD, " << basic_expr;
@@ -287,12 +524,24 @@ bool Vectorizable(const Expr &expr, const std::set<int> &vectorize_widths, int *
     // check the argument used in the basic expressions.
     Expr iterator_expr = Expr(for_->iterator);
     CHECK(iterator_expr.is_var());
-    if (!BasicExprVarsCanPassToSIMD(basic_expr, iterator_expr)) {
+    if (!HalfPrecisionLoadsContiguous(basic_expr, iterator_expr)) {
+      CINN_DEBUG(3) << "fail, detect half precision data not contiguous in the iterator, " << basic_expr;
+      return false;
+    }
+    int gathers;
+    if (BasicExprVarsCanGatherToSIMD(basic_expr, iterator_expr, &gathers)) {
+      num_gathers += gathers;
+    } else if (!BasicExprVarsCanPassToSIMD(basic_expr, iterator_expr)) {
       CINN_DEBUG(3) << "fail, detect variable in the operation can't supported by SIMD, " << basic_expr;
       return false;
     }
   }
 
+  if (num_gathers > 0 && !GatherIsProfitable(for_->body, *vector_width, num_gathers)) {
+    CINN_DEBUG(3) << "fail, the gathers are slower than the scalar loads";
+    return false;
+  }
+
   return true;
 }
 
@@ -35,6 +35,25 @@ bool BasicExprContainsOnlySIMDReleatedOpr(const Expr &expr);
  */
 bool BasicExprVarsCanPassToSIMD(const Expr &basic_expr, const Expr &iterator);
 
+/**
+ * Get the distance in elements between the elements a reference accesses in the neighbouring iterations. If the
+ * innermost forloop's iterator is i, and A is in shape [M, N]:
+ *
+ * 1. A[x][i]: 1
+ * 2. A[i][x]: N
+ * 3. A[x]: 0
+ *
+ * @return false if the distance is not a constant.
+ */
+bool ReferenceIteratorStride(const Expr &expr, const Expr &iterator, int *stride);
+
+/**
+ * Tell whether all the variables in a basic expression can pass to SIMD with gathers, that is all the references have
+ * constant strides, and the destination is contiguous or invariant in the iterator.
+ * @param num_gathers the number of references need a gather, whose strides are neither 0 nor 1.
+ */
+bool BasicExprVarsCanGatherToSIMD(const Expr &basic_expr, const Expr &iterator, int *num_gathers);
+
 //! cast arguments for SIMD oprations + - * /
 void CastSimdBasicExprOprArgument(ir::Expr *expr);
 
@@ -120,5 +120,72 @@ TEST(IsReferenceExprSIMDLoadable, test) {
   }
 }
 
+TEST(ReferenceIteratorStride, test) {
+  SetGlobalContext(new CINNContext);
+
+  ir::Constant M("M", 100);
+  ir::Constant N("N", 50);
+  ir::Var i, j;
+  Expr A({M, N}, primitive_t::float32);
+
+  std::vector<std::tuple<Expr, int>> datas{{
+      std::make_tuple(A[i][j], 1),            //
+      std::make_tuple(A[j][i], 50),           //
+      std::make_tuple(A[i][i], 0),            //
+      std::make_tuple(A[j * 2][j + 1], 101),  //
+      std::make_tuple(A[i][j * 2], 2),        //
+  }};
+
+  for (auto& data : datas) {
+    int stride;
+    ASSERT_TRUE(ReferenceIteratorStride(std::get<0>(data), j, &stride));
+    ASSERT_EQ(stride, std::get<1>(data));
+  }
+}
+
+TEST(BasicExprVarsCanGatherToSIMD, test) {
+  SetGlobalContext(new CINNContext);
+
+  ir::Constant M("M", 100);
+  ir::Constant N("N", 100);
+  ir::Var i, j;
+  Expr A({M, N}, primitive_t::float32);
+  Expr B({M, N}, primitive_t::float32);
+  Expr C({M, N}, primitive_t::float32);
+
+  int num_gathers;
+  ASSERT_TRUE(BasicExprVarsCanGatherToSIMD(C[i][j] = A[j][i] * B[i][j], j, &num_gathers));
+  ASSERT_EQ(num_gathers, 1);
+  ASSERT_TRUE(BasicExprVarsCanGatherToSIMD(C[i][i] += A[j][i] * B[i][j], j, &num_gathers));
+  ASSERT_EQ(num_gathers, 1);
+  // no scatter
+  ASSERT_FALSE(BasicExprVarsCanGatherToSIMD(C[j][i] = A[i][j], j, &num_gathers));
+}
+
+TEST(Vectorizable, indirect_index) {
+  SetGlobalContext(new CINNContext);
+
+  ir::Constant M("M", 100);
+  ir::Constant N("N", 8);
+  ir::Var i, j;
+  Expr A({M, N}, primitive_t::float32);
+  Expr C({M, N}, primitive_t::float32);
+  Expr idx({N}, primitive_t::int32);
+
+  auto make_for = [&](Expr body) {
+    return ir::For::make(Expr(0), Expr(j) <= Expr(7), Expr(1), ir::Block::make({body}), j);
+  };
+
+  int vector_width;
+  ASSERT_TRUE(Vectorizable(make_for(C[i][j] = A[i][j] * Expr(2.f)), {8}, &vector_width));
+
+  // The value of idx[j] is unknown, A[i][idx[j]] is neither contiguous nor invariant in j, so the loop stays scalar.
+  int stride;
+  ASSERT_FALSE(ReferenceIteratorStride(A[i][idx[j]], j, &stride));
+  ASSERT_FALSE(ReferenceIteratorStride(A[i][j % 4], j, &stride));
+  ASSERT_FALSE(Vectorizable(make_for(C[i][j] = A[i][idx[j]] * Expr(2.f)), {8}, &vector_width));
+  ASSERT_FALSE(Vectorizable(make_for(C[i][j] = A[i][j % 4] * Expr(2.f)), {8}, &vector_width));
+}
+
 }  // namespace optimize
 }  // namespace cinn
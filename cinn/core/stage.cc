@@ -223,6 +223,25 @@ void Stage::set_name(const std::string& name) {
   }
 }
 
+void Stage::SwitchIslContext(isl_ctx *ctx) {
+  CHECK(ctx);
+  if (data_->ctx == ctx) return;
+  // The isl objects are copied to the other context by their string representations.
+  if (!data_->iter_domain.is_null()) {
+    data_->iter_domain = isl::set(ctx, GetStreamStr(data_->iter_domain).c_str());
+  }
+  if (!data_->schedule.is_null()) {
+    data_->schedule = isl_utils::map(ctx, GetStreamStr(data_->schedule));
+  }
+  if (!data_->read_access.is_null()) {
+    data_->read_access = isl::union_map(ctx, GetStreamStr(data_->read_access).c_str());
+  }
+  if (!data_->write_access.is_null()) {
+    data_->write_access = isl::union_map(ctx, GetStreamStr(data_->write_access).c_str());
+  }
+  data_->ctx = ctx;
+}
+
 void Stage::InitData() {
   CHECK(!data_);
   data_ = std::make_shared<Data>();
@@ -434,6 +453,15 @@ void Stage::InitWriteDependencies() {
   CINN_DEBUG(2) << "get write dependency: " << isl_union_map_to_str(write_access());
 }
 
+void Stage::ResetExpr(Expr expr) {
+  CHECK(expr.is_assign_derived());
+  data_->expr = expr;
+  data_->read_access = isl::union_map();
+  data_->write_access = isl::union_map();
+  InitReadDependencies();
+  InitWriteDependencies();
+}
+
 void Stage::SetCond(const ir::Var& iterator, const std::string& cond) {
   data_->iter_domain =
       BuildWithCond(data_->iter_domain.release(), StringFormat("%s %s", iterator.name().c_str(), cond.c_str()));
@@ -535,21 +563,27 @@ bool TwoStagesHasDependency(const Stage& a, const Stage& b) {
 }
 
 Stage Generator::GetStageByName(const std::string& name) {
+  std::lock_guard<std::mutex> lock(mutex_);
   auto it = stages_.find(name);
   if (it == stages_.end()) return Stage();
   return Stage(*it->second);
 }
 
 void Generator::RegisterStage(const std::string& name, const Stage& x) {
+  std::lock_guard<std::mutex> lock(mutex_);
   CHECK(!stages_.count(name)) << "duplicate register a stage called [" << name << "]";
   stages_[name] = new Stage(x);
 }
 
 std::vector<Stage> Generator::FilterStagesByDomain(const isl::set& domain) {
-  std::vector<Stage> result;
+  std::vector<Stage> stages;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& item : stages_) stages.push_back(*item.second);
+  }
 
-  for (auto& item : stages_) {
-    Stage stage = *item.second;
+  std::vector<Stage> result;
+  for (auto& stage : stages) {
     const auto& iterator_domain = stage.iterator_domain();
 
     auto interct = iterator_domain.intersect(domain);
@@ -155,6 +155,12 @@ class Stage {
     CHECK(data_->ctx);
     return data_->ctx;
   }
+
+  /**
+   * Rebuild the isl objects of this stage in another isl context. The isl contexts are not thread safe, a stage should
+   * be moved to the context of a thread before it is compiled in the thread.
+   */
+  void SwitchIslContext(isl_ctx* ctx);
   //! Get the iteration domain of the expression this stage holds.
   const isl::set& iterator_domain() const { return data_->iter_domain; }
 
@@ -186,6 +192,8 @@ class Stage {
   // Some basic polyhedral transformations --------------------------------------------------------
 
   void FuseWith(const Stage& o) { data_->stages_fuse_with.insert(o.name()); }
+  //! Cancel the fusion with the stage named `name`.
+  void UnfuseWith(const std::string& name) { data_->stages_fuse_with.erase(name); }
 
   //! Interchange two loop levels `i` and `j`.
   void Interchange(ir::Var i, ir::Var j);
@@ -234,6 +242,9 @@ class Stage {
 
   bool unroll() const { return data_->unroll; }
 
+  //! Replace the expression this stage holds, the iteration domain is kept and the accesses are recomputed.
+  void ResetExpr(ir::Expr expr);
+
   // Dump the schedule to ISL C code.
   std::string DumpIslC() const;
 
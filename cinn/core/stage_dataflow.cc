@@ -0,0 +1,339 @@
+#include "cinn/core/stage_dataflow.h"
+#include <isl/set.h>
+#include <isl/union_map.h>
+#include <isl/union_set.h>
+#include <isl/val.h>
+#include <algorithm>
+#include <map>
+#include <set>
+#include <string>
+#include "cinn/core/cinn_context.h"
+#include "cinn/ir/ir_helper.h"
+#include "cinn/ir/ir_printer.h"
+#include "cinn/utils/isl_utils.h"
+#include "cinn/utils/logging.h"
+#include "cinn/utils/string.h"
+
+namespace cinn {
+
+namespace {
+
+//! Tell whether the dataflow analysis can see through the stage.
+bool IsAnalyzable(const Stage& stage) {
+  if (stage.type() != Stage::Type::polyhedral) return false;
+  if (stage.iterator_domain().is_null() || !stage.read_access() || !stage.write_access()) return false;
+  return !GlobalContext().once_call_registry().Contains(stage.name());
+}
+
+//! The tensor elements accessed by the stage across its iteration domain.
+isl::union_set AccessedElements(const Stage& stage, isl_union_map* access) {
+  isl_union_set* domain = isl_union_set_from_set(stage.iterator_domain().copy());
+  return isl::manage(isl_union_map_range(isl_union_map_intersect_domain(isl_union_map_copy(access), domain)));
+}
+
+isl::union_set WrittenElements(const Stage& stage) { return AccessedElements(stage, stage.write_access()); }
+
+//! The elements read by the stage, a compound assignment such as `+=` also reads its target.
+isl::union_set ReadElements(const Stage& stage) {
+  auto reads = AccessedElements(stage, stage.read_access());
+  if (stage.expr().is_assign()) return reads;
+  return isl::manage(isl_union_set_union(reads.release(), WrittenElements(stage).release()));
+}
+
+bool Intersects(const isl::union_set& a, const isl::union_set& b) {
+  isl::union_set intersection = isl::manage(isl_union_set_intersect(a.copy(), b.copy()));
+  return !isl_union_set_is_empty(intersection.get());
+}
+
+bool IsZero(const Expr& expr) {
+  if (expr.is_float_imm()) return expr.As<ir::FloatImm>()->val() == 0.f;
+  if (expr.is_int_imm()) return expr.As<ir::IntImm>()->val() == 0;
+  return false;
+}
+
+//! Tell whether every point of the other dimensions iterates the `pos`-th dimension at `value`.
+bool CoversIteration(const isl::set& domain, int pos, int value) {
+  isl::set all = isl::manage(isl_set_project_out(domain.copy(), isl_dim_set, pos, 1));
+  isl::set fixed =
+      isl::manage(isl_set_project_out(isl_set_fix_si(domain.copy(), isl_dim_set, pos, value), isl_dim_set, pos, 1));
+  return isl_set_is_equal(all.get(), fixed.get()) == isl_bool_true;
+}
+
+/**
+ * Get the lower bound of the `pos`-th dimension, return false if it is not a constant or not shared by the other
+ * dimensions.
+ */
+bool GetConstantLowerBound(const isl::set& domain, int pos, int* lower_bound) {
+  int ndims = isl_set_dim(domain.get(), isl_dim_set);
+  isl_set* dim = isl_set_project_out(domain.copy(), isl_dim_set, pos + 1, ndims - pos - 1);
+  dim = isl_set_project_out(dim, isl_dim_set, 0, pos);
+  isl_set* min = isl_set_lexmin(dim);
+  isl_val* val = isl_set_plain_get_val_if_fixed(min, isl_dim_set, 0);
+  isl_set_free(min);
+
+  bool fixed = val && isl_val_is_int(val);
+  if (fixed) *lower_bound = isl_val_get_num_si(val);
+  isl_val_free(val);
+  return fixed && CoversIteration(domain, pos, *lower_bound);
+}
+
+/**
+ * The tile size of the `pos`-th of the `ndims` loop levels of a stage, 1 if the level is not tiled. The vectorization
+ * tiles the last levels in order, the unrolling tiles them in the reversed order.
+ */
+int GetTileSize(const Stage& stage, int pos, int ndims) {
+  int size = 1;
+  const auto& vector_width = stage.vector_width();
+  int vector_pos = pos - (ndims - static_cast<int>(vector_width.size()));
+  if (vector_pos >= 0) size = std::max(size, vector_width[vector_pos]);
+  int unroll_pos = ndims - 1 - pos;
+  if (stage.unroll() && unroll_pos < stage.tile_sizes().size()) size = std::max(size, stage.tile_sizes()[unroll_pos]);
+  return size;
+}
+
+std::string GetTensorName(const Expr& reference) {
+  auto* tensor = reference.As<ir::Reference>()->target.As<ir::Tensor>();
+  return tensor ? tensor->name() : "";
+}
+
+//! Rename the statement of a domain to compare it with the domain of another stage.
+isl::set RenameDomain(const isl::set& domain, const std::string& name) {
+  return isl::manage(isl_set_set_tuple_name(domain.copy(), name.c_str()));
+}
+
+/**
+ * Forward a reduction to its consumer that adds a bias to it, e.g.
+ *
+ *     C[i][j] = 0;                      // init
+ *     C[i][j] += A[i][k] * B[k][j];     // reduce
+ *     D[i][j] = C[i][j] + bias[j];      // consumer
+ *
+ * is rewritten to
+ *
+ *     D[i][j] = bias[j];
+ *     D[i][j] += A[i][k] * B[k][j];
+ *
+ * so that the bias is added by the initialization and the temporary `C` is not written any more. It is the FC layer in
+ * HLIR. The bias is added before the products, so it is skipped when the floating-point rounding should be kept.
+ *
+ * @return the index of the consumer removed, or -1 if not forwarded.
+ */
+int ForwardReductionToConsumer(std::vector<Stage>* stages,
+                               size_t init_id,
+                               size_t reduce_id,
+                               const std::set<std::string>& outputs) {
+  if (GlobalContext().strict_fp()) return -1;
+  Stage& init = stages->at(init_id);
+  Stage& reduce = stages->at(reduce_id);
+  auto* assign = init.expr().As<ir::Assign>();
+  auto* sum_assign = reduce.expr().As<ir::SumAssign>();
+  if (!assign || !sum_assign || !assign->a.is_reference()) return -1;
+  if (ir::Dump(assign->a) != ir::Dump(sum_assign->a)) return -1;
+  // The temporary should not be read after the stages.
+  const std::string temp = GetTensorName(assign->a);
+  if (temp.empty() || outputs.count(temp)) return -1;
+
+  auto temp_elements = WrittenElements(init);
+  size_t consumer_id = reduce_id + 1;
+  while (consumer_id < stages->size() && IsAnalyzable(stages->at(consumer_id)) &&
+         !Intersects(ReadElements(stages->at(consumer_id)), temp_elements) &&
+         !Intersects(WrittenElements(stages->at(consumer_id)), temp_elements)) {
+    consumer_id++;
+  }
+  if (consumer_id >= stages->size() || !IsAnalyzable(stages->at(consumer_id))) return -1;
+  const Stage& consumer = stages->at(consumer_id);
+
+  // The consumer should be `D = C + bias` or `D = bias + C` over the same domain as the initialization.
+  auto* consumer_assign = consumer.expr().As<ir::Assign>();
+  if (!consumer_assign || !consumer_assign->b.is_add()) return -1;
+  auto* add = consumer_assign->b.As<ir::Add>();
+  Expr bias;
+  if (ir::Dump(add->a) == ir::Dump(assign->a)) bias = add->b;
+  if (ir::Dump(add->b) == ir::Dump(assign->a)) bias = add->a;
+  if (!bias.valid()) return -1;
+  for (auto& ref : ir::CollectExprNode<ir::Reference>(bias)) {
+    if (GetTensorName(ref) == temp) return -1;
+  }
+  isl::set consumer_domain = RenameDomain(consumer.iterator_domain(), init.name());
+  if (isl_set_is_equal(consumer_domain.get(), init.iterator_domain().get()) != isl_bool_true) return -1;
+
+  // The consumer's output is written from the initialization on, no stage between should access it, and the bias is
+  // read ahead, no stage between should write it.
+  auto outs = WrittenElements(consumer);
+  auto bias_elements = AccessedElements(consumer, consumer.read_access());
+  bias_elements = isl::manage(isl_union_set_subtract(bias_elements.release(), temp_elements.copy()));
+  for (size_t i = init_id; i < consumer_id; i++) {
+    auto& stage = stages->at(i);
+    if (Intersects(ReadElements(stage), outs) || Intersects(WrittenElements(stage), outs)) return -1;
+    if (i != init_id && i != reduce_id && Intersects(WrittenElements(stage), bias_elements)) return -1;
+  }
+  // The temporary is dead after the consumer.
+  for (size_t i = consumer_id + 1; i < stages->size(); i++) {
+    if (!IsAnalyzable(stages->at(i)) || Intersects(ReadElements(stages->at(i)), temp_elements)) return -1;
+  }
+
+  CINN_DEBUG(2) << "forward the reduction " << reduce.name() << " to " << consumer.name();
+  Expr value = IsZero(assign->b) ? bias : ir::Add::make(bias, assign->b);
+  Expr target = consumer_assign->a, products = sum_assign->b;
+  init.ResetExpr(ir::Assign::make(target, value));
+  reduce.ResetExpr(ir::SumAssign::make(target, products));
+  return consumer_id;
+}
+
+/**
+ * Try to fold the initialization `init` into the reduction `reduce`, the stages between them are `between`.
+ *
+ * If the reduction iterator is tiled by the vectorization or unrolling, the whole first tile is folded, so that the
+ * rest of the reduction still starts at a tile boundary and keeps the full tiles.
+ *
+ * @return true if folded.
+ */
+bool FoldInitIntoReduction(Stage* init, Stage* reduce, const std::vector<Stage>& between) {
+  auto* assign = init->expr().As<ir::Assign>();
+  auto* sum_assign = reduce->expr().As<ir::SumAssign>();
+  if (!assign || !sum_assign) return false;
+  if (ir::Dump(assign->a) != ir::Dump(sum_assign->a)) return false;
+
+  auto written = WrittenElements(*init);
+  if (Intersects(ReadElements(*init), written)) return false;
+  if (Intersects(AccessedElements(*reduce, reduce->read_access()), written)) return false;
+
+  // The first iterations of the reduction are moved ahead, the stages between should not write its sources.
+  auto sources = AccessedElements(*reduce, reduce->read_access());
+  for (auto& stage : between) {
+    if (Intersects(WrittenElements(stage), sources)) return false;
+  }
+
+  // The reduction should iterate exactly one more iterator than the initialization.
+  auto init_dims = isl_set_get_dims(init->iterator_domain());
+  auto reduce_dims = isl_set_get_dims(reduce->iterator_domain());
+  if (reduce_dims.size() != init_dims.size() + 1) return false;
+  int pos = 0;
+  while (pos < init_dims.size() && init_dims[pos] == reduce_dims[pos]) pos++;
+  for (int i = pos; i < init_dims.size(); i++) {
+    if (init_dims[i] != reduce_dims[i + 1]) return false;
+  }
+  const std::string reduce_iter = reduce_dims[pos];
+
+  int lower_bound;
+  if (!GetConstantLowerBound(reduce->iterator_domain(), pos, &lower_bound)) return false;
+  int folded = GetTileSize(*reduce, pos, reduce_dims.size());
+  for (int i = 1; i < folded; i++) {
+    if (!CoversIteration(reduce->iterator_domain(), pos, lower_bound + i)) return false;
+  }
+  isl::set outer = RenameDomain(
+      isl::manage(isl_set_project_out(reduce->iterator_domain().copy(), isl_dim_set, pos, 1)), init->name());
+  if (isl_set_is_equal(outer.get(), init->iterator_domain().get()) != isl_bool_true) return false;
+
+  const ir::Var* iter{};
+  for (auto* var : ir::CollectVarsFromExpr(reduce->expr())) {
+    if (var->name() == reduce_iter) iter = var;
+  }
+  Expr value = IsZero(assign->b) ? Expr() : assign->b;
+  for (int i = 0; i < folded; i++) {
+    Expr term = ir::IRDeepCopy(sum_assign->b);
+    if (iter) ir::IRReplace(&term, Expr(*iter), Expr(lower_bound + i));
+    value = value.valid() ? ir::Add::make(value, term) : term;
+  }
+  CINN_DEBUG(2) << "fold the first " << folded << " iterations of " << reduce->name() << " into " << init->name();
+  init->ResetExpr(ir::Assign::make(assign->a, value));
+  reduce->SetCond(StringFormat("%s >= %d", reduce_iter.c_str(), lower_bound + folded));
+  return true;
+}
+
+/**
+ * Fold the initializations of the reductions.
+ * @param outputs the names of the tensors read after the stages.
+ * @param replaced the stages removed, mapped to the stages computing their results now.
+ */
+void FoldReductionInits(std::vector<Stage>* stages,
+                        const std::set<std::string>& outputs,
+                        std::map<std::string, std::string>* replaced) {
+  std::vector<Stage> result;
+  for (size_t i = 0; i < stages->size(); i++) {
+    auto& init = stages->at(i);
+    if (replaced->count(init.name())) continue;
+    result.push_back(init);
+    if (!IsAnalyzable(init) || !init.expr().is_assign()) continue;
+
+    auto written = WrittenElements(init);
+    // Find the next stage accessing the initialized elements.
+    for (size_t j = i + 1; j < stages->size(); j++) {
+      auto& reduce = stages->at(j);
+      if (!IsAnalyzable(reduce)) break;
+      if (!Intersects(ReadElements(reduce), written) && !Intersects(WrittenElements(reduce), written)) continue;
+
+      int consumer_id = ForwardReductionToConsumer(stages, i, j, outputs);
+      if (consumer_id >= 0) (*replaced)[stages->at(consumer_id).name()] = reduce.name();
+
+      std::vector<Stage> between(stages->begin() + i + 1, stages->begin() + j);
+      if (FoldInitIntoReduction(&init, &reduce, between) &&
+          isl_set_is_empty(reduce.iterator_domain().get()) == isl_bool_true) {
+        (*replaced)[reduce.name()] = init.name();
+      }
+      break;
+    }
+  }
+  *stages = std::move(result);
+}
+
+void RemoveDeadStores(std::vector<Stage>* stages) {
+  std::vector<Stage> result;
+  for (size_t i = 0; i < stages->size(); i++) {
+    auto& stage = stages->at(i);
+    bool dead = false;
+    if (IsAnalyzable(stage)) {
+      auto remaining = WrittenElements(stage);
+      for (size_t j = i + 1; j < stages->size() && !isl_union_set_is_empty(remaining.get()); j++) {
+        auto& other = stages->at(j);
+        if (!IsAnalyzable(other) || Intersects(ReadElements(other), remaining)) break;
+        if (other.expr().is_assign()) {
+          remaining = isl::manage(isl_union_set_subtract(remaining.release(), WrittenElements(other).release()));
+        }
+      }
+      dead = isl_union_set_is_empty(remaining.get());
+    }
+
+    if (dead) {
+      CINN_DEBUG(2) << "remove the dead stage " << stage.name() << " " << stage.expr();
+    } else {
+      result.push_back(stage);
+    }
+  }
+  *stages = std::move(result);
+}
+
+/**
+ * Redirect the fusions with the stages removed to the stages replacing them, or drop them if the stages are removed as
+ * dead stores.
+ */
+void UpdateFusions(std::vector<Stage>* stages, const std::map<std::string, std::string>& replaced) {
+  std::map<std::string, Stage*> names;
+  for (auto& stage : *stages) names[stage.name()] = &stage;
+  for (auto& stage : *stages) {
+    std::vector<std::string> targets(stage.stages_fuse_with().begin(), stage.stages_fuse_with().end());
+    for (auto& target : targets) {
+      if (names.count(target)) continue;
+      stage.UnfuseWith(target);
+      std::string replacement = target;
+      while (replaced.count(replacement)) replacement = replaced.at(replacement);
+      if (names.count(replacement) && replacement != stage.name()) stage.FuseWith(*names[replacement]);
+    }
+  }
+}
+
+}  // namespace
+
+void EliminateRedundantStages(std::vector<Stage>* stages, const std::vector<Expr>& outputs) {
+  LOG_INDENT(6);
+  std::set<std::string> output_names;
+  for (auto& output : outputs) {
+    if (output.As<ir::Tensor>()) output_names.insert(output.As<ir::Tensor>()->name());
+  }
+  std::map<std::string, std::string> replaced;
+  FoldReductionInits(stages, output_names, &replaced);
+  RemoveDeadStores(stages);
+  UpdateFusions(stages, replaced);
+}
+
+}  // namespace cinn
@@ -0,0 +1,47 @@
+#pragma once
+#include <vector>
+#include "cinn/core/stage.h"
+
+namespace cinn {
+
+/**
+ * Simplify a list of stages with the dataflow analysis on their write and read accesses.
+ *
+ * Two kinds of redundancy are eliminated:
+ *
+ * 1. The initialization of a reduction is folded into the first iteration of the reduction, e.g.
+ *
+ *     C[i][j] = 0;                      // S0
+ *     C[i][j] += A[i][k] * B[k][j];     // S1, 0 <= k < K
+ *
+ * is rewritten to
+ *
+ *     C[i][j] = A[i][0] * B[0][j];      // S0
+ *     C[i][j] += A[i][k] * B[k][j];     // S1, 0 < k < K
+ *
+ * so that the output is written once less. A non-zero initialization such as a bias is kept as the first addend, the
+ * order of the additions is not changed. If the reduction iterator is vectorized or unrolled, the first tile is folded.
+ *
+ * A reduction into a temporary consumed by a bias addition, such as the FC layer, is forwarded to the consumer first,
+ *
+ *     C[i][j] = 0;
+ *     C[i][j] += A[i][k] * B[k][j];
+ *     D[i][j] = C[i][j] + bias[j];
+ *
+ * is rewritten to
+ *
+ *     D[i][j] = bias[j];
+ *     D[i][j] += A[i][k] * B[k][j];
+ *
+ * it changes the floating-point rounding, so it is skipped with CINNContext::strict_fp.
+ *
+ * 2. A stage is removed if all the elements it writes are overwritten by the later stages before being read.
+ *
+ * The stages calling functions or called only once are treated as barriers.
+ *
+ * @param stages the stages in the execution order.
+ * @param outputs the tensors read after the stages, they are always written.
+ */
+void EliminateRedundantStages(std::vector<Stage>* stages, const std::vector<Expr>& outputs);
+
+}  // namespace cinn
@@ -16,9 +16,447 @@ float hsum_ps_sse3(__m128 v) {
   return _mm_cvtss_f32(sums);
 }
 
+#ifdef __AVX__
 float _m256_custom_reduce_add(__m256 v) {
   __m128 vlow = _mm256_castps256_ps128(v);
   __m128 vhigh = _mm256_extractf128_ps(v, 1);
   vlow = _mm_add_ps(vlow, vhigh);
   return hsum_ps_sse3(vlow);
 }
+#endif
+
+namespace {
+
+#ifdef __AVX2__
+int32_t _m256_reduce_add_epi32(__m256i v) {
+  __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+  sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+  sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(sum);
+}
+
+// The products of a with 4 vectors starting from b with the stride n.
+void _m256_dot4_s8(const int8_t* a, const int8_t* b, int n, int32_t* out) {
+  const __m256i ones = _mm256_set1_epi16(1);
+  __m256i acc[4] = {_mm256_setzero_si256(), _mm256_setzero_si256(), _mm256_setzero_si256(), _mm256_setzero_si256()};
+  int i = 0;
+  for (; i + 32 <= n; i += 32) {
+    __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+    __m256i abs_a = _mm256_sign_epi8(va, va);
+    for (int r = 0; r < 4; r++) {
+      __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + r * n + i));
+      __m256i pairs = _mm256_maddubs_epi16(abs_a, _mm256_sign_epi8(vb, va));
+      acc[r] = _mm256_add_epi32(acc[r], _mm256_madd_epi16(pairs, ones));
+    }
+  }
+  for (int r = 0; r < 4; r++) {
+    int32_t result = _m256_reduce_add_epi32(acc[r]);
+    for (int k = i; k < n; k++) result += static_cast<int32_t>(a[k]) * b[r * n + k];
+    out[r] = result;
+  }
+}
+#endif
+
+}  // namespace
+
+int32_t _m256_dot_s8(const int8_t* a, const int8_t* b, int n) {
+  int i = 0;
+  int32_t result = 0;
+#ifdef __AVX2__
+  const __m256i ones = _mm256_set1_epi16(1);
+  __m256i acc = _mm256_setzero_si256();
+  for (; i + 32 <= n; i += 32) {
+    __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+    __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+    // |a| * (b * sign(a)) == a * b
+    __m256i pairs = _mm256_maddubs_epi16(_mm256_sign_epi8(va, va), _mm256_sign_epi8(vb, va));
+    acc = _mm256_add_epi32(acc, _mm256_madd_epi16(pairs, ones));
+  }
+  result = _m256_reduce_add_epi32(acc);
+#endif
+  for (; i < n; i++) result += static_cast<int32_t>(a[i]) * b[i];
+  return result;
+}
+
+void cinn_gemm_s8(const int8_t* x, const int8_t* w, int32_t* out, int M, int N, int K) {
+  for (int i = 0; i < M; i++) {
+    const int8_t* row = x + i * K;
+    int j = 0;
+#ifdef __AVX2__
+    for (; j + 4 <= N; j += 4) _m256_dot4_s8(row, w + j * K, K, out + i * N + j);
+#endif
+    for (; j < N; j++) out[i * N + j] = _m256_dot_s8(row, w + j * K, K);
+  }
+}
+
+namespace {
+
+// The inputs of exp are clamped to [exp_lo, exp_hi] so that 2^n stays a normal float.
+const float exp_hi = 88.02f;
+const float exp_lo = -87.33f;
+const float log2e = 1.44269504088896341f;
+// ln2 split into a exact high part and a low part for the Cody-Waite range reduction.
+const float ln2_hi = 0.693359375f;
+const float ln2_lo = -2.12194440e-4f;
+
+const float exp_p0 = 1.9875691500e-4f;
+const float exp_p1 = 1.3981999507e-3f;
+const float exp_p2 = 8.3334519073e-3f;
+const float exp_p3 = 4.1665795894e-2f;
+const float exp_p4 = 1.6666665459e-1f;
+const float exp_p5 = 5.0000001201e-1f;
+
+const float sqrt_half = 0.707106781186547524f;
+const float log_p0 = 7.0376836292e-2f;
+const float log_p1 = -1.1514610310e-1f;
+const float log_p2 = 1.1676998740e-1f;
+const float log_p3 = -1.2420140846e-1f;
+const float log_p4 = 1.4249322787e-1f;
+const float log_p5 = -1.6668057665e-1f;
+const float log_p6 = 2.0000714765e-1f;
+const float log_p7 = -2.4999993993e-1f;
+const float log_p8 = 3.3333331174e-1f;
+
+// tanh(x) is computed by the odd polynomial below when |x| < tanh_small, and by 1 - 2 / (exp(2x) + 1) otherwise.
+const float tanh_small = 0.625f;
+const float tanh_p0 = -5.70498872745e-3f;
+const float tanh_p1 = 2.06390887954e-2f;
+const float tanh_p2 = -5.37397155531e-2f;
+const float tanh_p3 = 1.33314422036e-1f;
+const float tanh_p4 = -3.33332819422e-1f;
+// tanh(x) rounds to 1 in float when |x| > tanh_hi.
+const float tanh_hi = 9.0f;
+
+const int float_exponent_mask = 0x7f800000;
+const int float_exponent_bias = 0x7f;
+const int float_mantissa_bits = 23;
+
+// Compute 2^n for the integral n.
+__m128 _m128_pow2n_ps(__m128 n) {
+  __m128i e = _mm_cvttps_epi32(n);
+  e = _mm_add_epi32(e, _mm_set1_epi32(float_exponent_bias));
+  e = _mm_slli_epi32(e, float_mantissa_bits);
+  return _mm_castsi128_ps(e);
+}
+
+// Split x into the mantissa in [0.5, 1) and the exponent.
+__m128 _m128_frexp_ps(__m128 x, __m128* exponent) {
+  __m128i e = _mm_srli_epi32(_mm_castps_si128(x), float_mantissa_bits);
+  e = _mm_sub_epi32(e, _mm_set1_epi32(float_exponent_bias - 1));
+  *exponent = _mm_cvtepi32_ps(e);
+
+  x = _mm_andnot_ps(_mm_castsi128_ps(_mm_set1_epi32(float_exponent_mask)), x);
+  return _mm_or_ps(x, _mm_set1_ps(0.5f));
+}
+
+#ifdef __AVX__
+__m256 _m256_pow2n_ps(__m256 n) {
+  __m256i e = _mm256_cvttps_epi32(n);
+#ifdef __AVX2__
+  e = _mm256_add_epi32(e, _mm256_set1_epi32(float_exponent_bias));
+  e = _mm256_slli_epi32(e, float_mantissa_bits);
+#else
+  // AVX has no 256-bit integer arithmetic, compute the two halves with SSE.
+  __m128i lo = _mm256_castsi256_si128(e);
+  __m128i hi = _mm256_extractf128_si256(e, 1);
+  lo = _mm_slli_epi32(_mm_add_epi32(lo, _mm_set1_epi32(float_exponent_bias)), float_mantissa_bits);
+  hi = _mm_slli_epi32(_mm_add_epi32(hi, _mm_set1_epi32(float_exponent_bias)), float_mantissa_bits);
+  e = _mm256_insertf128_si256(_mm256_castsi128_si256(lo), hi, 1);
+#endif
+  return _mm256_castsi256_ps(e);
+}
+
+__m256 _m256_frexp_ps(__m256 x, __m256* exponent) {
+#ifdef __AVX2__
+  __m256i e = _mm256_srli_epi32(_mm256_castps_si256(x), float_mantissa_bits);
+  e = _mm256_sub_epi32(e, _mm256_set1_epi32(float_exponent_bias - 1));
+  *exponent = _mm256_cvtepi32_ps(e);
+#else
+  __m128 lo_exponent, hi_exponent;
+  _m128_frexp_ps(_mm256_castps256_ps128(x), &lo_exponent);
+  _m128_frexp_ps(_mm256_extractf128_ps(x, 1), &hi_exponent);
+  *exponent = _mm256_insertf128_ps(_mm256_castps128_ps256(lo_exponent), hi_exponent, 1);
+#endif
+
+  x = _mm256_andnot_ps(_mm256_castsi256_ps(_mm256_set1_epi32(float_exponent_mask)), x);
+  return _mm256_or_ps(x, _mm256_set1_ps(0.5f));
+}
+#endif
+
+}  // namespace
+
+__m128 _m128_exp_ps(__m128 x) {
+  x = _mm_min_ps(x, _mm_set1_ps(exp_hi));
+  x = _mm_max_ps(x, _mm_set1_ps(exp_lo));
+
+  // exp(x) = 2^n * exp(r), n = round(x / ln2), r = x - n * ln2
+  __m128 n = _mm_floor_ps(_mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(log2e)), _mm_set1_ps(0.5f)));
+  x = _mm_sub_ps(x, _mm_mul_ps(n, _mm_set1_ps(ln2_hi)));
+  x = _mm_sub_ps(x, _mm_mul_ps(n, _mm_set1_ps(ln2_lo)));
+
+  __m128 z = _mm_mul_ps(x, x);
+  __m128 y = _mm_set1_ps(exp_p0);
+  y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(exp_p1));
+  y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(exp_p2));
+  y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(exp_p3));
+  y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(exp_p4));
+  y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(exp_p5));
+  y = _mm_add_ps(_mm_mul_ps(y, z), x);
+  y = _mm_add_ps(y, _mm_set1_ps(1.f));
+
+  return _mm_mul_ps(y, _m128_pow2n_ps(n));
+}
+
+__m128 _m128_log_ps(__m128 x) {
+  __m128 invalid = _mm_cmple_ps(x, _mm_setzero_ps());
+  x = _mm_max_ps(x, _mm_castsi128_ps(_mm_set1_epi32(0x00800000)));  // the min positive normal float
+
+  // log(x) = log(m) + e * ln2, m in [sqrt(0.5), sqrt(2))
+  __m128 e;
+  x = _m128_frexp_ps(x, &e);
+  __m128 small = _mm_cmplt_ps(x, _mm_set1_ps(sqrt_half));
+  e = _mm_sub_ps(e, _mm_and_ps(_mm_set1_ps(1.f), small));
+  x = _mm_add_ps(_mm_sub_ps(x, _mm_set1_ps(1.f)), _mm_and_ps(x, small));
+
+  __m128 z = _mm_mul_ps(x, x);
+  __m128 y = _mm_set1_ps(log_p0);
+  y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(log_p1));
+  y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(log_p2));
+  y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(log_p3));
+  y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(log_p4));
+  y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(log_p5));
+  y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(log_p6));
+  y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(log_p7));
+  y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(log_p8));
+  y = _mm_mul_ps(_mm_mul_ps(y, x), z);
+
+  y = _mm_add_ps(y, _mm_mul_ps(e, _mm_set1_ps(ln2_lo)));
+  y = _mm_sub_ps(y, _mm_mul_ps(z, _mm_set1_ps(0.5f)));
+  x = _mm_add_ps(x, y);
+  x = _mm_add_ps(x, _mm_mul_ps(e, _mm_set1_ps(ln2_hi)));
+
+  // NaN for the non-positive inputs.
+  return _mm_or_ps(x, invalid);
+}
+
+__m128 _m128_tanh_ps(__m128 x) {
+  __m128 sign_mask = _mm_set1_ps(-0.f);
+  __m128 abs_x = _mm_andnot_ps(sign_mask, x);
+
+  // small inputs: x + x^3 * P(x^2)
+  __m128 z = _mm_mul_ps(x, x);
+  __m128 y = _mm_set1_ps(tanh_p0);
+  y = _mm_add_ps(_mm_mul_ps(y, z), _mm_set1_ps(tanh_p1));
+  y = _mm_add_ps(_mm_mul_ps(y, z), _mm_set1_ps(tanh_p2));
+  y = _mm_add_ps(_mm_mul_ps(y, z), _mm_set1_ps(tanh_p3));
+  y = _mm_add_ps(_mm_mul_ps(y, z), _mm_set1_ps(tanh_p4));
+  y = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(y, z), x), x);
+
+  // large inputs: sign(x) * (1 - 2 / (exp(2|x|) + 1))
+  __m128 clamped = _mm_min_ps(abs_x, _mm_set1_ps(tanh_hi));
+  __m128 t = _m128_exp_ps(_mm_add_ps(clamped, clamped));
+  t = _mm_sub_ps(_mm_set1_ps(1.f), _mm_div_ps(_mm_set1_ps(2.f), _mm_add_ps(t, _mm_set1_ps(1.f))));
+  t = _mm_or_ps(t, _mm_and_ps(sign_mask, x));
+
+  return _mm_blendv_ps(t, y, _mm_cmplt_ps(abs_x, _mm_set1_ps(tanh_small)));
+}
+
+__m128 _m128_sigmoid_ps(__m128 x) {
+  __m128 one = _mm_set1_ps(1.f);
+  return _mm_div_ps(one, _mm_add_ps(one, _m128_exp_ps(_mm_sub_ps(_mm_setzero_ps(), x))));
+}
+
+#ifdef __AVX__
+__m256 _m256_exp_ps(__m256 x) {
+  x = _mm256_min_ps(x, _mm256_set1_ps(exp_hi));
+  x = _mm256_max_ps(x, _mm256_set1_ps(exp_lo));
+
+  __m256 n = _mm256_floor_ps(_mm256_add_ps(_mm256_mul_ps(x, _mm256_set1_ps(log2e)), _mm256_set1_ps(0.5f)));
+  x = _mm256_sub_ps(x, _mm256_mul_ps(n, _mm256_set1_ps(ln2_hi)));
+  x = _mm256_sub_ps(x, _mm256_mul_ps(n, _mm256_set1_ps(ln2_lo)));
+
+  __m256 z = _mm256_mul_ps(x, x);
+  __m256 y = _mm256_set1_ps(exp_p0);
+  y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(exp_p1));
+  y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(exp_p2));
+  y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(exp_p3));
+  y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(exp_p4));
+  y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(exp_p5));
+  y = _mm256_add_ps(_mm256_mul_ps(y, z), x);
+  y = _mm256_add_ps(y, _mm256_set1_ps(1.f));
+
+  return _mm256_mul_ps(y, _m256_pow2n_ps(n));
+}
+
+__m256 _m256_log_ps(__m256 x) {
+  __m256 invalid = _mm256_cmp_ps(x, _mm256_setzero_ps(), _CMP_LE_OQ);
+  x = _mm256_max_ps(x, _mm256_castsi256_ps(_mm256_set1_epi32(0x00800000)));
+
+  __m256 e;
+  x = _m256_frexp_ps(x, &e);
+  __m256 small = _mm256_cmp_ps(x, _mm256_set1_ps(sqrt_half), _CMP_LT_OQ);
+  e = _mm256_sub_ps(e, _mm256_and_ps(_mm256_set1_ps(1.f), small));
+  x = _mm256_add_ps(_mm256_sub_ps(x, _mm256_set1_ps(1.f)), _mm256_and_ps(x, small));
+
+  __m256 z = _mm256_mul_ps(x, x);
+  __m256 y = _mm256_set1_ps(log_p0);
+  y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(log_p1));
+  y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(log_p2));
+  y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(log_p3));
+  y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(log_p4));
+  y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(log_p5));
+  y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(log_p6));
+  y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(log_p7));
+  y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(log_p8));
+  y = _mm256_mul_ps(_mm256_mul_ps(y, x), z);
+
+  y = _mm256_add_ps(y, _mm256_mul_ps(e, _mm256_set1_ps(ln2_lo)));
+  y = _mm256_sub_ps(y, _mm256_mul_ps(z, _mm256_set1_ps(0.5f)));
+  x = _mm256_add_ps(x, y);
+  x = _mm256_add_ps(x, _mm256_mul_ps(e, _mm256_set1_ps(ln2_hi)));
+
+  return _mm256_or_ps(x, invalid);
+}
+
+__m256 _m256_tanh_ps(__m256 x) {
+  __m256 sign_mask = _mm256_set1_ps(-0.f);
+  __m256 abs_x = _mm256_andnot_ps(sign_mask, x);
+
+  __m256 z = _mm256_mul_ps(x, x);
+  __m256 y = _mm256_set1_ps(tanh_p0);
+  y = _mm256_add_ps(_mm256_mul_ps(y, z), _mm256_set1_ps(tanh_p1));
+  y = _mm256_add_ps(_mm256_mul_ps(y, z), _mm256_set1_ps(tanh_p2));
+  y = _mm256_add_ps(_mm256_mul_ps(y, z), _mm256_set1_ps(tanh_p3));
+  y = _mm256_add_ps(_mm256_mul_ps(y, z), _mm256_set1_ps(tanh_p4));
+  y = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(y, z), x), x);
+
+  __m256 clamped = _mm256_min_ps(abs_x, _mm256_set1_ps(tanh_hi));
+  __m256 t = _m256_exp_ps(_mm256_add_ps(clamped, clamped));
+  t = _mm256_sub_ps(_mm256_set1_ps(1.f), _mm256_div_ps(_mm256_set1_ps(2.f), _mm256_add_ps(t, _mm256_set1_ps(1.f))));
+  t = _mm256_or_ps(t, _mm256_and_ps(sign_mask, x));
+
+  return _mm256_blendv_ps(t, y, _mm256_cmp_ps(abs_x, _mm256_set1_ps(tanh_small), _CMP_LT_OQ));
+}
+
+__m256 _m256_sigmoid_ps(__m256 x) {
+  __m256 one = _mm256_set1_ps(1.f);
+  return _mm256_div_ps(one, _mm256_add_ps(one, _m256_exp_ps(_mm256_sub_ps(_mm256_setzero_ps(), x))));
+}
+#endif
+
+#ifdef __AVX512F__
+namespace {
+
+__m512 _m512_and_ps(__m512 a, __m512 b) {
+  return _mm512_castsi512_ps(_mm512_and_si512(_mm512_castps_si512(a), _mm512_castps_si512(b)));
+}
+
+__m512 _m512_or_ps(__m512 a, __m512 b) {
+  return _mm512_castsi512_ps(_mm512_or_si512(_mm512_castps_si512(a), _mm512_castps_si512(b)));
+}
+
+}  // namespace
+
+__m512 _m512_exp_ps(__m512 x) {
+  x = _mm512_min_ps(x, _mm512_set1_ps(exp_hi));
+  x = _mm512_max_ps(x, _mm512_set1_ps(exp_lo));
+
+  __m512 n = _mm512_roundscale_ps(_mm512_fmadd_ps(x, _mm512_set1_ps(log2e), _mm512_set1_ps(0.5f)),
+                                  _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+  x = _mm512_fnmadd_ps(n, _mm512_set1_ps(ln2_hi), x);
+  x = _mm512_fnmadd_ps(n, _mm512_set1_ps(ln2_lo), x);
+
+  __m512 z = _mm512_mul_ps(x, x);
+  __m512 y = _mm512_set1_ps(exp_p0);
+  y = _mm512_fmadd_ps(y, x, _mm512_set1_ps(exp_p1));
+  y = _mm512_fmadd_ps(y, x, _mm512_set1_ps(exp_p2));
+  y = _mm512_fmadd_ps(y, x, _mm512_set1_ps(exp_p3));
+  y = _mm512_fmadd_ps(y, x, _mm512_set1_ps(exp_p4));
+  y = _mm512_fmadd_ps(y, x, _mm512_set1_ps(exp_p5));
+  y = _mm512_fmadd_ps(y, z, x);
+  y = _mm512_add_ps(y, _mm512_set1_ps(1.f));
+
+  __m512i e = _mm512_cvttps_epi32(n);
+  e = _mm512_slli_epi32(_mm512_add_epi32(e, _mm512_set1_epi32(float_exponent_bias)), float_mantissa_bits);
+  return _mm512_mul_ps(y, _mm512_castsi512_ps(e));
+}
+
+__m512 _m512_log_ps(__m512 x) {
+  __mmask16 invalid = _mm512_cmp_ps_mask(x, _mm512_setzero_ps(), _CMP_LE_OQ);
+  x = _mm512_max_ps(x, _mm512_castsi512_ps(_mm512_set1_epi32(0x00800000)));
+
+  __m512i ei = _mm512_srli_epi32(_mm512_castps_si512(x), float_mantissa_bits);
+  __m512 e = _mm512_cvtepi32_ps(_mm512_sub_epi32(ei, _mm512_set1_epi32(float_exponent_bias - 1)));
+  x = _mm512_castsi512_ps(_mm512_andnot_si512(_mm512_set1_epi32(float_exponent_mask), _mm512_castps_si512(x)));
+  x = _m512_or_ps(x, _mm512_set1_ps(0.5f));
+
+  __mmask16 small = _mm512_cmp_ps_mask(x, _mm512_set1_ps(sqrt_half), _CMP_LT_OQ);
+  e = _mm512_mask_sub_ps(e, small, e, _mm512_set1_ps(1.f));
+  x = _mm512_mask_add_ps(_mm512_sub_ps(x, _mm512_set1_ps(1.f)), small, _mm512_sub_ps(x, _mm512_set1_ps(1.f)), x);
+
+  __m512 z = _mm512_mul_ps(x, x);
+  __m512 y = _mm512_set1_ps(log_p0);
+  y = _mm512_fmadd_ps(y, x, _mm512_set1_ps(log_p1));
+  y = _mm512_fmadd_ps(y, x, _mm512_set1_ps(log_p2));
+  y = _mm512_fmadd_ps(y, x, _mm512_set1_ps(log_p3));
+  y = _mm512_fmadd_ps(y, x, _mm512_set1_ps(log_p4));
+  y = _mm512_fmadd_ps(y, x, _mm512_set1_ps(log_p5));
+  y = _mm512_fmadd_ps(y, x, _mm512_set1_ps(log_p6));
+  y = _mm512_fmadd_ps(y, x, _mm512_set1_ps(log_p7));
+  y = _mm512_fmadd_ps(y, x, _mm512_set1_ps(log_p8));
+  y = _mm512_mul_ps(_mm512_mul_ps(y, x), z);
+
+  y = _mm512_fmadd_ps(e, _mm512_set1_ps(ln2_lo), y);
+  y = _mm512_fnmadd_ps(z, _mm512_set1_ps(0.5f), y);
+  x = _mm512_add_ps(x, y);
+  x = _mm512_fmadd_ps(e, _mm512_set1_ps(ln2_hi), x);
+
+  return _mm512_mask_blend_ps(invalid, x, _mm512_set1_ps(__builtin_nanf("")));
+}
+
+__m512 _m512_tanh_ps(__m512 x) {
+  __m512 sign_mask = _mm512_set1_ps(-0.f);
+  __m512 abs_x = _mm512_abs_ps(x);
+
+  __m512 z = _mm512_mul_ps(x, x);
+  __m512 y = _mm512_set1_ps(tanh_p0);
+  y = _mm512_fmadd_ps(y, z, _mm512_set1_ps(tanh_p1));
+  y = _mm512_fmadd_ps(y, z, _mm512_set1_ps(tanh_p2));
+  y = _mm512_fmadd_ps(y, z, _mm512_set1_ps(tanh_p3));
+  y = _mm512_fmadd_ps(y, z, _mm512_set1_ps(tanh_p4));
+  y = _mm512_fmadd_ps(_mm512_mul_ps(y, z), x, x);
+
+  __m512 clamped = _mm512_min_ps(abs_x, _mm512_set1_ps(tanh_hi));
+  __m512 t = _m512_exp_ps(_mm512_add_ps(clamped, clamped));
+  t = _mm512_sub_ps(_mm512_set1_ps(1.f), _mm512_div_ps(_mm512_set1_ps(2.f), _mm512_add_ps(t, _mm512_set1_ps(1.f))));
+  t = _m512_or_ps(t, _m512_and_ps(sign_mask, x));
+
+  return _mm512_mask_blend_ps(_mm512_cmp_ps_mask(abs_x, _mm512_set1_ps(tanh_small), _CMP_LT_OQ), t, y);
+}
+
+__m512 _m512_sigmoid_ps(__m512 x) {
+  __m512 one = _mm512_set1_ps(1.f);
+  return _mm512_div_ps(one, _mm512_add_ps(one, _m512_exp_ps(_mm512_sub_ps(_mm512_setzero_ps(), x))));
+}
+#endif
+
+void* cinn_map_file(const char* path, size_t size) {
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    fprintf(stderr, "cinn: failed to open %s\n", path);
+    abort();
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) != size) {
+    fprintf(stderr, "cinn: %s should have %zu bytes, the weights file doesn't match the program\n", path, size);
+    abort();
+  }
+  // The mapping lives as long as the program.
+  void* data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    fprintf(stderr, "cinn: failed to map %s\n", path);
+    abort();
+  }
+  return data;
+}
@@ -1,8 +1,177 @@
 #pragma once
+#include <fcntl.h>
 #include <immintrin.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 float _m128_custom_reduce_add(__m128 v);
 
 float hsum_ps_sse3(__m128 v);
 
+#ifdef __AVX__
 float _m256_custom_reduce_add(__m256 v);
+#endif
+
+/*
+ * Load the floats `base[0], base[stride], base[2 * stride], ...` to a vector, used by the vectorized loops reading
+ * a tensor along a non-contiguous axis.
+ *
+ * The 256-bit version uses the AVX2 gather, the others insert the elements one by one. They are defined inline for
+ * they are called in the innermost loops.
+ *
+ * The inline functions are static, so that the copies compiled for different instruction sets in a library are not
+ * merged by the linker, and the 256-bit ones are only available with AVX.
+ */
+static inline __m128 _m128_gather_ps(const float* base, int stride) {
+  return _mm_setr_ps(base[0], base[stride], base[2 * stride], base[3 * stride]);
+}
+
+#ifdef __AVX__
+static inline __m256 _m256_gather_ps(const float* base, int stride) {
+#ifdef __AVX2__
+  const __m256i vindex = _mm256_mullo_epi32(_mm256_set1_epi32(stride), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+  return _mm256_i32gather_ps(base, vindex, 4);
+#else
+  return _mm256_setr_ps(base[0],
+                        base[stride],
+                        base[2 * stride],
+                        base[3 * stride],
+                        base[4 * stride],
+                        base[5 * stride],
+                        base[6 * stride],
+                        base[7 * stride]);
+#endif
+}
+#endif
+
+/*
+ * Widen the float16 and bfloat16 weights to float32, the generated code stores them as unsigned shorts.
+ *
+ * The float16 loads use the F16C conversions, a bfloat16 is the upper half of a float32 and is widened by a shift.
+ */
+static inline float cinn_float16_to_float32(unsigned short x) {
+#ifdef __F16C__
+  return _cvtsh_ss(x);
+#else
+  unsigned int sign = (x & 0x8000u) << 16;
+  unsigned int exponent = (x >> 10) & 0x1f;
+  unsigned int mantissa = x & 0x3ff;
+  unsigned int bits;
+  float result;
+  if (exponent == 0x1f) {
+    bits = sign | 0x7f800000u | (mantissa << 13);
+  } else if (exponent == 0) {
+    result = mantissa * 5.9604644775390625e-8f;  // mantissa * 2^-24
+    return sign ? -result : result;
+  } else {
+    bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+  }
+  memcpy(&result, &bits, sizeof(result));
+  return result;
+#endif
+}
+
+static inline float cinn_bfloat16_to_float32(unsigned short x) {
+  unsigned int bits = static_cast<unsigned int>(x) << 16;
+  float result;
+  memcpy(&result, &bits, sizeof(result));
+  return result;
+}
+
+static inline __m128 _m128_load_ph_ps(const unsigned short* x) {
+#ifdef __F16C__
+  return _mm_cvtph_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(x)));
+#else
+  return _mm_setr_ps(
+      cinn_float16_to_float32(x[0]), cinn_float16_to_float32(x[1]), cinn_float16_to_float32(x[2]),
+      cinn_float16_to_float32(x[3]));
+#endif
+}
+
+#ifdef __AVX__
+static inline __m256 _m256_load_ph_ps(const unsigned short* x) {
+#ifdef __F16C__
+  return _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(x)));
+#else
+  return _mm256_setr_m128(_m128_load_ph_ps(x), _m128_load_ph_ps(x + 4));
+#endif
+}
+#endif
+
+static inline __m128 _m128_load_bf16_ps(const unsigned short* x) {
+  // Interleave with zeros to put each bfloat16 in the upper half of a float32.
+  __m128i v = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(x));
+  return _mm_castsi128_ps(_mm_unpacklo_epi16(_mm_setzero_si128(), v));
+}
+
+#ifdef __AVX__
+static inline __m256 _m256_load_bf16_ps(const unsigned short* x) {
+  __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(x));
+#ifdef __AVX2__
+  return _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_cvtepu16_epi32(v), 16));
+#else
+  __m128 low = _mm_castsi128_ps(_mm_unpacklo_epi16(_mm_setzero_si128(), v));
+  __m128 high = _mm_castsi128_ps(_mm_unpackhi_epi16(_mm_setzero_si128(), v));
+  return _mm256_setr_m128(low, high);
+#endif
+}
+#endif
+
+/*
+ * Dot product of two int8 vectors of length n with int32 accumulation, used by the int8 quantized kernels.
+ *
+ * `_mm256_maddubs_epi16` multiplies unsigned bytes with signed bytes, so the sign of a is moved to b by
+ * `_mm256_sign_epi8` first, then `_mm256_madd_epi16` widens the sums of the adjacent pairs to 32-bit. The 16-bit pair
+ * sums only saturate when both pairs are -128 * -128, the symmetric quantization keeps the values in [-127, 127].
+ * Falls back to the scalar loop without AVX2.
+ */
+int32_t _m256_dot_s8(const int8_t* a, const int8_t* b, int n);
+
+/*
+ * The int32 products of the int8 quantized matmul, `out[i, j] = sum_k x[i, k] * w[j, k]` with x in [M, K] and the
+ * transposed w in [N, K], both row major. The generated code calls it for the K-reduction, for the IR can't express
+ * the integer vectors. Four rows of w are multiplied with a row of x at a time to load the row of x once.
+ */
+void cinn_gemm_s8(const int8_t* x, const int8_t* w, int32_t* out, int M, int N, int K);
+
+/*
+ * Vectorized math functions for the generated code.
+ *
+ * They are the polynomial approximations from Cephes. The error bounds below are the max errors measured against the
+ * float64 results of libm:
+ *
+ * - exp: relative error < 1e-7 in [-87.3, 88.0]. Inputs outside this range are clamped to it.
+ * - log: relative error < 1e-7 for the positive normal floats, NaN for x <= 0.
+ * - tanh: absolute error < 1e-7 and relative error < 2e-7 for all the inputs.
+ * - sigmoid: absolute error < 1e-7 and relative error < 2e-7 in [-87, +inf).
+ */
+
+__m128 _m128_exp_ps(__m128 x);
+__m128 _m128_log_ps(__m128 x);
+__m128 _m128_tanh_ps(__m128 x);
+__m128 _m128_sigmoid_ps(__m128 x);
+
+#ifdef __AVX__
+__m256 _m256_exp_ps(__m256 x);
+__m256 _m256_log_ps(__m256 x);
+__m256 _m256_tanh_ps(__m256 x);
+__m256 _m256_sigmoid_ps(__m256 x);
+#endif
+
+#ifdef __AVX512F__
+__m512 _m512_exp_ps(__m512 x);
+__m512 _m512_log_ps(__m512 x);
+__m512 _m512_tanh_ps(__m512 x);
+__m512 _m512_sigmoid_ps(__m512 x);
+#endif
+
+/*
+ * Map a file read-only, the generated code maps the file of the weights when the program is loaded. The weights are
+ * placed at the offsets fixed at the build time, so it aborts if the file doesn't have `size` bytes.
+ */
+void* cinn_map_file(const char* path, size_t size);
@@ -1,6 +1,9 @@
 #include "simd.h"  // NOLINT
+#include <cmath>
 #include <glog/logging.h>
 #include <gtest/gtest.h>
+#include <vector>
+#include "cinn/utils/timer.h"
 
 TEST(simd256, add) {
   float* data = static_cast<float*>(aligned_alloc(32, 8 * sizeof(float)));
@@ -14,3 +17,141 @@ TEST(simd256, add) {
 
   delete data;
 }
+
+// The references are computed in double, the errors of the float libm results are up to 2 ulp near 1.
+TEST(simd256, math) {
+  float data[8] = {-10.f, -2.5f, -0.5f, -0.01f, 0.f, 0.3f, 1.7f, 20.f};
+  float out[8];
+  auto v = _mm256_loadu_ps(data);
+
+  _mm256_storeu_ps(out, _m256_exp_ps(v));
+  for (int i = 0; i < 8; i++) ASSERT_NEAR(out[i] / std::exp(static_cast<double>(data[i])), 1., 1e-7);
+
+  _mm256_storeu_ps(out, _m256_tanh_ps(v));
+  for (int i = 0; i < 8; i++) ASSERT_NEAR(out[i], std::tanh(static_cast<double>(data[i])), 1e-7);
+
+  _mm256_storeu_ps(out, _m256_sigmoid_ps(v));
+  for (int i = 0; i < 8; i++) ASSERT_NEAR(out[i], 1. / (1. + std::exp(-static_cast<double>(data[i]))), 1e-7);
+
+  _mm256_storeu_ps(out, _m256_log_ps(_mm256_set_ps(1e-20f, 0.1f, 0.7f, 1.f, 1.5f, 3.f, 1e5f, 1e30f)));
+  float log_data[8] = {1e30f, 1e5f, 3.f, 1.5f, 1.f, 0.7f, 0.1f, 1e-20f};
+  for (int i = 0; i < 8; i++) ASSERT_NEAR(out[i], std::log(log_data[i]), 1e-7 * std::abs(std::log(log_data[i])) + 1e-7);
+}
+
+TEST(simd128, math) {
+  float data[4] = {-3.f, -0.2f, 0.6f, 5.f};
+  float out[4];
+  auto v = _mm_loadu_ps(data);
+
+  _mm_storeu_ps(out, _m128_tanh_ps(v));
+  for (int i = 0; i < 4; i++) ASSERT_NEAR(out[i], std::tanh(static_cast<double>(data[i])), 1e-7);
+
+  _mm_storeu_ps(out, _m128_sigmoid_ps(v));
+  for (int i = 0; i < 4; i++) ASSERT_NEAR(out[i], 1. / (1. + std::exp(-static_cast<double>(data[i]))), 1e-7);
+}
+
+TEST(simd256, gather) {
+  float data[24];
+  for (int i = 0; i < 24; i++) data[i] = i;
+  float out[8];
+
+  _mm256_storeu_ps(out, _m256_gather_ps(data + 1, 3));
+  for (int i = 0; i < 8; i++) ASSERT_EQ(out[i], 1 + 3 * i);
+
+  _mm_storeu_ps(out, _m128_gather_ps(data, 5));
+  for (int i = 0; i < 4; i++) ASSERT_EQ(out[i], 5 * i);
+}
+
+TEST(simd256, dot_s8) {
+  const int n = 75;  // two full vectors and a tail
+  int8_t a[n], b[n];
+  for (int i = 0; i < n; i++) {
+    a[i] = static_cast<int8_t>((i * 37) % 255 - 127);
+    b[i] = static_cast<int8_t>(127 - (i * 53) % 255);
+  }
+  // The extreme values of the symmetric quantization should not saturate.
+  a[0] = b[0] = a[1] = b[1] = -127;
+  a[2] = b[2] = a[3] = b[3] = 127;
+
+  int32_t expected = 0;
+  for (int i = 0; i < n; i++) expected += a[i] * b[i];
+  ASSERT_EQ(_m256_dot_s8(a, b, n), expected);
+}
+
+TEST(simd256, gemm_s8) {
+  // The columns and the reduction both have a tail.
+  const int M = 3, N = 7, K = 45;
+  std::vector<int8_t> x(M * K), w(N * K);
+  for (int i = 0; i < M * K; i++) x[i] = static_cast<int8_t>((i * 37) % 255 - 127);
+  for (int i = 0; i < N * K; i++) w[i] = static_cast<int8_t>(127 - (i * 53) % 255);
+  std::vector<int32_t> out(M * N);
+
+  cinn_gemm_s8(x.data(), w.data(), out.data(), M, N, K);
+  for (int i = 0; i < M; i++) {
+    for (int j = 0; j < N; j++) {
+      int32_t expected = 0;
+      for (int k = 0; k < K; k++) expected += x[i * K + k] * w[j * K + k];
+      ASSERT_EQ(out[i * N + j], expected) << i << " " << j;
+    }
+  }
+}
+
+// Compare the int8 GEMM with the float matmul of the same shape, the float one is vectorized like the generated
+// code of matmul_transposed.
+TEST(simd256, gemm_s8_benchmark) {
+  const int M = 64, N = 512, K = 512;
+  const int repeat = 100;
+  std::vector<int8_t> x(M * K), w(N * K);
+  std::vector<float> xf(M * K), wf(N * K);
+  for (int i = 0; i < M * K; i++) xf[i] = x[i] = static_cast<int8_t>(i % 255 - 127);
+  for (int i = 0; i < N * K; i++) wf[i] = w[i] = static_cast<int8_t>(127 - i % 253);
+  std::vector<int32_t> out(M * N);
+  std::vector<float> outf(M * N);
+
+  cinn::Timer timer;
+  timer.Start();
+  for (int r = 0; r < repeat; r++) cinn_gemm_s8(x.data(), w.data(), out.data(), M, N, K);
+  timer.Stop();
+  float int8_duration = static_cast<float>(timer.duration()) / repeat;
+
+  timer.Start();
+  for (int r = 0; r < repeat; r++) {
+    for (int i = 0; i < M; i++) {
+      for (int j = 0; j < N; j++) {
+        __m256 acc = _mm256_setzero_ps();
+        for (int k = 0; k < K; k += 8) {
+          acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_loadu_ps(&xf[i * K + k]), _mm256_loadu_ps(&wf[j * K + k])));
+        }
+        outf[i * N + j] = _m256_custom_reduce_add(acc);
+      }
+    }
+  }
+  timer.Stop();
+  float fp32_duration = static_cast<float>(timer.duration()) / repeat;
+
+  LOG(INFO) << "gemm " << M << "x" << N << "x" << K << ": int8 " << int8_duration << " ms, fp32 " << fp32_duration
+            << " ms";
+  // The products are small integers, exact in float.
+  for (int i = 0; i < M * N; i++) ASSERT_EQ(out[i], static_cast<int32_t>(outf[i]));
+}
+
+TEST(simd256, load_half) {
+  // 1, -2, 0.5, 65504, 2^-24, -0, 3, 0.25 in float16 and bfloat16
+  unsigned short f16[8] = {0x3c00, 0xc000, 0x3800, 0x7bff, 0x0001, 0x8000, 0x4200, 0x3400};
+  unsigned short bf16[8] = {0x3f80, 0xc000, 0x3f00, 0x477f, 0x3380, 0x8000, 0x4040, 0x3e80};
+  float expected[8] = {1.f, -2.f, 0.5f, 65504.f, 5.9604644775390625e-8f, -0.f, 3.f, 0.25f};
+  float out[8];
+
+  _mm256_storeu_ps(out, _m256_load_ph_ps(f16));
+  for (int i = 0; i < 8; i++) ASSERT_EQ(out[i], expected[i]);
+  _mm_storeu_ps(out, _m128_load_ph_ps(f16 + 4));
+  for (int i = 0; i < 4; i++) ASSERT_EQ(out[i], expected[i + 4]);
+  for (int i = 0; i < 8; i++) ASSERT_EQ(cinn_float16_to_float32(f16[i]), expected[i]);
+
+  _mm256_storeu_ps(out, _m256_load_bf16_ps(bf16));
+  for (int i = 0; i < 8; i++) ASSERT_EQ(out[i], i == 3 ? 65280.f : expected[i]);
+  _mm_storeu_ps(out, _m128_load_bf16_ps(bf16));
+  for (int i = 0; i < 4; i++) ASSERT_EQ(out[i], i == 3 ? 65280.f : expected[i]);
+  ASSERT_EQ(cinn_bfloat16_to_float32(bf16[6]), 3.f);
+}
+
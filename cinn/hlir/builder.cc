@@ -1,10 +1,17 @@
 #include "cinn/hlir/builder.h"
 #include "cinn/backends/code_gen_c.h"
 #include "cinn/core/optimize/optimizer.h"
+#include "cinn/core/optimize/pass_registry.h"
 #include "cinn/core/stage.h"
+#include "cinn/hlir/memory_planner.h"
+#include "cinn/hlir/weights_file.h"
 #include "cinn/ir/ir_helper.h"
 #include "cinn/utils/logging.h"
 
+// The graph optimizations run by the Builder before the operators are compiled.
+USE_HLIR_PASS(fold_constants);
+USE_HLIR_PASS(fold_batch_norm);
+
 namespace cinn {
 namespace hlir {
 
@@ -13,6 +20,22 @@ ir::Expr Builder::Build(Session *session, Network *net) {
 
   Graph graph;
   graph.Build(program, *session);
+  graph.set_output_names(net->output_names());
+
+  // Fold the weights at build time, the tensors folded away are not declared any more, and the temporary variables
+  // evaluated are declared as weights.
+  Optimizer<Graph> graph_optimizer({"fold_constants", "fold_batch_norm"});
+  graph_optimizer(&graph);
+  for (auto &name : graph.removed_tensors()) {
+    net->RemoveVar(name);
+  }
+  std::vector<std::string> folded;
+  for (auto &name : net->tmp_var_names()) {
+    if (session->GetTensor(name)->is_weight()) folded.push_back(name);
+  }
+  for (auto &name : folded) {
+    net->MarkWeight(name);
+  }
 
   for (Node &node : GraphTraits::TS(graph)) {
     if (node.is_op()) node.op->Compile();
@@ -22,8 +45,13 @@ ir::Expr Builder::Build(Session *session, Network *net) {
   auto fns = graph.PartitionFunctions();
   AutoFuseStages(&fns);
 
+  // Fold the initializations of the reductions such as the matmuls and the FC biases when the functions end their
+  // definitions.
+  bool eliminate_redundant_stages = GlobalContext().eliminate_redundant_stages();
+  GlobalContext().set_eliminate_redundant_stages(true);
   auto main_expr = graph.CompileExpr(&fns);
-  auto global_vars = DeclBuffersGlobal(session, *net);
+  GlobalContext().set_eliminate_redundant_stages(eliminate_redundant_stages);
+  auto global_vars = DeclBuffersGlobal(session, *net, fns);
 
   AddMainFnToProgram(&main_expr, CreateMainFn(main_expr));
   AddIOFnsToProgram(&main_expr, CreateLoadInputFns(*net, *session));
@@ -38,6 +66,7 @@ ir::Expr Builder::Build(Session *session, Network *net) {
 }
 
 Expr Builder::CreateExprForWeightDeclaration(const Session &session, const Network &network) {
+  if (!weights_file_.empty()) return CreateExprForMappedWeightDeclaration(session, network);
   std::vector<ir::Expr> exprs;
 
   exprs.push_back(ir::Mark::make("create weight buffers"));
@@ -48,7 +77,21 @@ Expr Builder::CreateExprForWeightDeclaration(const Session &session, const Netwo
     CHECK(tensor->ptype() != primitive_t::unk);
     Expr size(tensor->shape().num_bytes(tensor->ptype()));
     auto expr = ir::BufferOpr::make(target, size, ir::BufferOpr::Opr::kCreateAssign, tensor->ptype(), tensor->name());
-    expr.As<ir::BufferOpr>()->assigned_data.set<std::vector<float>>(tensor->buffer()->data<std::vector<float>>());
+    auto &assigned_data = expr.As<ir::BufferOpr>()->assigned_data;
+    switch (tensor->ptype()) {
+      case primitive_t::float32:
+        assigned_data.set<std::vector<float>>(tensor->buffer()->data<std::vector<float>>());
+        break;
+      case primitive_t::int8:
+        assigned_data.set<std::vector<int8_t>>(tensor->buffer()->data<std::vector<int8_t>>());
+        break;
+      case primitive_t::float16:
+      case primitive_t::bfloat16:
+        assigned_data.set<std::vector<uint16_t>>(tensor->buffer()->data<std::vector<uint16_t>>());
+        break;
+      default:
+        NOT_IMPLEMENT
+    }
     exprs.push_back(expr);
   }
 
@@ -56,7 +99,49 @@ Expr Builder::CreateExprForWeightDeclaration(const Session &session, const Netwo
   return block;
 }
 
-Expr Builder::CreateExprForInputOutputDeclaration(const Session &session, const Network &network) {
+Expr Builder::CreateExprForMappedWeightDeclaration(const Session &session, const Network &network) {
+  WeightsFile file;
+  for (auto &x : network.weight_names()) {
+    Tensor *tensor = session.GetTensor(x);
+    CHECK(tensor);
+    CHECK(tensor->ptype() != primitive_t::unk);
+    size_t size = tensor->shape().num_bytes(tensor->ptype());
+    switch (tensor->ptype()) {
+      case primitive_t::float32:
+        file.Add(x, tensor->ptype(), tensor->buffer()->data<std::vector<float>>().data(), size);
+        break;
+      case primitive_t::int8:
+        file.Add(x, tensor->ptype(), tensor->buffer()->data<std::vector<int8_t>>().data(), size);
+        break;
+      case primitive_t::float16:
+      case primitive_t::bfloat16:
+        file.Add(x, tensor->ptype(), tensor->buffer()->data<std::vector<uint16_t>>().data(), size);
+        break;
+      default:
+        NOT_IMPLEMENT
+    }
+  }
+  file.Plan();
+  LOG(INFO) << "write " << file.file_size() << " bytes of weights to " << weights_file_;
+  file.Write(weights_file_);
+
+  std::vector<ir::Expr> exprs;
+  exprs.push_back(ir::Mark::make("map weight buffers"));
+  // The file is larger than 2GB for the big networks, the sizes and the offsets in it are int64.
+  Expr file_size(static_cast<int64_t>(file.file_size()));
+  exprs.push_back(ir::BufferOpr::make_map_file(weights_file_, file_size, weights_name));
+  for (auto &x : network.weight_names()) {
+    Tensor *tensor = session.GetTensor(x);
+    Expr size(tensor->shape().num_bytes(tensor->ptype()));
+    Expr offset(static_cast<int64_t>(file.offset(x)));
+    exprs.push_back(ir::BufferOpr::make_in_arena(weights_name, offset, size, tensor->ptype(), tensor->name()));
+  }
+  return ir::Block::make(std::move(exprs));
+}
+
+Expr Builder::CreateExprForInputOutputDeclaration(const Session &session,
+                                                  const Network &network,
+                                                  const std::vector<Function> &fns) {
   std::vector<ir::Expr> exprs;
 
   auto create_tensor = [&](const std::string &name) {
@@ -78,22 +163,83 @@ Expr Builder::CreateExprForInputOutputDeclaration(const Session &session, const
     create_tensor(x);
   }
   exprs.push_back(ir::Mark::make("create temporary variable buffers"));
+  auto tmp_vars = CreateExprForTempVarDeclaration(session, network, fns);
+  exprs.insert(exprs.end(), tmp_vars.begin(), tmp_vars.end());
+
+  return ir::Block::make(std::move(exprs));
+}
+
+std::vector<Expr> Builder::CreateExprForTempVarDeclaration(const Session &session,
+                                                           const Network &network,
+                                                           const std::vector<Function> &fns) {
+  if (network.tmp_var_names().empty()) return {};
+
+  // Compute the live ranges of the temporary variables in the order of the functions.
+  const int forever = fns.size();
+  std::map<std::string, std::pair<int, int>> live_ranges;
+  for (auto &x : network.tmp_var_names()) live_ranges[x] = std::make_pair(forever, -1);
+
+  for (int i = 0; i < fns.size(); i++) {
+    for (auto &stage : fns[i].stages()) {
+      bool call_once = GlobalContext().once_call_registry().Contains(stage.name());
+      // The tensors are referenced by the elements, or passed to the runtime calls as a whole.
+      for (auto &expr : ir::CollectExprNode<ir::Tensor>(stage.expr())) {
+        auto *tensor = expr.As<ir::Tensor>();
+        auto it = live_ranges.find(tensor->name());
+        if (it == live_ranges.end()) continue;
+        if (call_once) {
+          it->second = std::make_pair(0, forever);
+        } else {
+          it->second.first = std::min(it->second.first, i);
+          it->second.second = std::max(it->second.second, i);
+        }
+      }
+    }
+  }
+
+  MemoryPlanner planner;
   for (auto &x : network.tmp_var_names()) {
-    create_tensor(x);
+    auto *tensor = session.GetTensor(x);
+    CHECK(tensor);
+    CHECK(tensor->ptype() != primitive_t::unk);
+    auto &range = live_ranges[x];
+    // Keep the variables not accessed by any function alive all the time, and all the variables in the calibration
+    // mode to read them after the run.
+    if (range.second < range.first || calibration_mode_) range = std::make_pair(0, forever);
+    planner.AddBuffer(x, tensor->shape().num_bytes(tensor->ptype()), range.first, range.second);
   }
+  planner.Plan();
+  LOG(INFO) << "temporary variables take " << planner.arena_size() << " bytes, " << planner.total_size()
+            << " bytes without memory reuse";
 
-  return ir::Block::make(std::move(exprs));
+  std::vector<Expr> exprs;
+  Target target;
+  Expr arena_size(static_cast<int>(planner.arena_size()));
+  exprs.push_back(ir::BufferOpr::make(target, arena_size, ir::BufferOpr::Opr::kCreate, primitive_t::uint8, arena_name));
+  for (auto &x : network.tmp_var_names()) {
+    auto *tensor = session.GetTensor(x);
+    Expr size(tensor->shape().num_bytes(tensor->ptype()));
+    Expr offset(static_cast<int>(planner.offset(x)));
+    exprs.push_back(ir::BufferOpr::make_in_arena(arena_name, offset, size, tensor->ptype(), tensor->name()));
+  }
+  return exprs;
 }
 
-void Builder::ToCSourceCode(ir::Expr expr, const std::string &prefix) {
+void Builder::ToCSourceCode(ir::Expr expr, const std::string &prefix, int num_shards) {
+  if (num_shards > 1) {
+    for (auto &path : backends::CompileAsShardedC(expr, prefix, num_shards)) {
+      LOG(INFO) << "output source file to " << path;
+    }
+    return;
+  }
   LOG(INFO) << "output header file to " << prefix + ".h";
   LOG(INFO) << "output source file to " << prefix + ".cc";
   backends::CompileAsC(expr, prefix + ".h", prefix + ".cc");
 }
 
-Expr Builder::DeclBuffersGlobal(Session *session, const Network &net) {
+Expr Builder::DeclBuffersGlobal(Session *session, const Network &net, const std::vector<Function> &fns) {
   std::vector<ir::Expr> exprs(
-      {CreateExprForWeightDeclaration(*session, net), CreateExprForInputOutputDeclaration(*session, net)});
+      {CreateExprForWeightDeclaration(*session, net), CreateExprForInputOutputDeclaration(*session, net, fns)});
   return ir::Block::make(std::move(exprs));
 }
 
@@ -118,7 +264,13 @@ Expr Builder::CreateLoadInputFns(const Network &net, const Session &session) {
 Expr Builder::CreateGetOutputFns(const Network &net, const Session &session) {
   std::vector<Expr> exprs;
   exprs.emplace_back(ir::Mark::make("functions for reading output data"));
-  for (auto &x : net.output_names()) {
+  std::vector<std::string> names(net.output_names().begin(), net.output_names().end());
+  if (calibration_mode_) {
+    for (auto &x : net.tmp_var_names()) {
+      if (session.GetTensor(x)->ptype() == primitive_t::float32) names.push_back(x);
+    }
+  }
+  for (auto &x : names) {
     std::string fn_name = StringFormat(read_fn_name_format, x.c_str());
     // cinn_copy(x_, x)
     auto ptype = session.GetTensor(x)->ptype();
@@ -174,6 +326,11 @@ void Builder::AutoFuseStages(std::vector<Function> *fns) {
     std::map<std::string, Stage *> pre_stages;
     CHECK(!fn->end_definition());
     for (auto &stage : fn->stages()) {
+      // The runtime calls split the stages into snippets, only the stages in the same snippet can be fused.
+      if (stage.type() != Stage::Type::polyhedral) {
+        pre_stages.clear();
+        continue;
+      }
       // check has dependency.
       for (auto &item : pre_stages) {
         if (TwoStagesHasDependency(stage, *item.second)) {
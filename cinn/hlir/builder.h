@@ -13,25 +13,62 @@ namespace hlir {
 
 class Builder {
  public:
-  //! Build a network.
+  /**
+   * Build a network. The weights in the session are folded in place and the network is compiled, so a network can only
+   * be built once.
+   */
   ir::Expr Build(Session* session, Network* net);
 
   /**
    * Transform an expression to C source code.
    * @param expr the expression
    * @prefix the prefix of the file to persist the content of the header and source file.
+   * @num_shards split the functions to this number of source files, so that they can be compiled in parallel, such as
+   * by `make -j`. The files are <prefix>.h, <prefix>_data.cc for the global data and <prefix>_<i>.cc for the functions,
+   * see CompileAsShardedC. 1 to write a single source file <prefix>.cc.
    */
-  void ToCSourceCode(ir::Expr expr, const std::string& prefix);
+  void ToCSourceCode(ir::Expr expr, const std::string& prefix, int num_shards = 1);
+
+  /**
+   * Build for the quantization calibration. Each float temporary variable gets its own memory and a reader function
+   * like the outputs, so that the intermediate tensors can be collected by a Calibrator after running a sample.
+   */
+  void set_calibration_mode(bool x = true) { calibration_mode_ = x; }
+  bool calibration_mode() const { return calibration_mode_; }
+
+  /**
+   * Write the weights to a file, see WeightsFile, and the generated code maps it when the program is loaded instead of
+   * embedding the weights as array literals. It keeps the source code small and fast to compile, and the weights can be
+   * updated without recompiling. The path is opened by the program as is, an absolute path is preferred. Only the C
+   * backend supports it.
+   */
+  void set_weights_file(const std::string& path) { weights_file_ = path; }
+  const std::string& weights_file() const { return weights_file_; }
 
  protected:
   /**
    * In CINN, declare all the buffers(as global variables).
    */
-  Expr DeclBuffersGlobal(Session* session, const Network& net);
+  Expr DeclBuffersGlobal(Session* session, const Network& net, const std::vector<Function>& fns);
 
  private:
   Expr CreateExprForWeightDeclaration(const Session& session, const Network& network);
-  Expr CreateExprForInputOutputDeclaration(const Session& session, const Network& network);
+  //! Declare the weights in the file mapped by the program.
+  Expr CreateExprForMappedWeightDeclaration(const Session& session, const Network& network);
+  Expr CreateExprForInputOutputDeclaration(const Session& session,
+                                           const Network& network,
+                                           const std::vector<Function>& fns);
+
+  /**
+   * Declare the temporary variables in a single memory arena, the ones not alive at the same time share the memory.
+   *
+   * The live range of a temporary variable is from the first function to the last function accessing it, the functions
+   * are called in the topological order of the graph. The temporary variables accessed by the call-once functions keep
+   * alive across the calls of main_, so they don't share memory with the others.
+   */
+  std::vector<Expr> CreateExprForTempVarDeclaration(const Session& session,
+                                                    const Network& network,
+                                                    const std::vector<Function>& fns);
 
   /**
    * Create the functions for loadding inputs data.
@@ -78,6 +115,11 @@ class Builder {
   const char* main_fn_name = "main_";
   const char* load_fn_name_format = "set_input_%s";
   const char* read_fn_name_format = "get_output_%s";
+  const char* arena_name = "cinn_arena";
+  const char* weights_name = "cinn_weights";
+
+  bool calibration_mode_{false};
+  std::string weights_file_;
 };
 
 }  // namespace hlir
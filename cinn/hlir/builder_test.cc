@@ -1,9 +1,14 @@
 #include "cinn/hlir/builder.h"
 #include <gtest/gtest.h>
+#include <unistd.h>
+#include <cstdio>
+#include <string>
 #include "cinn/backends/code_gen_c.h"
 #include "cinn/core/optimize/use_passes.h"
 #include "cinn/hlir/instruction_layer/use_ops.h"
 #include "cinn/hlir/network_test_util.h"
+#include "cinn/hlir/weights_file.h"
+#include "cinn/utils/string.h"
 
 namespace cinn {
 namespace hlir {
@@ -25,16 +30,19 @@ TEST(builder, weight) {
   auto program = gen.compiled_code();
   LOG(INFO) << std::endl << program << std::endl;
 
+  // The FC bias initializes the output tmp1 with the first product, the matmul result tmp0 is not written any more, and
+  // tmp1 is still written since it is an output of the network.
   std::string target = R"ROC(// create weight buffers
-cinn_float32_t b[] = {0.100000,0.200000};
-cinn_float32_t w0[] = {0.100000,0.200000,0.300000,0.400000,0.500000,0.600000,0.700000,0.800000};
+cinn_float32_t b[] __attribute__((aligned(64))) = {0.100000,0.200000};
+cinn_float32_t w0[] __attribute__((aligned(64))) = {0.100000,0.200000,0.300000,0.400000,0.500000,0.600000,0.700000,0.800000};
 // create input buffers
-cinn_float32_t* x0 =  (cinn_float32_t*) malloc(48);
+cinn_float32_t* x0 =  (cinn_float32_t*) aligned_alloc(64, 64);
 // create output buffers
-cinn_float32_t* tmp1 =  (cinn_float32_t*) malloc(24);
+cinn_float32_t* tmp1 =  (cinn_float32_t*) aligned_alloc(64, 64);
 // create temporary variable buffers
-cinn_float32_t* tmp0 =  (cinn_float32_t*) malloc(24);
-cinn_float32_t* tmp2 =  (cinn_float32_t*) malloc(24);
+cinn_uint8_t* cinn_arena =  (cinn_uint8_t*) aligned_alloc(64, 128);
+cinn_float32_t* tmp0 =  (cinn_float32_t*) (cinn_arena + 0);
+cinn_float32_t* tmp2 =  (cinn_float32_t*) (cinn_arena + 64);
 
 // functions for reading output data
 void get_output_tmp1 (cinn_float32_t* tmp1_) {
@@ -44,24 +52,84 @@ void get_output_tmp1 (cinn_float32_t* tmp1_) {
 void set_input_x0 (cinn_float32_t* x0_) {
   cinn_copy(x0_, x0, 48);
 }
-void func9 (cinn_float32_t* b, cinn_float32_t* w0, cinn_float32_t* x0, cinn_float32_t* tmp2) {
+void func9 (cinn_float32_t* b, cinn_float32_t* w0, cinn_float32_t* x0, cinn_float32_t* tmp1, cinn_float32_t* tmp2) {
   for (int c0 = 0; (c0 <= 2); c0 += 1) {
     for (int c1 = 0; (c1 <= 1); c1 += 1) {
-      tmp0[c0, c1] = 0;
-      for (int c2 = 0; (c2 <= 3); c2 += 1) {
-        tmp0[c0, c1] += (x0[c0, c2] * w0[c2, c1]);
+      tmp1[c0, c1] = (b[c1] + (x0[c0, 0] * w0[0, c1]));
+      for (int c2 = 1; (c2 <= 3); c2 += 1) {
+        tmp1[c0, c1] += (x0[c0, c2] * w0[c2, c1]);
       }
-      tmp1[c0, c1] = (tmp0[c0, c1] + b[c1]);
-      tmp2[c0, c1] = cinn_max(tmp1[c0, c1], 0);
+      tmp2[c0, c1] = tanh(tmp1[c0, c1]);
     }
   }
 }
 void main_ () {
-  func9(b, w0, x0, tmp2);
+  func9(b, w0, x0, tmp1, tmp2);
 })ROC";
 
   ASSERT_EQ(program, target);
 }
 
+TEST(builder, weights_file) {
+  SetGlobalContext(new CINNContext);
+
+  Session session;
+  Network net("tmp", &session);
+  Network1Builder net_builder;
+  net_builder.Build(&net, &session);
+
+  std::string path = StringFormat("/tmp/cinn_builder_weights_%d", static_cast<int>(getpid()));
+  Builder builder;
+  builder.set_weights_file(path);
+  auto expr = builder.Build(&session, &net);
+
+  backends::C_CodeGen gen;
+  gen.Print(expr);
+  auto program = gen.compiled_code();
+  LOG(INFO) << std::endl << program << std::endl;
+
+  auto file = WeightsFile::Read(path);
+  ASSERT_EQ(file.entries().size(), 2UL);
+  EXPECT_EQ(file.entry("b").data.size(), 2 * sizeof(float));
+  EXPECT_EQ(reinterpret_cast<const float*>(file.entry("w0").data.data())[7], 0.8f);
+
+  // The weights are views of the mapped file, no array literals in the code.
+  auto map_file = StringFormat("cinn_uint8_t* cinn_weights =  (cinn_uint8_t*) cinn_map_file(\"%s\", %s);",
+                               path.c_str(),
+                               std::to_string(file.file_size()).c_str());
+  auto weight = StringFormat("cinn_float32_t* w0 =  (cinn_float32_t*) (cinn_weights + %s);",
+                             std::to_string(file.offset("w0")).c_str());
+  EXPECT_NE(program.find(map_file), std::string::npos);
+  EXPECT_NE(program.find(weight), std::string::npos);
+  EXPECT_EQ(program.find("cinn_float32_t w0[]"), std::string::npos);
+
+  std::remove(path.c_str());
+}
+
+TEST(builder, parallel_compile) {
+  auto build = [](int compile_threads) {
+    SetGlobalContext(new CINNContext);
+    GlobalContext().set_compile_threads(compile_threads);
+
+    Session session;
+    Network net("tmp", &session);
+    Network2Builder net_builder(4);
+    net_builder.Build(&net, &session);
+
+    Builder builder;
+    auto expr = builder.Build(&session, &net);
+
+    backends::C_CodeGen gen;
+    gen.Print(expr);
+    return gen.compiled_code();
+  };
+
+  // The generated code is the same whatever the number of the threads is.
+  auto program = build(2);
+  LOG(INFO) << std::endl << program << std::endl;
+  EXPECT_EQ(program, build(4));
+  EXPECT_EQ(program, build(4));
+}
+
 }  // namespace hlir
 }  // namespace cinn
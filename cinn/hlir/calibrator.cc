@@ -0,0 +1,170 @@
+#include "cinn/hlir/calibrator.h"
+#include <glog/logging.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace cinn {
+namespace hlir {
+
+namespace {
+
+//! The number of the positive levels of the symmetric int8 quantization.
+const int kQuantLevels = 127;
+
+float ThresholdToScale(float threshold) { return threshold > 0.f ? threshold / kQuantLevels : 1.f; }
+
+}  // namespace
+
+Calibrator::Calibrator(Method method, int num_bins) : method_(method), num_bins_(num_bins) {
+  CHECK_GT(num_bins, 0);
+  CHECK_EQ(num_bins % (kQuantLevels + 1), 0) << "number of the bins should be a multiple of 128";
+}
+
+void Calibrator::Observe(const std::string &name, const float *data, size_t size) {
+  CHECK(data);
+  auto &histogram = histograms_[name];
+  if (histogram.bins.empty()) histogram.bins.assign(num_bins_, 0.);
+
+  float abs_max = 0.f;
+  for (size_t i = 0; i < size; i++) abs_max = std::max(abs_max, std::abs(data[i]));
+  histogram.abs_max = std::max(histogram.abs_max, abs_max);
+  if (abs_max == 0.f) {
+    histogram.bins[0] += size;
+    return;
+  }
+  Extend(&histogram, abs_max);
+
+  const float bin_width = histogram.range / num_bins_;
+  for (size_t i = 0; i < size; i++) {
+    int bin = std::min(static_cast<int>(std::abs(data[i]) / bin_width), num_bins_ - 1);
+    histogram.bins[bin] += 1.;
+  }
+}
+
+void Calibrator::Extend(Histogram *histogram, float abs_max) const {
+  if (histogram->range == 0.f) {
+    // All the values observed are zeros, they stay in the first bin whatever the range is.
+    histogram->range = abs_max;
+    return;
+  }
+  while (histogram->range < abs_max) {
+    auto &bins = histogram->bins;
+    for (int i = 0; i < num_bins_ / 2; i++) bins[i] = bins[2 * i] + bins[2 * i + 1];
+    std::fill(bins.begin() + num_bins_ / 2, bins.end(), 0.);
+    histogram->range *= 2;
+  }
+}
+
+float Calibrator::KLThreshold(const Histogram &histogram) const {
+  const auto &bins = histogram.bins;
+  const int levels = kQuantLevels + 1;
+  const double eps = 1e-10;
+
+  // Sum of the bins out of the threshold, they are clipped to the last bin.
+  std::vector<double> suffix_sum(num_bins_ + 1, 0.);
+  for (int i = num_bins_ - 1; i >= 0; i--) suffix_sum[i] = suffix_sum[i + 1] + bins[i];
+  if (suffix_sum[0] == 0.) return histogram.abs_max;
+
+  int best = num_bins_;
+  double min_divergence = std::numeric_limits<double>::max();
+  std::vector<double> reference, candidate;
+  for (int i = levels; i <= num_bins_; i++) {
+    reference.assign(bins.begin(), bins.begin() + i);
+    reference[i - 1] += suffix_sum[i];
+
+    // Merge the bins to the quantization levels, and expand them back over the non-empty bins.
+    candidate.assign(i, 0.);
+    for (int level = 0; level < levels; level++) {
+      int begin = level * i / levels;
+      int end = (level + 1) * i / levels;
+      double total = 0.;
+      int non_empty = 0;
+      for (int b = begin; b < end; b++) {
+        total += bins[b];
+        if (bins[b] > 0.) non_empty++;
+      }
+      if (non_empty == 0) continue;
+      for (int b = begin; b < end; b++) {
+        if (bins[b] > 0.) candidate[b] = total / non_empty;
+      }
+    }
+
+    double reference_sum = suffix_sum[0];
+    double candidate_sum = 0.;
+    for (double x : candidate) candidate_sum += x;
+
+    double divergence = 0.;
+    for (int b = 0; b < i; b++) {
+      if (reference[b] == 0.) continue;
+      double p = reference[b] / reference_sum;
+      double q = candidate_sum > 0. ? candidate[b] / candidate_sum : 0.;
+      divergence += p * std::log(p / std::max(q, eps));
+    }
+
+    if (divergence < min_divergence) {
+      min_divergence = divergence;
+      best = i;
+    }
+  }
+
+  return std::min(histogram.abs_max, best * histogram.range / num_bins_);
+}
+
+const Calibrator::Histogram &Calibrator::GetHistogram(const std::string &name) const {
+  auto it = histograms_.find(name);
+  CHECK(it != histograms_.end()) << "tensor " << name << " is not observed";
+  return it->second;
+}
+
+float Calibrator::Scale(const std::string &name) const {
+  const auto &histogram = GetHistogram(name);
+  switch (method_) {
+    case Method::kMinMax:
+      return ThresholdToScale(histogram.abs_max);
+    case Method::kKL:
+      return ThresholdToScale(KLThreshold(histogram));
+    default:
+      LOG(FATAL) << "unknown calibration method";
+  }
+  return 1.f;
+}
+
+std::map<std::string, float> Calibrator::Scales() const {
+  std::map<std::string, float> result;
+  for (auto &item : histograms_) result[item.first] = Scale(item.first);
+  return result;
+}
+
+float Calibrator::abs_max(const std::string &name) const { return GetHistogram(name).abs_max; }
+
+std::vector<int8_t> QuantizeWeightPerChannel(const std::vector<float> &w, int k, int n, std::vector<float> *scales) {
+  CHECK_EQ(w.size(), static_cast<size_t>(k) * n);
+  CHECK(scales);
+  scales->assign(n, 0.f);
+  for (int i = 0; i < k; i++) {
+    for (int j = 0; j < n; j++) (*scales)[j] = std::max((*scales)[j], std::abs(w[i * n + j]));
+  }
+  for (auto &scale : *scales) scale = ThresholdToScale(scale);
+
+  std::vector<int8_t> result(w.size());
+  for (int j = 0; j < n; j++) {
+    for (int i = 0; i < k; i++) {
+      float q = std::round(w[i * n + j] / (*scales)[j]);
+      result[j * k + i] = static_cast<int8_t>(std::min(std::max(q, -1.f * kQuantLevels), 1.f * kQuantLevels));
+    }
+  }
+  return result;
+}
+
+float QuantizationError(const float *expected, const float *actual, size_t size) {
+  double diff = 0., norm = 0.;
+  for (size_t i = 0; i < size; i++) {
+    diff += (expected[i] - actual[i]) * (expected[i] - actual[i]);
+    norm += expected[i] * expected[i];
+  }
+  return norm > 0. ? std::sqrt(diff / norm) : std::sqrt(diff);
+}
+
+}  // namespace hlir
+}  // namespace cinn
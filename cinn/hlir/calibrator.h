@@ -0,0 +1,92 @@
+#pragma once
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace cinn {
+namespace hlir {
+
+/**
+ * Calibrator collects the statistics of the float tensors over a set of sample inputs, and computes the scales to
+ * quantize them to int8 symmetrically, that is `x = q * scale` with q in [-127, 127].
+ *
+ * Usage:
+ *
+ *     Calibrator calibrator(Calibrator::Method::kKL);
+ *     for (auto& sample : samples) {
+ *       // run the float model built in calibration mode, and read the intermediate tensors.
+ *       calibrator.Observe("tmp0", tmp0.data(), tmp0.size());
+ *     }
+ *     network.QuantizeMatMuls(calibrator.Scales());
+ *
+ * Two methods are supported:
+ *
+ * - kMinMax: the threshold is the max absolute value, no value is clipped.
+ * - kKL: the threshold minimizes the KL divergence between the distribution of the absolute values and its quantized
+ *   version, the outliers are clipped to make the common values more precise.
+ */
+class Calibrator {
+ public:
+  enum class Method {
+    kMinMax = 0,
+    kKL,
+  };
+
+  /**
+   * @param method the method to compute the thresholds.
+   * @param num_bins number of the histogram bins used by kKL, should be a multiple of 128.
+   */
+  explicit Calibrator(Method method = Method::kKL, int num_bins = 2048);
+
+  //! Collect the values of a tensor in a sample.
+  void Observe(const std::string& name, const float* data, size_t size);
+
+  //! Get the quantization scale of a tensor.
+  float Scale(const std::string& name) const;
+
+  //! Get the quantization scales of all the observed tensors.
+  std::map<std::string, float> Scales() const;
+
+  //! Get the max absolute value of a tensor observed.
+  float abs_max(const std::string& name) const;
+
+ private:
+  //! The histogram of the absolute values in [0, range).
+  struct Histogram {
+    std::vector<double> bins;
+    float range{0.f};
+    float abs_max{0.f};
+  };
+
+  //! Double the range of the histogram by merging the adjacent bins, until it covers `abs_max`.
+  void Extend(Histogram* histogram, float abs_max) const;
+
+  //! Compute the threshold with the minimum KL divergence.
+  float KLThreshold(const Histogram& histogram) const;
+
+  const Histogram& GetHistogram(const std::string& name) const;
+
+  Method method_;
+  int num_bins_;
+  std::map<std::string, Histogram> histograms_;
+};
+
+/**
+ * Compute the per output channel scales of a weight in layout [K, N], and quantize it to int8 in the transposed layout
+ * [N, K].
+ * @param w the float weight.
+ * @param k the number of input channels.
+ * @param n the number of output channels.
+ * @param scales the scales of the output channels.
+ * @return the quantized weight.
+ */
+std::vector<int8_t> QuantizeWeightPerChannel(const std::vector<float>& w, int k, int n, std::vector<float>* scales);
+
+/**
+ * The relative L2 error of the output of a quantized build, used to compare it with the float build.
+ */
+float QuantizationError(const float* expected, const float* actual, size_t size);
+
+}  // namespace hlir
+}  // namespace cinn
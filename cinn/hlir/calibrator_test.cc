@@ -0,0 +1,70 @@
+#include "cinn/hlir/calibrator.h"
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+#include <cmath>
+
+namespace cinn {
+namespace hlir {
+
+TEST(Calibrator, min_max) {
+  Calibrator calibrator(Calibrator::Method::kMinMax);
+  std::vector<float> sample0({-2.f, 1.f, 0.5f});
+  std::vector<float> sample1({0.f, 3.f, -1.f});
+  calibrator.Observe("x", sample0.data(), sample0.size());
+  EXPECT_FLOAT_EQ(calibrator.Scale("x"), 2.f / 127);
+  calibrator.Observe("x", sample1.data(), sample1.size());
+  EXPECT_FLOAT_EQ(calibrator.Scale("x"), 3.f / 127);
+  EXPECT_EQ(calibrator.Scales().size(), 1UL);
+}
+
+TEST(Calibrator, kl) {
+  Calibrator calibrator(Calibrator::Method::kKL);
+  // Bell shaped values in [-2, 2] with a few outliers, the outliers should be clipped.
+  std::vector<float> sample;
+  unsigned seed = 1;
+  for (int i = 0; i < 20000; i++) {
+    float x = 0.f;
+    for (int j = 0; j < 4; j++) {
+      seed = seed * 1103515245 + 12345;
+      x += ((seed >> 8) % 10001) / 10000.f - 0.5f;
+    }
+    sample.push_back(x);
+  }
+  sample.push_back(50.f);
+  sample.push_back(-80.f);
+
+  calibrator.Observe("x", sample.data(), sample.size() / 2);
+  calibrator.Observe("x", sample.data() + sample.size() / 2, sample.size() - sample.size() / 2);
+  EXPECT_FLOAT_EQ(calibrator.abs_max("x"), 80.f);
+
+  float threshold = calibrator.Scale("x") * 127;
+  LOG(INFO) << "threshold: " << threshold;
+  EXPECT_GT(threshold, 0.9f);
+  EXPECT_LT(threshold, 10.f);
+}
+
+TEST(Calibrator, quantize_weight) {
+  // w in layout [K=2, N=3]
+  std::vector<float> w({1.f, -0.5f, 0.f,  //
+                        -2.f, 0.25f, 0.f});
+  std::vector<float> scales;
+  auto q = QuantizeWeightPerChannel(w, 2, 3, &scales);
+  ASSERT_EQ(scales.size(), 3UL);
+  EXPECT_FLOAT_EQ(scales[0], 2.f / 127);
+  EXPECT_FLOAT_EQ(scales[1], 0.5f / 127);
+  EXPECT_FLOAT_EQ(scales[2], 1.f);
+
+  // transposed to [N, K]
+  std::vector<int8_t> target({64, -127, -127, 64, 0, 0});
+  EXPECT_EQ(q, target);
+
+  std::vector<float> restored;
+  for (int j = 0; j < 3; j++) {
+    for (int i = 0; i < 2; i++) restored.push_back(q[j * 2 + i] * scales[j]);
+  }
+  std::vector<float> expected({1.f, -2.f, -0.5f, 0.25f, 0.f, 0.f});
+  EXPECT_LT(QuantizationError(expected.data(), restored.data(), expected.size()), 0.01f);
+}
+
+}  // namespace hlir
+}  // namespace cinn
@@ -3,11 +3,57 @@
 #include "cinn/backends/code_gen_c.h"
 #include "cinn/hlir/graph_util.h"
 #include "cinn/ir/ir_helper.h"
+#include "cinn/utils/isl_utils.h"
 #include "cinn/utils/logging.h"
+#include "cinn/utils/parallel.h"
 
 namespace cinn {
 namespace hlir {
 
+namespace {
+
+/**
+ * End the definitions of the functions, on `GlobalContext().compile_threads()` threads.
+ *
+ * A function is compiled in an isl context taken from the pool of IslContextScope, so the threads don't share a
+ * context and the contexts are reused by the later builds. The stages of a function are moved to that context, and
+ * moved back after all the functions are compiled since the tensors of the graph share them. The function and its
+ * ir::Function hold the context for their isl objects, so no other scope takes it until they are freed. The names
+ * created by a function are prefixed with the function name, so the generated code does not depend on the order the
+ * threads run.
+ *
+ * The stages are created and registered to the generator of the global context before, EndDefinition only looks them
+ * up, the generator guards them with a mutex anyway.
+ */
+void EndDefinitions(std::vector<Function>* fns) {
+  int num_threads = std::min<int>(GlobalContext().compile_threads(), fns->size());
+  if (num_threads <= 1) {
+    for (auto& fn : *fns) fn.EndDefinition();
+    return;
+  }
+
+  // The stages are created in the isl context of the current thread, move them back after compiled.
+  std::vector<isl_ctx*> origin_ctxs;
+  for (auto& fn : *fns) {
+    CHECK(!fn.stages().empty());
+    origin_ctxs.push_back(fn.stages().front().ctx());
+  }
+
+  ParallelFor(fns->size(), num_threads, [&](int i) {
+    Function& fn = (*fns)[i];
+    NameScope scope(fn.name() + "_");
+    isl_utils::IslContextScope ctx_scope;
+    fn.SwitchIslContext(ctx_scope.holder());
+    fn.EndDefinition();
+  });
+
+  for (size_t i = 0; i < fns->size(); i++) {
+    for (auto& stage : (*fns)[i].stages()) stage.SwitchIslContext(origin_ctxs[i]);
+  }
+}
+
+}  // namespace
+
 static int node_count = 0;
 
 void Graph::Build(const Program& program, const Session& session) {
@@ -90,6 +136,20 @@ void Graph::NewTensorNode(const std::string& name) {
   vars_[name] = var_node;
 }
 
+void Graph::RemoveNode(Node* node) {
+  for (auto* x : node->inlinks) x->outlinks.remove(node);
+  for (auto* x : node->outlinks) x->inlinks.remove(node);
+  if (node->is_tensor()) {
+    vars_.erase(node->name);
+    removed_tensors_.insert(node->name);
+  }
+
+  auto it = std::find_if(
+      nodes_.begin(), nodes_.end(), [&](const std::unique_ptr<Node>& x) { return x.get() == node; });
+  CHECK(it != nodes_.end()) << "node " << node->name << " is not in the graph";
+  nodes_.erase(it);
+}
+
 std::set<const Node*> Graph::Inputs() const {
   std::set<const Node*> result;
   for (auto& node : nodes()) {
@@ -154,7 +214,13 @@ std::vector<Function> Graph::PartitionFunctions() {
   LOG_INDENT(0);
 
   std::vector<ir::Expr> fn_inputs = SortInputsOrOutputs(Inputs());
-  std::vector<ir::Expr> fn_outputs = SortInputsOrOutputs(Outputs());
+  // The outputs of the network consumed by other operators are still outputs of the functions.
+  std::set<Node*> fn_output_nodes = Outputs();
+  for (auto& name : output_names_) {
+    auto it = vars_.find(name);
+    if (it != vars_.end()) fn_output_nodes.insert(it->second);
+  }
+  std::vector<ir::Expr> fn_outputs = SortInputsOrOutputs(fn_output_nodes);
 
   CINN_DEBUG(1) << "inputs.size " << fn_inputs.size();
   CINN_DEBUG(1) << "outputs.size " << fn_outputs.size();
@@ -243,9 +309,7 @@ void Graph::Compile(bool finalize_function) {
   auto fns = PartitionFunctions();
 
   CHECK(!fns.empty());
-  for (auto& fn : fns) {
-    fn.EndDefinition();
-  }
+  EndDefinitions(&fns);
 
   std::vector<ir::Expr> exprs;
   std::transform(fns.begin(), fns.end(), std::back_inserter(exprs), [](const Function& x) { return x.ir_function(); });
@@ -258,9 +322,7 @@ Expr Graph::CompileExpr(std::vector<Function>* fns) {
   LOG_INDENT(0);
   CINN_DEBUG(2) << "fns.size " << fns->size();
   CHECK(!fns->empty());
-  for (auto& fn : *fns) {
-    fn.EndDefinition();
-  }
+  EndDefinitions(fns);
 
   AllocateBuffersForTempVars();
 
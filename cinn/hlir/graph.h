@@ -133,6 +133,22 @@ class Graph {
 
   ArgumentRegistry& arguments() { return arguments_; }
 
+  /**
+   * Remove a node and all its links, used by the graph optimizations before the operators are compiled.
+   * @param node the node, the names of the tensor nodes removed are recorded in removed_tensors.
+   */
+  void RemoveNode(Node* node);
+
+  //! Names of the tensors removed from the graph, the network shouldn't declare them any more.
+  const std::set<std::string>& removed_tensors() const { return removed_tensors_; }
+
+  /**
+   * Set the tensors declared as the outputs of the network. They are read after the run even if other operators consume
+   * them, so the optimizations should keep them written.
+   */
+  void set_output_names(const std::set<std::string>& names) { output_names_ = names; }
+  const std::set<std::string>& output_names() const { return output_names_; }
+
   /**
    * Partition the graph and generate functions.
    */
@@ -151,6 +167,8 @@ class Graph {
   const Program* program_;
   const Session* session_;
   ArgumentRegistry arguments_;
+  std::set<std::string> removed_tensors_;
+  std::set<std::string> output_names_;
 };
 
 /**
@@ -107,5 +107,16 @@ Node *NodesTSIterator::operator->() {
   return sorted_[cursor_];
 }
 
+Node *GetInputNode(Node *op_node, const std::string &argument) {
+  CHECK(op_node->is_op());
+  auto it = op_node->op->inputs().find(argument);
+  if (it == op_node->op->inputs().end()) return nullptr;
+  for (auto *x : op_node->inlinks) {
+    if (x->name == it->second) return x;
+  }
+  LOG(FATAL) << "the input " << it->second << " of " << op_node->name << " is not linked";
+  return nullptr;
+}
+
 }  // namespace hlir
 }  // namespace cinn
@@ -3,6 +3,7 @@
 #include <map>
 #include <set>
 #include <stack>
+#include <string>
 #include <utility>
 #include <vector>
 #include "cinn/hlir/graph.h"
@@ -103,5 +104,13 @@ struct GraphTraits {
   }
 };
 
+/**
+ * Get the tensor node of an input argument of an operator node.
+ * @param op_node the operator node.
+ * @param argument the argument, such as "X".
+ * @return the tensor node, nullptr if the argument is not set.
+ */
+Node *GetInputNode(Node *op_node, const std::string &argument);
+
 }  // namespace hlir
 }  // namespace cinn
@@ -41,7 +41,7 @@ class Tanh : public ActivationBase {
 
     CHECK_EQ(input0->shape().size(), output0.shape().size());
     output0.AddStage(  //
-        output0.Elem().Assign(Max_(input0->Elem(), Expr(0.f))));
+        output0.Elem().Assign(Tanh_(input0->Elem())));
   }
 };
 
@@ -53,7 +53,7 @@ class Sigmoid : public ActivationBase {
   void CompileImpl() override {
     auto* input0 = GetInput("X");
     auto& output0 = GetOutput("Out");
-    output0.AddStage(output0.Elem().Assign(Expr(1.f) / (Expr(1.f) + Exp_(input0->Elem() * -1.f))));
+    output0.AddStage(output0.Elem().Assign(Sigmoid_(input0->Elem())));
   }
 };
 
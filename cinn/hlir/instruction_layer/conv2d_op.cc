@@ -1,24 +1,545 @@
 #include "cinn/hlir/instruction_layer/conv2d_op.h"
+#include <algorithm>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+#include "cinn/core/cinn_context.h"
 #include "cinn/core/function.h"
 #include "cinn/hlir/op_registry.h"
 #include "cinn/hlir/operator.h"
 #include "cinn/ir/ir.h"
 #include "cinn/ir/ir_printer.h"
+#include "cinn/ir/ops_overload.h"
 #include "cinn/utils/logging.h"
+#include "cinn/utils/string.h"
 
 namespace cinn {
 namespace hlir {
 namespace instruction_layer {
 
+namespace {
+
+//! The columns of im2col larger than this are not materialized, the direct convolution is used instead.
+const size_t kIm2ColMaxBytes = 32 * 1024 * 1024;
+
+//! The max sizes of the blocks of the accumulation, a block of the output is 8 channels x 4 rows x 64 columns for
+//! NCHW, or 4 rows x 8 columns x all the channels for NHWC, so that it stays in the L1 cache.
+const int kChannelBlock = 8;
+const int kRowBlock = 4;
+const int kColumnBlock = 64;
+const int kNHWCColumnBlock = 8;
+
+//! The tiles of Winograd are padded to a multiple of the widest vector, so that the GEMMs are always vectorized.
+const int kWinogradTileAlign = 8;
+
+//! `x * factor`, without multiplying 1 to keep the index simple.
+Expr Scale(Expr x, int factor) { return factor == 1 ? x : x * Expr(factor); }
+
+/**
+ * The largest divisor of `extent` not larger than `max_size` and a multiple of `multiple`, so that the blocks have no
+ * remainder and the vectorized loop still has a multiple of the vector width iterations. The extent itself if it is
+ * not larger than `max_size` or no such divisor.
+ */
+int BlockSize(int extent, int max_size, int multiple = 1) {
+  if (extent <= max_size) return extent;
+  for (int size = max_size - max_size % multiple; size >= multiple; size -= multiple) {
+    if (extent % size == 0) return size;
+  }
+  return extent;
+}
+
+/**
+ * A loop of `extent` iterations split to the blocks of `size` iterations, the iterator is `outer * size + inner`. The
+ * outer loop is dropped if there is only one block.
+ */
+struct LoopBlock {
+  LoopBlock(int extent, int size) : extent(extent), size(size) { CHECK_EQ(extent % size, 0); }
+
+  bool blocked() const { return size < extent; }
+  Expr value() const { return blocked() ? Scale(outer, size) + inner : Expr(inner); }
+
+  //! Bound the iterators explicitly, they appear in the references only combined with the other ones.
+  void Bound(Stage* stage) const {
+    stage->SetCond(inner, ">= 0");
+    stage->SetCond(inner, StringFormat("< %d", size));
+    if (blocked()) {
+      stage->SetCond(outer, ">= 0");
+      stage->SetCond(outer, StringFormat("< %d", extent / size));
+    }
+  }
+
+  int extent;
+  int size;
+  ir::Var outer;
+  ir::Var inner;
+};
+
+//! The offset of an element in a group, `group * extent + x`, or `x` if there is only one group.
+Expr GroupOffset(Expr group, int extent, Expr x, int groups) { return groups == 1 ? x : group * Expr(extent) + x; }
+
+/**
+ * The transforms of Winograd F(m x m, 3 x 3) with the tile m, from "Fast Algorithms for Convolutional Neural Networks"
+ * by Lavin and Gray. The filter transform G has fractions, it is stored as integers with a divisor of each row, so that
+ * the constants in the generated code are exact.
+ */
+struct WinogradMatrices {
+  //! The input transform, alpha x alpha where alpha = m + 2.
+  std::vector<std::vector<int>> Bt;
+  //! The filter transform multiplied by the divisors of the rows, alpha x 3.
+  std::vector<std::vector<int>> G;
+  std::vector<int> G_divisors;
+  //! The output transform, m x alpha.
+  std::vector<std::vector<int>> At;
+};
+
+const WinogradMatrices& GetWinogradMatrices(int tile) {
+  static const WinogradMatrices f2{{{1, 0, -1, 0}, {0, 1, 1, 0}, {0, -1, 1, 0}, {0, 1, 0, -1}},
+                                   {{1, 0, 0}, {1, 1, 1}, {1, -1, 1}, {0, 0, 1}},
+                                   {1, 2, 2, 1},
+                                   {{1, 1, 1, 0}, {0, 1, -1, -1}}};
+  static const WinogradMatrices f4{{{4, 0, -5, 0, 1, 0},
+                                    {0, -4, -4, 1, 1, 0},
+                                    {0, 4, -4, -1, 1, 0},
+                                    {0, -2, -1, 2, 1, 0},
+                                    {0, 2, -1, -2, 1, 0},
+                                    {0, 4, 0, -5, 0, 1}},
+                                   {{1, 0, 0}, {-1, -1, -1}, {-1, 1, -1}, {1, 2, 4}, {1, -2, 4}, {0, 0, 1}},
+                                   {4, 6, 6, 24, 24, 1},
+                                   {{1, 1, 1, 1, 1, 0},  //
+                                    {0, 1, -1, 2, -2, 0},
+                                    {0, 1, 1, 4, 4, 0},
+                                    {0, 1, -1, 8, -8, 1}}};
+  CHECK(tile == 2 || tile == 4) << "Winograd only supports the tile 2 or 4, got " << tile;
+  return tile == 2 ? f2 : f4;
+}
+
+//! The sum of `coefficient * x` of the terms, the zero coefficients are skipped and the signs are folded.
+Expr LinearCombination(const std::vector<std::pair<int, Expr>>& terms) {
+  Expr sum;
+  for (auto& term : terms) {
+    if (term.first == 0) continue;
+    int magnitude = std::abs(term.first);
+    Expr x = magnitude == 1 ? term.second : Expr(static_cast<float>(magnitude)) * term.second;
+    if (!sum.valid()) {
+      sum = term.first > 0 ? x : Expr(0.f) - x;
+    } else {
+      sum = term.first > 0 ? sum + x : sum - x;
+    }
+  }
+  CHECK(sum.valid()) << "all the coefficients are zero";
+  return sum;
+}
+
+int OutputSize(int input, int kernel, int stride, int padding, int dilation) {
+  int size = (input + 2 * padding - dilation * (kernel - 1) - 1) / stride + 1;
+  CHECK_GT(size, 0) << "the kernel is larger than the padded input";
+  return size;
+}
+
+}  // namespace
+
+Conv2dParam::Algorithm Conv2dSelectAlgorithm(const Conv2dParam& param,
+                                             const std::vector<int>& out_shape,
+                                             size_t columns_bytes) {
+  using Algorithm = Conv2dParam::Algorithm;
+  if (param.algorithm != Algorithm::kAuto) return param.algorithm;
+  // The output channels of NHWC are contiguous in both the output and the filter, im2col doesn't help.
+  if (param.layout == Conv2dParam::Layout::kNHWC) return Algorithm::kDirect;
+  bool direct_vectorizable = param.strides[1] == 1 && VectorWidth(out_shape[3]) > 0;
+  if (direct_vectorizable || param.columns.empty() || columns_bytes > kIm2ColMaxBytes) return Algorithm::kDirect;
+  return Algorithm::kIm2Col;
+}
+
+bool Conv2dWinogradApplicable(const Conv2dParam& param, const std::vector<int>& w_shape) {
+  return param.layout == Conv2dParam::Layout::kNCHW && w_shape[2] == 3 && w_shape[3] == 3 &&  //
+         param.strides[0] == 1 && param.strides[1] == 1 && param.dilations[0] == 1 && param.dilations[1] == 1 &&
+         param.groups == 1;
+}
+
+std::vector<Conv2dParam::Algorithm> Conv2dCandidateAlgorithms(const Conv2dParam& param,
+                                                              const std::vector<int>& w_shape) {
+  using Algorithm = Conv2dParam::Algorithm;
+  std::vector<Algorithm> algorithms({Algorithm::kDirect, Algorithm::kIm2Col});
+  if (Conv2dWinogradApplicable(param, w_shape)) algorithms.push_back(Algorithm::kWinograd);
+  return algorithms;
+}
+
+/**
+ * The 2D convolution.
+ *
+ * It is lowered to the stages
+ *
+ * 1. pad the input to the padded temporary variable if any padding is not zero, so that the accumulation loops are
+ *    rectangular,
+ * 2. unfold the patches of the input to the columns if the algorithm is im2col,
+ * 3. initialize the output with the bias or zero,
+ * 4. accumulate the products of the input, or the columns, and the filter.
+ *
+ * The accumulation is blocked on the output, the loops over the blocks are outside, then the reduction loops, then the
+ * loops in a block, so that a block of the output stays in the cache while the reduction runs, and a row of the input
+ * is reused by all the output channels of the block. The block is 8 channels x 4 rows x up to 64 columns for NCHW, or 4
+ * rows x 8 columns x all the channels for NHWC. im2col takes the same blocked accumulation, it is the GEMM of the
+ * filter and the columns blocked on both the output channels and the output pixels. The innermost loop, the columns
+ * for NCHW or the channels for NHWC, is vectorized if its extent is a multiple of the vector width.
+ *
+ * The Winograd algorithm is lowered differently, see CompileWinograd.
+ */
 class Conv2d : public Operator {
  public:
+  using Layout = Conv2dParam::Layout;
+  using Algorithm = Conv2dParam::Algorithm;
+
   Conv2d() : Operator("conv2d", HlirLayer::kInstructionWise, nullptr) { param_.set(Conv2dParam()); }
 
+ protected:
+  void InferenceOutputType() override {
+    const auto* x = GetInput("X");
+    const auto* w = GetInput("W");
+    const auto* b = GetInput("B");
+    auto& output0 = GetOutput("Out");
+    auto& the_param = param<Conv2dParam>();
+
+    CHECK_EQ(x->ptype(), primitive_t::float32);
+    CHECK_EQ(w->ptype(), primitive_t::float32);
+    if (b) CHECK_EQ(b->ptype(), primitive_t::float32);
+    output0.set_ptype(x->ptype());
+    const bool winograd = the_param.algorithm == Algorithm::kWinograd;
+    if (the_param.has_padding() || winograd) padded()->set_ptype(x->ptype());
+    if (!the_param.columns.empty()) columns()->set_ptype(x->ptype());
+    if (winograd) {
+      winograd_filter()->set_ptype(x->ptype());
+      winograd_input()->set_ptype(x->ptype());
+      winograd_product()->set_ptype(x->ptype());
+    }
+  }
+
   void Resize() override {
-    auto& input0 = GetInput("X");
+    const auto* x = GetInput("X");
+    const auto* w = GetInput("W");
+    const auto* b = GetInput("B");
     auto& output0 = GetOutput("Out");
     auto& the_param = param<Conv2dParam>();
+
+    CHECK_EQ(the_param.strides.size(), 2UL);
+    CHECK_EQ(the_param.paddings.size(), 2UL);
+    CHECK_EQ(the_param.dilations.size(), 2UL);
+    for (int i = 0; i < 2; i++) {
+      CHECK_GT(the_param.strides[i], 0);
+      CHECK_GE(the_param.paddings[i], 0);
+      CHECK_GT(the_param.dilations[i], 0);
+    }
+    CHECK_EQ(x->shape().size(), 4UL);
+    CHECK_EQ(w->shape().size(), 4UL);
+
+    const bool nchw = the_param.layout == Layout::kNCHW;
+    const int groups = the_param.groups;
+    const int N = x->shape()[0];
+    const int C = nchw ? x->shape()[1] : x->shape()[3];
+    const int H = nchw ? x->shape()[2] : x->shape()[1];
+    const int W = nchw ? x->shape()[3] : x->shape()[2];
+    const int M = nchw ? w->shape()[0] : w->shape()[3];
+    const int KH = nchw ? w->shape()[2] : w->shape()[0];
+    const int KW = nchw ? w->shape()[3] : w->shape()[1];
+    const int filter_channels = nchw ? w->shape()[1] : w->shape()[2];
+
+    CHECK_GT(groups, 0);
+    CHECK_EQ(C % groups, 0) << "input channels " << C << " can't be divided to " << groups << " groups";
+    CHECK_EQ(M % groups, 0) << "output channels " << M << " can't be divided to " << groups << " groups";
+    CHECK_EQ(filter_channels, C / groups) << "the filter doesn't match the input channels";
+    if (b) {
+      CHECK_EQ(b->shape().size(), 1UL);
+      CHECK_EQ(b->shape()[0], M);
+    }
+
+    const int OH = OutputSize(H, KH, the_param.strides[0], the_param.paddings[0], the_param.dilations[0]);
+    const int OW = OutputSize(W, KW, the_param.strides[1], the_param.paddings[1], the_param.dilations[1]);
+    output0.set_shape(nchw ? std::vector<int>({N, M, OH, OW}) : std::vector<int>({N, OH, OW, M}));
+
+    std::vector<int> columns_shape =
+        nchw ? std::vector<int>({N, C, KH, KW, OH, OW}) : std::vector<int>({N, OH, OW, KH, KW, C});
+    algorithm_ = Conv2dSelectAlgorithm(
+        the_param, output0.shape().data, Shape(columns_shape).num_bytes(primitive_t::float32));
+    CINN_DEBUG(2) << "conv2d algorithm: " << static_cast<int>(algorithm_);
+
+    if (algorithm_ == Algorithm::kWinograd) {
+      CHECK(Conv2dWinogradApplicable(the_param, w->shape().data)) << "Winograd doesn't apply to the convolution";
+      const int tile = the_param.winograd_tile;
+      const int alpha = tile + 2;
+      // The padded input covers all the tiles, the tiles of the output beyond the borders are computed and dropped.
+      const int TH = (OH + tile - 1) / tile;
+      const int TW = (OW + tile - 1) / tile;
+      // The padded tiles are zeros, their products are computed and dropped.
+      const int P = (N * TH * TW + kWinogradTileAlign - 1) / kWinogradTileAlign * kWinogradTileAlign;
+      padded()->set_shape(std::vector<int>({N, C, TH * tile + 2, TW * tile + 2}));
+      winograd_filter()->set_shape(std::vector<int>({alpha, alpha, M, C}));
+      winograd_input()->set_shape(std::vector<int>({alpha, alpha, C, P}));
+      winograd_product()->set_shape(std::vector<int>({alpha, alpha, M, P}));
+    } else if (the_param.has_padding()) {
+      const int PH = H + 2 * the_param.paddings[0];
+      const int PW = W + 2 * the_param.paddings[1];
+      padded()->set_shape(nchw ? std::vector<int>({N, C, PH, PW}) : std::vector<int>({N, PH, PW, C}));
+    }
+    if (algorithm_ == Algorithm::kIm2Col) {
+      CHECK(!the_param.columns.empty()) << "the columns of im2col is not declared";
+      columns()->set_shape(columns_shape);
+    } else if (!the_param.columns.empty()) {
+      // The columns are declared but not used, keep it a placeholder.
+      columns()->set_shape(std::vector<int>({1}));
+    }
   }
+
+  void CompileImpl() override {
+    LOG_INDENT(1);
+    if (algorithm_ == Algorithm::kWinograd) {
+      CompileWinograd();
+      return;
+    }
+
+    const auto* x = GetInput("X");
+    const auto* w = GetInput("W");
+    const auto* b = GetInput("B");
+    auto& output0 = GetOutput("Out");
+    auto& the_param = param<Conv2dParam>();
+
+    const bool nchw = the_param.layout == Layout::kNCHW;
+    const int groups = the_param.groups;
+    const int M = output0.shape()[nchw ? 1 : 3];
+    const int C = x->shape()[nchw ? 1 : 3];
+    const int Mg = M / groups;
+    const int Cg = C / groups;
+    const int SH = the_param.strides[0], SW = the_param.strides[1];
+    const int DH = the_param.dilations[0], DW = the_param.dilations[1];
+
+    // An element of the image tensors in the layout.
+    auto image = [&](const Tensor* t, Expr n, Expr c, Expr h, Expr w) {
+      return nchw ? t->Elem({n, c, h, w}) : t->Elem({n, h, w, c});
+    };
+
+    // 1. pad the input.
+    const Tensor* input = x;
+    if (the_param.has_padding()) {
+      Tensor* pad = padded();
+      TensorAppendExpr(&output0, pad->Elem().Assign(Expr(0.f)));
+      ir::Var n, c, h, w;
+      Expr padded_elem = image(pad, n, c, h + Expr(the_param.paddings[0]), w + Expr(the_param.paddings[1]));
+      TensorAppendExpr(&output0,
+                       padded_elem.Assign(image(x, n, c, h, w)),
+                       nchw ? std::vector<ir::Var>({n, c, h, w}) : std::vector<ir::Var>({n, h, w, c}));
+      input = pad;
+    }
+
+    // 2. unfold the input patches to the columns.
+    if (algorithm_ == Algorithm::kIm2Col) {
+      ir::Var n, c, kh, kw, oh, ow;
+      Expr patch = image(input, n, c, Scale(oh, SH) + Scale(kh, DH), Scale(ow, SW) + Scale(kw, DW));
+      std::vector<ir::Var> iterators =
+          nchw ? std::vector<ir::Var>({n, c, kh, kw, oh, ow}) : std::vector<ir::Var>({n, oh, ow, kh, kw, c});
+      std::vector<Expr> indices(iterators.begin(), iterators.end());
+      Stage stage = TensorAppendExpr(&output0, columns()->Elem(indices).Assign(patch), iterators);
+      // The patch rows are contiguous only if the stride is 1.
+      int width = VectorWidth(output0.shape()[3]);
+      if (nchw && SW == 1 && width) stage.Vectorize(width);
+    }
+
+    // 3. initialize the output.
+    Expr init = b ? b->Elem({output0.iterators()[nchw ? 1 : 3]}) : Expr(0.f);
+    TensorAppendExpr(&output0, output0.Elem().Assign(init));
+
+    // 4. accumulate, the output channel is split to the group and the channel in the group, and the output is blocked.
+    // The innermost loop reads the input contiguously for NCHW only if the stride is 1 or the columns are used.
+    const int OH = output0.shape()[nchw ? 2 : 1];
+    const int OW = output0.shape()[nchw ? 3 : 2];
+    bool contiguous = !nchw || SW == 1 || algorithm_ == Algorithm::kIm2Col;
+    int width = contiguous ? VectorWidth(nchw ? OW : Mg) : 0;
+    LoopBlock mb(Mg, nchw ? BlockSize(Mg, kChannelBlock) : Mg);
+    LoopBlock ohb(OH, BlockSize(OH, kRowBlock));
+    LoopBlock owb(OW, nchw ? BlockSize(OW, kColumnBlock, std::max(width, 1)) : BlockSize(OW, kNHWCColumnBlock));
+
+    ir::Var n, g, c, kh, kw;
+    Expr m = GroupOffset(g, Mg, mb.value(), groups);
+    Expr ic = GroupOffset(g, Cg, c, groups);
+    Expr oh = ohb.value(), ow = owb.value();
+    Expr filter = nchw ? w->Elem({m, c, kh, kw}) : w->Elem({kh, kw, c, m});
+    Expr patch = algorithm_ == Algorithm::kIm2Col
+                     ? (nchw ? columns()->Elem({n, ic, kh, kw, oh, ow}) : columns()->Elem({n, oh, ow, kh, kw, ic}))
+                     : image(input, n, ic, Scale(oh, SH) + Scale(kh, DH), Scale(ow, SW) + Scale(kw, DW));
+
+    std::vector<ir::Var> iterators({n});
+    auto add_outer = [&](const LoopBlock& block) {
+      if (block.blocked()) iterators.push_back(block.outer);
+    };
+    if (groups > 1) iterators.push_back(g);
+    if (nchw) {
+      add_outer(mb);
+      add_outer(ohb);
+      add_outer(owb);
+      iterators.insert(iterators.end(), {c, kh, kw, mb.inner, ohb.inner, owb.inner});
+    } else {
+      add_outer(ohb);
+      add_outer(owb);
+      iterators.insert(iterators.end(), {kh, kw, c, ohb.inner, owb.inner, mb.inner});
+    }
+    Stage stage = TensorAppendExpr(&output0, image(&output0, n, m, oh, ow).SumAssign(patch * filter), iterators);
+    for (auto* block : {&mb, &ohb, &owb}) block->Bound(&stage);
+    if (width) stage.Vectorize(width);
+  }
+
+ private:
+  /**
+   * Lower the convolution with Winograd F(m x m, 3 x 3), where m is the output tile and alpha = m + 2 is the input
+   * tile, to the stages
+   *
+   * 1. pad the input to cover all the tiles,
+   * 2. transform the filter to U[alpha][alpha][M][C] = G g G^T, only once since the filter is a weight,
+   * 3. transform the input tiles to V[alpha][alpha][C][P] = B^T d B, where P is the number of the tiles padded to a
+   *    multiple of the vector width, the padded tiles are zeroed,
+   * 4. multiply them as alpha x alpha independent GEMMs, M[alpha][alpha][M][P] = U V,
+   * 5. transform the products back to the output tiles, Y = A^T M A plus the bias.
+   *
+   * The transforms are unrolled, a stage for each element of the transformed tile, with the constant coefficients
+   * folded. The stages of a transform are fused, so that each tile is loaded once for all its elements. The tiles are
+   * the innermost dimension of the GEMMs so that they are vectorized.
+   */
+  void CompileWinograd() {
+    const auto* x = GetInput("X");
+    const auto* w = GetInput("W");
+    const auto* b = GetInput("B");
+    auto& output0 = GetOutput("Out");
+    auto& the_param = param<Conv2dParam>();
+    auto* pad = padded();
+    auto* U = winograd_filter();
+    auto* V = winograd_input();
+    auto* product = winograd_product();
+
+    const auto& matrices = GetWinogradMatrices(the_param.winograd_tile);
+    const int tile = the_param.winograd_tile;
+    const int alpha = tile + 2;
+    const int TH = (pad->shape()[2] - 2) / tile;
+    const int TW = (pad->shape()[3] - 2) / tile;
+    const int P = pad->shape()[0] * TH * TW;
+
+    // 1. pad the input.
+    TensorAppendExpr(&output0, pad->Elem().Assign(Expr(0.f)));
+    {
+      ir::Var n, c, h, w;
+      Expr padded_elem = pad->Elem({n, c, h + Expr(the_param.paddings[0]), w + Expr(the_param.paddings[1])});
+      TensorAppendExpr(&output0, padded_elem.Assign(x->Elem({n, c, h, w})), {n, c, h, w});
+    }
+
+    // 2. transform the filter.
+    for (int a0 = 0; a0 < alpha; a0++) {
+      for (int a1 = 0; a1 < alpha; a1++) {
+        ir::Var m, c;
+        std::vector<std::pair<int, Expr>> terms;
+        for (int i = 0; i < 3; i++) {
+          for (int j = 0; j < 3; j++) {
+            terms.emplace_back(matrices.G[a0][i] * matrices.G[a1][j], w->Elem({m, c, Expr(i), Expr(j)}));
+          }
+        }
+        Expr value = LinearCombination(terms);
+        int divisor = matrices.G_divisors[a0] * matrices.G_divisors[a1];
+        if (divisor != 1) value = value / Expr(static_cast<float>(divisor));
+        Stage stage = TensorAppendExpr(&output0, U->Elem({Expr(a0), Expr(a1), m, c}).Assign(value), {m, c});
+        GlobalContext().once_call_registry().Register(stage.name());
+      }
+    }
+
+    // 3. transform the input tiles.
+    if (V->shape()[3] > P) {
+      ir::Var a0, a1, c, p;
+      Stage stage = TensorAppendExpr(&output0, V->Elem({a0, a1, c, p}).Assign(Expr(0.f)), {a0, a1, c, p});
+      stage.SetCond(p, StringFormat(">= %d", P));
+    }
+    std::vector<Stage> tile_stages;
+    for (int a0 = 0; a0 < alpha; a0++) {
+      for (int a1 = 0; a1 < alpha; a1++) {
+        ir::Var c, n, th, tw;
+        std::vector<std::pair<int, Expr>> terms;
+        for (int i = 0; i < alpha; i++) {
+          for (int j = 0; j < alpha; j++) {
+            Expr pixel = pad->Elem({n, c, Scale(th, tile) + Expr(i), Scale(tw, tile) + Expr(j)});
+            terms.emplace_back(matrices.Bt[a0][i] * matrices.Bt[a1][j], pixel);
+          }
+        }
+        Expr p = (Scale(n, TH) + th) * Expr(TW) + tw;
+        Expr tile_elem = V->Elem({Expr(a0), Expr(a1), c, p});
+        Stage stage = TensorAppendExpr(&output0, tile_elem.Assign(LinearCombination(terms)), {c, n, th, tw});
+        BoundTiles(&stage, th, TH, tw, TW);
+        tile_stages.push_back(stage);
+      }
+    }
+    FuseStages(&tile_stages);
+
+    // 4. the batched GEMMs.
+    TensorAppendExpr(&output0, product->Elem().Assign(Expr(0.f)));
+    {
+      ir::Var a0, a1, m, c, p;
+      Expr value = U->Elem({a0, a1, m, c}) * V->Elem({a0, a1, c, p});
+      Stage stage = TensorAppendExpr(&output0, product->Elem({a0, a1, m, p}).SumAssign(value), {a0, a1, m, c, p});
+      int width = VectorWidth(V->shape()[3]);
+      if (width) stage.Vectorize(width);
+    }
+
+    // 5. transform the products back to the output.
+    std::vector<Stage> out_stages;
+    for (int i = 0; i < tile; i++) {
+      for (int j = 0; j < tile; j++) {
+        ir::Var n, m, th, tw;
+        Expr p = (Scale(n, TH) + th) * Expr(TW) + tw;
+        std::vector<std::pair<int, Expr>> terms;
+        for (int a0 = 0; a0 < alpha; a0++) {
+          for (int a1 = 0; a1 < alpha; a1++) {
+            terms.emplace_back(matrices.At[i][a0] * matrices.At[j][a1], product->Elem({Expr(a0), Expr(a1), m, p}));
+          }
+        }
+        Expr value = LinearCombination(terms);
+        if (b) value = value + b->Elem({m});
+        // The output elements beyond the borders are dropped by the domain of the output reference.
+        Expr out = output0.Elem({n, m, Scale(th, tile) + Expr(i), Scale(tw, tile) + Expr(j)});
+        Stage stage = TensorAppendExpr(&output0, out.Assign(value), {n, m, th, tw});
+        BoundTiles(&stage, th, TH, tw, TW);
+        out_stages.push_back(stage);
+      }
+    }
+    FuseStages(&out_stages);
+  }
+
+  //! Bound the iterators of the tiles explicitly, they appear in the references only combined with the other ones.
+  static void BoundTiles(Stage* stage, const ir::Var& th, int TH, const ir::Var& tw, int TW) {
+    stage->SetCond(th, ">= 0");
+    stage->SetCond(th, StringFormat("< %d", TH));
+    stage->SetCond(tw, ">= 0");
+    stage->SetCond(tw, StringFormat("< %d", TW));
+  }
+
+  //! Fuse the stages into the loops of the first one.
+  static void FuseStages(std::vector<Stage>* stages) {
+    for (size_t i = 1; i < stages->size(); i++) (*stages)[i].FuseWith(stages->front());
+  }
+
+  Tensor* padded() {
+    auto* tensor = session_->GetTensor(param<Conv2dParam>().padded);
+    CHECK(tensor) << "padded input of conv2d is not declared";
+    return tensor;
+  }
+
+  Tensor* columns() {
+    auto* tensor = session_->GetTensor(param<Conv2dParam>().columns);
+    CHECK(tensor) << "columns of conv2d is not declared";
+    return tensor;
+  }
+
+  Tensor* GetWinogradTmpVar(const std::string& name) {
+    auto* tensor = session_->GetTensor(name);
+    CHECK(tensor) << "temporary variable of Winograd is not declared";
+    return tensor;
+  }
+
+  Tensor* winograd_filter() { return GetWinogradTmpVar(param<Conv2dParam>().winograd_filter); }
+  Tensor* winograd_input() { return GetWinogradTmpVar(param<Conv2dParam>().winograd_input); }
+  Tensor* winograd_product() { return GetWinogradTmpVar(param<Conv2dParam>().winograd_product); }
+
+  Algorithm algorithm_{Algorithm::kDirect};
 };
 
 }  // namespace instruction_layer
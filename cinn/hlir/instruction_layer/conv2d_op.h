@@ -1,15 +1,97 @@
 #pragma once
 
+#include <string>
 #include <vector>
 
 namespace cinn {
 namespace hlir {
 namespace instruction_layer {
 
+/**
+ * Param of the 2D convolution.
+ *
+ * Inputs: X, the filter W and an optional bias B [M].
+ * - NCHW: X [N, C, H, W], W [M, C/groups, KH, KW], Out [N, M, OH, OW],
+ * - NHWC: X [N, H, W, C], W [KH, KW, C/groups, M], Out [N, OH, OW, M],
+ *
+ * where OH = (H + 2 * padding_h - dilation_h * (KH - 1) - 1) / stride_h + 1, and OW is similar.
+ */
 struct Conv2dParam {
+  enum class Layout {
+    kNCHW = 0,
+    kNHWC,
+  };
+
+  enum class Algorithm {
+    //! Select by the shapes, see Conv2dSelectAlgorithm.
+    kAuto = 0,
+    //! Accumulate the products from the input directly.
+    kDirect,
+    //! Unfold the input patches to the columns first, then multiply them with the filter as a GEMM.
+    kIm2Col,
+    //! Transform the tiles of the input and the filter to the Winograd domain, multiply them as the batched GEMMs and
+    //! transform the products back, only for the 3x3 NCHW convolutions with stride 1, see Conv2dWinogradApplicable.
+    kWinograd,
+  };
+
+  //! The strides of the height and width.
   std::vector<int> strides{{1, 1}};
+  //! The zero paddings of the height and width, the same on the both sides.
+  std::vector<int> paddings{{0, 0}};
+  //! The dilations of the height and width.
+  std::vector<int> dilations{{1, 1}};
+  //! The number of the groups, the input and output channels are divided to the groups, each output channel only sees
+  //! the input channels in its group.
+  int groups{1};
+  Layout layout{Layout::kNCHW};
+  Algorithm algorithm{Algorithm::kAuto};
+  //! The output tile of Winograd F(m x m, 3 x 3), 2 or 4. The larger tile saves more multiplications, 4x instead of
+  //! 2.25x, but is less accurate.
+  int winograd_tile{2};
+
+  //! Name of the temporary variable holds the padded input, required if any padding is not zero or the algorithm is
+  //! kWinograd.
+  std::string padded;
+  //! Name of the temporary variable holds the columns of im2col, required unless the algorithm is kDirect or
+  //! kWinograd.
+  std::string columns;
+  //! Names of the temporary variables hold the filter, the input tiles and their products in the Winograd domain,
+  //! required if the algorithm is kWinograd.
+  std::string winograd_filter;
+  std::string winograd_input;
+  std::string winograd_product;
+
+  bool has_padding() const { return paddings[0] > 0 || paddings[1] > 0; }
 };
 
+/**
+ * Select the algorithm for a convolution.
+ *
+ * The direct convolution vectorizes the innermost dimension of the output, the width for NCHW or the channels for
+ * NHWC. For NCHW, the input row is read contiguously only with stride 1, otherwise the input is unfolded by im2col so
+ * that both the columns and the output are accessed contiguously, if the columns are not too large.
+ *
+ * Winograd is never selected, it changes the numerical results slightly, it is specified or chosen by the autotuner.
+ *
+ * @param param the param, the algorithm is returned as is if it is not kAuto.
+ * @param out_shape the shape of the output.
+ * @param columns_bytes the size of the columns of im2col.
+ */
+Conv2dParam::Algorithm Conv2dSelectAlgorithm(const Conv2dParam& param,
+                                             const std::vector<int>& out_shape,
+                                             size_t columns_bytes);
+
+/**
+ * Tell whether the Winograd algorithm applies to a convolution, it requires the NCHW layout, a 3x3 filter, stride 1,
+ * dilation 1 and a single group.
+ * @param w_shape the shape of the filter.
+ */
+bool Conv2dWinogradApplicable(const Conv2dParam& param, const std::vector<int>& w_shape);
+
+//! The algorithms a convolution can be lowered with, the candidates for the autotuner.
+std::vector<Conv2dParam::Algorithm> Conv2dCandidateAlgorithms(const Conv2dParam& param,
+                                                              const std::vector<int>& w_shape);
+
 }  // namespace instruction_layer
 }  // namespace hlir
 }  // namespace cinn
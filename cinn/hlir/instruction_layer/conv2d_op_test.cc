@@ -0,0 +1,235 @@
+#include "cinn/hlir/instruction_layer/conv2d_op.h"
+#include <gtest/gtest.h>
+#include <set>
+#include <string>
+#include "cinn/backends/code_gen_c.h"
+#include "cinn/core/function.h"
+#include "cinn/hlir/instruction_layer/use_ops.h"
+#include "cinn/hlir/op_registry.h"
+
+namespace cinn {
+namespace hlir {
+namespace instruction_layer {
+
+TEST(conv2d_op, select_algorithm) {
+  using Algorithm = Conv2dParam::Algorithm;
+  Conv2dParam param;
+  param.columns = "columns";
+
+  // The width is vectorizable with stride 1.
+  ASSERT_EQ(Conv2dSelectAlgorithm(param, {1, 16, 32, 32}, 1024), Algorithm::kDirect);
+  // The input row is not contiguous with stride 2.
+  param.strides = {2, 2};
+  ASSERT_EQ(Conv2dSelectAlgorithm(param, {1, 16, 32, 32}, 1024), Algorithm::kIm2Col);
+  // The columns are too large.
+  ASSERT_EQ(Conv2dSelectAlgorithm(param, {1, 16, 32, 32}, 1UL << 30), Algorithm::kDirect);
+  // The output channels of NHWC are vectorized.
+  param.layout = Conv2dParam::Layout::kNHWC;
+  ASSERT_EQ(Conv2dSelectAlgorithm(param, {1, 32, 32, 16}, 1024), Algorithm::kDirect);
+  // The algorithm specified is kept.
+  param.algorithm = Algorithm::kIm2Col;
+  ASSERT_EQ(Conv2dSelectAlgorithm(param, {1, 32, 32, 16}, 1UL << 30), Algorithm::kIm2Col);
+}
+
+TEST(conv2d_op, test) {
+  SetGlobalContext(new CINNContext);
+
+  auto op = OpRegistry::Global().CreateOp(HlirLayer::kInstructionWise, "conv2d");
+  ASSERT_TRUE(op);
+
+  auto &param = op->param<Conv2dParam>();
+  param.strides = {2, 2};
+  param.paddings = {1, 1};
+  param.groups = 2;
+  param.padded = "padded";
+  param.columns = "columns";
+
+  Session session;
+  auto *x = session.NewTensor("x");
+  auto *w = session.NewTensor("w");
+  auto *b = session.NewTensor("b");
+  auto *padded = session.NewTensor("padded");
+  auto *columns = session.NewTensor("columns");
+  auto *output = session.NewTensor("out");
+
+  x->set_ptype(primitive_t::float32);
+  w->set_ptype(primitive_t::float32);
+  b->set_ptype(primitive_t::float32);
+
+  x->set_shape({1, 4, 15, 15});
+  w->set_shape({8, 2, 3, 3});
+  b->set_shape({8});
+
+  op->set_session(&session);
+
+  op->SetInput("X", "x");
+  op->SetInput("W", "w");
+  op->SetInput("B", "b");
+  op->SetOutput("Out", "out");
+
+  op->Compile();
+
+  ASSERT_EQ(output->shape().data, std::vector<int>({1, 8, 8, 8}));
+  ASSERT_EQ(padded->shape().data, std::vector<int>({1, 4, 17, 17}));
+  // The stride 2 selects im2col.
+  ASSERT_EQ(columns->shape().data, std::vector<int>({1, 4, 3, 3, 8, 8}));
+  // pad, copy, im2col, init and accumulate.
+  ASSERT_EQ(output->stages().size(), 5UL);
+
+  Function fn("conv2d");
+  {
+    for (auto &stage : output->stages()) {
+      fn.AddStage(stage);
+    }
+    fn.Inputs({x->expr(), w->expr(), b->expr(), padded->expr(), columns->expr()});
+    fn.Outputs({output->expr()});
+    fn.EndDefinition();
+  }
+
+  backends::C_CodeGen gen;
+  gen.Print(fn.ir_function());
+
+  LOG(INFO) << "generated code:\n" << gen.compiled_code();
+}
+
+TEST(conv2d_op, blocked) {
+  SetGlobalContext(new CINNContext);
+
+  auto op = OpRegistry::Global().CreateOp(HlirLayer::kInstructionWise, "conv2d");
+  ASSERT_TRUE(op);
+  op->param<Conv2dParam>().algorithm = Conv2dParam::Algorithm::kDirect;
+
+  Session session;
+  auto *x = session.NewTensor("x");
+  auto *w = session.NewTensor("w");
+  auto *output = session.NewTensor("out");
+
+  x->set_ptype(primitive_t::float32);
+  w->set_ptype(primitive_t::float32);
+
+  x->set_shape({1, 4, 130, 130});
+  w->set_shape({32, 4, 3, 3});
+
+  op->set_session(&session);
+
+  op->SetInput("X", "x");
+  op->SetInput("W", "w");
+  op->SetOutput("Out", "out");
+
+  op->Compile();
+
+  ASSERT_EQ(output->shape().data, std::vector<int>({1, 32, 128, 128}));
+  ASSERT_EQ(output->stages().size(), 2UL);
+  // The 32 channels, 128 rows and 128 columns are split to the blocks of 8, 4 and 64, the loops are
+  // n, the 3 block loops, c, kh, kw and the 3 loops in a block.
+  auto &domain = output->stages().back().iterator_domain();
+  ASSERT_EQ(isl_set_dim(domain.get(), isl_dim_set), 10);
+  EXPECT_EQ(output->stages().back().vector_width(), std::vector<int>({8}));
+
+  Function fn("conv2d");
+  {
+    for (auto &stage : output->stages()) {
+      fn.AddStage(stage);
+    }
+    fn.Inputs({x->expr(), w->expr()});
+    fn.Outputs({output->expr()});
+    fn.EndDefinition();
+  }
+
+  backends::C_CodeGen gen;
+  gen.Print(fn.ir_function());
+  LOG(INFO) << "generated code:\n" << gen.compiled_code();
+}
+
+TEST(conv2d_op, nhwc) {
+  SetGlobalContext(new CINNContext);
+
+  auto op = OpRegistry::Global().CreateOp(HlirLayer::kInstructionWise, "conv2d");
+  ASSERT_TRUE(op);
+
+  auto &param = op->param<Conv2dParam>();
+  param.layout = Conv2dParam::Layout::kNHWC;
+  param.dilations = {2, 2};
+
+  Session session;
+  auto *x = session.NewTensor("x");
+  auto *w = session.NewTensor("w");
+  auto *output = session.NewTensor("out");
+
+  x->set_ptype(primitive_t::float32);
+  w->set_ptype(primitive_t::float32);
+
+  x->set_shape({1, 12, 12, 4});
+  w->set_shape({3, 3, 4, 8});
+
+  op->set_session(&session);
+
+  op->SetInput("X", "x");
+  op->SetInput("W", "w");
+  op->SetOutput("Out", "out");
+
+  op->Compile();
+
+  ASSERT_EQ(output->shape().data, std::vector<int>({1, 8, 8, 8}));
+  // init and accumulate.
+  ASSERT_EQ(output->stages().size(), 2UL);
+}
+
+TEST(conv2d_op, winograd) {
+  SetGlobalContext(new CINNContext);
+
+  auto op = OpRegistry::Global().CreateOp(HlirLayer::kInstructionWise, "conv2d");
+  ASSERT_TRUE(op);
+
+  auto &param = op->param<Conv2dParam>();
+  param.paddings = {1, 1};
+  param.algorithm = Conv2dParam::Algorithm::kWinograd;
+  param.winograd_tile = 4;
+  param.padded = "padded";
+  param.winograd_filter = "winograd_filter";
+  param.winograd_input = "winograd_input";
+  param.winograd_product = "winograd_product";
+
+  Session session;
+  auto *x = session.NewTensor("x");
+  auto *w = session.NewTensor("w");
+  auto *padded = session.NewTensor("padded");
+  auto *filter = session.NewTensor("winograd_filter");
+  auto *input = session.NewTensor("winograd_input");
+  auto *product = session.NewTensor("winograd_product");
+  auto *output = session.NewTensor("out");
+
+  x->set_ptype(primitive_t::float32);
+  w->set_ptype(primitive_t::float32);
+
+  x->set_shape({2, 4, 10, 10});
+  w->set_shape({8, 4, 3, 3});
+
+  op->set_session(&session);
+
+  op->SetInput("X", "x");
+  op->SetInput("W", "w");
+  op->SetOutput("Out", "out");
+
+  op->Compile();
+
+  ASSERT_EQ(output->shape().data, std::vector<int>({2, 8, 10, 10}));
+  // 3x3 tiles of 4x4 cover the output, the padded input covers the tiles.
+  ASSERT_EQ(padded->shape().data, std::vector<int>({2, 4, 14, 14}));
+  ASSERT_EQ(filter->shape().data, std::vector<int>({6, 6, 8, 4}));
+  // the 18 tiles are padded to 24 to vectorize the GEMMs.
+  ASSERT_EQ(input->shape().data, std::vector<int>({6, 6, 4, 24}));
+  ASSERT_EQ(product->shape().data, std::vector<int>({6, 6, 8, 24}));
+  // pad, copy, the transform of the filter, zero the padded tiles, the transform of the input, zero, the GEMMs and the
+  // transform of the output.
+  ASSERT_EQ(output->stages().size(), 2UL + 36 + 1 + 36 + 2 + 16);
+  ASSERT_TRUE(GlobalContext().once_call_registry().Contains(output->stages()[2].name()));
+  const auto &stages = output->stages();
+  ASSERT_EQ(stages[2 + 36 + 1 + 1].stages_fuse_with(), std::set<std::string>({stages[2 + 36 + 1].name()}));
+  ASSERT_EQ(stages.back().stages_fuse_with(), std::set<std::string>({stages[stages.size() - 16].name()}));
+  ASSERT_EQ(stages[2 + 36 + 1 + 36 + 1].vector_width(), std::vector<int>({8}));
+}
+
+}  // namespace instruction_layer
+}  // namespace hlir
+}  // namespace cinn
@@ -0,0 +1,216 @@
+#include "cinn/hlir/instruction_layer/depthwise_conv2d_op.h"
+#include <vector>
+#include "cinn/core/cinn_context.h"
+#include "cinn/hlir/op_registry.h"
+#include "cinn/hlir/operator.h"
+#include "cinn/ir/ir.h"
+#include "cinn/ir/ops_overload.h"
+#include "cinn/utils/logging.h"
+#include "cinn/utils/string.h"
+
+namespace cinn {
+namespace hlir {
+namespace instruction_layer {
+
+namespace {
+
+//! `x * factor + offset`, without the trivial operations to keep the index simple.
+Expr Affine(Expr x, int factor, int offset) {
+  Expr result = factor == 1 ? x : x * Expr(factor);
+  return offset == 0 ? result : result + Expr(offset);
+}
+
+Expr Activate(Expr x, DepthwiseConv2dParam::Activation activation) {
+  using Activation = DepthwiseConv2dParam::Activation;
+  switch (activation) {
+    case Activation::kNone:
+      return x;
+    case Activation::kRelu:
+      return Max_(x, Expr(0.f));
+    case Activation::kTanh:
+      return Tanh_(x);
+    case Activation::kSigmoid:
+      return Sigmoid_(x);
+  }
+  return x;
+}
+
+}  // namespace
+
+int DepthwiseConv2dChannelBlock(int channels) {
+  int width = VectorWidth(channels);
+  return width ? width : 1;
+}
+
+/**
+ * The depthwise 2D convolution.
+ *
+ * The general convolution with groups accumulates each product of the window into the output, and vectorizes the
+ * width only if the stride is 1. This one rearranges the channels to blocks and is lowered to the stages
+ *
+ * 1. zero the ring of the padding in the blocked input if any padding is not zero,
+ * 2. copy the input to the blocked input,
+ * 3. copy the filter to the blocked filter, only once,
+ * 4. compute each element of the blocked output as a single expression, the bias plus the products of the whole
+ *    window, so that the partial sums are kept in registers, the activation is applied in the same expression. The
+ *    innermost loop iterates the channels in a block and is vectorized,
+ * 5. copy the blocked output to the output, fused into the loops of the kernel.
+ */
+class DepthwiseConv2d : public Operator {
+ public:
+  DepthwiseConv2d() : Operator("depthwise_conv2d", HlirLayer::kInstructionWise, nullptr) {
+    param_.set(DepthwiseConv2dParam());
+  }
+
+ protected:
+  void InferenceOutputType() override {
+    const auto* x = GetInput("X");
+    const auto* w = GetInput("W");
+    const auto* b = GetInput("B");
+    auto& output0 = GetOutput("Out");
+
+    CHECK_EQ(x->ptype(), primitive_t::float32);
+    CHECK_EQ(w->ptype(), primitive_t::float32);
+    if (b) CHECK_EQ(b->ptype(), primitive_t::float32);
+    output0.set_ptype(x->ptype());
+    blocked_input()->set_ptype(x->ptype());
+    blocked_filter()->set_ptype(x->ptype());
+    blocked_output()->set_ptype(x->ptype());
+  }
+
+  void Resize() override {
+    const auto* x = GetInput("X");
+    const auto* w = GetInput("W");
+    const auto* b = GetInput("B");
+    auto& output0 = GetOutput("Out");
+    auto& the_param = param<DepthwiseConv2dParam>();
+
+    CHECK_EQ(the_param.strides.size(), 2UL);
+    CHECK_EQ(the_param.paddings.size(), 2UL);
+    CHECK_EQ(the_param.dilations.size(), 2UL);
+    CHECK_EQ(x->shape().size(), 4UL);
+    CHECK_EQ(w->shape().size(), 4UL);
+
+    const int N = x->shape()[0];
+    const int C = x->shape()[1];
+    const int KH = w->shape()[2];
+    const int KW = w->shape()[3];
+    CHECK_EQ(w->shape()[0], C) << "the filter doesn't match the input channels";
+    CHECK_EQ(w->shape()[1], 1) << "each channel should have its own filter";
+    if (b) {
+      CHECK_EQ(b->shape().size(), 1UL);
+      CHECK_EQ(b->shape()[0], C);
+    }
+
+    int sizes[2];
+    for (int i = 0; i < 2; i++) {
+      CHECK_GT(the_param.strides[i], 0);
+      CHECK_GE(the_param.paddings[i], 0);
+      CHECK_GT(the_param.dilations[i], 0);
+      const int kernel = i == 0 ? KH : KW;
+      sizes[i] = x->shape()[2 + i] + 2 * the_param.paddings[i];
+      const int extent = the_param.dilations[i] * (kernel - 1) + 1;
+      CHECK_GE(sizes[i], extent) << "the kernel is larger than the padded input";
+    }
+    const int OH = (sizes[0] - the_param.dilations[0] * (KH - 1) - 1) / the_param.strides[0] + 1;
+    const int OW = (sizes[1] - the_param.dilations[1] * (KW - 1) - 1) / the_param.strides[1] + 1;
+    output0.set_shape(std::vector<int>({N, C, OH, OW}));
+
+    const int block = DepthwiseConv2dChannelBlock(C);
+    blocked_input()->set_shape(std::vector<int>({N, C / block, sizes[0], sizes[1], block}));
+    blocked_filter()->set_shape(std::vector<int>({C / block, KH, KW, block}));
+    blocked_output()->set_shape(std::vector<int>({N, C / block, OH, OW, block}));
+  }
+
+  void CompileImpl() override {
+    LOG_INDENT(1);
+    const auto* x = GetInput("X");
+    const auto* w = GetInput("W");
+    const auto* b = GetInput("B");
+    auto& output0 = GetOutput("Out");
+    auto& the_param = param<DepthwiseConv2dParam>();
+    auto* input = blocked_input();
+    auto* filter = blocked_filter();
+    auto* blocked = blocked_output();
+
+    const int block = filter->shape()[3];
+    const int KH = filter->shape()[1];
+    const int KW = filter->shape()[2];
+    const int SH = the_param.strides[0], SW = the_param.strides[1];
+    const int DH = the_param.dilations[0], DW = the_param.dilations[1];
+    const int PH = the_param.paddings[0], PW = the_param.paddings[1];
+
+    // 1. zero the borders, only the ring of the padding, the inner part is overwritten by the next stage.
+    if (PH > 0 || PW > 0) {
+      ir::Var n, co, h, w, ci;
+      const int H = x->shape()[2], W = x->shape()[3];
+      Stage stage = TensorAppendExpr(&output0, input->Elem({n, co, h, w, ci}).Assign(Expr(0.f)), {n, co, h, w, ci});
+      stage.SetCond(StringFormat("(%s < %d or %s >= %d or %s < %d or %s >= %d)",
+                                 h.name().c_str(),
+                                 PH,
+                                 h.name().c_str(),
+                                 PH + H,
+                                 w.name().c_str(),
+                                 PW,
+                                 w.name().c_str(),
+                                 PW + W));
+    }
+
+    // 2. block the input.
+    {
+      ir::Var n, co, h, w, ci;
+      Expr pixel = x->Elem({n, Affine(co, block, 0) + ci, h, w});
+      Expr padded = input->Elem({n, co, Affine(h, 1, PH), Affine(w, 1, PW), ci});
+      TensorAppendExpr(&output0, padded.Assign(pixel), {n, co, h, w, ci});
+    }
+
+    // 3. block the filter, it is a weight so only once.
+    {
+      ir::Var co, kh, kw, ci;
+      Expr channel = Affine(co, block, 0) + ci;
+      Stage stage = TensorAppendExpr(&output0,
+                                     filter->Elem({co, kh, kw, ci}).Assign(w->Elem({channel, Expr(0), kh, kw})),
+                                     {co, kh, kw, ci});
+      GlobalContext().once_call_registry().Register(stage.name());
+    }
+
+    // 4. the kernel.
+    ir::Var n, co, oh, ow, ci;
+    Expr sum = b ? b->Elem({Affine(co, block, 0) + ci}) : Expr(0.f);
+    for (int kh = 0; kh < KH; kh++) {
+      for (int kw = 0; kw < KW; kw++) {
+        Expr pixel = input->Elem({n, co, Affine(oh, SH, kh * DH), Affine(ow, SW, kw * DW), ci});
+        sum = sum + pixel * filter->Elem({co, Expr(kh), Expr(kw), ci});
+      }
+    }
+    Stage kernel = TensorAppendExpr(&output0,
+                                    blocked->Elem({n, co, oh, ow, ci}).Assign(Activate(sum, the_param.activation)),
+                                    {n, co, oh, ow, ci});
+    if (block > 1) kernel.Vectorize(block);
+
+    // 5. unblock the output, in the loops of the kernel so that each block is copied while it is still in the cache.
+    Stage unblock = TensorAppendExpr(
+        &output0,
+        output0.Elem({n, Affine(co, block, 0) + ci, oh, ow}).Assign(blocked->Elem({n, co, oh, ow, ci})),
+        {n, co, oh, ow, ci});
+    unblock.FuseWith(kernel);
+  }
+
+ private:
+  Tensor* GetTmpVar(const std::string& name) {
+    CHECK(!name.empty()) << "temporary variable of depthwise_conv2d is not declared";
+    auto* tensor = session_->GetTensor(name);
+    CHECK(tensor) << "temporary variable " << name << " of depthwise_conv2d is not declared";
+    return tensor;
+  }
+
+  Tensor* blocked_input() { return GetTmpVar(param<DepthwiseConv2dParam>().blocked_input); }
+  Tensor* blocked_filter() { return GetTmpVar(param<DepthwiseConv2dParam>().blocked_filter); }
+  Tensor* blocked_output() { return GetTmpVar(param<DepthwiseConv2dParam>().blocked_output); }
+};
+
+}  // namespace instruction_layer
+}  // namespace hlir
+}  // namespace cinn
+
+REGISTER_OP(depthwise_conv2d, kInstructionWise, ::cinn::hlir::instruction_layer::DepthwiseConv2d);
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace cinn {
+namespace hlir {
+namespace instruction_layer {
+
+/**
+ * Param of the depthwise 2D convolution, each channel of the input is convolved with its own filter.
+ *
+ * Inputs: X [N, C, H, W], the filter W [C, 1, KH, KW] and an optional bias B [C]. Output: Out [N, C, OH, OW].
+ *
+ * The channels are blocked by DepthwiseConv2dChannelBlock, the input, the filter and the output are rearranged to the
+ * NCHWc layouts with the block of the channels innermost, so that the kernel is vectorized across the channels.
+ */
+struct DepthwiseConv2dParam {
+  enum class Activation {
+    kNone = 0,
+    kRelu,
+    kTanh,
+    kSigmoid,
+  };
+
+  //! The strides of the height and width.
+  std::vector<int> strides{{1, 1}};
+  //! The zero paddings of the height and width, the same on the both sides.
+  std::vector<int> paddings{{0, 0}};
+  //! The dilations of the height and width.
+  std::vector<int> dilations{{1, 1}};
+  //! The activation fused after adding the bias.
+  Activation activation{Activation::kNone};
+
+  //! Name of the temporary variable holds the padded input in the blocked layout [N, C/c, PH, PW, c].
+  std::string blocked_input;
+  //! Name of the temporary variable holds the filter in the blocked layout [C/c, KH, KW, c].
+  std::string blocked_filter;
+  //! Name of the temporary variable holds the output in the blocked layout [N, C/c, OH, OW, c].
+  std::string blocked_output;
+};
+
+//! The number of the channels in a block, the vector width if the channels can be vectorized, 1 otherwise.
+int DepthwiseConv2dChannelBlock(int channels);
+
+}  // namespace instruction_layer
+}  // namespace hlir
+}  // namespace cinn
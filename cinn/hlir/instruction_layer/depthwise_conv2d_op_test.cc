@@ -0,0 +1,97 @@
+#include "cinn/hlir/instruction_layer/depthwise_conv2d_op.h"
+#include <gtest/gtest.h>
+#include <string>
+#include "cinn/backends/code_gen_c.h"
+#include "cinn/core/function.h"
+#include "cinn/hlir/instruction_layer/use_ops.h"
+#include "cinn/hlir/op_registry.h"
+
+namespace cinn {
+namespace hlir {
+namespace instruction_layer {
+
+TEST(depthwise_conv2d_op, channel_block) {
+  ASSERT_EQ(DepthwiseConv2dChannelBlock(32), 8);
+  ASSERT_EQ(DepthwiseConv2dChannelBlock(12), 4);
+  ASSERT_EQ(DepthwiseConv2dChannelBlock(3), 1);
+}
+
+TEST(depthwise_conv2d_op, test) {
+  SetGlobalContext(new CINNContext);
+
+  auto op = OpRegistry::Global().CreateOp(HlirLayer::kInstructionWise, "depthwise_conv2d");
+  ASSERT_TRUE(op);
+
+  auto &param = op->param<DepthwiseConv2dParam>();
+  param.strides = {2, 2};
+  param.paddings = {1, 1};
+  param.activation = DepthwiseConv2dParam::Activation::kRelu;
+  param.blocked_input = "blocked_input";
+  param.blocked_filter = "blocked_filter";
+  param.blocked_output = "blocked_output";
+
+  Session session;
+  auto *x = session.NewTensor("x");
+  auto *w = session.NewTensor("w");
+  auto *b = session.NewTensor("b");
+  auto *blocked_input = session.NewTensor("blocked_input");
+  auto *blocked_filter = session.NewTensor("blocked_filter");
+  auto *blocked_output = session.NewTensor("blocked_output");
+  auto *output = session.NewTensor("out");
+
+  x->set_ptype(primitive_t::float32);
+  w->set_ptype(primitive_t::float32);
+  b->set_ptype(primitive_t::float32);
+
+  x->set_shape({1, 16, 16, 16});
+  w->set_shape({16, 1, 3, 3});
+  b->set_shape({16});
+
+  op->set_session(&session);
+
+  op->SetInput("X", "x");
+  op->SetInput("W", "w");
+  op->SetInput("B", "b");
+  op->SetOutput("Out", "out");
+
+  op->Compile();
+
+  ASSERT_EQ(output->shape().data, std::vector<int>({1, 16, 8, 8}));
+  ASSERT_EQ(blocked_input->shape().data, std::vector<int>({1, 2, 18, 18, 8}));
+  ASSERT_EQ(blocked_filter->shape().data, std::vector<int>({2, 3, 3, 8}));
+  ASSERT_EQ(blocked_output->shape().data, std::vector<int>({1, 2, 8, 8, 8}));
+  // zero, block the input and the filter, the kernel and unblock.
+  ASSERT_EQ(output->stages().size(), 5UL);
+  ASSERT_TRUE(GlobalContext().once_call_registry().Contains(output->stages()[2].name()));
+  // only the ring of the padding is zeroed.
+  {
+    isl::set inner = output->stages()[0].iterator_domain();
+    inner = isl::manage(isl_set_fix_si(inner.release(), isl_dim_set, 2, 5));
+    inner = isl::manage(isl_set_fix_si(inner.release(), isl_dim_set, 3, 5));
+    ASSERT_TRUE(inner.is_empty());
+    isl::set border = output->stages()[0].iterator_domain();
+    border = isl::manage(isl_set_fix_si(border.release(), isl_dim_set, 2, 17));
+    ASSERT_FALSE(border.is_empty());
+  }
+  // the output is unblocked in the loops of the kernel.
+  ASSERT_EQ(output->stages()[4].stages_fuse_with().count(output->stages()[3].name()), 1UL);
+
+  Function fn("depthwise_conv2d");
+  {
+    for (auto &stage : output->stages()) {
+      fn.AddStage(stage);
+    }
+    fn.Inputs({x->expr(), w->expr(), b->expr(), blocked_input->expr(), blocked_filter->expr(), blocked_output->expr()});
+    fn.Outputs({output->expr()});
+    fn.EndDefinition();
+  }
+
+  backends::C_CodeGen gen;
+  gen.Print(fn.ir_function());
+
+  LOG(INFO) << "generated code:\n" << gen.compiled_code();
+}
+
+}  // namespace instruction_layer
+}  // namespace hlir
+}  // namespace cinn
@@ -1,5 +1,6 @@
 #include "cinn/hlir/instruction_layer/matmul_op.h"
 #include <vector>
+#include "cinn/hlir/instruction_layer/quantize_op.h"
 #include "cinn/hlir/op_registry.h"
 #include "cinn/hlir/operator.h"
 #include "cinn/ir/ir_helper.h"
@@ -10,6 +11,23 @@ namespace cinn {
 namespace hlir {
 namespace instruction_layer {
 
+namespace {
+
+//! Check the types of the float matmul, the weight can be stored in half precision.
+void CheckMatMulInputTypes(const Tensor* x, const Tensor* w) {
+  CHECK_NE(x->ptype(), primitive_t::unk);
+  if (is_half_float(w->ptype())) {
+    CHECK_EQ(x->ptype(), primitive_t::float32);
+  } else {
+    CHECK_EQ(x->ptype(), w->ptype());
+  }
+}
+
+//! Widen an element of a half precision weight to float32, the accumulation is in float32.
+Expr WidenWeight(Expr w) { return is_half_float(w.ptype()) ? ir::Cast::make(w, primitive_t::float32) : w; }
+
+}  // namespace
+
 class MatMulOp : public Operator {
  public:
   MatMulOp() : Operator("matmul", HlirLayer::kInstructionWise, nullptr) { param_.set(MatMulParam()); }
@@ -20,8 +38,7 @@ class MatMulOp : public Operator {
     const auto* W = GetInput("W");
     auto& output = GetOutput("Out");
 
-    CHECK_EQ(input0->ptype(), W->ptype());
-    CHECK_NE(input0->ptype(), primitive_t::unk);
+    CheckMatMulInputTypes(input0, W);
 
     output.set_ptype(input0->ptype());
   }
@@ -62,7 +79,7 @@ class MatMulOp : public Operator {
                      out[i][j] = Expr(0.f));
 
     TensorAppendExpr(&output0,  //
-                     out[i][j] += x[i][k] * w[k][j]);
+                     out[i][j] += x[i][k] * WidenWeight(w[k][j]));
 
     input0->set_iterators({i, k});
     W->set_iterators({k, j});
@@ -83,8 +100,7 @@ class MatMulTransposedOp : public Operator {
     const auto* W = GetInput("W");
     auto& output = GetOutput("Out");
 
-    CHECK_EQ(input0->ptype(), W->ptype());
-    CHECK_NE(input0->ptype(), primitive_t::unk);
+    CheckMatMulInputTypes(input0, W);
 
     output.set_ptype(input0->ptype());
   }
@@ -124,7 +140,106 @@ class MatMulTransposedOp : public Operator {
     TensorAppendExpr(&output0,  //
                      output0.Elem() = Expr(0.f));
     TensorAppendExpr(&output0,  //
-                     output0.Elem() += input0->Elem() * W->Elem());
+                     output0.Elem() += input0->Elem() * WidenWeight(W->Elem()));
+  }
+};
+
+/**
+ * MatMul on int8 operands with the int32 accumulation, the W is transposed so that the reduction reads both the
+ * operands contiguously.
+ *
+ * Inputs: X [M, K] int8, W [N, K] int8, WScale [N] float32 for the per output channel scales, and an optional bias B
+ * [N] float32.
+ * Output: Out [M, N], float32 or int8 requantized with the `out_scale`.
+ *
+ * The dequantization, bias and requantization are fused into a single stage after the accumulation.
+ */
+class QuantizedMatMulOp : public Operator {
+ public:
+  QuantizedMatMulOp() : Operator("quantized_matmul", HlirLayer::kInstructionWise, nullptr) {
+    param_.set(QuantizedMatMulParam());
+  }
+
+ private:
+  void InferenceOutputType() override {
+    const auto* input0 = GetInput("X");
+    const auto* W = GetInput("W");
+    const auto* w_scale = GetInput("WScale");
+    const auto* B = GetInput("B");
+    auto& output = GetOutput("Out");
+    auto& the_param = param<QuantizedMatMulParam>();
+
+    CHECK_EQ(input0->ptype(), primitive_t::int8);
+    CHECK_EQ(W->ptype(), primitive_t::int8);
+    CHECK_EQ(w_scale->ptype(), primitive_t::float32);
+    if (B) CHECK_EQ(B->ptype(), primitive_t::float32);
+
+    output.set_ptype(the_param.out_scale > 0.f ? primitive_t::int8 : primitive_t::float32);
+    accumulator()->set_ptype(primitive_t::int32);
+  }
+
+  void Resize() override {
+    auto* input0 = GetInput("X");
+    auto* W = GetInput("W");
+    auto* w_scale = GetInput("WScale");
+    auto* B = GetInput("B");
+    auto& output0 = GetOutput("Out");
+
+    CHECK_EQ(input0->shape().size(), 2UL);
+    CHECK_EQ(W->shape().size(), 2UL);
+    CHECK_EQ(input0->shape()[1], W->shape()[1]);
+    CHECK_EQ(w_scale->shape().size(), 1UL);
+    CHECK_EQ(w_scale->shape()[0], W->shape()[0]);
+    if (B) CHECK_EQ(B->shape().data, w_scale->shape().data);
+
+    std::vector<int> shape({input0->shape()[0], W->shape()[0]});
+    output0.set_shape(Shape(shape));
+    accumulator()->set_shape(Shape(shape));
+
+    // set iterators
+    ir::Expr i, j, k;
+    i = input0->iterators()[0];
+    k = W->iterators()[0];
+    j = W->iterators()[1];
+
+    input0->set_iterators({i, k});
+    W->set_iterators({j, k});
+    w_scale->set_iterators({j});
+    if (B) B->set_iterators({j});
+    output0.set_iterators({i, j});
+    accumulator()->set_iterators({i, j});
+  }
+
+  void CompileImpl() override {
+    LOG_INDENT(1);
+    auto* input0 = GetInput("X");
+    auto* W = GetInput("W");
+    auto* w_scale = GetInput("WScale");
+    auto* B = GetInput("B");
+    auto& output0 = GetOutput("Out");
+    auto* acc = accumulator();
+    auto& the_param = param<QuantizedMatMulParam>();
+
+    // The int8 products are accumulated by the AVX2 kernel of the runtime, the vectorizer only supports floats.
+    const int M = input0->shape()[0];
+    const int N = W->shape()[0];
+    const int K = W->shape()[1];
+    TensorAppendExpr(&output0,  //
+                     ir::Call::make("cinn_gemm_s8",
+                                    {input0->expr(), W->expr(), acc->expr(), Expr(M), Expr(N), Expr(K)}));
+
+    Expr value = ir::Cast::make(acc->Elem(), primitive_t::float32) * (Expr(the_param.x_scale) * w_scale->Elem());
+    if (B) value = value + B->Elem();
+    if (the_param.out_scale > 0.f) value = QuantizeExpr(value, the_param.out_scale);
+
+    TensorAppendExpr(&output0,  //
+                     output0.Elem() = value);
+  }
+
+  Tensor* accumulator() {
+    auto* tensor = session_->GetTensor(param<QuantizedMatMulParam>().accumulator);
+    CHECK(tensor) << "accumulator of quantized_matmul is not declared";
+    return tensor;
   }
 };
 
@@ -134,3 +249,4 @@ class MatMulTransposedOp : public Operator {
 
 REGISTER_OP(matmul, kInstructionWise, ::cinn::hlir::instruction_layer::MatMulOp);
 REGISTER_OP(matmul_transposed, kInstructionWise, ::cinn::hlir::instruction_layer::MatMulTransposedOp);
+REGISTER_OP(quantized_matmul, kInstructionWise, ::cinn::hlir::instruction_layer::QuantizedMatMulOp);
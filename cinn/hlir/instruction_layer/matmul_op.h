@@ -1,4 +1,5 @@
 #pragma once
+#include <string>
 
 namespace cinn {
 namespace hlir {
@@ -8,6 +9,18 @@ struct MatMulParam {};
 
 using MatMulTransposedParam = MatMulParam;
 
+/**
+ * Param of the int8 quantized matmul, the real values are `x = X * x_scale` and `w[j] = W[j] * WScale[j]`.
+ */
+struct QuantizedMatMulParam {
+  //! Scale of the input X.
+  float x_scale{1.f};
+  //! Scale of the int8 output, the output is left in float32 if it is not positive.
+  float out_scale{0.f};
+  //! Name of the int32 temporary variable to accumulate the products.
+  std::string accumulator;
+};
+
 }  // namespace instruction_layer
 }  // namespace hlir
 }  // namespace cinn
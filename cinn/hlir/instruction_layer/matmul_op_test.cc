@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 #include "cinn/backends/code_gen_c.h"
 #include "cinn/core/function.h"
+#include "cinn/hlir/instruction_layer/matmul_op.h"
 #include "cinn/hlir/instruction_layer/use_ops.h"
 #include "cinn/hlir/op_registry.h"
 
@@ -66,6 +67,64 @@ TEST(matmul_op, test) {
   ASSERT_EQ(gen.compiled_code(), target);
 }
 
+TEST(matmul_op, float16_weight) {
+  SetGlobalContext(new CINNContext);
+
+  auto op = OpRegistry::Global().CreateOp(HlirLayer::kInstructionWise, "matmul");
+  ASSERT_TRUE(op);
+
+  Session session;
+  auto *input0 = session.NewTensor("x");
+  auto *input1 = session.NewTensor("w");
+  auto *output = session.NewTensor("out");
+
+  input0->set_ptype(primitive_t::float32);
+  input1->set_ptype(primitive_t::float16);
+
+  input0->set_shape({20, 30});
+  input1->set_shape({30, 40});
+
+  op->set_session(&session);
+
+  op->SetInput("X", "x");
+  op->SetInput("W", "w");
+  op->SetOutput("Out", "out");
+
+  op->Compile();
+  ASSERT_EQ(output->ptype(), primitive_t::float32);
+
+  Function fn("complex");
+  {
+    for (auto &stage : output->stages()) {
+      fn.AddStage(stage);
+    }
+    fn.Inputs({input0->expr(), input1->expr()});
+    fn.Outputs({output->expr()});
+    fn.EndDefinition();
+  }
+
+  backends::C_CodeGen gen;
+  gen.Print(fn.ir_function());
+
+  std::string target = R"ROC(void complex (cinn_float32_t* x, cinn_float16_t* w, cinn_float32_t* out) {
+  for (int c0 = 0; (c0 <= 19); c0 += 1) {
+    for (int c1 = 0; (c1 <= 39); c1 += 1) {
+      out[c0, c1] = 0;
+    }
+  }
+  for (int c0 = 0; (c0 <= 19); c0 += 1) {
+    for (int c1 = 0; (c1 <= 39); c1 += 1) {
+      for (int c2 = 0; (c2 <= 29); c2 += 1) {
+        out[c0, c1] += (x[c0, c2] * cinn_float16_to_float32(w[c2, c1]));
+      }
+    }
+  }
+})ROC";
+
+  LOG(INFO) << "generated code:" << std::endl << gen.compiled_code() << std::endl;
+  ASSERT_EQ(gen.compiled_code(), target);
+}
+
 TEST(matmul_transposed_op, test) {
   SetGlobalContext(new CINNContext);
 
@@ -123,6 +182,66 @@ TEST(matmul_transposed_op, test) {
   ASSERT_EQ(gen.compiled_code(), target);
 }
 
+TEST(quantized_matmul_op, test) {
+  SetGlobalContext(new CINNContext);
+
+  auto op = OpRegistry::Global().CreateOp(HlirLayer::kInstructionWise, "quantized_matmul");
+  ASSERT_TRUE(op);
+
+  Session session;
+  auto *input0 = session.NewTensor("x");
+  auto *input1 = session.NewTensor("w");
+  auto *w_scale = session.NewTensor("w_scale");
+  auto *acc = session.NewTensor("acc");
+  auto *output = session.NewTensor("out");
+
+  input0->set_ptype(primitive_t::int8);
+  input1->set_ptype(primitive_t::int8);
+  w_scale->set_ptype(primitive_t::float32);
+
+  input0->set_shape({20, 30});
+  input1->set_shape({40, 30});
+  w_scale->set_shape({40});
+
+  op->set_session(&session);
+
+  op->SetInput("X", "x");
+  op->SetInput("W", "w");
+  op->SetInput("WScale", "w_scale");
+  op->SetOutput("Out", "out");
+  op->param<QuantizedMatMulParam>().x_scale = 0.5f;
+  op->param<QuantizedMatMulParam>().accumulator = "acc";
+
+  op->Compile();
+  ASSERT_EQ(output->ptype(), primitive_t::float32);
+  ASSERT_EQ(acc->ptype(), primitive_t::int32);
+
+  Function fn("complex");
+  {
+    for (auto &stage : output->stages()) {
+      fn.AddStage(stage);
+    }
+    fn.Inputs({input0->expr(), input1->expr(), w_scale->expr()});
+    fn.Outputs({output->expr()});
+    fn.EndDefinition();
+  }
+
+  backends::C_CodeGen gen;
+  gen.Print(fn.ir_function());
+  std::string target =
+      R"ROC(void complex (cinn_int8_t* x, cinn_int8_t* w, cinn_float32_t* w_scale, cinn_float32_t* out) {
+  cinn_gemm_s8(x, w, acc, 20, 40, 30);
+  for (int c0 = 0; (c0 <= 19); c0 += 1) {
+    for (int c1 = 0; (c1 <= 39); c1 += 1) {
+      out[c0, c1] = ((cinn_float32_t)(acc[c0, c1]) * (0.5 * w_scale[c1]));
+    }
+  }
+})ROC";
+
+  LOG(INFO) << "generated code:" << std::endl << gen.compiled_code() << std::endl;
+  ASSERT_EQ(gen.compiled_code(), target);
+}
+
 }  // namespace instruction_layer
 }  // namespace hlir
 }  // namespace cinn
@@ -0,0 +1,350 @@
+#include "cinn/hlir/instruction_layer/normalization_ops.h"
+#include <limits>
+#include <string>
+#include <vector>
+#include "cinn/hlir/op_registry.h"
+#include "cinn/hlir/operator.h"
+#include "cinn/ir/ir.h"
+#include "cinn/ir/ops_overload.h"
+#include "cinn/utils/logging.h"
+#include "cinn/utils/string.h"
+
+namespace cinn {
+namespace hlir {
+namespace instruction_layer {
+
+/**
+ * The base of the operators normalize each row of the last dimension, the input is viewed as the rows [...] of D
+ * elements, and the statistics of the rows are kept in the temporary variables of the shape [...].
+ */
+class RowNormalization : public Operator {
+ public:
+  explicit RowNormalization(const std::string& type) : Operator(type, HlirLayer::kInstructionWise, nullptr) {}
+
+ protected:
+  //! Create the iterators of the rows, one for each dimension except the last.
+  void InitRowIterators(const Tensor* x) {
+    CHECK_GE(x->shape().size(), 2UL) << "the input of " << type() << " should have the rows";
+    rows_.assign(x->shape().size() - 1, ir::Var());
+  }
+
+  //! The element of a row at `d`.
+  Expr RowElem(const Tensor* t, Expr d) const {
+    std::vector<Expr> indices(rows_.begin(), rows_.end());
+    indices.push_back(d);
+    return t->Elem(indices);
+  }
+
+  //! The statistic of the row.
+  Expr RowStat(const Tensor* t) const { return t->Elem(std::vector<Expr>(rows_.begin(), rows_.end())); }
+
+  //! The iterators of the rows followed by the `inner` ones.
+  std::vector<ir::Var> RowIterators(const std::vector<ir::Var>& inner) const {
+    std::vector<ir::Var> iterators(rows_);
+    iterators.insert(iterators.end(), inner.begin(), inner.end());
+    return iterators;
+  }
+
+  //! The shape of the rows followed by `inner`.
+  static std::vector<int> RowShape(const Tensor* x, const std::vector<int>& inner = {}) {
+    std::vector<int> shape(x->shape().data.begin(), x->shape().data.end() - 1);
+    shape.insert(shape.end(), inner.begin(), inner.end());
+    return shape;
+  }
+
+  Tensor* GetTmpVar(const std::string& name) {
+    CHECK(!name.empty()) << "temporary variable of " << type() << " is not declared";
+    auto* tensor = session_->GetTensor(name);
+    CHECK(tensor) << "temporary variable " << name << " of " << type() << " is not declared";
+    return tensor;
+  }
+
+  std::vector<ir::Var> rows_;
+};
+
+/**
+ * The softmax over the last dimension.
+ *
+ * The rows are reduced in the stages
+ *
+ * 1. the maximum of each row. If the row can be vectorized by w lanes, the row is read as the vectors of w elements
+ *    and each lane keeps its own maximum in a temporary variable [..., w], so that the reduction is vectorized, and
+ *    the maxima of the lanes are combined after that,
+ * 2. the exponent of the element minus the maximum is written to the output, and added to the sum of the row,
+ *    these two stages iterate the same elements of the row and are fused in one pass,
+ * 3. the reciprocal of the sum of each row,
+ * 4. the output is scaled by the reciprocal.
+ *
+ * The input is read twice, the exponents are computed only once. All the elementwise stages are vectorized with the
+ * SIMD exp, and the sum is reduced in vector registers by the vector_accumulate pass.
+ */
+class Softmax : public RowNormalization {
+ public:
+  Softmax() : RowNormalization("softmax") { param_.set(SoftmaxParam()); }
+
+ protected:
+  void InferenceOutputType() override {
+    const auto* x = GetInput("X");
+    auto& output0 = GetOutput("Out");
+
+    CHECK_EQ(x->ptype(), primitive_t::float32);
+    output0.set_ptype(x->ptype());
+    for (auto* tmp : {lanes(), max(), sum()}) tmp->set_ptype(x->ptype());
+  }
+
+  void Resize() override {
+    const auto* x = GetInput("X");
+    auto& output0 = GetOutput("Out");
+
+    CHECK_GE(x->shape().size(), 2UL) << "the input of softmax should have the rows";
+    output0.set_shape(x->shape());
+    const int width = VectorWidth(x->shape().data.back());
+    lanes()->set_shape(RowShape(x, {width ? width : 1}));
+    max()->set_shape(RowShape(x));
+    sum()->set_shape(RowShape(x));
+  }
+
+  void CompileImpl() override {
+    LOG_INDENT(1);
+    const auto* x = GetInput("X");
+    auto& output0 = GetOutput("Out");
+    auto* row_max = max();
+    auto* row_sum = sum();
+
+    InitRowIterators(x);
+    const int D = x->shape().data.back();
+    const int width = VectorWidth(D);
+    const Expr lowest(std::numeric_limits<float>::lowest());
+
+    // 1. the maximum.
+    if (width) {
+      auto* lane_max = lanes();
+      TensorAppendExpr(&output0, lane_max->Elem().Assign(lowest));
+      ir::Var k, l;
+      std::vector<Expr> lane_indices(rows_.begin(), rows_.end());
+      lane_indices.push_back(l);
+      auto lane = [&] { return lane_max->Elem(lane_indices); };
+      Expr reduce = lane().Assign(Max_(lane(), RowElem(x, Expr(k) * Expr(width) + l)));
+      Stage stage = TensorAppendExpr(&output0, reduce, RowIterators({k, l}));
+      // k appears only combined with the lane.
+      stage.SetCond(k, ">= 0");
+      stage.SetCond(k, StringFormat("< %d", D / width));
+      stage.Vectorize(width);
+
+      Expr value;
+      for (int i = 0; i < width; i++) {
+        lane_indices.back() = Expr(i);
+        value = value.valid() ? Max_(value, lane()) : lane();
+      }
+      TensorAppendExpr(&output0, RowStat(row_max).Assign(value), rows_);
+    } else {
+      ir::Var d;
+      TensorAppendExpr(&output0, row_max->Elem().Assign(lowest));
+      Expr reduce = RowStat(row_max).Assign(Max_(RowStat(row_max), RowElem(x, d)));
+      TensorAppendExpr(&output0, reduce, RowIterators({d}));
+    }
+
+    // 2. the exponents and their sum.
+    ir::Var d;
+    TensorAppendExpr(&output0, row_sum->Elem().Assign(Expr(0.f)));
+    Stage exp_stage = TensorAppendExpr(
+        &output0, RowElem(&output0, d).Assign(Exp_(RowElem(x, d) - RowStat(row_max))), RowIterators({d}));
+    Stage sum_stage = TensorAppendExpr(&output0, RowStat(row_sum).SumAssign(RowElem(&output0, d)), RowIterators({d}));
+    sum_stage.FuseWith(exp_stage);
+
+    // 3. the reciprocal.
+    TensorAppendExpr(&output0, RowStat(row_sum).Assign(Expr(1.f) / RowStat(row_sum)), rows_);
+
+    // 4. scale.
+    Stage scale_stage = TensorAppendExpr(
+        &output0, RowElem(&output0, d).Assign(RowElem(&output0, d) * RowStat(row_sum)), RowIterators({d}));
+
+    if (width) {
+      for (auto* stage : {&exp_stage, &sum_stage, &scale_stage}) stage->Vectorize(width);
+    }
+  }
+
+ private:
+  Tensor* lanes() { return GetTmpVar(param<SoftmaxParam>().lanes); }
+  Tensor* max() { return GetTmpVar(param<SoftmaxParam>().max); }
+  Tensor* sum() { return GetTmpVar(param<SoftmaxParam>().sum); }
+};
+
+/**
+ * The layer normalization over the last dimension.
+ *
+ * The mean and the variance are computed in a single pass over the input, accumulating the sum and the sum of squares
+ * of the elements shifted by the first element of the row K,
+ *
+ *     mean = K + sum(x - K) / D, variance = sum((x - K)^2) / D - (sum(x - K) / D)^2,
+ *
+ * the shift makes the sums close to zero when the elements are close to each other, so unlike the naive sum of
+ * squares there is no catastrophic cancellation if the mean is large compared to the deviation. The two sums are
+ * accumulated in vector registers in the same loop. Then the reciprocal of the standard deviation of each row is
+ * computed, and the output is normalized in the second pass, scaled and biased in the same expression.
+ */
+class LayerNorm : public RowNormalization {
+ public:
+  LayerNorm() : RowNormalization("layer_norm") { param_.set(LayerNormParam()); }
+
+ protected:
+  void InferenceOutputType() override {
+    const auto* x = GetInput("X");
+    const auto* scale = GetInput("Scale");
+    const auto* bias = GetInput("Bias");
+    auto& output0 = GetOutput("Out");
+
+    CHECK_EQ(x->ptype(), primitive_t::float32);
+    if (scale) CHECK_EQ(scale->ptype(), primitive_t::float32);
+    if (bias) CHECK_EQ(bias->ptype(), primitive_t::float32);
+    output0.set_ptype(x->ptype());
+    mean()->set_ptype(x->ptype());
+    variance()->set_ptype(x->ptype());
+  }
+
+  void Resize() override {
+    const auto* x = GetInput("X");
+    const auto* scale = GetInput("Scale");
+    const auto* bias = GetInput("Bias");
+    auto& output0 = GetOutput("Out");
+
+    CHECK_GE(x->shape().size(), 2UL) << "the input of layer_norm should have the rows";
+    const int D = x->shape().data.back();
+    for (const auto* t : {scale, bias}) {
+      if (!t) continue;
+      CHECK_EQ(t->shape().size(), 1UL);
+      CHECK_EQ(t->shape()[0], D);
+    }
+    CHECK_GT(param<LayerNormParam>().epsilon, 0.f);
+    output0.set_shape(x->shape());
+    mean()->set_shape(RowShape(x));
+    variance()->set_shape(RowShape(x));
+  }
+
+  void CompileImpl() override {
+    LOG_INDENT(1);
+    const auto* x = GetInput("X");
+    const auto* scale = GetInput("Scale");
+    const auto* bias = GetInput("Bias");
+    auto& output0 = GetOutput("Out");
+    auto* row_mean = mean();
+    auto* row_variance = variance();
+
+    InitRowIterators(x);
+    const int D = x->shape().data.back();
+    const int width = VectorWidth(D);
+    ir::Var d;
+    auto shifted = [&] { return RowElem(x, d) - RowElem(x, Expr(0)); };
+
+    // 1. the shifted sums in a single pass.
+    TensorAppendExpr(&output0, row_mean->Elem().Assign(Expr(0.f)));
+    TensorAppendExpr(&output0, row_variance->Elem().Assign(Expr(0.f)));
+    Stage sum_stage = TensorAppendExpr(&output0, RowStat(row_mean).SumAssign(shifted()), RowIterators({d}));
+    Stage square_stage =
+        TensorAppendExpr(&output0, RowStat(row_variance).SumAssign(shifted() * shifted()), RowIterators({d}));
+    square_stage.FuseWith(sum_stage);
+
+    // 2. the shifted mean and the reciprocal of the standard deviation.
+    const Expr count(static_cast<float>(D));
+    TensorAppendExpr(&output0, RowStat(row_mean).Assign(RowStat(row_mean) / count), rows_);
+    Expr variance = RowStat(row_variance) / count - RowStat(row_mean) * RowStat(row_mean);
+    Expr epsilon(param<LayerNormParam>().epsilon);
+    // The cancellation can make the variance slightly negative for the constant rows.
+    variance = Max_(variance, Expr(0.f));
+    TensorAppendExpr(&output0, RowStat(row_variance).Assign(Expr(1.f) / Sqrt_(variance + epsilon)), rows_);
+
+    // 3. normalize.
+    Expr value = (shifted() - RowStat(row_mean)) * RowStat(row_variance);
+    if (scale) value = value * scale->Elem({d});
+    if (bias) value = value + bias->Elem({d});
+    Stage normalize_stage = TensorAppendExpr(&output0, RowElem(&output0, d).Assign(value), RowIterators({d}));
+
+    if (width) {
+      for (auto* stage : {&sum_stage, &square_stage, &normalize_stage}) stage->Vectorize(width);
+    }
+  }
+
+ private:
+  Tensor* mean() { return GetTmpVar(param<LayerNormParam>().mean); }
+  Tensor* variance() { return GetTmpVar(param<LayerNormParam>().variance); }
+};
+
+/**
+ * The inference batch normalization, or the per-channel affine transform without the statistics.
+ *
+ * It is lowered to a single elementwise stage. Without the statistics the stage is vectorized, the channel parameters
+ * are broadcasted if the channels are not the innermost dimension.
+ */
+class BatchNorm : public Operator {
+ public:
+  BatchNorm() : Operator("batch_norm", HlirLayer::kInstructionWise, nullptr) { param_.set(BatchNormParam()); }
+
+ protected:
+  void InferenceOutputType() override {
+    const auto* x = GetInput("X");
+    auto& output0 = GetOutput("Out");
+
+    CHECK_EQ(x->ptype(), primitive_t::float32);
+    for (const auto* t : channel_params()) {
+      if (t) CHECK_EQ(t->ptype(), primitive_t::float32);
+    }
+    output0.set_ptype(x->ptype());
+  }
+
+  void Resize() override {
+    const auto* x = GetInput("X");
+    auto& output0 = GetOutput("Out");
+    auto& the_param = param<BatchNormParam>();
+
+    CHECK_GE(the_param.axis, 0);
+    CHECK_LT(the_param.axis, static_cast<int>(x->shape().size()));
+    CHECK_EQ(!GetInput("Mean"), !GetInput("Variance")) << "the mean and the variance should be given together";
+    CHECK_GT(the_param.epsilon, 0.f);
+    const int C = x->shape()[the_param.axis];
+    for (const auto* t : channel_params()) {
+      if (!t) continue;
+      CHECK_EQ(t->shape().size(), 1UL);
+      CHECK_EQ(t->shape()[0], C);
+    }
+    output0.set_shape(x->shape());
+  }
+
+  void CompileImpl() override {
+    LOG_INDENT(1);
+    const auto* x = GetInput("X");
+    const auto* scale = GetInput("Scale");
+    const auto* bias = GetInput("Bias");
+    const auto* mean = GetInput("Mean");
+    const auto* variance = GetInput("Variance");
+    auto& output0 = GetOutput("Out");
+    auto& the_param = param<BatchNormParam>();
+
+    std::vector<ir::Var> iterators(x->shape().size());
+    std::vector<Expr> indices(iterators.begin(), iterators.end());
+    Expr c = indices[the_param.axis];
+
+    Expr value = x->Elem(indices);
+    if (mean) {
+      value = (value - mean->Elem({c})) / Sqrt_(variance->Elem({c}) + Expr(the_param.epsilon));
+    }
+    if (scale) value = value * scale->Elem({c});
+    if (bias) value = value + bias->Elem({c});
+    Stage stage = TensorAppendExpr(&output0, output0.Elem(indices).Assign(value), iterators);
+
+    int width = VectorWidth(x->shape().data.back());
+    if (width && !mean) stage.Vectorize(width);
+  }
+
+ private:
+  std::vector<const Tensor*> channel_params() const {
+    return {GetInput("Scale"), GetInput("Bias"), GetInput("Mean"), GetInput("Variance")};
+  }
+};
+
+}  // namespace instruction_layer
+}  // namespace hlir
+}  // namespace cinn
+
+REGISTER_OP(softmax, kInstructionWise, ::cinn::hlir::instruction_layer::Softmax);
+REGISTER_OP(layer_norm, kInstructionWise, ::cinn::hlir::instruction_layer::LayerNorm);
+REGISTER_OP(batch_norm, kInstructionWise, ::cinn::hlir::instruction_layer::BatchNorm);
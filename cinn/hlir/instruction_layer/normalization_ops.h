@@ -0,0 +1,59 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace cinn {
+namespace hlir {
+namespace instruction_layer {
+
+/**
+ * Param of the softmax over the last dimension.
+ *
+ * Input: X [..., D], each row of D elements is normalized independently. Output: Out, the same shape as X,
+ * Out[r, d] = exp(X[r, d] - max(X[r])) / sum(exp(X[r] - max(X[r]))).
+ */
+struct SoftmaxParam {
+  //! Name of the temporary variable holds the partial maxima of the vector lanes [..., w], w is the vector width.
+  std::string lanes;
+  //! Name of the temporary variable holds the maximum of each row [...].
+  std::string max;
+  //! Name of the temporary variable holds the sum of the exponents of each row, and then its reciprocal [...].
+  std::string sum;
+};
+
+/**
+ * Param of the layer normalization over the last dimension.
+ *
+ * Inputs: X [..., D], an optional Scale [D] and an optional Bias [D]. Output: Out, the same shape as X,
+ * Out[r, d] = (X[r, d] - mean(X[r])) / sqrt(variance(X[r]) + epsilon) * Scale[d] + Bias[d].
+ */
+struct LayerNormParam {
+  float epsilon{1e-5f};
+
+  //! Name of the temporary variable holds the mean of each row shifted by its first element [...].
+  std::string mean;
+  //! Name of the temporary variable holds the variance of each row, and then the reciprocal of the standard
+  //! deviation [...].
+  std::string variance;
+};
+
+/**
+ * Param of the inference batch normalization, it normalizes each channel with the statistics collected in training.
+ *
+ * Inputs: X, the channels are at `axis`, the optional Scale [C], Bias [C], Mean [C] and Variance [C]. Output: Out, the
+ * same shape as X, Out = (X - Mean[c]) / sqrt(Variance[c] + epsilon) * Scale[c] + Bias[c]. Without the Mean and
+ * Variance, it is a per-channel affine transform, Out = X * Scale[c] + Bias[c].
+ *
+ * It is folded into the weights of the preceding convolution or fully connected layer at build time if possible, see
+ * the fold_batch_norm pass.
+ */
+struct BatchNormParam {
+  float epsilon{1e-5f};
+  //! The axis of the channels, 1 for NCHW and the [N, C] inputs, 3 for NHWC.
+  int axis{1};
+};
+
+}  // namespace instruction_layer
+}  // namespace hlir
+}  // namespace cinn
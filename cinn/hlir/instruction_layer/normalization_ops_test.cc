@@ -0,0 +1,173 @@
+#include "cinn/hlir/instruction_layer/normalization_ops.h"
+#include <gtest/gtest.h>
+#include <string>
+#include "cinn/backends/code_gen_c.h"
+#include "cinn/core/function.h"
+#include "cinn/hlir/instruction_layer/use_ops.h"
+#include "cinn/hlir/op_registry.h"
+
+namespace cinn {
+namespace hlir {
+namespace instruction_layer {
+
+TEST(softmax_op, test) {
+  SetGlobalContext(new CINNContext);
+
+  auto op = OpRegistry::Global().CreateOp(HlirLayer::kInstructionWise, "softmax");
+  ASSERT_TRUE(op);
+
+  auto &param = op->param<SoftmaxParam>();
+  param.lanes = "lanes";
+  param.max = "max";
+  param.sum = "sum";
+
+  Session session;
+  auto *x = session.NewTensor("x");
+  auto *lanes = session.NewTensor("lanes");
+  auto *max = session.NewTensor("max");
+  auto *sum = session.NewTensor("sum");
+  auto *output = session.NewTensor("out");
+
+  x->set_ptype(primitive_t::float32);
+  x->set_shape({4, 6, 32});
+
+  op->set_session(&session);
+
+  op->SetInput("X", "x");
+  op->SetOutput("Out", "out");
+
+  op->Compile();
+
+  ASSERT_EQ(output->shape().data, std::vector<int>({4, 6, 32}));
+  ASSERT_EQ(lanes->shape().data, std::vector<int>({4, 6, 8}));
+  ASSERT_EQ(max->shape().data, std::vector<int>({4, 6}));
+  ASSERT_EQ(sum->shape().data, std::vector<int>({4, 6}));
+  // the maximum of the lanes, the maximum of the rows, the exponents, their sum, the reciprocal and the scale.
+  ASSERT_EQ(output->stages().size(), 8UL);
+
+  Function fn("softmax");
+  {
+    for (auto &stage : output->stages()) {
+      fn.AddStage(stage);
+    }
+    fn.Inputs({x->expr(), lanes->expr(), max->expr(), sum->expr()});
+    fn.Outputs({output->expr()});
+    fn.EndDefinition();
+  }
+
+  backends::C_CodeGen gen;
+  gen.Print(fn.ir_function());
+
+  LOG(INFO) << "generated code:\n" << gen.compiled_code();
+}
+
+TEST(layer_norm_op, test) {
+  SetGlobalContext(new CINNContext);
+
+  auto op = OpRegistry::Global().CreateOp(HlirLayer::kInstructionWise, "layer_norm");
+  ASSERT_TRUE(op);
+
+  auto &param = op->param<LayerNormParam>();
+  param.mean = "mean";
+  param.variance = "variance";
+
+  Session session;
+  auto *x = session.NewTensor("x");
+  auto *scale = session.NewTensor("scale");
+  auto *bias = session.NewTensor("bias");
+  auto *mean = session.NewTensor("mean");
+  auto *variance = session.NewTensor("variance");
+  auto *output = session.NewTensor("out");
+
+  x->set_ptype(primitive_t::float32);
+  x->set_shape({16, 64});
+  scale->set_ptype(primitive_t::float32);
+  scale->set_shape({64});
+  bias->set_ptype(primitive_t::float32);
+  bias->set_shape({64});
+
+  op->set_session(&session);
+
+  op->SetInput("X", "x");
+  op->SetInput("Scale", "scale");
+  op->SetInput("Bias", "bias");
+  op->SetOutput("Out", "out");
+
+  op->Compile();
+
+  ASSERT_EQ(output->shape().data, std::vector<int>({16, 64}));
+  ASSERT_EQ(mean->shape().data, std::vector<int>({16}));
+  ASSERT_EQ(variance->shape().data, std::vector<int>({16}));
+  // init the two sums, accumulate them, the mean, the standard deviation and normalize.
+  ASSERT_EQ(output->stages().size(), 7UL);
+
+  Function fn("layer_norm");
+  {
+    for (auto &stage : output->stages()) {
+      fn.AddStage(stage);
+    }
+    fn.Inputs({x->expr(), scale->expr(), bias->expr(), mean->expr(), variance->expr()});
+    fn.Outputs({output->expr()});
+    fn.EndDefinition();
+  }
+
+  backends::C_CodeGen gen;
+  gen.Print(fn.ir_function());
+
+  LOG(INFO) << "generated code:\n" << gen.compiled_code();
+}
+
+TEST(batch_norm_op, test) {
+  SetGlobalContext(new CINNContext);
+
+  auto op = OpRegistry::Global().CreateOp(HlirLayer::kInstructionWise, "batch_norm");
+  ASSERT_TRUE(op);
+
+  Session session;
+  auto *x = session.NewTensor("x");
+  auto *scale = session.NewTensor("scale");
+  auto *bias = session.NewTensor("bias");
+  auto *mean = session.NewTensor("mean");
+  auto *variance = session.NewTensor("variance");
+  auto *output = session.NewTensor("out");
+
+  x->set_ptype(primitive_t::float32);
+  x->set_shape({2, 16, 8, 8});
+  for (auto *t : {scale, bias, mean, variance}) {
+    t->set_ptype(primitive_t::float32);
+    t->set_shape({16});
+  }
+
+  op->set_session(&session);
+
+  op->SetInput("X", "x");
+  op->SetInput("Scale", "scale");
+  op->SetInput("Bias", "bias");
+  op->SetInput("Mean", "mean");
+  op->SetInput("Variance", "variance");
+  op->SetOutput("Out", "out");
+
+  op->Compile();
+
+  ASSERT_EQ(output->shape().data, std::vector<int>({2, 16, 8, 8}));
+  ASSERT_EQ(output->stages().size(), 1UL);
+
+  Function fn("batch_norm");
+  {
+    for (auto &stage : output->stages()) {
+      fn.AddStage(stage);
+    }
+    fn.Inputs({x->expr(), scale->expr(), bias->expr(), mean->expr(), variance->expr()});
+    fn.Outputs({output->expr()});
+    fn.EndDefinition();
+  }
+
+  backends::C_CodeGen gen;
+  gen.Print(fn.ir_function());
+
+  LOG(INFO) << "generated code:\n" << gen.compiled_code();
+}
+
+}  // namespace instruction_layer
+}  // namespace hlir
+}  // namespace cinn
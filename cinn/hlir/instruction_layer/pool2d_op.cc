@@ -0,0 +1,184 @@
+#include "cinn/hlir/instruction_layer/pool2d_op.h"
+#include <limits>
+#include <vector>
+#include "cinn/hlir/op_registry.h"
+#include "cinn/hlir/operator.h"
+#include "cinn/ir/ir.h"
+#include "cinn/ir/ops_overload.h"
+#include "cinn/utils/logging.h"
+
+namespace cinn {
+namespace hlir {
+namespace instruction_layer {
+
+/**
+ * The 2D pooling.
+ *
+ * The windowed pooling computes each output element in a single stage, the maximum or the sum of the whole window is
+ * unrolled into one expression, so the partial results are kept in registers instead of written back for each element
+ * of the window. If any padding is not zero, the input is copied to a padded temporary variable filled with the lowest
+ * float for max or zero for average first.
+ *
+ * The global pooling is a reduction over the height and width, lowered to an initialization, an accumulation and a
+ * scale for the average.
+ *
+ * The channels are the innermost loop and vectorized for NHWC, the width is vectorized for NCHW only with stride 1.
+ *
+ * The pooling is not fused into the loops of the operator producing its input, such as a convolution, it takes its own
+ * pass over the input. An output element reads a window of `kernel` rows and columns starting at `strides` times its
+ * position, so the producer should be scheduled a window ahead and at the stride of the pooling. The fusion of the
+ * Builder (Stage::FuseWith) only adds a proximity between the whole iteration domains of the two stages and has no
+ * such alignment, and tiling the producer by the window is not supported by the stage transforms.
+ */
+class Pool2d : public Operator {
+ public:
+  using Layout = Pool2dParam::Layout;
+  using PoolingType = Pool2dParam::PoolingType;
+
+  Pool2d() : Operator("pool2d", HlirLayer::kInstructionWise, nullptr) { param_.set(Pool2dParam()); }
+
+ protected:
+  void InferenceOutputType() override {
+    const auto* x = GetInput("X");
+    auto& output0 = GetOutput("Out");
+
+    CHECK_EQ(x->ptype(), primitive_t::float32);
+    output0.set_ptype(x->ptype());
+    if (param<Pool2dParam>().has_padding()) padded()->set_ptype(x->ptype());
+  }
+
+  void Resize() override {
+    const auto* x = GetInput("X");
+    auto& output0 = GetOutput("Out");
+    auto& the_param = param<Pool2dParam>();
+
+    CHECK_EQ(x->shape().size(), 4UL);
+    const bool nchw = the_param.layout == Layout::kNCHW;
+    const int N = x->shape()[0];
+    const int C = nchw ? x->shape()[1] : x->shape()[3];
+    const int H = nchw ? x->shape()[2] : x->shape()[1];
+    const int W = nchw ? x->shape()[3] : x->shape()[2];
+
+    int OH = 1, OW = 1;
+    if (!the_param.global_pooling) {
+      CHECK_EQ(the_param.kernel.size(), 2UL);
+      CHECK_EQ(the_param.strides.size(), 2UL);
+      CHECK_EQ(the_param.paddings.size(), 2UL);
+      int sizes[2] = {H, W};
+      int outputs[2];
+      for (int i = 0; i < 2; i++) {
+        CHECK_GT(the_param.kernel[i], 0);
+        CHECK_GT(the_param.strides[i], 0);
+        CHECK_GE(the_param.paddings[i], 0);
+        CHECK_LT(the_param.paddings[i], the_param.kernel[i]) << "a window shouldn't be all padding";
+        const int padded_size = sizes[i] + 2 * the_param.paddings[i];
+        CHECK_GE(padded_size, the_param.kernel[i]) << "the kernel is larger than the padded input";
+        outputs[i] = (padded_size - the_param.kernel[i]) / the_param.strides[i] + 1;
+        sizes[i] = padded_size;
+      }
+      OH = outputs[0];
+      OW = outputs[1];
+      if (the_param.has_padding()) {
+        padded()->set_shape(nchw ? std::vector<int>({N, C, sizes[0], sizes[1]})
+                                 : std::vector<int>({N, sizes[0], sizes[1], C}));
+      }
+    }
+    output0.set_shape(nchw ? std::vector<int>({N, C, OH, OW}) : std::vector<int>({N, OH, OW, C}));
+  }
+
+  void CompileImpl() override {
+    LOG_INDENT(1);
+    if (param<Pool2dParam>().global_pooling) {
+      CompileGlobal();
+    } else {
+      CompileWindowed();
+    }
+  }
+
+ private:
+  void CompileWindowed() {
+    const auto* x = GetInput("X");
+    auto& output0 = GetOutput("Out");
+    auto& the_param = param<Pool2dParam>();
+
+    const bool nchw = the_param.layout == Layout::kNCHW;
+    const bool max = the_param.pooling_type == PoolingType::kMax;
+    auto image = [&](const Tensor* t, Expr n, Expr c, Expr h, Expr w) {
+      return nchw ? t->Elem({n, c, h, w}) : t->Elem({n, h, w, c});
+    };
+    auto iterators = [&](const ir::Var& n, const ir::Var& c, const ir::Var& h, const ir::Var& w) {
+      return nchw ? std::vector<ir::Var>({n, c, h, w}) : std::vector<ir::Var>({n, h, w, c});
+    };
+
+    const Tensor* input = x;
+    if (the_param.has_padding()) {
+      Tensor* pad = padded();
+      Expr init = max ? Expr(std::numeric_limits<float>::lowest()) : Expr(0.f);
+      TensorAppendExpr(&output0, pad->Elem().Assign(init));
+      ir::Var n, c, h, w;
+      Expr padded_elem = image(pad, n, c, h + Expr(the_param.paddings[0]), w + Expr(the_param.paddings[1]));
+      TensorAppendExpr(&output0, padded_elem.Assign(image(x, n, c, h, w)), iterators(n, c, h, w));
+      input = pad;
+    }
+
+    ir::Var n, c, oh, ow;
+    Expr value;
+    for (int kh = 0; kh < the_param.kernel[0]; kh++) {
+      for (int kw = 0; kw < the_param.kernel[1]; kw++) {
+        Expr h = the_param.strides[0] == 1 ? Expr(oh) : Expr(oh) * Expr(the_param.strides[0]);
+        Expr w = the_param.strides[1] == 1 ? Expr(ow) : Expr(ow) * Expr(the_param.strides[1]);
+        Expr pixel = image(input, n, c, h + Expr(kh), w + Expr(kw));
+        if (!value.valid()) {
+          value = pixel;
+        } else {
+          value = max ? Max_(value, pixel) : value + pixel;
+        }
+      }
+    }
+    if (!max) value = value / Expr(static_cast<float>(the_param.kernel[0] * the_param.kernel[1]));
+
+    Stage stage = TensorAppendExpr(&output0, image(&output0, n, c, oh, ow).Assign(value), iterators(n, c, oh, ow));
+    // The input of NCHW is read contiguously only with stride 1.
+    int width = VectorWidth(output0.shape()[3]);
+    if (width && (!nchw || the_param.strides[1] == 1)) stage.Vectorize(width);
+  }
+
+  void CompileGlobal() {
+    const auto* x = GetInput("X");
+    auto& output0 = GetOutput("Out");
+    auto& the_param = param<Pool2dParam>();
+
+    const bool nchw = the_param.layout == Layout::kNCHW;
+    const bool max = the_param.pooling_type == PoolingType::kMax;
+    const int H = x->shape()[nchw ? 2 : 1];
+    const int W = x->shape()[nchw ? 3 : 2];
+
+    ir::Var n, c, h, w;
+    auto out = [&] { return nchw ? output0.Elem({n, c, Expr(0), Expr(0)}) : output0.Elem({n, Expr(0), Expr(0), c}); };
+    Expr pixel = nchw ? x->Elem({n, c, h, w}) : x->Elem({n, h, w, c});
+    // The channels are the innermost for NHWC, so the accumulation is vectorized.
+    std::vector<ir::Var> iterators = nchw ? std::vector<ir::Var>({n, c, h, w}) : std::vector<ir::Var>({n, h, w, c});
+    const int width = nchw ? 0 : VectorWidth(output0.shape()[3]);
+
+    Expr init = max ? Expr(std::numeric_limits<float>::lowest()) : Expr(0.f);
+    TensorAppendExpr(&output0, output0.Elem().Assign(init));
+    Expr reduce = max ? out().Assign(Max_(out(), pixel)) : out().SumAssign(pixel);
+    Stage stage = TensorAppendExpr(&output0, reduce, iterators);
+    if (width) stage.Vectorize(width);
+    if (!max) {
+      TensorAppendExpr(&output0, output0.Elem().Assign(output0.Elem() / Expr(static_cast<float>(H * W))));
+    }
+  }
+
+  Tensor* padded() {
+    auto* tensor = session_->GetTensor(param<Pool2dParam>().padded);
+    CHECK(tensor) << "padded input of pool2d is not declared";
+    return tensor;
+  }
+};
+
+}  // namespace instruction_layer
+}  // namespace hlir
+}  // namespace cinn
+
+REGISTER_OP(pool2d, kInstructionWise, ::cinn::hlir::instruction_layer::Pool2d);
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "cinn/hlir/instruction_layer/conv2d_op.h"
+
+namespace cinn {
+namespace hlir {
+namespace instruction_layer {
+
+/**
+ * Param of the 2D pooling.
+ *
+ * Input: X [N, C, H, W] for NCHW or [N, H, W, C] for NHWC. Output: Out [N, C, OH, OW] or [N, OH, OW, C], where
+ * OH = (H + 2 * padding_h - kernel_h) / stride_h + 1, and OW is similar. The global pooling outputs a single element
+ * for each channel, OH = OW = 1.
+ */
+struct Pool2dParam {
+  using Layout = Conv2dParam::Layout;
+
+  enum class PoolingType {
+    kMax = 0,
+    //! The average counts the padded zeros in.
+    kAvg,
+  };
+
+  PoolingType pooling_type{PoolingType::kMax};
+  //! Pool the whole image of each channel, the kernel, strides and paddings are ignored.
+  bool global_pooling{false};
+  //! The window of the height and width.
+  std::vector<int> kernel{{2, 2}};
+  //! The strides of the height and width.
+  std::vector<int> strides{{2, 2}};
+  //! The paddings of the height and width, the same on the both sides.
+  std::vector<int> paddings{{0, 0}};
+  Layout layout{Layout::kNCHW};
+
+  //! Name of the temporary variable holds the padded input, required if any padding is not zero.
+  std::string padded;
+
+  bool has_padding() const { return !global_pooling && (paddings[0] > 0 || paddings[1] > 0); }
+};
+
+}  // namespace instruction_layer
+}  // namespace hlir
+}  // namespace cinn
@@ -0,0 +1,108 @@
+#include "cinn/hlir/instruction_layer/pool2d_op.h"
+#include <gtest/gtest.h>
+#include <string>
+#include "cinn/backends/code_gen_c.h"
+#include "cinn/core/function.h"
+#include "cinn/hlir/instruction_layer/use_ops.h"
+#include "cinn/hlir/op_registry.h"
+
+namespace cinn {
+namespace hlir {
+namespace instruction_layer {
+
+TEST(pool2d_op, max) {
+  SetGlobalContext(new CINNContext);
+
+  auto op = OpRegistry::Global().CreateOp(HlirLayer::kInstructionWise, "pool2d");
+  ASSERT_TRUE(op);
+
+  auto &param = op->param<Pool2dParam>();
+  param.kernel = {3, 3};
+  param.strides = {2, 2};
+  param.paddings = {1, 1};
+  param.layout = Pool2dParam::Layout::kNHWC;
+  param.padded = "padded";
+
+  Session session;
+  auto *x = session.NewTensor("x");
+  auto *padded = session.NewTensor("padded");
+  auto *output = session.NewTensor("out");
+
+  x->set_ptype(primitive_t::float32);
+  x->set_shape({1, 16, 16, 8});
+
+  op->set_session(&session);
+
+  op->SetInput("X", "x");
+  op->SetOutput("Out", "out");
+
+  op->Compile();
+
+  ASSERT_EQ(output->shape().data, std::vector<int>({1, 8, 8, 8}));
+  ASSERT_EQ(padded->shape().data, std::vector<int>({1, 18, 18, 8}));
+  // fill, copy and pool.
+  ASSERT_EQ(output->stages().size(), 3UL);
+
+  Function fn("max_pool2d");
+  {
+    for (auto &stage : output->stages()) {
+      fn.AddStage(stage);
+    }
+    fn.Inputs({x->expr(), padded->expr()});
+    fn.Outputs({output->expr()});
+    fn.EndDefinition();
+  }
+
+  backends::C_CodeGen gen;
+  gen.Print(fn.ir_function());
+
+  LOG(INFO) << "generated code:\n" << gen.compiled_code();
+}
+
+TEST(pool2d_op, global_avg) {
+  SetGlobalContext(new CINNContext);
+
+  auto op = OpRegistry::Global().CreateOp(HlirLayer::kInstructionWise, "pool2d");
+  ASSERT_TRUE(op);
+
+  auto &param = op->param<Pool2dParam>();
+  param.pooling_type = Pool2dParam::PoolingType::kAvg;
+  param.global_pooling = true;
+
+  Session session;
+  auto *x = session.NewTensor("x");
+  auto *output = session.NewTensor("out");
+
+  x->set_ptype(primitive_t::float32);
+  x->set_shape({2, 16, 7, 7});
+
+  op->set_session(&session);
+
+  op->SetInput("X", "x");
+  op->SetOutput("Out", "out");
+
+  op->Compile();
+
+  ASSERT_EQ(output->shape().data, std::vector<int>({2, 16, 1, 1}));
+  // init, accumulate and scale.
+  ASSERT_EQ(output->stages().size(), 3UL);
+
+  Function fn("global_avg_pool2d");
+  {
+    for (auto &stage : output->stages()) {
+      fn.AddStage(stage);
+    }
+    fn.Inputs({x->expr()});
+    fn.Outputs({output->expr()});
+    fn.EndDefinition();
+  }
+
+  backends::C_CodeGen gen;
+  gen.Print(fn.ir_function());
+
+  LOG(INFO) << "generated code:\n" << gen.compiled_code();
+}
+
+}  // namespace instruction_layer
+}  // namespace hlir
+}  // namespace cinn
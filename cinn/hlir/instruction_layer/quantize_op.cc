@@ -0,0 +1,49 @@
+#include "cinn/hlir/instruction_layer/quantize_op.h"
+#include "cinn/hlir/op_registry.h"
+#include "cinn/hlir/operator.h"
+
+namespace cinn {
+namespace hlir {
+namespace instruction_layer {
+
+ir::Expr QuantizeExpr(ir::Expr value, float scale) {
+  CHECK_GT(scale, 0.f);
+  ir::Expr clamped = ir::Min::make(ir::Max::make(value * Expr(1.f / scale), Expr(-127.f)), Expr(127.f));
+  ir::Expr rounded = ir::Cast::make(clamped + Expr(127.5f), primitive_t::int32) - Expr(127);
+  return ir::Cast::make(rounded, primitive_t::int8);
+}
+
+//! Quantize a float32 tensor to int8.
+class QuantizeOp : public Operator {
+ public:
+  QuantizeOp() : Operator("quantize", HlirLayer::kInstructionWise, nullptr) { param_.set(QuantizeParam()); }
+
+ protected:
+  void InferenceOutputType() override {
+    const auto* x = GetInput("X");
+    auto& out = GetOutput("Out");
+
+    CHECK_EQ(x->ptype(), primitive_t::float32);
+    out.set_ptype(primitive_t::int8);
+  }
+
+  void Resize() override {
+    const auto* x = GetInput("X");
+    auto& out = GetOutput("Out");
+    out.set_shape(x->shape());
+    out.set_iterators(x->iterators());
+  }
+
+  void CompileImpl() override {
+    const auto* x = GetInput("X");
+    auto& out = GetOutput("Out");
+    TensorAppendExpr(&out,  //
+                     out.Elem() = QuantizeExpr(x->Elem(), param<QuantizeParam>().scale));
+  }
+};
+
+}  // namespace instruction_layer
+}  // namespace hlir
+}  // namespace cinn
+
+REGISTER_OP(quantize, kInstructionWise, ::cinn::hlir::instruction_layer::QuantizeOp);
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "cinn/ir/ir.h"
+
+namespace cinn {
+namespace hlir {
+namespace instruction_layer {
+
+struct QuantizeParam {
+  //! The real value is `x = X * scale`.
+  float scale{1.f};
+};
+
+/**
+ * Quantize a float expression to int8 symmetrically, the values are clamped to [-127, 127] and rounded to the nearest.
+ * The clamped value is shifted to be positive before the truncation, so that the rounding needs no function call.
+ */
+ir::Expr QuantizeExpr(ir::Expr value, float scale);
+
+}  // namespace instruction_layer
+}  // namespace hlir
+}  // namespace cinn
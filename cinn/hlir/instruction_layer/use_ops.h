@@ -4,8 +4,16 @@
 USE_OP(pad, kInstructionWise);
 USE_OP(matmul, kInstructionWise);
 USE_OP(matmul_transposed, kInstructionWise);
+USE_OP(quantized_matmul, kInstructionWise);
+USE_OP(quantize, kInstructionWise);
 USE_OP(reshape, kInstructionWise);
 USE_OP(transpose, kInstructionWise);
+USE_OP(conv2d, kInstructionWise);
+USE_OP(depthwise_conv2d, kInstructionWise);
+USE_OP(pool2d, kInstructionWise);
+USE_OP(softmax, kInstructionWise);
+USE_OP(layer_norm, kInstructionWise);
+USE_OP(batch_norm, kInstructionWise);
 
 // elementwise operations
 USE_OP(elementwise_add, kInstructionWise);
@@ -0,0 +1,63 @@
+#include "cinn/hlir/memory_planner.h"
+#include <glog/logging.h>
+#include <algorithm>
+
+namespace cinn {
+namespace hlir {
+
+void MemoryPlanner::AddBuffer(const std::string &name, size_t size, int first_use, int last_use) {
+  CHECK(!planned_) << "add buffer after planned";
+  CHECK(!buffer_ids_.count(name)) << "duplicate add buffer " << name;
+  CHECK_LE(first_use, last_use) << "invalid live range of buffer " << name;
+  buffer_ids_[name] = buffers_.size();
+  buffers_.push_back(Buffer{name, size, first_use, last_use});
+}
+
+void MemoryPlanner::Plan() {
+  CHECK(!planned_) << "duplicate plan";
+  CHECK_GT(alignment_, 0UL);
+
+  std::vector<Buffer *> order;
+  for (auto &buffer : buffers_) order.push_back(&buffer);
+  std::stable_sort(order.begin(), order.end(), [](const Buffer *a, const Buffer *b) { return a->size > b->size; });
+
+  std::vector<const Buffer *> placed;
+  for (auto *buffer : order) {
+    // Collect the placed buffers alive at the same time, and find the lowest gap among them.
+    std::vector<const Buffer *> conflicts;
+    for (auto *other : placed) {
+      if (buffer->LiveOverlap(*other)) conflicts.push_back(other);
+    }
+    std::sort(conflicts.begin(), conflicts.end(), [](const Buffer *a, const Buffer *b) {
+      return a->offset < b->offset;
+    });
+
+    size_t offset = 0;
+    for (auto *other : conflicts) {
+      if (offset + buffer->size <= other->offset) break;
+      offset = std::max(offset, Align(other->offset + other->size));
+    }
+
+    buffer->offset = offset;
+    arena_size_ = std::max(arena_size_, offset + buffer->size);
+    placed.push_back(buffer);
+  }
+
+  planned_ = true;
+}
+
+size_t MemoryPlanner::offset(const std::string &name) const {
+  CHECK(planned_) << "should call Plan first";
+  auto it = buffer_ids_.find(name);
+  CHECK(it != buffer_ids_.end()) << "no buffer called " << name;
+  return buffers_[it->second].offset;
+}
+
+size_t MemoryPlanner::total_size() const {
+  size_t result = 0;
+  for (auto &buffer : buffers_) result += buffer.size;
+  return result;
+}
+
+}  // namespace hlir
+}  // namespace cinn
@@ -0,0 +1,74 @@
+#pragma once
+#include <map>
+#include <string>
+#include <vector>
+
+namespace cinn {
+namespace hlir {
+
+/**
+ * MemoryPlanner places the temporary buffers in a single arena, the buffers whose live ranges don't overlap share the
+ * same memory.
+ *
+ * Usage:
+ *
+ *     MemoryPlanner planner;
+ *     planner.AddBuffer("tmp0", 1024, 0, 1);  // live from step 0 to step 1
+ *     planner.AddBuffer("tmp1", 1024, 2, 3);
+ *     planner.Plan();
+ *     planner.offset("tmp1");  // 0, reuses the memory of tmp0
+ *     planner.arena_size();    // 1024
+ *
+ * The offsets are assigned greedily by size, the larger buffers are placed first in the lowest gap that fits.
+ */
+class MemoryPlanner {
+ public:
+  explicit MemoryPlanner(size_t alignment = 64) : alignment_(alignment) {}
+
+  /**
+   * Add a buffer to plan.
+   * @param name name of the buffer.
+   * @param size size of the buffer in bytes.
+   * @param first_use the first step the buffer is accessed.
+   * @param last_use the last step the buffer is accessed.
+   */
+  void AddBuffer(const std::string& name, size_t size, int first_use, int last_use);
+
+  //! Assign the offsets in the arena for all the buffers.
+  void Plan();
+
+  //! Get the offset of a buffer in the arena, should be called after Plan.
+  size_t offset(const std::string& name) const;
+
+  //! Size of the arena, that is the peak memory footprint of the buffers.
+  size_t arena_size() const { return arena_size_; }
+
+  //! The memory footprint if each buffer is allocated separately.
+  size_t total_size() const;
+
+  size_t alignment() const { return alignment_; }
+
+ private:
+  struct Buffer {
+    std::string name;
+    size_t size;
+    int first_use;
+    int last_use;
+    size_t offset{0};
+
+    bool LiveOverlap(const Buffer& other) const {
+      return first_use <= other.last_use && other.first_use <= last_use;
+    }
+  };
+
+  size_t Align(size_t x) const { return (x + alignment_ - 1) / alignment_ * alignment_; }
+
+  size_t alignment_;
+  std::vector<Buffer> buffers_;
+  std::map<std::string, int> buffer_ids_;
+  size_t arena_size_{0};
+  bool planned_{false};
+};
+
+}  // namespace hlir
+}  // namespace cinn
@@ -0,0 +1,45 @@
+#include "cinn/hlir/memory_planner.h"
+#include <gtest/gtest.h>
+
+namespace cinn {
+namespace hlir {
+
+TEST(MemoryPlanner, reuse) {
+  MemoryPlanner planner(64);
+  // A chain of FC layers, each temporary is only alive between its producer and consumer.
+  planner.AddBuffer("tmp0", 1000, 0, 1);
+  planner.AddBuffer("tmp1", 1000, 1, 2);
+  planner.AddBuffer("tmp2", 1000, 2, 3);
+  planner.AddBuffer("tmp3", 1000, 3, 4);
+  planner.Plan();
+
+  EXPECT_EQ(planner.offset("tmp0"), 0UL);
+  EXPECT_EQ(planner.offset("tmp1"), 1024UL);
+  EXPECT_EQ(planner.offset("tmp2"), 0UL);
+  EXPECT_EQ(planner.offset("tmp3"), 1024UL);
+  EXPECT_EQ(planner.arena_size(), 2024UL);
+  EXPECT_EQ(planner.total_size(), 4000UL);
+}
+
+TEST(MemoryPlanner, gap) {
+  MemoryPlanner planner(16);
+  planner.AddBuffer("big", 256, 0, 1);
+  planner.AddBuffer("long", 64, 0, 4);
+  planner.AddBuffer("small0", 100, 2, 3);
+  planner.AddBuffer("small1", 100, 2, 2);
+  planner.Plan();
+
+  EXPECT_EQ(planner.offset("big"), 0UL);
+  EXPECT_EQ(planner.offset("long"), 256UL);
+  // Placed in the memory of big, which is dead after step 1.
+  EXPECT_EQ(planner.offset("small0"), 0UL);
+  EXPECT_EQ(planner.offset("small1"), 112UL);
+  EXPECT_EQ(planner.arena_size(), 320UL);
+
+  for (auto& name : {"big", "long", "small0", "small1"}) {
+    EXPECT_EQ(planner.offset(name) % planner.alignment(), 0UL);
+  }
+}
+
+}  // namespace hlir
+}  // namespace cinn
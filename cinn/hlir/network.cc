@@ -1,8 +1,12 @@
 #include "cinn/hlir/network.h"
+#include "cinn/hlir/calibrator.h"
+#include "cinn/hlir/instruction_layer/matmul_op.h"
+#include "cinn/hlir/instruction_layer/quantize_op.h"
 #include "cinn/hlir/instruction_layer/reshape_op.h"
 #include "cinn/hlir/instruction_layer/transpose_op.h"
 #include "cinn/hlir/op_registry.h"
 #include "cinn/ir/ir.h"
+#include "cinn/utils/float16.h"
 
 namespace cinn {
 namespace hlir {
@@ -97,7 +101,76 @@ Network::Var Network::AddReshape(const std::vector<int> &shape, Var x) {
   operators_.emplace_back(std::move(op));
 }
 
+int Network::QuantizeMatMuls(const std::map<std::string, float> &scales) {
+  int count = 0;
+  std::set<std::string> float_weights;
+  std::vector<std::unique_ptr<Operator>> operators;
+  for (auto &op : operators_) {
+    if (op->type() != "matmul") {
+      operators.emplace_back(std::move(op));
+      continue;
+    }
+    const std::string &x = op->inputs().at("X");
+    const std::string &w = op->inputs().at("W");
+    const std::string &out = op->outputs().at("Out");
+    auto scale_it = scales.find(x);
+    if (!is_weight(w) || scale_it == scales.end()) {
+      operators.emplace_back(std::move(op));
+      continue;
+    }
+
+    auto *w_tensor = session_->GetTensor(w);
+    CHECK_EQ(w_tensor->ptype(), primitive_t::float32);
+    CHECK_EQ(w_tensor->shape().size(), 2UL);
+    const int k = w_tensor->shape()[0];
+    const int n = w_tensor->shape()[1];
+    std::vector<float> w_scales;
+    auto w_data = QuantizeWeightPerChannel(w_tensor->buffer()->data<std::vector<float>>(), k, n, &w_scales);
+    auto w_int8 = DeclWeight<int8_t>(w + "_int8", primitive_t::int8, Shape({n, k}), w_data);
+    auto w_scale = DeclWeight<float>(w + "_scale", primitive_t::float32, Shape({n}), w_scales);
+
+    auto quantize = OpRegistry::Global().CreateOp(HlirLayer::kInstructionWise, "quantize");
+    quantize->set_session(session_);
+    quantize->SetInput("X", x);
+    quantize->param<instruction_layer::QuantizeParam>().scale = scale_it->second;
+    Var x_int8(GlobalContext().name_generator().NewTmpVar());
+    DeclTmpVar(x_int8.name);
+    quantize->SetOutput("Out", x_int8.name);
+
+    auto matmul = OpRegistry::Global().CreateOp(HlirLayer::kInstructionWise, "quantized_matmul");
+    matmul->set_session(session_);
+    matmul->SetInput("X", x_int8.name);
+    matmul->SetInput("W", w_int8.name);
+    matmul->SetInput("WScale", w_scale.name);
+    Var acc(GlobalContext().name_generator().NewTmpVar());
+    DeclTmpVar(acc.name);
+    auto &the_param = matmul->param<instruction_layer::QuantizedMatMulParam>();
+    the_param.x_scale = scale_it->second;
+    the_param.accumulator = acc.name;
+    // Keep the output name, so that the consumers need no change.
+    matmul->SetOutput("Out", out);
+
+    operators.emplace_back(std::move(quantize));
+    operators.emplace_back(std::move(matmul));
+    float_weights.insert(w);
+    count++;
+  }
+  operators_ = std::move(operators);
+
+  // Drop the float weights not used any more.
+  std::set<std::string> used;
+  for (auto &op : operators_) {
+    for (auto &item : op->inputs()) used.insert(item.second);
+  }
+  for (auto &w : float_weights) {
+    if (!used.count(w)) weight_names_.erase(w);
+  }
+  return count;
+}
+
 Program Network::Compile() {
+  CHECK(!compiled_) << "network " << name_ << " is compiled already";
+  compiled_ = true;
   Program program;
   for (auto &op : operators_) {
     program.AddOp(std::move(op));
@@ -114,6 +187,28 @@ Network::Var Network::AddFc(Network::Var x, Network::Var w, Network::Var b, bool
   return out;
 }
 
+Network::Var Network::AddQuantizedFc(Var x, Var w, Var w_scale, Var b, float x_scale, float out_scale) {
+  auto op = OpRegistry::Global().CreateOp(HlirLayer::kInstructionWise, "quantized_matmul");
+  op->set_session(session_);
+  op->SetInput("X", x.name);
+  op->SetInput("W", w.name);
+  op->SetInput("WScale", w_scale.name);
+  if (b) op->SetInput("B", b.name);
+
+  Var acc(GlobalContext().name_generator().NewTmpVar());
+  DeclTmpVar(acc.name);
+  auto &the_param = op->param<hlir::instruction_layer::QuantizedMatMulParam>();
+  the_param.x_scale = x_scale;
+  the_param.out_scale = out_scale;
+  the_param.accumulator = acc.name;
+
+  Var out(GlobalContext().name_generator().NewTmpVar());
+  DeclTmpVar(out.name);
+  op->SetOutput("Out", out.name);
+  operators_.emplace_back(std::move(op));
+  return out;
+}
+
 Network::Var Network::DeclInput(const std::string &name, primitive_t ptype, Shape shape) {
   input_names_.insert(name);
 
@@ -124,6 +219,30 @@ Network::Var Network::DeclInput(const std::string &name, primitive_t ptype, Shap
   return Var(name);
 }
 
+Network::Var Network::DeclHalfWeight(const std::string &name,
+                                     primitive_t ptype,
+                                     const Shape &shape,
+                                     const std::vector<float> &data) {
+  CHECK(is_half_float(ptype));
+  CHECK_EQ(data.size(), static_cast<size_t>(shape.num_elements()));
+  std::vector<uint16_t> half(data.size());
+  for (size_t i = 0; i < data.size(); i++) {
+    half[i] = ptype == primitive_t::float16 ? Float32ToFloat16(data[i]) : Float32ToBFloat16(data[i]);
+  }
+  weight_names_.insert(name);
+
+  Tensor *tensor = session_->NewTensor(name);
+  auto buf = std::make_shared<Buffer>(name + "_buf", ptype);
+  buf->Resize(shape.num_bytes(ptype));
+  buf->SetData<uint16_t>(half.data());
+
+  tensor->AttachBuffer(buf);
+  tensor->set_is_weight();
+  tensor->set_shape(shape);
+  tensor->set_ptype(ptype);
+  return Var(name);
+}
+
 Network::Var Network::DeclOutput(const std::string &name) {
   CHECK(is_tmp_var(name));
   tmp_var_names_.erase(name);
@@ -140,10 +259,150 @@ Tensor *Network::DeclTmpVar(const std::string &name) {
   return session_->NewTensor(name);
 }
 
+void Network::RemoveVar(const std::string &name) {
+  CHECK(!is_input(name) && !is_output(name)) << "the input or output " << name << " can't be removed";
+  CHECK(is_weight(name) || is_tmp_var(name)) << "no variable called " << name;
+  weight_names_.erase(name);
+  tmp_var_names_.erase(name);
+}
+
+void Network::MarkWeight(const std::string &name) {
+  CHECK(is_tmp_var(name)) << "no temporary variable called " << name;
+  auto *tensor = session_->GetTensor(name);
+  CHECK(tensor->is_weight() && tensor->buffer()) << "the data of " << name << " is not evaluated";
+  tmp_var_names_.erase(name);
+  weight_names_.insert(name);
+}
+
 bool Network::IsVarNameAvailable(const std::string &name) const {
   return !(is_input(name) || is_output(name) || is_weight(name) || is_tmp_var(name));
 }
 
+Network::Var Network::AddConv2d(Var x, Var w, Var b, instruction_layer::Conv2dParam param) {
+  auto op = OpRegistry::Global().CreateOp(HlirLayer::kInstructionWise, "conv2d");
+  op->set_session(session_);
+  op->SetInput("X", x.name);
+  op->SetInput("W", w.name);
+  if (b) op->SetInput("B", b.name);
+
+  using Algorithm = instruction_layer::Conv2dParam::Algorithm;
+  const bool winograd = param.algorithm == Algorithm::kWinograd;
+  std::vector<std::string*> tmp_vars;
+  if (param.has_padding() || winograd) tmp_vars.push_back(&param.padded);
+  if (param.algorithm == Algorithm::kAuto || param.algorithm == Algorithm::kIm2Col) tmp_vars.push_back(&param.columns);
+  if (winograd) {
+    tmp_vars.insert(tmp_vars.end(), {&param.winograd_filter, &param.winograd_input, &param.winograd_product});
+  }
+  for (auto *name : tmp_vars) {
+    *name = GlobalContext().name_generator().NewTmpVar();
+    DeclTmpVar(*name);
+  }
+  op->param<instruction_layer::Conv2dParam>() = param;
+
+  Var out(GlobalContext().name_generator().NewTmpVar());
+  DeclTmpVar(out.name);
+  op->SetOutput("Out", out.name);
+  operators_.emplace_back(std::move(op));
+  return out;
+}
+
+Network::Var Network::AddDepthwiseConv2d(Var x, Var w, Var b, instruction_layer::DepthwiseConv2dParam param) {
+  auto op = OpRegistry::Global().CreateOp(HlirLayer::kInstructionWise, "depthwise_conv2d");
+  op->set_session(session_);
+  op->SetInput("X", x.name);
+  op->SetInput("W", w.name);
+  if (b) op->SetInput("B", b.name);
+
+  for (auto *name : {&param.blocked_input, &param.blocked_filter, &param.blocked_output}) {
+    *name = GlobalContext().name_generator().NewTmpVar();
+    DeclTmpVar(*name);
+  }
+  op->param<instruction_layer::DepthwiseConv2dParam>() = param;
+
+  Var out(GlobalContext().name_generator().NewTmpVar());
+  DeclTmpVar(out.name);
+  op->SetOutput("Out", out.name);
+  operators_.emplace_back(std::move(op));
+  return out;
+}
+
+Network::Var Network::AddPool2d(Var x, instruction_layer::Pool2dParam param) {
+  auto op = OpRegistry::Global().CreateOp(HlirLayer::kInstructionWise, "pool2d");
+  op->set_session(session_);
+  op->SetInput("X", x.name);
+
+  if (param.has_padding()) {
+    param.padded = GlobalContext().name_generator().NewTmpVar();
+    DeclTmpVar(param.padded);
+  }
+  op->param<instruction_layer::Pool2dParam>() = param;
+
+  Var out(GlobalContext().name_generator().NewTmpVar());
+  DeclTmpVar(out.name);
+  op->SetOutput("Out", out.name);
+  operators_.emplace_back(std::move(op));
+  return out;
+}
+
+Network::Var Network::AddSoftmax(Var x) {
+  auto op = OpRegistry::Global().CreateOp(HlirLayer::kInstructionWise, "softmax");
+  op->set_session(session_);
+  op->SetInput("X", x.name);
+
+  instruction_layer::SoftmaxParam param;
+  for (auto *name : {&param.lanes, &param.max, &param.sum}) {
+    *name = GlobalContext().name_generator().NewTmpVar();
+    DeclTmpVar(*name);
+  }
+  op->param<instruction_layer::SoftmaxParam>() = param;
+
+  Var out(GlobalContext().name_generator().NewTmpVar());
+  DeclTmpVar(out.name);
+  op->SetOutput("Out", out.name);
+  operators_.emplace_back(std::move(op));
+  return out;
+}
+
+Network::Var Network::AddLayerNorm(Var x, Var scale, Var bias, float epsilon) {
+  auto op = OpRegistry::Global().CreateOp(HlirLayer::kInstructionWise, "layer_norm");
+  op->set_session(session_);
+  op->SetInput("X", x.name);
+  if (scale) op->SetInput("Scale", scale.name);
+  if (bias) op->SetInput("Bias", bias.name);
+
+  instruction_layer::LayerNormParam param;
+  param.epsilon = epsilon;
+  for (auto *name : {&param.mean, &param.variance}) {
+    *name = GlobalContext().name_generator().NewTmpVar();
+    DeclTmpVar(*name);
+  }
+  op->param<instruction_layer::LayerNormParam>() = param;
+
+  Var out(GlobalContext().name_generator().NewTmpVar());
+  DeclTmpVar(out.name);
+  op->SetOutput("Out", out.name);
+  operators_.emplace_back(std::move(op));
+  return out;
+}
+
+Network::Var Network::AddBatchNorm(
+    Var x, Var scale, Var bias, Var mean, Var variance, instruction_layer::BatchNormParam param) {
+  auto op = OpRegistry::Global().CreateOp(HlirLayer::kInstructionWise, "batch_norm");
+  op->set_session(session_);
+  op->SetInput("X", x.name);
+  if (scale) op->SetInput("Scale", scale.name);
+  if (bias) op->SetInput("Bias", bias.name);
+  if (mean) op->SetInput("Mean", mean.name);
+  if (variance) op->SetInput("Variance", variance.name);
+  op->param<instruction_layer::BatchNormParam>() = param;
+
+  Var out(GlobalContext().name_generator().NewTmpVar());
+  DeclTmpVar(out.name);
+  op->SetOutput("Out", out.name);
+  operators_.emplace_back(std::move(op));
+  return out;
+}
+
 Network::Var Network::AddTranspose(const Network::Var &x, const std::vector<int> &perm, bool call_once) {
   auto op = OpRegistry::Global().CreateOp(HlirLayer::kInstructionWise, "transpose");
   op->set_call_once(call_once);
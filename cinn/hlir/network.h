@@ -3,10 +3,15 @@
  * This file defines Network, the API to make model construction easier.
  */
 
+#include <map>
 #include <memory>
 #include <set>
 #include <string>
 #include <vector>
+#include "cinn/hlir/instruction_layer/conv2d_op.h"
+#include "cinn/hlir/instruction_layer/depthwise_conv2d_op.h"
+#include "cinn/hlir/instruction_layer/normalization_ops.h"
+#include "cinn/hlir/instruction_layer/pool2d_op.h"
 #include "cinn/hlir/operator.h"
 #include "cinn/hlir/program.h"
 #include "cinn/hlir/session.h"
@@ -36,9 +41,14 @@ class Network {
   Var DeclInput(const std::string& name, primitive_t ptype, Shape shape);
   //! Declare an output placeholder.
   Network::Var DeclOutput(const std::string& name);
-  //! Declare a weight for the model.
+  /**
+   * Declare a weight for the model.
+   * If ptype is float16 or bfloat16, the data is converted and stored in half precision, and widened to float32 in the
+   * kernels.
+   */
   template <typename T>
   Var DeclWeight(const std::string& name, primitive_t ptype, const Shape& shape, const std::vector<T>& data) {
+    if (is_half_float(ptype)) return DeclHalfWeight(name, ptype, shape, std::vector<float>(data.begin(), data.end()));
     weight_names_.insert(name);
 
     Tensor* tensor = session_->NewTensor(name);
@@ -64,6 +74,18 @@ class Network {
    */
   Network::Var AddFc(Network::Var x, Network::Var w, Network::Var b, bool w_transposed = false);
 
+  /**
+   * Add an int8 quantized Fully Connected layer, the products are accumulated in int32.
+   * @param x the int8 input.
+   * @param w the int8 weight in layout [N, K], each row is an output channel.
+   * @param w_scale the float32 scales of the output channels.
+   * @param b the float32 bias, leave empty if not valid.
+   * @param x_scale the scale of the input.
+   * @param out_scale the scale to requantize the output to int8, the output is float32 if it is not positive.
+   * @return the output.
+   */
+  Var AddQuantizedFc(Var x, Var w, Var w_scale, Var b, float x_scale, float out_scale = 0.f);
+
   /**
    * Add a MatMul operator.
    * @param x Name of the first input.
@@ -72,11 +94,80 @@ class Network {
    */
   Var AddMatMul(const Var& x, const Var& y, bool y_transposed = false);
 
+  /**
+   * Add a 2D convolution.
+   * @param x the input image.
+   * @param w the filter, OIHW for the NCHW layout and HWIO for NHWC.
+   * @param b the bias, leave empty if not valid.
+   * @param param the strides, paddings, dilations, groups, layout and algorithm, the temporary variables are declared
+   * by the network.
+   * @return the output.
+   */
+  Var AddConv2d(Var x, Var w, Var b, instruction_layer::Conv2dParam param = instruction_layer::Conv2dParam());
+
+  /**
+   * Add a depthwise 2D convolution, with a kernel vectorized across the channels.
+   * @param x the NCHW input image.
+   * @param w the filter [C, 1, KH, KW].
+   * @param b the bias, leave empty if not valid.
+   * @param param the strides, paddings, dilations and the fused activation, the temporary variables are declared by the
+   * network.
+   * @return the output.
+   */
+  Var AddDepthwiseConv2d(Var x,
+                         Var w,
+                         Var b,
+                         instruction_layer::DepthwiseConv2dParam param = instruction_layer::DepthwiseConv2dParam());
+
+  /**
+   * Add a 2D pooling, it is computed in its own loops after the operator producing `x`.
+   * @param x the input image.
+   * @param param the pooling type, window and layout, the padded temporary variable is declared by the network.
+   * @return the output.
+   */
+  Var AddPool2d(Var x, instruction_layer::Pool2dParam param);
+
+  /**
+   * Add a softmax over the last dimension.
+   * @param x the input.
+   * @return the output.
+   */
+  Var AddSoftmax(Var x);
+
+  /**
+   * Add a layer normalization over the last dimension.
+   * @param x the input.
+   * @param scale the scale of the last dimension, leave empty if not valid.
+   * @param bias the bias of the last dimension, leave empty if not valid.
+   * @param epsilon added to the variance to avoid dividing by zero.
+   * @return the output.
+   */
+  Var AddLayerNorm(Var x, Var scale, Var bias, float epsilon = 1e-5f);
+
+  /**
+   * Add an inference batch normalization, it is folded into the weights of the preceding convolution or fully
+   * connected layer at build time if possible.
+   * @param x the input.
+   * @param scale the scale of the channels, leave empty if not valid.
+   * @param bias the bias of the channels, leave empty if not valid.
+   * @param mean the mean of the channels, leave both the mean and the variance empty for a per-channel affine
+   * transform.
+   * @param variance the variance of the channels.
+   * @param param the epsilon and the axis of the channels.
+   * @return the output.
+   */
+  Var AddBatchNorm(Var x,
+                   Var scale,
+                   Var bias,
+                   Var mean,
+                   Var variance,
+                   instruction_layer::BatchNormParam param = instruction_layer::BatchNormParam());
+
   /**
    * Transpose a tensor.
    * @param x the input.
    * @param perm the permutated indexs.
-   * @param call_once execute only once.
+   * @param call_once execute only once, a transpose of a weight is evaluated at build time by the Builder anyway.
    * @return the transposed tensor.
    */
   Network::Var AddTranspose(const Network::Var& x, const std::vector<int>& perm, bool call_once = false);
@@ -102,10 +193,10 @@ class Network {
     kDiv,
   };
 
-  Var AddElementwiseAdd(Var x, Var y) { AddElementwise(ElementwiseOpKind::kAdd, x, y); }
-  Var AddElementwiseSub(Var x, Var y) { AddElementwise(ElementwiseOpKind::kSub, x, y); }
-  Var AddElementwiseMul(Var x, Var y) { AddElementwise(ElementwiseOpKind::kMul, x, y); }
-  Var AddElementwiseDiv(Var x, Var y) { AddElementwise(ElementwiseOpKind::kDiv, x, y); }
+  Var AddElementwiseAdd(Var x, Var y) { return AddElementwise(ElementwiseOpKind::kAdd, x, y); }
+  Var AddElementwiseSub(Var x, Var y) { return AddElementwise(ElementwiseOpKind::kSub, x, y); }
+  Var AddElementwiseMul(Var x, Var y) { return AddElementwise(ElementwiseOpKind::kMul, x, y); }
+  Var AddElementwiseDiv(Var x, Var y) { return AddElementwise(ElementwiseOpKind::kDiv, x, y); }
 
   /**
    * Add a Reshape operator.
@@ -115,10 +206,21 @@ class Network {
    */
   Var AddReshape(const std::vector<int>& shape, Var x);
 
+  /**
+   * Rewrite the float MatMuls whose second input is a weight into the int8 quantized ones, the input is quantized by a
+   * quantize operator and the weight is quantized per output channel. The outputs are dequantized to float32 in the
+   * quantized MatMuls, so the other operators are not changed.
+   *
+   * @param scales the scales of the inputs to quantize, usually computed by a Calibrator. The MatMuls whose input has
+   * no scale are kept in float.
+   * @return the number of the MatMuls rewritten.
+   */
+  int QuantizeMatMuls(const std::map<std::string, float>& scales);
+
   /**
    * Compile the network and generate a program.
    *
-   * NOTE Once it compiled, the network is invalid for further modification.
+   * NOTE Once it compiled, the network is invalid for further modification, and it can't be compiled again.
    */
   Program Compile();
 
@@ -130,6 +232,17 @@ class Network {
   const std::set<std::string>& weight_names() const { return weight_names_; }
   const std::set<std::string>& tmp_var_names() const { return tmp_var_names_; }
 
+  /**
+   * Remove a weight or a temporary variable folded away by the graph optimizations, so that it is not declared.
+   */
+  void RemoveVar(const std::string& name);
+
+  /**
+   * Turn a temporary variable evaluated by the graph optimizations at build time to a weight, its tensor should hold
+   * the data already.
+   */
+  void MarkWeight(const std::string& name);
+
  private:
   /**
    * Add an Elementwise operator.
@@ -148,6 +261,9 @@ class Network {
    */
   Tensor* DeclTmpVar(const std::string& name);
 
+  //! Declare a weight stored in float16 or bfloat16.
+  Var DeclHalfWeight(const std::string& name, primitive_t ptype, const Shape& shape, const std::vector<float>& data);
+
   //! Check whether this name is not duplicate.
   bool IsVarNameAvailable(const std::string& name) const;
 
@@ -167,6 +283,8 @@ class Network {
   Session* session_{};
   //! Hold all the operator instances.
   std::vector<std::unique_ptr<Operator>> operators_;
+  //! The operators are moved to the program once compiled.
+  bool compiled_{false};
 
   std::set<std::string> input_names_, output_names_;
   std::set<std::string> weight_names_;
@@ -33,5 +33,36 @@ TEST(network, basic) {
   graph.Compile(false);
 }
 
+TEST(network, quantize_matmuls) {
+  SetGlobalContext(new CINNContext);
+
+  Session session;
+  Network net("tmp", &session);
+
+  Network1Builder net_builder;
+  net_builder.Build(&net, &session);
+
+  // No scale for the input, keep it in float.
+  ASSERT_EQ(net.QuantizeMatMuls({}), 0);
+  ASSERT_EQ(net.QuantizeMatMuls({{"x0", 0.05f}}), 1);
+  // quantize, quantized_matmul, elementwise_add and tanh
+  ASSERT_EQ(net.num_operators(), 4UL);
+  ASSERT_TRUE(net.weight_names().count("w0_int8"));
+  ASSERT_TRUE(net.weight_names().count("w0_scale"));
+  ASSERT_FALSE(net.weight_names().count("w0"));
+  ASSERT_EQ(session.GetTensor("w0_int8")->shape().data, std::vector<int>({2, 4}));
+
+  auto program = net.Compile();
+
+  Graph graph;
+  graph.Build(program, session);
+
+  for (Node& node : GraphTraits::TS(graph)) {
+    if (node.is_op()) node.op->Compile();
+  }
+
+  graph.Compile(false);
+}
+
 }  // namespace hlir
 }  // namespace cinn
@@ -1,4 +1,7 @@
 #pragma once
+#include <algorithm>
+#include <cmath>
+#include <vector>
 #include "cinn/hlir/network.h"
 
 namespace cinn {
@@ -82,7 +85,7 @@ struct Network2Builder {
         }
 
         y[i * N + j] += b_data[j];
-        y[i * N + j] = std::max(y[i * N + j], 0.f);
+        y[i * N + j] = std::tanh(y[i * N + j]);
       }
     }
     return y;
@@ -116,5 +119,417 @@ struct Network2Builder {
   }
 };
 
+/**
+ * Two NCHW convolutions, the first one with stride 1 lowers to the direct convolution, and the second grouped one with
+ * stride 2 lowers to im2col.
+ */
+struct Conv2dNetworkBuilder {
+  using Var = Network::Var;
+  using Conv2dParam = instruction_layer::Conv2dParam;
+
+  Shape x0_shape{{1, 16, 32, 32}};
+  Shape w0_shape{{32, 16, 3, 3}};
+  Shape w1_shape{{32, 16, 3, 3}};
+  Shape b_shape{{32}};
+  Shape out_shape{{1, 32, 16, 16}};
+
+  Conv2dParam param0;
+  Conv2dParam param1;
+
+  std::vector<float> w0_data;
+  std::vector<float> w1_data;
+  std::vector<float> b_data;
+
+  Conv2dNetworkBuilder() {
+    param0.paddings = {1, 1};
+    param1.strides = {2, 2};
+    param1.paddings = {1, 1};
+    param1.groups = 2;
+
+    w0_data.resize(w0_shape.num_elements());
+    w1_data.resize(w1_shape.num_elements());
+    b_data.resize(b_shape.num_elements());
+    for (int i = 0; i < w0_data.size(); i++) w0_data[i] = 0.001 * (i % 97) - 0.05;
+    for (int i = 0; i < w1_data.size(); i++) w1_data[i] = 0.002 * (i % 53) - 0.05;
+    for (int i = 0; i < b_data.size(); i++) b_data[i] = 0.01 * i;
+  }
+
+  void Build(Network* net, Session* session) {
+    Var x0 = net->DeclInput("x0", primitive_t::float32, x0_shape);
+    Var w0 = net->DeclWeight<float>("w0", primitive_t::float32, w0_shape, w0_data);
+    Var w1 = net->DeclWeight<float>("w1", primitive_t::float32, w1_shape, w1_data);
+    Var b = net->DeclWeight<float>("b", primitive_t::float32, b_shape, b_data);
+
+    auto conv0 = net->AddConv2d(x0, w0, b, param0);
+    auto conv1 = net->AddConv2d(conv0, w1, b, param1);
+    net->DeclOutput(conv1.name);
+  }
+
+  std::vector<float> ManualTest(const std::vector<float>& x) {
+    Shape y_shape, out_shape;
+    auto y = Conv2dNCHW(x, x0_shape, w0_data, w0_shape, b_data, param0, &y_shape);
+    return Conv2dNCHW(y, y_shape, w1_data, w1_shape, b_data, param1, &out_shape);
+  }
+
+  //! The naive NCHW convolution.
+  static std::vector<float> Conv2dNCHW(const std::vector<float>& x,
+                                       const Shape& x_shape,
+                                       const std::vector<float>& w,
+                                       const Shape& w_shape,
+                                       const std::vector<float>& b,
+                                       const Conv2dParam& param,
+                                       Shape* y_shape) {
+    const int N = x_shape[0], C = x_shape[1], H = x_shape[2], W = x_shape[3];
+    const int M = w_shape[0], Cg = w_shape[1], KH = w_shape[2], KW = w_shape[3];
+    const int Mg = M / param.groups;
+    const int OH = (H + 2 * param.paddings[0] - param.dilations[0] * (KH - 1) - 1) / param.strides[0] + 1;
+    const int OW = (W + 2 * param.paddings[1] - param.dilations[1] * (KW - 1) - 1) / param.strides[1] + 1;
+    *y_shape = Shape({N, M, OH, OW});
+
+    std::vector<float> y(y_shape->num_elements());
+    for (int n = 0; n < N; n++) {
+      for (int m = 0; m < M; m++) {
+        const int g = m / Mg;
+        for (int oh = 0; oh < OH; oh++) {
+          for (int ow = 0; ow < OW; ow++) {
+            float sum = b.empty() ? 0.f : b[m];
+            for (int c = 0; c < Cg; c++) {
+              for (int kh = 0; kh < KH; kh++) {
+                for (int kw = 0; kw < KW; kw++) {
+                  int h = oh * param.strides[0] - param.paddings[0] + kh * param.dilations[0];
+                  int w_ = ow * param.strides[1] - param.paddings[1] + kw * param.dilations[1];
+                  if (h < 0 || h >= H || w_ < 0 || w_ >= W) continue;
+                  sum += x[((n * C + g * Cg + c) * H + h) * W + w_] * w[((m * Cg + c) * KH + kh) * KW + kw];
+                }
+              }
+            }
+            y[((n * M + m) * OH + oh) * OW + ow] = sum;
+          }
+        }
+      }
+    }
+    return y;
+  }
+};
+
+/**
+ * A depthwise 3x3 convolution followed by tanh, built by the depthwise operator or by the general convolution with a
+ * group for each channel, to compare the two lowerings.
+ */
+struct DepthwiseConv2dNetworkBuilder {
+  using Var = Network::Var;
+
+  //! Use the general convolution instead of the depthwise one.
+  bool general{};
+
+  Shape x0_shape{{1, 32, 56, 56}};
+  Shape w0_shape{{32, 1, 3, 3}};
+  Shape b_shape{{32}};
+
+  std::vector<float> w0_data;
+  std::vector<float> b_data;
+
+  explicit DepthwiseConv2dNetworkBuilder(bool general = false) : general(general) {
+    w0_data.resize(w0_shape.num_elements());
+    b_data.resize(b_shape.num_elements());
+    for (int i = 0; i < w0_data.size(); i++) w0_data[i] = 0.01 * (i % 31) - 0.1;
+    for (int i = 0; i < b_data.size(); i++) b_data[i] = 0.01 * i;
+  }
+
+  void Build(Network* net, Session* session) {
+    Var x0 = net->DeclInput("x0", primitive_t::float32, x0_shape);
+    Var w0 = net->DeclWeight<float>("w0", primitive_t::float32, w0_shape, w0_data);
+    Var b = net->DeclWeight<float>("b", primitive_t::float32, b_shape, b_data);
+
+    Var out;
+    if (general) {
+      out = net->AddTanh(net->AddConv2d(x0, w0, b, conv2d_param()));
+    } else {
+      instruction_layer::DepthwiseConv2dParam param;
+      param.paddings = {1, 1};
+      param.activation = instruction_layer::DepthwiseConv2dParam::Activation::kTanh;
+      out = net->AddDepthwiseConv2d(x0, w0, b, param);
+    }
+    net->DeclOutput(out.name);
+  }
+
+  std::vector<float> ManualTest(const std::vector<float>& x) {
+    Shape y_shape;
+    auto y = Conv2dNetworkBuilder::Conv2dNCHW(x, x0_shape, w0_data, w0_shape, b_data, conv2d_param(), &y_shape);
+    for (auto& v : y) v = std::tanh(v);
+    return y;
+  }
+
+  //! The param of the equivalent general convolution.
+  instruction_layer::Conv2dParam conv2d_param() const {
+    instruction_layer::Conv2dParam param;
+    param.paddings = {1, 1};
+    param.groups = x0_shape[1];
+    return param;
+  }
+};
+
+/**
+ * Two 3x3 convolutions with stride 1 lowered by Winograd, F(2x2, 3x3) and then F(4x4, 3x3), the size of the output
+ * is not a multiple of the tiles.
+ */
+struct WinogradNetworkBuilder {
+  using Var = Network::Var;
+  using Conv2dParam = instruction_layer::Conv2dParam;
+
+  Shape x0_shape{{1, 16, 30, 30}};
+  Shape w0_shape{{32, 16, 3, 3}};
+  Shape w1_shape{{16, 32, 3, 3}};
+  Shape b0_shape{{32}};
+  Shape b1_shape{{16}};
+
+  Conv2dParam param0;
+  Conv2dParam param1;
+
+  std::vector<float> w0_data, w1_data;
+  std::vector<float> b0_data, b1_data;
+
+  WinogradNetworkBuilder() {
+    for (auto* param : {&param0, &param1}) {
+      param->paddings = {1, 1};
+      param->algorithm = Conv2dParam::Algorithm::kWinograd;
+    }
+    param0.winograd_tile = 2;
+    param1.winograd_tile = 4;
+
+    w0_data.resize(w0_shape.num_elements());
+    w1_data.resize(w1_shape.num_elements());
+    b0_data.resize(b0_shape.num_elements());
+    b1_data.resize(b1_shape.num_elements());
+    for (int i = 0; i < w0_data.size(); i++) w0_data[i] = 0.001 * (i % 89) - 0.04;
+    for (int i = 0; i < w1_data.size(); i++) w1_data[i] = 0.001 * (i % 71) - 0.03;
+    for (int i = 0; i < b0_data.size(); i++) b0_data[i] = 0.01 * i;
+    for (int i = 0; i < b1_data.size(); i++) b1_data[i] = -0.01 * i;
+  }
+
+  void Build(Network* net, Session* session) {
+    Var x0 = net->DeclInput("x0", primitive_t::float32, x0_shape);
+    Var w0 = net->DeclWeight<float>("w0", primitive_t::float32, w0_shape, w0_data);
+    Var w1 = net->DeclWeight<float>("w1", primitive_t::float32, w1_shape, w1_data);
+    Var b0 = net->DeclWeight<float>("b0", primitive_t::float32, b0_shape, b0_data);
+    Var b1 = net->DeclWeight<float>("b1", primitive_t::float32, b1_shape, b1_data);
+
+    auto conv0 = net->AddConv2d(x0, w0, b0, param0);
+    auto conv1 = net->AddConv2d(conv0, w1, b1, param1);
+    net->DeclOutput(conv1.name);
+  }
+
+  std::vector<float> ManualTest(const std::vector<float>& x) {
+    Shape y_shape, out_shape;
+    auto y = Conv2dNetworkBuilder::Conv2dNCHW(x, x0_shape, w0_data, w0_shape, b0_data, param0, &y_shape);
+    return Conv2dNetworkBuilder::Conv2dNCHW(y, y_shape, w1_data, w1_shape, b1_data, param1, &out_shape);
+  }
+};
+
+/**
+ * An NHWC convolution followed by a 2x2 max pooling with stride 2.
+ */
+struct ConvPoolNetworkBuilder {
+  using Var = Network::Var;
+
+  Shape x0_shape{{1, 32, 32, 16}};
+  Shape w0_shape{{3, 3, 16, 32}};
+  Shape b_shape{{32}};
+  Shape out_shape{{1, 16, 16, 32}};
+
+  std::vector<float> w0_data;
+  std::vector<float> b_data;
+
+  ConvPoolNetworkBuilder() {
+    w0_data.resize(w0_shape.num_elements());
+    b_data.resize(b_shape.num_elements());
+    for (int i = 0; i < w0_data.size(); i++) w0_data[i] = 0.001 * (i % 83) - 0.04;
+    for (int i = 0; i < b_data.size(); i++) b_data[i] = 0.01 * i;
+  }
+
+  void Build(Network* net, Session* session) {
+    Var x0 = net->DeclInput("x0", primitive_t::float32, x0_shape);
+    Var w0 = net->DeclWeight<float>("w0", primitive_t::float32, w0_shape, w0_data);
+    Var b = net->DeclWeight<float>("b", primitive_t::float32, b_shape, b_data);
+
+    instruction_layer::Conv2dParam conv_param;
+    conv_param.paddings = {1, 1};
+    conv_param.layout = instruction_layer::Conv2dParam::Layout::kNHWC;
+    instruction_layer::Pool2dParam pool_param;
+    pool_param.layout = instruction_layer::Pool2dParam::Layout::kNHWC;
+
+    auto conv = net->AddConv2d(x0, w0, b, conv_param);
+    auto pool = net->AddPool2d(conv, pool_param);
+    net->DeclOutput(pool.name);
+  }
+
+  std::vector<float> ManualTest(const std::vector<float>& x) {
+    const int N = x0_shape[0], H = x0_shape[1], W = x0_shape[2], C = x0_shape[3];
+    const int M = w0_shape[3];
+    std::vector<float> conv(N * H * W * M);
+    for (int n = 0; n < N; n++) {
+      for (int h = 0; h < H; h++) {
+        for (int w = 0; w < W; w++) {
+          for (int m = 0; m < M; m++) {
+            float sum = b_data[m];
+            for (int kh = 0; kh < 3; kh++) {
+              for (int kw = 0; kw < 3; kw++) {
+                int ih = h + kh - 1, iw = w + kw - 1;
+                if (ih < 0 || ih >= H || iw < 0 || iw >= W) continue;
+                for (int c = 0; c < C; c++) {
+                  sum += x[((n * H + ih) * W + iw) * C + c] * w0_data[((kh * 3 + kw) * C + c) * M + m];
+                }
+              }
+            }
+            conv[((n * H + h) * W + w) * M + m] = sum;
+          }
+        }
+      }
+    }
+
+    const int OH = H / 2, OW = W / 2;
+    std::vector<float> out(N * OH * OW * M);
+    for (int n = 0; n < N; n++) {
+      for (int oh = 0; oh < OH; oh++) {
+        for (int ow = 0; ow < OW; ow++) {
+          for (int m = 0; m < M; m++) {
+            float v = conv[((n * H + oh * 2) * W + ow * 2) * M + m];
+            for (int kh = 0; kh < 2; kh++) {
+              for (int kw = 0; kw < 2; kw++) {
+                v = std::max(v, conv[((n * H + oh * 2 + kh) * W + ow * 2 + kw) * M + m]);
+              }
+            }
+            out[((n * OH + oh) * OW + ow) * M + m] = v;
+          }
+        }
+      }
+    }
+    return out;
+  }
+};
+
+/**
+ * A layer normalization followed by a softmax over the last dimension, the rows are of 128 elements so that both are
+ * vectorized.
+ */
+struct NormalizationNetworkBuilder {
+  using Var = Network::Var;
+
+  Shape x0_shape{{8, 4, 128}};
+  Shape scale_shape{{128}};
+  Shape out_shape{{8, 4, 128}};
+
+  std::vector<float> scale_data;
+  std::vector<float> bias_data;
+
+  NormalizationNetworkBuilder() {
+    scale_data.resize(scale_shape.num_elements());
+    bias_data.resize(scale_shape.num_elements());
+    for (int i = 0; i < scale_data.size(); i++) scale_data[i] = 0.5 + 0.01 * (i % 37);
+    for (int i = 0; i < bias_data.size(); i++) bias_data[i] = 0.02 * (i % 11) - 0.1;
+  }
+
+  void Build(Network* net, Session* session) {
+    Var x0 = net->DeclInput("x0", primitive_t::float32, x0_shape);
+    Var scale = net->DeclWeight<float>("scale", primitive_t::float32, scale_shape, scale_data);
+    Var bias = net->DeclWeight<float>("bias", primitive_t::float32, scale_shape, bias_data);
+
+    auto norm = net->AddLayerNorm(x0, scale, bias);
+    auto softmax = net->AddSoftmax(norm);
+    net->DeclOutput(softmax.name);
+  }
+
+  std::vector<float> ManualTest(const std::vector<float>& x) {
+    const int D = x0_shape.data.back();
+    const int R = x0_shape.num_elements() / D;
+    std::vector<float> out(x.size());
+    std::vector<double> row(D);
+    for (int r = 0; r < R; r++) {
+      const float* in = &x[r * D];
+      double mean = 0., variance = 0.;
+      for (int d = 0; d < D; d++) mean += in[d];
+      mean /= D;
+      for (int d = 0; d < D; d++) variance += (in[d] - mean) * (in[d] - mean);
+      variance /= D;
+
+      double max = -1e30, sum = 0.;
+      for (int d = 0; d < D; d++) {
+        row[d] = (in[d] - mean) / std::sqrt(variance + 1e-5) * scale_data[d] + bias_data[d];
+        max = std::max(max, row[d]);
+      }
+      for (int d = 0; d < D; d++) sum += std::exp(row[d] - max);
+      for (int d = 0; d < D; d++) out[r * D + d] = std::exp(row[d] - max) / sum;
+    }
+    return out;
+  }
+};
+
+/**
+ * An NCHW convolution without bias followed by a batch normalization and a per-channel affine transform, both are
+ * folded into the weights of the convolution by the Builder.
+ */
+struct BatchNormNetworkBuilder {
+  using Var = Network::Var;
+
+  Shape x0_shape{{1, 8, 16, 16}};
+  Shape w0_shape{{16, 8, 3, 3}};
+  Shape channel_shape{{16}};
+  Shape out_shape{{1, 16, 16, 16}};
+
+  instruction_layer::Conv2dParam conv_param;
+
+  std::vector<float> w0_data;
+  std::vector<float> scale_data, bias_data, mean_data, variance_data;
+  std::vector<float> affine_scale_data, affine_bias_data;
+
+  BatchNormNetworkBuilder() {
+    conv_param.paddings = {1, 1};
+
+    w0_data.resize(w0_shape.num_elements());
+    for (int i = 0; i < w0_data.size(); i++) w0_data[i] = 0.001 * (i % 97) - 0.05;
+    const int C = channel_shape.num_elements();
+    for (auto* data : {&scale_data, &bias_data, &mean_data, &variance_data, &affine_scale_data, &affine_bias_data}) {
+      data->resize(C);
+    }
+    for (int c = 0; c < C; c++) {
+      scale_data[c] = 0.5 + 0.1 * (c % 7);
+      bias_data[c] = 0.05 * (c % 5) - 0.1;
+      mean_data[c] = 0.02 * (c % 9) - 0.08;
+      variance_data[c] = 0.2 + 0.05 * (c % 11);
+      affine_scale_data[c] = 1.5 - 0.1 * (c % 3);
+      affine_bias_data[c] = 0.01 * c;
+    }
+  }
+
+  void Build(Network* net, Session* session) {
+    Var x0 = net->DeclInput("x0", primitive_t::float32, x0_shape);
+    Var w0 = net->DeclWeight<float>("w0", primitive_t::float32, w0_shape, w0_data);
+    Var scale = net->DeclWeight<float>("scale", primitive_t::float32, channel_shape, scale_data);
+    Var bias = net->DeclWeight<float>("bias", primitive_t::float32, channel_shape, bias_data);
+    Var mean = net->DeclWeight<float>("mean", primitive_t::float32, channel_shape, mean_data);
+    Var variance = net->DeclWeight<float>("variance", primitive_t::float32, channel_shape, variance_data);
+    Var affine_scale = net->DeclWeight<float>("affine_scale", primitive_t::float32, channel_shape, affine_scale_data);
+    Var affine_bias = net->DeclWeight<float>("affine_bias", primitive_t::float32, channel_shape, affine_bias_data);
+
+    auto conv = net->AddConv2d(x0, w0, Var(), conv_param);
+    auto norm = net->AddBatchNorm(conv, scale, bias, mean, variance);
+    auto affine = net->AddBatchNorm(norm, affine_scale, affine_bias, Var(), Var());
+    net->DeclOutput(affine.name);
+  }
+
+  //! The convolution and the normalizations computed one after another.
+  std::vector<float> ManualTest(const std::vector<float>& x) {
+    Shape y_shape;
+    auto y = Conv2dNetworkBuilder::Conv2dNCHW(x, x0_shape, w0_data, w0_shape, {}, conv_param, &y_shape);
+    const int C = y_shape[1], HW = y_shape[2] * y_shape[3];
+    for (int i = 0; i < y.size(); i++) {
+      const int c = (i / HW) % C;
+      double v = (y[i] - mean_data[c]) / std::sqrt(variance_data[c] + 1e-5) * scale_data[c] + bias_data[c];
+      y[i] = v * affine_scale_data[c] + affine_bias_data[c];
+    }
+    return y;
+  }
+};
+
 }  // namespace hlir
 }  // namespace cinn
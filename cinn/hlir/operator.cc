@@ -28,11 +28,19 @@ void Operator::set_session(Session *x) {
   session_ = x;
 }
 
-void Operator::TensorAppendExpr(Tensor *tensor, ir::Expr expr) {
-  auto stage = tensor->AddStage(expr);
+Stage Operator::TensorAppendExpr(Tensor *tensor, ir::Expr expr, const std::vector<ir::Var> &iterators) {
+  auto stage = tensor->AddStage(Stage(expr, iterators));
   if (call_once_) {
     GlobalContext().once_call_registry().Register(stage.name());
   }
+  return stage;
+}
+
+int VectorWidth(int extent) {
+  for (int width : {8, 4}) {
+    if (extent % width == 0) return width;
+  }
+  return 0;
 }
 
 void Operator::Compile() {
@@ -5,6 +5,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 #include "cinn/hlir/hlir_util.h"
 #include "cinn/hlir/session.h"
 #include "cinn/hlir/tensor.h"
@@ -39,8 +40,10 @@ class Operator {
 
   /**
    * Append an expression to tensor's stages.
+   * @param iterators the iterators from the outermost loop to the innermost one, in the order they appear if empty.
+   * @return the stage appended.
    */
-  void TensorAppendExpr(Tensor* tensor, ir::Expr expr);
+  Stage TensorAppendExpr(Tensor* tensor, ir::Expr expr, const std::vector<ir::Var>& iterators = {});
 
   /**
    * Tell whether this operator is compiled, each operator can only compiled once.
@@ -118,5 +121,8 @@ class Operator {
   bool call_once_ = false;
 };
 
+//! The vector width to vectorize a loop with `extent` iterations, 0 if it can't be vectorized.
+int VectorWidth(int extent);
+
 }  // namespace hlir
 }  // namespace cinn
@@ -0,0 +1,216 @@
+/**
+ * The fold_batch_norm pass folds the inference batch normalizations and the per-channel affine transforms into the
+ * weights of the preceding convolutions and fully connected layers at build time, e.g.
+ *
+ *     conv2d(X, W, B) -> batch_norm(Scale, Bias, Mean, Variance)
+ *
+ * is rewritten to conv2d(X, W', B') with
+ *
+ *     a = Scale / sqrt(Variance + epsilon), b = Bias - Mean * a,
+ *     W'[m] = W[m] * a[m], B'[m] = B[m] * a[m] + b[m],
+ *
+ * where m is the output channel, so the normalization doesn't take another pass over the activations. The producers
+ * folded are conv2d, depthwise_conv2d without a fused activation and the fully connected layer matmul +
+ * elementwise_add. If the convolution has no bias, one of the parameters of the normalization is reused to hold it.
+ *
+ * The data of the weights is updated in their buffers, the normalization node and its parameters are removed from the
+ * graph, and the producer writes the output of the normalization directly. It only folds the weights used by nothing
+ * else, and the intermediate tensor consumed only by the normalization and not an output of the network.
+ */
+#include <cmath>
+#include <string>
+#include <vector>
+#include "cinn/core/optimize/pass.h"
+#include "cinn/core/optimize/pass_registry.h"
+#include "cinn/hlir/graph.h"
+#include "cinn/hlir/graph_util.h"
+#include "cinn/hlir/instruction_layer/conv2d_op.h"
+#include "cinn/hlir/instruction_layer/depthwise_conv2d_op.h"
+#include "cinn/hlir/instruction_layer/normalization_ops.h"
+#include "cinn/utils/logging.h"
+
+namespace cinn {
+namespace hlir {
+namespace optimize {
+
+namespace {
+
+//! Tell whether a node is a float32 weight only used by a single operator, so that its data can be modified.
+bool IsFoldableWeight(const Node* node) {
+  return node && node->tensor->is_weight() && node->tensor->ptype() == primitive_t::float32 &&
+         node->tensor->buffer() && node->tensor->buffer()->has_data() && node->outlinks.size() == 1UL;
+}
+
+const std::vector<float>& WeightData(const Node* node) { return node->tensor->buffer()->data<std::vector<float>>(); }
+
+void SetWeightData(Node* node, const std::vector<float>& data) {
+  CHECK_EQ(data.size(), static_cast<size_t>(node->tensor->shape().num_elements()));
+  node->tensor->buffer()->SetData<float>(data.data());
+}
+
+//! The operator writes the output of the folded normalization and the weights to modify.
+struct FoldTarget {
+  //! The operator writes the tensor normalized.
+  Node* producer{};
+  //! The weight scaled along its axis of the output channels.
+  Node* weight{};
+  int weight_axis{};
+  //! The bias, nullptr if the producer has none.
+  Node* bias{};
+  //! The axis of the output channels in the output.
+  int out_axis{};
+};
+
+}  // namespace
+
+class FoldBatchNormPass : public Pass<Graph> {
+ public:
+  explicit FoldBatchNormPass(const std::string& name) : Pass(name) {}
+
+ protected:
+  void Impl(Graph* graph) override {
+    LOG_INDENT(1);
+    std::vector<Node*> normalizations;
+    for (auto& node : GraphTraits::TS(*graph)) {
+      if (node.is_op() && node.op->type() == "batch_norm") normalizations.push_back(&node);
+    }
+
+    int num_folded = 0;
+    for (auto* node : normalizations) {
+      FoldTarget target;
+      if (Match(*graph, node, &target) && Fold(graph, node, target)) num_folded++;
+    }
+    LOG(INFO) << "folded " << num_folded << " of " << normalizations.size() << " batch_norm";
+  }
+
+ private:
+  //! Match the producer of the normalized tensor.
+  bool Match(const Graph& graph, Node* norm, FoldTarget* target) {
+    Node* x = GetInputNode(norm, "X");
+    if (x->inlinks.size() != 1UL || x->outlinks.size() != 1UL) return false;
+    // The normalized tensor is removed, it should not be read after the run.
+    if (graph.output_names().count(x->name)) return false;
+    Node* producer = x->inlinks.front();
+    const std::string& type = producer->op->type();
+
+    if (type == "conv2d") {
+      auto& param = producer->op->param<instruction_layer::Conv2dParam>();
+      const bool nchw = param.layout == instruction_layer::Conv2dParam::Layout::kNCHW;
+      target->weight = GetInputNode(producer, "W");
+      target->weight_axis = nchw ? 0 : 3;
+      target->bias = GetInputNode(producer, "B");
+      target->out_axis = nchw ? 1 : 3;
+    } else if (type == "depthwise_conv2d") {
+      // The activation is applied before the normalization, it can't be folded through.
+      auto& param = producer->op->param<instruction_layer::DepthwiseConv2dParam>();
+      if (param.activation != instruction_layer::DepthwiseConv2dParam::Activation::kNone) return false;
+      target->weight = GetInputNode(producer, "W");
+      target->weight_axis = 0;
+      target->bias = GetInputNode(producer, "B");
+      target->out_axis = 1;
+    } else if (type == "elementwise_add") {
+      // The fully connected layer, a matmul with the bias added.
+      Node* product = GetInputNode(producer, "X");
+      if (product->inlinks.size() != 1UL || product->outlinks.size() != 1UL) return false;
+      Node* matmul = product->inlinks.front();
+      if (matmul->op->type() != "matmul" && matmul->op->type() != "matmul_transposed") return false;
+      target->weight = GetInputNode(matmul, "W");
+      target->weight_axis = matmul->op->type() == "matmul" ? 1 : 0;
+      target->bias = GetInputNode(producer, "Y");
+      if (!target->bias || target->bias->tensor->shape().size() != 1UL) return false;
+      target->out_axis = 1;
+    } else {
+      return false;
+    }
+    target->producer = producer;
+
+    if (norm->op->param<instruction_layer::BatchNormParam>().axis != target->out_axis) return false;
+    if (!GetInputNode(norm, "Mean") != !GetInputNode(norm, "Variance")) return false;
+    if (!IsFoldableWeight(target->weight)) return false;
+    if (target->bias && !IsFoldableWeight(target->bias)) return false;
+
+    const int C = target->weight->tensor->shape()[target->weight_axis];
+    if (target->bias && target->bias->tensor->shape().num_elements() != C) return false;
+    for (auto* argument : {"Scale", "Bias", "Mean", "Variance"}) {
+      Node* param = GetInputNode(norm, argument);
+      if (!param) continue;
+      if (!param->tensor->is_weight() || param->tensor->ptype() != primitive_t::float32) return false;
+      if (param->tensor->shape().size() != 1UL || param->tensor->shape()[0] != C) return false;
+    }
+    return true;
+  }
+
+  bool Fold(Graph* graph, Node* norm, const FoldTarget& target) {
+    std::vector<Node*> params;
+    for (auto* argument : {"Scale", "Bias", "Mean", "Variance"}) params.push_back(GetInputNode(norm, argument));
+    Node *scale = params[0], *bias = params[1], *mean = params[2], *variance = params[3];
+
+    // A convolution without bias takes one of the parameters to hold its bias.
+    Node* new_bias = target.bias;
+    if (!new_bias) {
+      for (auto* param : params) {
+        if (IsFoldableWeight(param)) {
+          new_bias = param;
+          break;
+        }
+      }
+      if (!new_bias) return false;
+    }
+
+    // The coefficients of the channels, in double to keep the folded weights accurate.
+    const int C = target.weight->tensor->shape()[target.weight_axis];
+    const float epsilon = norm->op->param<instruction_layer::BatchNormParam>().epsilon;
+    std::vector<double> a(C, 1.), b(C, 0.);
+    for (int c = 0; c < C; c++) {
+      if (scale) a[c] = WeightData(scale)[c];
+      if (mean) a[c] /= std::sqrt(static_cast<double>(WeightData(variance)[c]) + epsilon);
+      if (bias) b[c] = WeightData(bias)[c];
+      if (mean) b[c] -= WeightData(mean)[c] * a[c];
+    }
+
+    // Scale the weight along the output channels.
+    const auto& shape = target.weight->tensor->shape().data;
+    int inner = 1;
+    for (int i = target.weight_axis + 1; i < shape.size(); i++) inner *= shape[i];
+    std::vector<float> weight = WeightData(target.weight);
+    for (size_t i = 0; i < weight.size(); i++) {
+      weight[i] = weight[i] * a[(i / inner) % C];
+    }
+    SetWeightData(target.weight, weight);
+
+    std::vector<float> bias_data(C);
+    for (int c = 0; c < C; c++) {
+      double origin = target.bias ? WeightData(target.bias)[c] : 0.;
+      bias_data[c] = origin * a[c] + b[c];
+    }
+    SetWeightData(new_bias, bias_data);
+
+    // The producer writes the output of the normalization.
+    Node* x = GetInputNode(norm, "X");
+    Node* out = norm->outlinks.front();
+    Node* producer = target.producer;
+    graph->RemoveNode(x);
+    graph->RemoveNode(norm);
+    producer->op->SetOutput("Out", out->name);
+    producer->outlinks.push_back(out);
+    out->inlinks.push_back(producer);
+
+    if (!target.bias) {
+      producer->op->SetInput("B", new_bias->name);
+      producer->inlinks.push_back(new_bias);
+      new_bias->outlinks.push_back(producer);
+    }
+    for (auto* param : params) {
+      if (param && param != new_bias && param->outlinks.empty()) graph->RemoveNode(param);
+    }
+
+    CINN_DEBUG(1) << "fold " << out->name << " into " << producer->name;
+    return true;
+  }
+};
+
+}  // namespace optimize
+}  // namespace hlir
+}  // namespace cinn
+
+REGISTER_HLIR_PASS(fold_batch_norm, ::cinn::hlir::optimize::FoldBatchNormPass);
@@ -0,0 +1,226 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <string>
+#include <vector>
+#include "cinn/core/optimize/optimizer.h"
+#include "cinn/core/optimize/pass_registry.h"
+#include "cinn/hlir/graph.h"
+#include "cinn/hlir/graph_util.h"
+#include "cinn/hlir/instruction_layer/use_ops.h"
+#include "cinn/hlir/network.h"
+#include "cinn/hlir/network_test_util.h"
+
+USE_HLIR_PASS(fold_batch_norm);
+
+namespace cinn {
+namespace hlir {
+namespace optimize {
+
+TEST(fold_batch_norm_pass, conv2d) {
+  SetGlobalContext(new CINNContext);
+
+  Session session;
+  Network net("tmp", &session);
+
+  BatchNormNetworkBuilder net_builder;
+  net_builder.Build(&net, &session);
+  const std::string output = *net.output_names().begin();
+
+  auto program = net.Compile();
+
+  Graph graph;
+  graph.Build(program, session);
+
+  Optimizer<Graph> optimizer({"fold_batch_norm"});
+  optimizer(&graph);
+
+  // Only the convolution is left, it writes the output with a bias reused from the parameters.
+  std::vector<Node*> ops;
+  for (auto& node : GraphTraits::TS(graph)) {
+    if (node.is_op()) ops.push_back(&node);
+  }
+  ASSERT_EQ(ops.size(), 1UL);
+  Operator* conv = ops.front()->op;
+  ASSERT_EQ(conv->type(), "conv2d");
+  ASSERT_EQ(conv->outputs().at("Out"), output);
+  ASSERT_TRUE(conv->inputs().count("B"));
+  const std::string bias = conv->inputs().at("B");
+
+  for (auto* name : {"scale", "bias", "mean", "variance", "affine_scale", "affine_bias"}) {
+    ASSERT_EQ(graph.removed_tensors().count(name) > 0, name != bias) << name;
+  }
+  // The two intermediate outputs.
+  ASSERT_EQ(graph.removed_tensors().size(), 7UL);
+  ASSERT_EQ(graph.Outputs().size(), 1UL);
+  ASSERT_EQ((*graph.Outputs().begin())->name, output);
+
+  const int C = net_builder.channel_shape.num_elements();
+  const int inner = net_builder.w0_shape.num_elements() / C;
+  auto& w0 = session.GetTensor("w0")->buffer()->data<std::vector<float>>();
+  auto& b = session.GetTensor(bias)->buffer()->data<std::vector<float>>();
+  for (int c = 0; c < C; c++) {
+    double a = net_builder.scale_data[c] / std::sqrt(net_builder.variance_data[c] + 1e-5);
+    double shift = net_builder.bias_data[c] - net_builder.mean_data[c] * a;
+    a *= net_builder.affine_scale_data[c];
+    shift = shift * net_builder.affine_scale_data[c] + net_builder.affine_bias_data[c];
+    EXPECT_NEAR(b[c], shift, 1e-5);
+    for (int i = 0; i < inner; i++) {
+      EXPECT_NEAR(w0[c * inner + i], net_builder.w0_data[c * inner + i] * a, 1e-6);
+    }
+  }
+
+  for (auto& node : GraphTraits::TS(graph)) {
+    if (node.is_op()) node.op->Compile();
+  }
+  ASSERT_EQ(session.GetTensor(output)->shape().data, net_builder.out_shape.data);
+}
+
+namespace {
+
+//! The operators left in the graph.
+std::vector<std::string> OpTypes(Graph* graph) {
+  std::vector<std::string> types;
+  for (auto& node : GraphTraits::TS(*graph)) {
+    if (node.is_op()) types.push_back(node.op->type());
+  }
+  return types;
+}
+
+std::vector<float> ChannelData(int C, float base, float step) {
+  std::vector<float> data(C);
+  for (int c = 0; c < C; c++) data[c] = base + step * (c % 7);
+  return data;
+}
+
+}  // namespace
+
+TEST(fold_batch_norm_pass, fc) {
+  SetGlobalContext(new CINNContext);
+
+  Session session;
+  Network net("tmp", &session);
+
+  const int K = 8, C = 16;
+  std::vector<float> w_data(K * C), b_data = ChannelData(C, -0.1, 0.03);
+  for (int i = 0; i < w_data.size(); i++) w_data[i] = 0.01 * (i % 13) - 0.05;
+  auto scale_data = ChannelData(C, 0.5, 0.1);
+  auto mean_data = ChannelData(C, -0.05, 0.02);
+  auto variance_data = ChannelData(C, 0.2, 0.05);
+
+  auto x = net.DeclInput("x", primitive_t::float32, Shape({4, K}));
+  auto w = net.DeclWeight<float>("w", primitive_t::float32, Shape({K, C}), w_data);
+  auto b = net.DeclWeight<float>("b", primitive_t::float32, Shape({C}), b_data);
+  auto scale = net.DeclWeight<float>("scale", primitive_t::float32, Shape({C}), scale_data);
+  auto mean = net.DeclWeight<float>("mean", primitive_t::float32, Shape({C}), mean_data);
+  auto variance = net.DeclWeight<float>("variance", primitive_t::float32, Shape({C}), variance_data);
+  auto out = net.AddBatchNorm(net.AddFc(x, w, b), scale, Network::Var(), mean, variance);
+  net.DeclOutput(out.name);
+
+  auto program = net.Compile();
+  Graph graph;
+  graph.Build(program, session);
+  Optimizer<Graph> optimizer({"fold_batch_norm"});
+  optimizer(&graph);
+
+  ASSERT_EQ(OpTypes(&graph), std::vector<std::string>({"matmul", "elementwise_add"}));
+  ASSERT_EQ((*graph.Outputs().begin())->name, out.name);
+
+  auto& w_folded = session.GetTensor("w")->buffer()->data<std::vector<float>>();
+  auto& b_folded = session.GetTensor("b")->buffer()->data<std::vector<float>>();
+  for (int c = 0; c < C; c++) {
+    double a = scale_data[c] / std::sqrt(variance_data[c] + 1e-5);
+    EXPECT_NEAR(b_folded[c], (b_data[c] - mean_data[c]) * a, 1e-5);
+    // The output channels are the columns of the weight.
+    for (int k = 0; k < K; k++) EXPECT_NEAR(w_folded[k * C + c], w_data[k * C + c] * a, 1e-6);
+  }
+}
+
+TEST(fold_batch_norm_pass, depthwise_conv2d) {
+  for (bool activated : {false, true}) {
+    SetGlobalContext(new CINNContext);
+
+    Session session;
+    Network net("tmp", &session);
+
+    const int C = 16;
+    std::vector<float> w_data(C * 9), b_data = ChannelData(C, -0.1, 0.03);
+    for (int i = 0; i < w_data.size(); i++) w_data[i] = 0.01 * (i % 31) - 0.1;
+    auto scale_data = ChannelData(C, 0.5, 0.1);
+    auto shift_data = ChannelData(C, 0.1, -0.02);
+
+    auto x = net.DeclInput("x", primitive_t::float32, Shape({1, C, 8, 8}));
+    auto w = net.DeclWeight<float>("w", primitive_t::float32, Shape({C, 1, 3, 3}), w_data);
+    auto b = net.DeclWeight<float>("b", primitive_t::float32, Shape({C}), b_data);
+    auto scale = net.DeclWeight<float>("scale", primitive_t::float32, Shape({C}), scale_data);
+    auto shift = net.DeclWeight<float>("shift", primitive_t::float32, Shape({C}), shift_data);
+    instruction_layer::DepthwiseConv2dParam param;
+    param.paddings = {1, 1};
+    if (activated) param.activation = instruction_layer::DepthwiseConv2dParam::Activation::kRelu;
+    auto conv = net.AddDepthwiseConv2d(x, w, b, param);
+    auto out = net.AddBatchNorm(conv, scale, shift, Network::Var(), Network::Var());
+    net.DeclOutput(out.name);
+
+    auto program = net.Compile();
+    Graph graph;
+    graph.Build(program, session);
+    Optimizer<Graph> optimizer({"fold_batch_norm"});
+    optimizer(&graph);
+
+    auto& w_folded = session.GetTensor("w")->buffer()->data<std::vector<float>>();
+    auto& b_folded = session.GetTensor("b")->buffer()->data<std::vector<float>>();
+    if (activated) {
+      // The activation is between the convolution and the normalization, nothing is folded.
+      ASSERT_EQ(OpTypes(&graph), std::vector<std::string>({"depthwise_conv2d", "batch_norm"}));
+      ASSERT_EQ(w_folded, w_data);
+      ASSERT_EQ(b_folded, b_data);
+      continue;
+    }
+
+    ASSERT_EQ(OpTypes(&graph), std::vector<std::string>({"depthwise_conv2d"}));
+    ASSERT_EQ((*graph.Outputs().begin())->name, out.name);
+    for (int c = 0; c < C; c++) {
+      EXPECT_NEAR(b_folded[c], b_data[c] * scale_data[c] + shift_data[c], 1e-5);
+      for (int i = 0; i < 9; i++) EXPECT_NEAR(w_folded[c * 9 + i], w_data[c * 9 + i] * scale_data[c], 1e-6);
+    }
+  }
+}
+
+TEST(fold_batch_norm_pass, output_normalized) {
+  SetGlobalContext(new CINNContext);
+
+  Session session;
+  Network net("tmp", &session);
+
+  const int C = 16;
+  std::vector<float> w_data(C * 9), b_data = ChannelData(C, -0.1, 0.03);
+  for (int i = 0; i < w_data.size(); i++) w_data[i] = 0.01 * (i % 31) - 0.1;
+
+  auto x = net.DeclInput("x", primitive_t::float32, Shape({1, C, 8, 8}));
+  auto w = net.DeclWeight<float>("w", primitive_t::float32, Shape({C, 1, 3, 3}), w_data);
+  auto b = net.DeclWeight<float>("b", primitive_t::float32, Shape({C}), b_data);
+  auto scale = net.DeclWeight<float>("scale", primitive_t::float32, Shape({C}), ChannelData(C, 0.5, 0.1));
+  auto shift = net.DeclWeight<float>("shift", primitive_t::float32, Shape({C}), ChannelData(C, 0.1, -0.02));
+  instruction_layer::DepthwiseConv2dParam param;
+  param.paddings = {1, 1};
+  auto conv = net.AddDepthwiseConv2d(x, w, b, param);
+  auto out = net.AddBatchNorm(conv, scale, shift, Network::Var(), Network::Var());
+  // The output of the convolution is read too.
+  net.DeclOutput(conv.name);
+  net.DeclOutput(out.name);
+
+  auto program = net.Compile();
+  Graph graph;
+  graph.Build(program, session);
+  graph.set_output_names(net.output_names());
+  Optimizer<Graph> optimizer({"fold_batch_norm"});
+  optimizer(&graph);
+
+  ASSERT_EQ(OpTypes(&graph), std::vector<std::string>({"depthwise_conv2d", "batch_norm"}));
+  ASSERT_TRUE(graph.removed_tensors().empty());
+  ASSERT_EQ(session.GetTensor("w")->buffer()->data<std::vector<float>>(), w_data);
+  ASSERT_EQ(session.GetTensor("b")->buffer()->data<std::vector<float>>(), b_data);
+}
+
+}  // namespace optimize
+}  // namespace hlir
+}  // namespace cinn
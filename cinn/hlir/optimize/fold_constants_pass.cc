@@ -0,0 +1,219 @@
+/**
+ * The fold_constants pass evaluates the operators whose inputs are all weights at build time, e.g. the transpose of the
+ * weight of a fully connected layer, so they are not executed at runtime, even once on the first call.
+ *
+ * The output of a folded operator becomes a weight holding the data evaluated, and the operator is removed from the
+ * graph, as well as the input weights used by nothing else, so only the folded copy of a weight is kept. The operators
+ * are visited in the topological order, so a chain of the operators on the weights is folded one by one.
+ *
+ * The operators folded are transpose, reshape, the elementwise operators, tanh, sigmoid and batch_norm, on the float32
+ * weights only.
+ */
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+#include "cinn/core/optimize/pass.h"
+#include "cinn/core/optimize/pass_registry.h"
+#include "cinn/hlir/buffer.h"
+#include "cinn/hlir/graph.h"
+#include "cinn/hlir/graph_util.h"
+#include "cinn/hlir/instruction_layer/normalization_ops.h"
+#include "cinn/hlir/instruction_layer/reshape_op.h"
+#include "cinn/hlir/instruction_layer/transpose_op.h"
+#include "cinn/utils/logging.h"
+
+namespace cinn {
+namespace hlir {
+namespace optimize {
+
+namespace {
+
+//! Tell whether a node is a float32 weight with data, so that it can be evaluated at build time.
+bool IsConstant(const Node* node) {
+  return node && node->is_tensor() && node->tensor->is_weight() && node->tensor->ptype() == primitive_t::float32 &&
+         node->tensor->buffer() && node->tensor->buffer()->has_data();
+}
+
+const std::vector<float>& ConstantData(const Node* node) {
+  return node->tensor->buffer()->data<std::vector<float>>();
+}
+
+//! The constant to evaluate.
+struct Constant {
+  std::vector<float> data;
+  Shape shape;
+};
+
+Constant Transpose(const Node* x, const std::vector<int>& perm) {
+  const auto& in_shape = x->tensor->shape().data;
+  const auto& in = ConstantData(x);
+  const int rank = in_shape.size();
+  CHECK_EQ(perm.size(), in_shape.size());
+
+  std::vector<int> in_strides(rank, 1);
+  for (int i = rank - 2; i >= 0; i--) in_strides[i] = in_strides[i + 1] * in_shape[i + 1];
+
+  Constant out;
+  out.shape.data.resize(rank);
+  for (int i = 0; i < rank; i++) out.shape.data[i] = in_shape[perm[i]];
+  out.data.resize(in.size());
+  // The offset of the input element is accumulated while the output is visited in order.
+  std::vector<int> index(rank, 0);
+  for (size_t i = 0; i < out.data.size(); i++) {
+    int offset = 0;
+    for (int d = 0; d < rank; d++) offset += index[d] * in_strides[perm[d]];
+    out.data[i] = in[offset];
+    for (int d = rank - 1; d >= 0 && ++index[d] == out.shape[d]; d--) index[d] = 0;
+  }
+  return out;
+}
+
+//! The elementwise operators broadcast Y along the leading dimensions of X.
+bool Elementwise(const std::string& type, const Node* x, const Node* y, Constant* out) {
+  if (!y) return false;
+  const auto& x_shape = x->tensor->shape().data;
+  const auto& y_shape = y->tensor->shape().data;
+  if (y_shape.size() > x_shape.size() || !std::equal(y_shape.rbegin(), y_shape.rend(), x_shape.rbegin())) return false;
+
+  const auto& a = ConstantData(x);
+  const auto& b = ConstantData(y);
+  out->shape = x->tensor->shape();
+  out->data.resize(a.size());
+  for (size_t i = 0; i < a.size(); i++) {
+    const float u = a[i], v = b[i % b.size()];
+    if (type == "elementwise_add") {
+      out->data[i] = u + v;
+    } else if (type == "elementwise_sub") {
+      out->data[i] = u - v;
+    } else if (type == "elementwise_mul") {
+      out->data[i] = u * v;
+    } else {
+      out->data[i] = u / v;
+    }
+  }
+  return true;
+}
+
+Constant BatchNorm(Node* op_node) {
+  const Node* x = GetInputNode(op_node, "X");
+  auto& param = op_node->op->param<instruction_layer::BatchNormParam>();
+  const auto& shape = x->tensor->shape().data;
+  int inner = 1;
+  for (int i = param.axis + 1; i < shape.size(); i++) inner *= shape[i];
+  const int C = shape[param.axis];
+
+  auto channel_data = [&](const std::string& argument) -> const std::vector<float>* {
+    Node* node = GetInputNode(op_node, argument);
+    return node ? &ConstantData(node) : nullptr;
+  };
+  const auto* scale = channel_data("Scale");
+  const auto* bias = channel_data("Bias");
+  const auto* mean = channel_data("Mean");
+  const auto* variance = channel_data("Variance");
+  CHECK_EQ(!mean, !variance) << "the mean and the variance should be given together";
+
+  Constant out;
+  out.shape = x->tensor->shape();
+  out.data = ConstantData(x);
+  for (size_t i = 0; i < out.data.size(); i++) {
+    const int c = (i / inner) % C;
+    float v = out.data[i];
+    if (mean) v = (v - (*mean)[c]) / std::sqrt((*variance)[c] + param.epsilon);
+    if (scale) v = v * (*scale)[c];
+    if (bias) v = v + (*bias)[c];
+    out.data[i] = v;
+  }
+  return out;
+}
+
+}  // namespace
+
+class FoldConstantsPass : public Pass<Graph> {
+ public:
+  explicit FoldConstantsPass(const std::string& name) : Pass(name) {}
+
+ protected:
+  void Impl(Graph* graph) override {
+    LOG_INDENT(1);
+    std::vector<Node*> op_nodes;
+    for (auto& node : GraphTraits::TS(*graph)) {
+      if (node.is_op()) op_nodes.push_back(&node);
+    }
+
+    int num_folded = 0;
+    for (auto* node : op_nodes) {
+      if (Fold(graph, node)) num_folded++;
+    }
+    LOG(INFO) << "folded " << num_folded << " operators on the weights";
+  }
+
+ private:
+  bool Fold(Graph* graph, Node* op_node) {
+    if (op_node->inlinks.empty() || op_node->outlinks.size() != 1UL) return false;
+    for (auto* x : op_node->inlinks) {
+      if (!IsConstant(x)) return false;
+    }
+    // The outputs of the graph and the network are kept computed, the folded data is not written to their buffers.
+    Node* out = op_node->outlinks.front();
+    if (out->outlinks.empty() || graph->output_names().count(out->name)) return false;
+
+    Constant constant;
+    if (!Evaluate(op_node, &constant)) return false;
+    CHECK_EQ(constant.data.size(), static_cast<size_t>(constant.shape.num_elements()));
+
+    Tensor* tensor = out->tensor;
+    tensor->set_ptype(primitive_t::float32);
+    tensor->set_shape(constant.shape);
+    auto buf = std::make_shared<Buffer>(tensor->name() + "_buf", primitive_t::float32);
+    buf->Resize(constant.shape.num_bytes(primitive_t::float32));
+    buf->SetData<float>(constant.data.data());
+    tensor->AttachBuffer(buf);
+    tensor->set_is_weight();
+
+    // An input used twice, such as `x * x`, is linked twice.
+    std::set<Node*> inputs(op_node->inlinks.begin(), op_node->inlinks.end());
+    graph->RemoveNode(op_node);
+    for (auto* x : inputs) {
+      if (x->outlinks.empty()) graph->RemoveNode(x);
+    }
+
+    CINN_DEBUG(1) << "fold " << out->name << " " << constant.shape.num_elements() << " elements";
+    return true;
+  }
+
+  //! Evaluate an operator, returns false if it is not supported.
+  bool Evaluate(Node* op_node, Constant* out) {
+    const std::string& type = op_node->op->type();
+    const Node* x = GetInputNode(op_node, "X");
+    if (!x) return false;
+
+    if (type == "transpose") {
+      *out = Transpose(x, op_node->op->param<instruction_layer::TransposeParam>().perm);
+    } else if (type == "reshape") {
+      out->shape = Shape(op_node->op->param<instruction_layer::ReshapeParam>().shape);
+      if (out->shape.num_elements() != x->tensor->shape().num_elements()) return false;
+      out->data = ConstantData(x);
+    } else if (type == "elementwise_add" || type == "elementwise_sub" || type == "elementwise_mul" ||
+               type == "elementwise_div") {
+      return Elementwise(type, x, GetInputNode(op_node, "Y"), out);
+    } else if (type == "tanh" || type == "sigmoid") {
+      out->shape = x->tensor->shape();
+      out->data = ConstantData(x);
+      for (auto& v : out->data) v = type == "tanh" ? std::tanh(v) : 1.f / (1.f + std::exp(-v));
+    } else if (type == "batch_norm") {
+      *out = BatchNorm(op_node);
+    } else {
+      return false;
+    }
+    return true;
+  }
+};
+
+}  // namespace optimize
+}  // namespace hlir
+}  // namespace cinn
+
+REGISTER_HLIR_PASS(fold_constants, ::cinn::hlir::optimize::FoldConstantsPass);
@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "cinn/core/optimize/optimizer.h"
+#include "cinn/core/optimize/pass_registry.h"
+#include "cinn/hlir/graph.h"
+#include "cinn/hlir/graph_util.h"
+#include "cinn/hlir/instruction_layer/use_ops.h"
+#include "cinn/hlir/network.h"
+#include "cinn/hlir/network_test_util.h"
+
+USE_HLIR_PASS(fold_constants);
+
+namespace cinn {
+namespace hlir {
+namespace optimize {
+
+TEST(fold_constants_pass, transposed_fc) {
+  SetGlobalContext(new CINNContext);
+
+  Session session;
+  Network net("tmp", &session);
+
+  // Two FC layers share the weight, each transposes it.
+  Network2Builder net_builder(2, true);
+  net_builder.Build(&net, &session);
+
+  auto program = net.Compile();
+
+  Graph graph;
+  graph.Build(program, session);
+
+  Optimizer<Graph> optimizer({"fold_constants"});
+  optimizer(&graph);
+
+  // The transposes are evaluated, and the original weight is dropped after the both are folded.
+  std::vector<Node*> matmuls;
+  for (auto& node : GraphTraits::TS(graph)) {
+    if (!node.is_op()) continue;
+    ASSERT_NE(node.op->type(), "transpose");
+    if (node.op->type() == "matmul_transposed") matmuls.push_back(&node);
+  }
+  ASSERT_EQ(matmuls.size(), 2UL);
+  ASSERT_TRUE(graph.removed_tensors().count("w0"));
+
+  const int K = net_builder.w0_shape[0], N = net_builder.w0_shape[1];
+  for (auto* matmul : matmuls) {
+    Tensor* w = GetInputNode(matmul, "W")->tensor;
+    ASSERT_TRUE(w->is_weight());
+    ASSERT_EQ(w->shape().data, std::vector<int>({N, K}));
+    auto& data = w->buffer()->data<std::vector<float>>();
+    for (int n = 0; n < N; n++) {
+      for (int k = 0; k < K; k++) {
+        ASSERT_EQ(data[n * K + k], net_builder.w0_data[k * N + n]);
+      }
+    }
+  }
+
+  for (auto& node : GraphTraits::TS(graph)) {
+    if (node.is_op()) node.op->Compile();
+  }
+}
+
+TEST(fold_constants_pass, same_inputs) {
+  SetGlobalContext(new CINNContext);
+
+  Session session;
+  Network net("tmp", &session);
+
+  const int K = 8, N = 16;
+  std::vector<float> w_data(K * N);
+  for (int i = 0; i < w_data.size(); i++) w_data[i] = 0.01 * (i % 13) - 0.05;
+  auto x = net.DeclInput("x", primitive_t::float32, Shape({4, K}));
+  auto w = net.DeclWeight<float>("w", primitive_t::float32, Shape({K, N}), w_data);
+  // The weight is both inputs of the multiplication.
+  auto out = net.AddMatMul(x, net.AddElementwiseMul(w, w));
+  net.DeclOutput(out.name);
+
+  auto program = net.Compile();
+
+  Graph graph;
+  graph.Build(program, session);
+
+  Optimizer<Graph> optimizer({"fold_constants"});
+  optimizer(&graph);
+
+  std::vector<Node*> ops;
+  for (auto& node : GraphTraits::TS(graph)) {
+    if (node.is_op()) ops.push_back(&node);
+  }
+  ASSERT_EQ(ops.size(), 1UL);
+  ASSERT_EQ(ops.front()->op->type(), "matmul");
+  ASSERT_TRUE(graph.removed_tensors().count("w"));
+
+  Tensor* square = GetInputNode(ops.front(), "W")->tensor;
+  ASSERT_TRUE(square->is_weight());
+  auto& data = square->buffer()->data<std::vector<float>>();
+  for (int i = 0; i < w_data.size(); i++) {
+    ASSERT_EQ(data[i], w_data[i] * w_data[i]);
+  }
+}
+
+TEST(fold_constants_pass, consumed_output) {
+  SetGlobalContext(new CINNContext);
+
+  Session session;
+  Network net("tmp", &session);
+
+  const int K = 8, N = 16;
+  std::vector<float> w_data(K * N, 0.5f);
+  auto x = net.DeclInput("x", primitive_t::float32, Shape({4, K}));
+  auto w = net.DeclWeight<float>("w", primitive_t::float32, Shape({K, N}), w_data);
+  // The square of the weight is an output of the network, and consumed by the matmul.
+  auto square = net.AddElementwiseMul(w, w);
+  auto out = net.AddMatMul(x, square);
+  net.DeclOutput(square.name);
+  net.DeclOutput(out.name);
+
+  auto program = net.Compile();
+
+  Graph graph;
+  graph.Build(program, session);
+  graph.set_output_names(net.output_names());
+
+  Optimizer<Graph> optimizer({"fold_constants"});
+  optimizer(&graph);
+
+  std::vector<std::string> types;
+  for (auto& node : GraphTraits::TS(graph)) {
+    if (node.is_op()) types.push_back(node.op->type());
+  }
+  ASSERT_EQ(types, std::vector<std::string>({"elementwise_mul", "matmul"}));
+  ASSERT_TRUE(graph.removed_tensors().empty());
+  ASSERT_FALSE(session.GetTensor(square.name)->is_weight());
+}
+
+}  // namespace optimize
+}  // namespace hlir
+}  // namespace cinn
@@ -9,7 +9,12 @@ namespace hlir {
 ir::Expr Tensor::Elem() const {
   CHECK(!shape().empty());
   CHECK_EQ(iterators().size(), shape().size());
-  auto node = ir::Reference::make(expr(), iterators());
+  return Elem(iterators());
+}
+
+ir::Expr Tensor::Elem(const std::vector<ir::Expr> &indices) const {
+  CHECK_EQ(indices.size(), shape().size());
+  auto node = ir::Reference::make(expr(), indices);
   node.InferenceIteratorDomain();
   return node;
 }
@@ -51,10 +56,16 @@ void Tensor::InitExpr() {
       ir_shape.emplace_back(v);
     }
     ir_inner_name_ = name_.empty() ? GlobalContext().name_generator().NewNamed("tensor") : name_;
-    expr_ = ir::Expr(ir_shape, primitive_t::float32, ir_inner_name());
+    expr_ = ir::Expr(ir_shape, ptype_ == primitive_t::unk ? primitive_t::float32 : ptype_, ir_inner_name());
   }
 }
 
+void Tensor::set_ptype(primitive_t type) {
+  ptype_ = type;
+  // Keep the IR tensor in the same type, so that the generated code declares the buffer in the right type.
+  if (expr_.valid()) expr_.set_ptype(type);
+}
+
 void Tensor::set_shape(const Shape &x) {
   CHECK(shape_.empty()) << "duplicate set shape";
   shape_ = x;
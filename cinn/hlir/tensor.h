@@ -56,6 +56,13 @@ class Tensor {
    */
   ir::Expr Elem() const;
 
+  /**
+   * Get the ir::Expr of the element at the indices, such as A[i*2][j+1].
+   * @param indices the index expressions of all the dimensions.
+   * @return the Expr.
+   */
+  ir::Expr Elem(const std::vector<ir::Expr>& indices) const;
+
   void AttachBuffer();
   void AttachBuffer(const std::shared_ptr<Buffer>& buf) { buffer_ = buf; }
   const std::shared_ptr<Buffer>& buffer() const { return buffer_; }
@@ -67,7 +74,7 @@ class Tensor {
   void set_is_weight(bool x = true) { is_weight_ = x; }
   bool is_weight() const { return is_weight_; }
 
-  void set_ptype(primitive_t type) { ptype_ = type; }
+  void set_ptype(primitive_t type);
   primitive_t ptype() const { return ptype_; }
 
   /**
@@ -0,0 +1,132 @@
+#include "cinn/hlir/weights_file.h"
+#include <glog/logging.h>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace cinn {
+namespace hlir {
+
+namespace {
+
+const char kMagic[] = "CINNWGT1";
+const size_t kMagicSize = sizeof(kMagic) - 1;
+
+template <typename T>
+void WriteValue(std::string *buffer, T value) {
+  buffer->append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template <typename T>
+T ReadValue(const std::string &buffer, size_t *pos) {
+  CHECK_LE(*pos + sizeof(T), buffer.size()) << "truncated weights file";
+  T value;
+  std::memcpy(&value, buffer.data() + *pos, sizeof(T));
+  *pos += sizeof(T);
+  return value;
+}
+
+}  // namespace
+
+void WeightsFile::Add(const std::string &name, primitive_t ptype, const void *data, size_t size) {
+  CHECK(!planned_) << "add weight after planned";
+  CHECK(!entry_ids_.count(name)) << "duplicate add weight " << name;
+  CHECK(data || size == 0);
+  entry_ids_[name] = entries_.size();
+  Entry entry;
+  entry.name = name;
+  entry.ptype = ptype;
+  entry.data.assign(static_cast<const char *>(data), size);
+  entries_.push_back(std::move(entry));
+}
+
+void WeightsFile::Plan() {
+  CHECK(!planned_) << "duplicate plan";
+  CHECK_GT(alignment_, 0UL);
+  size_t index_size = kMagicSize + sizeof(uint64_t);
+  for (auto &entry : entries_) {
+    index_size += 2 * sizeof(uint64_t) + sizeof(int32_t) + sizeof(uint32_t) + entry.name.size();
+  }
+
+  size_t offset = Align(index_size);
+  for (auto &entry : entries_) {
+    entry.offset = offset;
+    offset = Align(offset + entry.data.size());
+  }
+  file_size_ = offset;
+  planned_ = true;
+}
+
+size_t WeightsFile::offset(const std::string &name) const {
+  CHECK(planned_) << "get offset before planned";
+  return entry(name).offset;
+}
+
+size_t WeightsFile::file_size() const {
+  CHECK(planned_) << "get file size before planned";
+  return file_size_;
+}
+
+const WeightsFile::Entry &WeightsFile::entry(const std::string &name) const {
+  auto it = entry_ids_.find(name);
+  CHECK(it != entry_ids_.end()) << "weight " << name << " not exists";
+  return entries_[it->second];
+}
+
+void WeightsFile::Write(const std::string &path) const {
+  CHECK(planned_) << "write before planned";
+  std::string buffer(kMagic, kMagicSize);
+  WriteValue<uint64_t>(&buffer, entries_.size());
+  for (auto &entry : entries_) {
+    WriteValue<uint64_t>(&buffer, entry.offset);
+    WriteValue<uint64_t>(&buffer, entry.data.size());
+    WriteValue<int32_t>(&buffer, static_cast<int32_t>(entry.ptype));
+    WriteValue<uint32_t>(&buffer, entry.name.size());
+    buffer += entry.name;
+  }
+  for (auto &entry : entries_) {
+    buffer.resize(entry.offset, '\0');
+    buffer += entry.data;
+  }
+  buffer.resize(file_size_, '\0');
+
+  std::ofstream file(path, std::ios::binary);
+  CHECK(file.is_open()) << "failed to open file " << path;
+  file.write(buffer.data(), buffer.size());
+  CHECK(file.good()) << "failed to write file " << path;
+}
+
+WeightsFile WeightsFile::Read(const std::string &path) {
+  std::ifstream file(path, std::ios::binary);
+  CHECK(file.is_open()) << "failed to open file " << path;
+  std::stringstream ss;
+  ss << file.rdbuf();
+  std::string buffer = ss.str();
+
+  CHECK(buffer.compare(0, kMagicSize, kMagic) == 0) << path << " is not a weights file";
+  size_t pos = kMagicSize;
+  WeightsFile result;
+  auto num_entries = ReadValue<uint64_t>(buffer, &pos);
+  for (uint64_t i = 0; i < num_entries; i++) {
+    Entry entry;
+    entry.offset = ReadValue<uint64_t>(buffer, &pos);
+    auto size = ReadValue<uint64_t>(buffer, &pos);
+    entry.ptype = static_cast<primitive_t>(ReadValue<int32_t>(buffer, &pos));
+    auto name_size = ReadValue<uint32_t>(buffer, &pos);
+    CHECK_LE(pos + name_size, buffer.size()) << "truncated weights file";
+    entry.name = buffer.substr(pos, name_size);
+    pos += name_size;
+    CHECK_LE(entry.offset + size, buffer.size()) << "truncated weights file";
+    entry.data = buffer.substr(entry.offset, size);
+
+    result.entry_ids_[entry.name] = result.entries_.size();
+    result.entries_.push_back(std::move(entry));
+  }
+  result.file_size_ = buffer.size();
+  result.planned_ = true;
+  return result;
+}
+
+}  // namespace hlir
+}  // namespace cinn
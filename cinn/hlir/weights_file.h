@@ -0,0 +1,82 @@
+#pragma once
+#include <map>
+#include <string>
+#include <vector>
+#include "cinn/type.h"
+
+namespace cinn {
+namespace hlir {
+
+/**
+ * WeightsFile packs the weights of a model in a binary file, the generated code maps the file when it is loaded
+ * instead of embedding the weights in the source code as array literals.
+ *
+ * Usage:
+ *
+ *     WeightsFile file;
+ *     file.Add("w0", primitive_t::float32, w0.data(), w0.size() * sizeof(float));
+ *     file.Add("b0", primitive_t::float32, b0.data(), b0.size() * sizeof(float));
+ *     file.Plan();
+ *     file.offset("b0");  // the offset of b0 in the file, fixed in the generated code
+ *     file.Write("model.weights");
+ *
+ * The file starts with a small index, followed by the data of the weights:
+ *
+ *     "CINNWGT1" | uint64 number of weights | entries | padding | data
+ *
+ * each entry is `uint64 offset | uint64 size | int32 ptype | uint32 length of name | name`. The offsets are from the
+ * beginning of the file, and aligned so that the mapped weights can be loaded with the aligned SIMD instructions.
+ *
+ * The weights can be updated without recompiling the program, by writing a file with the same weights in the same
+ * order, that has the same layout.
+ */
+class WeightsFile {
+ public:
+  struct Entry {
+    std::string name;
+    primitive_t ptype;
+    size_t offset{0};
+    std::string data;
+  };
+
+  explicit WeightsFile(size_t alignment = 64) : alignment_(alignment) {}
+
+  /**
+   * Add a weight.
+   * @param name name of the weight.
+   * @param ptype the type of the elements.
+   * @param data the data of the weight.
+   * @param size size of the weight in bytes.
+   */
+  void Add(const std::string& name, primitive_t ptype, const void* data, size_t size);
+
+  //! Assign the offsets of the weights in the file.
+  void Plan();
+
+  //! Get the offset of a weight in the file, should be called after Plan.
+  size_t offset(const std::string& name) const;
+
+  //! Size of the whole file, should be called after Plan.
+  size_t file_size() const;
+
+  //! Write the file, should be called after Plan.
+  void Write(const std::string& path) const;
+
+  //! Read a file written by Write.
+  static WeightsFile Read(const std::string& path);
+
+  const std::vector<Entry>& entries() const { return entries_; }
+  const Entry& entry(const std::string& name) const;
+
+ private:
+  size_t Align(size_t x) const { return (x + alignment_ - 1) / alignment_ * alignment_; }
+
+  size_t alignment_;
+  std::vector<Entry> entries_;
+  std::map<std::string, int> entry_ids_;
+  size_t file_size_{0};
+  bool planned_{false};
+};
+
+}  // namespace hlir
+}  // namespace cinn
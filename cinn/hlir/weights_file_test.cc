@@ -0,0 +1,43 @@
+#include "cinn/hlir/weights_file.h"
+#include <gtest/gtest.h>
+#include <unistd.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace cinn {
+namespace hlir {
+
+TEST(WeightsFile, write_read) {
+  std::vector<float> w0({0.1f, 0.2f, 0.3f});
+  std::vector<int8_t> w1({1, -2, 3, -4, 5});
+
+  WeightsFile file(64);
+  file.Add("w0", primitive_t::float32, w0.data(), w0.size() * sizeof(float));
+  file.Add("w1", primitive_t::int8, w1.data(), w1.size());
+  file.Plan();
+
+  // The index takes 8 + 8 + 2 * 26 bytes, the weights follow it at the aligned offsets.
+  EXPECT_EQ(file.offset("w0"), 128UL);
+  EXPECT_EQ(file.offset("w1"), 192UL);
+  EXPECT_EQ(file.file_size(), 256UL);
+
+  std::string path = "/tmp/cinn_weights_file_" + std::to_string(getpid());
+  file.Write(path);
+
+  auto read = WeightsFile::Read(path);
+  ASSERT_EQ(read.entries().size(), 2UL);
+  EXPECT_EQ(read.file_size(), 256UL);
+  EXPECT_EQ(read.entries()[0].name, "w0");
+  EXPECT_EQ(read.entry("w1").ptype, primitive_t::int8);
+  EXPECT_EQ(read.offset("w1"), 192UL);
+  auto& data = read.entry("w0").data;
+  ASSERT_EQ(data.size(), w0.size() * sizeof(float));
+  EXPECT_EQ(reinterpret_cast<const float*>(data.data())[2], 0.3f);
+  EXPECT_EQ(read.entry("w1").data, std::string(reinterpret_cast<char*>(w1.data()), w1.size()));
+
+  std::remove(path.c_str());
+}
+
+}  // namespace hlir
+}  // namespace cinn
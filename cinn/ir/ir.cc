@@ -2,6 +2,7 @@
 #include <glog/logging.h>
 #include <algorithm>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <set>
 #include <utility>
 #include "cinn/core/cinn_context.h"
@@ -360,6 +361,9 @@ Var::operator Expr() const {
 }
 
 bool Var::CheckNameValid(const std::string &name) {
+  // The Vars might be created in multiple threads compiling the functions.
+  static std::mutex mutex;
+  std::lock_guard<std::mutex> lock(mutex);
   if (!name_set_.count(name)) {
     name_set_.insert(name);
     return true;
@@ -739,6 +743,11 @@ std::ostream &operator<<(std::ostream &os, SIMDOpr::Opr opr) {
     __(Store);
     __(Load);
     __(ReduceAdd);
+    __(Fma);
+    __(Exp);
+    __(Tanh);
+    __(Sigmoid);
+    __(Gather);
     default:
       NOT_IMPLEMENT
 
@@ -764,6 +773,24 @@ Expr BufferOpr::make(Target target, Expr size, Opr operation, primitive_t type,
   return Expr(buffer);
 }
 
+Expr BufferOpr::make_in_arena(
+    const std::string &arena, Expr offset, Expr size, primitive_t type, const std::string &name) {
+  CHECK(!arena.empty());
+  CHECK(offset.valid());
+  Expr expr = make(Target(), size, Opr::kCreateInArena, type, name);
+  auto *buffer = expr.As<BufferOpr>();
+  buffer->arena = arena;
+  buffer->offset = offset;
+  return expr;
+}
+
+Expr BufferOpr::make_map_file(const std::string &path, Expr size, const std::string &name) {
+  CHECK(!path.empty());
+  Expr expr = make(Target(), size, Opr::kMapFile, primitive_t::uint8, name);
+  expr.As<BufferOpr>()->path = path;
+  return expr;
+}
+
 Expr Let::make(Expr a, Expr b) {
   auto node = std::make_shared<Let>();
   node->a = a;
@@ -798,6 +825,14 @@ Expr Exp::make(Expr a) {
   return Expr(node);
 }
 
+Expr Sqrt::make(Expr a) {
+  CHECK(!a.is_unk());
+  auto node = std::make_shared<Sqrt>();
+  node->a = a;
+  node->set_ptype(a.ptype());
+  return Expr(node);
+}
+
 Expr Tensor::make(const std::vector<Constant> &dims, primitive_t type, const std::string &name) {
   auto node = std::make_shared<Tensor>(name.empty() ? GlobalContext().name_generator().NewVarName() : name, type, dims);
   return Expr(node);
@@ -841,6 +876,8 @@ Expr SIMDOpr::make(int vector_width, SIMDOpr::Opr opr, Expr a, Expr b) {
       return make_store(vector_width, a, b);
     case Opr::kLoad:
       return make_load(vector_width, a);
+    case Opr::kGather:
+      return make_gather(vector_width, a, b);
     default:
       NOT_IMPLEMENT
   }
@@ -906,6 +943,54 @@ Expr SIMDOpr::make_reduce_add(int vector_width, Expr a) {
   return Expr(node);
 }
 
+Expr SIMDOpr::make_fma(int vector_width, Expr a, Expr b, Expr c) {
+  CHECK(vector_width == 4 || vector_width == 8);
+  CHECK(a.is_simd());
+  CHECK(b.is_simd());
+  CHECK(c.is_simd());
+  CHECK(a.ptype() == b.ptype());
+  CHECK(a.ptype() == c.ptype());
+
+  auto node = std::make_shared<SIMDOpr>();
+  node->opr = Opr::kFma;
+  node->a = a;
+  node->b = b;
+  node->c = c;
+  node->vector_width = vector_width;
+  node->set_ptype(a.ptype());
+  node->set_ctype(ToSimdType(vector_width));
+  return Expr(node);
+}
+
+Expr SIMDOpr::make_math(int vector_width, Opr opr, Expr a) {
+  CHECK(vector_width == 4 || vector_width == 8);
+  CHECK(a.is_simd());
+  CHECK(opr == Opr::kExp || opr == Opr::kTanh || opr == Opr::kSigmoid) << "not a math function: " << opr;
+
+  auto node = std::make_shared<SIMDOpr>();
+  node->opr = opr;
+  node->a = a;
+  node->vector_width = vector_width;
+  node->set_ptype(a.ptype());
+  node->set_ctype(ToSimdType(vector_width));
+  return Expr(node);
+}
+
+Expr SIMDOpr::make_gather(int vector_width, Expr a, Expr stride) {
+  CHECK(vector_width == 4 || vector_width == 8);
+  CHECK(a.is_primitive());
+  CHECK(stride.is_int_imm()) << "the stride of a gather should be a constant, get " << stride;
+
+  auto node = std::make_shared<SIMDOpr>();
+  node->opr = Opr::kGather;
+  node->a = a;
+  node->b = stride;
+  node->vector_width = vector_width;
+  node->set_ptype(a.ptype());
+  node->set_ctype(ToSimdType(vector_width));
+  return Expr(node);
+}
+
 Expr Cast::make(Expr expr, primitive_t type, composite_t ctype) {
   CHECK(CheckPTypeCastable(expr.ptype(), type));
   CHECK(!(expr.ptype() == type && expr.ctype() == ctype)) << "no necessary cast found";
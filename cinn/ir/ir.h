@@ -1,4 +1,5 @@
 #pragma once
+#include <memory>
 #include <set>
 #include <string>
 #include <utility>
@@ -394,6 +395,10 @@ struct BufferOpr : public ExprNode<BufferOpr> {
     kReference,
     //! Create and assign some data.
     kCreateAssign,
+    //! Create a buffer in a memory arena shared by multiple buffers.
+    kCreateInArena,
+    //! Map a file to a read-only buffer when the program is loaded, such as the file of the weights.
+    kMapFile,
   };
 
   //! Destination of this buffer.
@@ -406,13 +411,27 @@ struct BufferOpr : public ExprNode<BufferOpr> {
   std::string name;
   //! Hold the data if this opr is kAssign.
   Any assigned_data;
+  //! Name of the arena and offset in bytes if this opr is kCreateInArena.
+  std::string arena;
+  Expr offset;
+  //! Path of the file if this opr is kMapFile.
+  std::string path;
 
   static Expr make(Target target, Expr size, Opr operation, primitive_t type, const std::string& name = "");
 
+  //! Create a buffer located at `offset` bytes of the buffer `arena`.
+  static Expr make_in_arena(
+      const std::string& arena, Expr offset, Expr size, primitive_t type, const std::string& name = "");
+
+  //! Create a uint8 buffer mapped from the file `path` of `size` bytes, the other buffers can be placed in it.
+  static Expr make_map_file(const std::string& path, Expr size, const std::string& name = "");
+
   bool is_create() const { return operation == Opr::kCreate; }
   bool is_destroy() const { return operation == Opr::kDestroy; }
   bool is_reference() const { return operation == Opr::kReference; }
   bool is_create_assign() const { return operation == Opr::kCreateAssign; }
+  bool is_create_in_arena() const { return operation == Opr::kCreateInArena; }
+  bool is_map_file() const { return operation == Opr::kMapFile; }
 
   static const NodeTy node_type = NodeTy::BufferOpr;
 };
@@ -477,6 +496,10 @@ class Function : public ExprNode<Function> {
   std::string name_;
 
  public:
+  //! Hold the isl context the body is created in, declared first to be released after the body, see
+  //! isl_utils::IslContextScope. Empty if the body is created in the context of the thread.
+  std::shared_ptr<isl_ctx> ctx_holder;
+
   //! For inline function to expand the definition inplace.
   std::vector<ir::Expr> inputs;
 
@@ -599,6 +622,14 @@ struct Exp : public ExprNode<Exp> {
   static const NodeTy node_type = NodeTy::Exp;
 };
 
+struct Sqrt : public ExprNode<Sqrt> {
+  Expr a;
+
+  static Expr make(Expr a);
+
+  static const NodeTy node_type = NodeTy::Sqrt;
+};
+
 //-------------------- Logical expressions -------------------------
 struct EQ : public ExprNode<EQ> {
   Expr a, b;
@@ -816,19 +847,21 @@ class Tanh : public ir::ExprNode<Tanh> {
   static Expr make(const Expr& e) {
     auto node = std::make_shared<Tanh>();
     node->a = e;
+    node->set_ptype(e.ptype());
     return Expr(node);
   }
 
   static const NodeTy node_type = NodeTy::Tanh;
 };
 
-class Sigmoid : public ir::ExprNode<Tanh> {
+class Sigmoid : public ir::ExprNode<Sigmoid> {
  public:
   Expr a;
 
   static Expr make(const Expr& e) {
-    auto node = std::make_shared<Tanh>();
+    auto node = std::make_shared<Sigmoid>();
     node->a = e;
+    node->set_ptype(e.ptype());
     return Expr(node);
   }
 
@@ -894,17 +927,30 @@ struct SIMDOpr : public ir::ExprNode<SIMDOpr> {
     kMin,
     kReduceAdd,
     kReduceMul,
+    kFma,
+    kExp,
+    kTanh,
+    kSigmoid,
+    kGather,
   };
 
   int vector_width;
   Opr opr;
   Expr a, b;
+  //! The addend of kFma, which computes a * b + c, not valid for the other oprs.
+  Expr c;
 
   static Expr make(int vector_width, Opr opr, Expr a, Expr b);
   static Expr make_load(int vector_width, Expr a);
   // Store b to a(address).
   static Expr make_store(int vector_width, Expr a, Expr b);
   static Expr make_reduce_add(int vector_width, Expr a);
+  // Fused multiply-add, a * b + c.
+  static Expr make_fma(int vector_width, Expr a, Expr b, Expr c);
+  // Math functions with one argument, such as kExp.
+  static Expr make_math(int vector_width, Opr opr, Expr a);
+  // Load the elements a[0], a[stride], a[2 * stride] ... from a(address), stride is an integer constant.
+  static Expr make_gather(int vector_width, Expr a, Expr stride);
 
   static const NodeTy node_type = NodeTy::SIMDOpr;
 };
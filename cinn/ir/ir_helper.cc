@@ -1,6 +1,8 @@
 #include "cinn/ir/ir_helper.h"
 #include <ginac/ginac.h>
 #include <algorithm>
+#include <cstdlib>
+#include <map>
 #include <memory>
 #include <set>
 #include <string>
@@ -155,9 +157,13 @@ std::vector<const Var*> CollectVarsFromExpr(const Expr& expr) {
   }
 __(SIMDOpr);
 __(Reference);
+__(Tensor);
 __(Var);
 __(Block);
 __(Assign);
+__(Cast);
+__(Function);
+__(BufferOpr);
 #undef __
 
 struct IRCopy : public IRVisitorBase<void, ir::Expr*> {
@@ -204,6 +210,7 @@ struct IRCopy : public IRVisitorBase<void, ir::Expr*> {
   OP_2PARAM(DivAssign);
 
   OP_1PARAM(Exp);
+  OP_1PARAM(Sqrt);
   OP_1PARAM(Tanh);
   OP_1PARAM(Sigmoid);
 
@@ -301,6 +308,7 @@ struct IRCopy : public IRVisitorBase<void, ir::Expr*> {
     Visit(&op->body, &body);
 
     *to = Function::make(op->name(), inputs, outputs, body);
+    to->As<Function>()->ctx_holder = op->ctx_holder;
   }
   void Visit(const Statement* op, Expr* to) override { NOT_IMPLEMENT }
   void Visit(const Allocate* op, Expr* to) override {
@@ -318,7 +326,15 @@ struct IRCopy : public IRVisitorBase<void, ir::Expr*> {
     Expr size;
     Visit(&op->size, &size);
 
-    *to = BufferOpr::make(op->target, size, op->operation, op->ptype(), op->name);
+    if (op->is_create_in_arena()) {
+      *to = BufferOpr::make_in_arena(op->arena, op->offset, size, op->ptype(), op->name);
+    } else if (op->is_map_file()) {
+      *to = BufferOpr::make_map_file(op->path, size, op->name);
+    } else {
+      *to = BufferOpr::make(op->target, size, op->operation, op->ptype(), op->name);
+      // The data of the weights is never changed, share it.
+      to->As<BufferOpr>()->assigned_data = op->assigned_data;
+    }
   }
   void Visit(const Cast* op, Expr* to) override {
     Expr expr;
@@ -333,11 +349,26 @@ struct IRCopy : public IRVisitorBase<void, ir::Expr*> {
     *to = Array::make(size, op->ptype(), op->name);
   }
   void Visit(const SIMDOpr* op, Expr* to) override {
-    Expr a, b;
+    Expr a, b, c;
     Visit(&op->a, &a);
-    Visit(&op->b, &b);
     CHECK(a);
+    switch (op->opr) {
+      case SIMDOpr::Opr::kExp:
+      case SIMDOpr::Opr::kTanh:
+      case SIMDOpr::Opr::kSigmoid:
+        *to = SIMDOpr::make_math(op->vector_width, op->opr, a);
+        return;
+      default:
+        break;
+    }
+    Visit(&op->b, &b);
     CHECK(b);
+    if (op->opr == SIMDOpr::Opr::kFma) {
+      Visit(&op->c, &c);
+      CHECK(c);
+      *to = SIMDOpr::make_fma(op->vector_width, a, b, c);
+      return;
+    }
     *to = SIMDOpr::make(op->vector_width, op->opr, a, b);
   }
   void Visit(const Module* op, Expr* to) override {
@@ -399,6 +430,7 @@ struct IREqualTeller : public IRVisitorBase<bool, const ir::Expr*> {
   OP_2PARAM(DivAssign);
 
   OP_1PARAM(Exp);
+  OP_1PARAM(Sqrt);
   OP_1PARAM(Tanh);
   OP_1PARAM(Sigmoid);
 
@@ -496,6 +528,8 @@ struct IREqualTeller : public IRVisitorBase<bool, const ir::Expr*> {
     auto* b = expr->As<BufferOpr>();
     if (a->getptr() == b->getptr()) return true;
     if (a->name != b->name || a->operation != b->operation) return false;
+    if (a->is_create_in_arena() && (a->arena != b->arena || !Visit(&a->offset, &b->offset))) return false;
+    if (a->is_map_file() && a->path != b->path) return false;
     return Visit(&a->size, &b->size);
   }
 
@@ -558,7 +592,10 @@ struct IREqualTeller : public IRVisitorBase<bool, const ir::Expr*> {
     auto* b = expr->As<SIMDOpr>();
     if (a == b) return true;
     if (a->vector_width != b->vector_width || a->opr != b->opr) return false;
-    return Visit(&a->a, &b->a) && Visit(&a->b, &b->b);
+    if (a->b.valid() != b->b.valid() || a->c.valid() != b->c.valid()) return false;
+    if (a->b.valid() && !Visit(&a->b, &b->b)) return false;
+    if (a->c.valid() && !Visit(&a->c, &b->c)) return false;
+    return Visit(&a->a, &b->a);
   }
 
   bool Visit(const Module* a, const Expr* expr) override {
@@ -873,6 +910,80 @@ bool BasicExprIdentityVarScale(const Expr& expr, const Expr& var_expr) {
   return expr_ex.diff(converter1.CreateGinacSymbol(var_expr), 1) == GiNaC::ex(1);
 }
 
+bool BasicExprVarCoefficient(const Expr& expr, const Expr& var_expr, int* coefficient) {
+  CHECK(IsBasicExpr(expr));
+  CHECK(var_expr.is_var());
+
+  ExprToGinacConveter converter;
+  auto expr_ex = converter(expr);
+  converter(var_expr);
+  auto diff = expr_ex.diff(converter.CreateGinacSymbol(var_expr), 1);
+  if (!GiNaC::is_a<GiNaC::numeric>(diff)) return false;
+  const auto& value = GiNaC::ex_to<GiNaC::numeric>(diff);
+  if (!value.is_integer()) return false;
+  *coefficient = value.to_int();
+  return true;
+}
+
+namespace {
+
+int64_t Gcd(int64_t a, int64_t b) {
+  a = std::abs(a);
+  b = std::abs(b);
+  while (b) {
+    int64_t t = a % b;
+    a = b;
+    b = t;
+  }
+  return a;
+}
+
+}  // namespace
+
+int64_t ExprKnownDivisor(const Expr& expr, const std::map<std::string, int64_t>& var_divisors) {
+  switch (expr.type()) {
+    case NodeTy::IntImm:
+      return std::abs(expr.As<IntImm>()->val());
+    case NodeTy::Constant: {
+      auto* constant = expr.As<Constant>();
+      if (constant->value_set() && constant->is_integer()) return std::abs(constant->int_val());
+      return 1;
+    }
+    case NodeTy::Var: {
+      auto it = var_divisors.find(expr.As<Var>()->name());
+      return it == var_divisors.end() ? 1 : it->second;
+    }
+    case NodeTy::Add:
+      return Gcd(ExprKnownDivisor(expr.As<Add>()->a, var_divisors), ExprKnownDivisor(expr.As<Add>()->b, var_divisors));
+    case NodeTy::Sub:
+      return Gcd(ExprKnownDivisor(expr.As<Sub>()->a, var_divisors), ExprKnownDivisor(expr.As<Sub>()->b, var_divisors));
+    case NodeTy::Mul:
+      return ExprKnownDivisor(expr.As<Mul>()->a, var_divisors) * ExprKnownDivisor(expr.As<Mul>()->b, var_divisors);
+    default:
+      return 1;
+  }
+}
+
+int64_t ReferenceOffsetDivisor(const Expr& expr, const std::map<std::string, int64_t>& var_divisors) {
+  auto* reference = expr.As<Reference>();
+  CHECK(reference);
+  if (reference->iterators.size() == 1UL) return ExprKnownDivisor(reference->iterators.front(), var_divisors);
+  if (!reference->target.is_tensor()) return 1;
+  auto& dims = reference->target.As<Tensor>()->dims();
+  if (dims.size() != reference->iterators.size()) return 1;
+
+  int64_t result = 0;
+  int64_t dim_stride = 1;
+  for (int i = reference->iterators.size() - 1; i >= 0; i--) {
+    result = Gcd(result, ExprKnownDivisor(reference->iterators[i], var_divisors) * dim_stride);
+    if (i > 0) {
+      if (!dims[i].value_set() || !dims[i].is_integer()) return 1;
+      dim_stride *= dims[i].int_val();
+    }
+  }
+  return result;
+}
+
 std::string ExprToGinacConveter::Repr(const Expr& expr) {
   CHECK(expr.is_reference() || expr.is_var());
   std::string repr = GetStreamStr(expr);
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <ginac/ginac.h>
+#include <map>
+#include <string>
 #include <vector>
 #include "cinn/ir/ir.h"
 #include "cinn/ir/ops_overload.h"
@@ -16,7 +18,7 @@ std::vector<const Var*> CollectVarsFromExpr(const Expr& expr);
 template <typename T>
 std::vector<Expr> CollectExprNode(const Expr& expr);
 
-static Expr tanh(Expr x) { return Max::make(Expr(0.f), x); }
+static Expr tanh(Expr x) { return Tanh::make(x); }
 static Expr exp(Expr x) { return Exp::make(x); }
 
 /**
@@ -110,8 +112,29 @@ bool IsBasicExpr(ir::Expr expr);
  */
 bool BasicExprIdentityVarScale(const Expr& expr, const Expr& var_expr);
 
+/**
+ * Get the coefficient of a variable in a basic expression, e.g. the coefficient of `c` in `a * b + c * 2` is 2.
+ * @return false if the coefficient is not an integer constant.
+ */
+bool BasicExprVarCoefficient(const Expr& expr, const Expr& var_expr, int* coefficient);
+
 bool ReferenceIsAddress(const Expr& expr);
 
+/**
+ * Get the largest known integer that an integer expression is always a multiple of, e.g. `i * 8 + 16` is a multiple of
+ * 8 if `i` is an integer.
+ * @param expr the integer expression.
+ * @param var_divisors the known divisors of the variables, such as the iterators of loops with a step larger than 1.
+ * @return the divisor, 0 if the expression is the constant 0.
+ */
+int64_t ExprKnownDivisor(const Expr& expr, const std::map<std::string, int64_t>& var_divisors = {});
+
+/**
+ * Get the largest known integer that the offset of a reference in the row-major layout is always a multiple of.
+ * @see ExprKnownDivisor
+ */
+int64_t ReferenceOffsetDivisor(const Expr& expr, const std::map<std::string, int64_t>& var_divisors = {});
+
 /**
  * Expand expressions contains SumAssign ..., DivAssign to Sum + Assign.
  */
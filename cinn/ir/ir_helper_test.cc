@@ -147,6 +147,39 @@ TEST(BasicExprIdentityVarScale, test) {
   }
 }
 
+TEST(BasicExprVarCoefficient, test) {
+  SetGlobalContext(new CINNContext);
+
+  ir::Expr a("a", primitive_t::int32);
+  ir::Expr b("b", primitive_t::int32);
+  ir::Expr c("c", primitive_t::int32);
+
+  int coefficient;
+  ASSERT_TRUE(BasicExprVarCoefficient(a * b + c * 2 + Expr(1), c, &coefficient));
+  ASSERT_EQ(coefficient, 2);
+  ASSERT_TRUE(BasicExprVarCoefficient(a * b + Expr(1), c, &coefficient));
+  ASSERT_EQ(coefficient, 0);
+  ASSERT_FALSE(BasicExprVarCoefficient(a * b + c * a, c, &coefficient));
+}
+
+TEST(ExprKnownDivisor, test) {
+  SetGlobalContext(new CINNContext);
+
+  ir::Expr i("i", primitive_t::int32);
+  ir::Expr j("j", primitive_t::int32);
+
+  EXPECT_EQ(ExprKnownDivisor(i * 32 + j), 1);
+  EXPECT_EQ(ExprKnownDivisor(i * 32 + j, {{"j", 8}}), 8);
+  EXPECT_EQ(ExprKnownDivisor(i * 32 + j * 2 + Expr(12), {{"j", 8}}), 4);
+  EXPECT_EQ(ExprKnownDivisor((i - Expr(1)) * 16), 16);
+  EXPECT_EQ(ExprKnownDivisor(Expr(0)), 0);
+
+  Expr A(std::vector<Constant>({Constant(10), Constant(24)}), primitive_t::float32, "A");
+  EXPECT_EQ(ReferenceOffsetDivisor(A[i][j * 8]), 8);
+  EXPECT_EQ(ReferenceOffsetDivisor(A[i][j], {{"j", 4}}), 4);
+  EXPECT_EQ(ReferenceOffsetDivisor(A[i][Expr(0)]), 24);
+}
+
 TEST(ExpandAssignOpr, test) {
   ir::Expr a("a", primitive_t::int32);
   ir::Expr b("b", primitive_t::int32);
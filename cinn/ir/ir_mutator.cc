@@ -126,6 +126,23 @@ void IRMutator::Visit(const ir::Add* op, ir::Expr* expr) {
   Visit(&node->b, &node->b);
 }
 
+void IRMutator::Visit(const ir::SIMDOpr* op, ir::Expr* expr) {
+  CHECK(op->a.valid());
+  auto* node = expr->As<ir::SIMDOpr>();
+
+  LazyUpdateExpr(&node->a, VisitBasicExpr(&node->a));
+  Visit(&node->a, &node->a);
+  // The load and reduce operations have only one argument, the FMA has three.
+  if (node->b.valid()) {
+    LazyUpdateExpr(&node->b, VisitBasicExpr(&node->b));
+    Visit(&node->b, &node->b);
+  }
+  if (node->c.valid()) {
+    LazyUpdateExpr(&node->c, VisitBasicExpr(&node->c));
+    Visit(&node->c, &node->c);
+  }
+}
+
 void IRMutator::Visit(const Module* op, Expr* expr) {
   auto* node = expr->As<ir::Module>();
 
@@ -76,9 +76,10 @@ class IRMutator : public IRVisitorBase<void, ir::Expr*> {
 
   void Visit(const ir::Let* op, ir::Expr* expr) override;
   void Visit(const ir::Add* op, ir::Expr* expr) override;
-  OP_2PARAM(SIMDOpr);
+  void Visit(const ir::SIMDOpr* op, ir::Expr* expr) override;
 
   OP_1PARAM(Exp);
+  OP_1PARAM(Sqrt);
   OP_1PARAM(Tanh);
   OP_1PARAM(Sigmoid);
 
@@ -78,6 +78,24 @@ void IRPrinter::Visit(const Exp *op) {
   os_ << ")";
 }
 
+void IRPrinter::Visit(const Sqrt *op) {
+  os_ << "sqrt(";
+  Print(op->a);
+  os_ << ")";
+}
+
+void IRPrinter::Visit(const Tanh *op) {
+  os_ << "tanh(";
+  Print(op->a);
+  os_ << ")";
+}
+
+void IRPrinter::Visit(const Sigmoid *op) {
+  os_ << "sigmoid(";
+  Print(op->a);
+  os_ << ")";
+}
+
 void IRPrinter::Visit(const Min *op) {
   os_ << "min(";
   Print(op->a);
@@ -431,6 +449,16 @@ void IRPrinter::Visit(const BufferOpr *op) {
     case BufferOpr::Opr::kCreateAssign:
       os_ << StringFormat("create_assign_buffer(%s)", op->name.c_str());
       break;
+    case BufferOpr::Opr::kCreateInArena:
+      os_ << StringFormat("%s = create_buffer_in_arena(%s, ", op->name.c_str(), op->arena.c_str());
+      Print(op->offset);
+      os_ << ")";
+      break;
+    case BufferOpr::Opr::kMapFile:
+      os_ << StringFormat("%s = map_file(\"%s\", ", op->name.c_str(), op->path.c_str());
+      Print(op->size);
+      os_ << ")";
+      break;
   }
 }
 
@@ -467,10 +495,32 @@ void IRPrinter::Visit(const SIMDOpr *op) {
     case ir::SIMDOpr::Opr::kStore:
       os_ << "simd_store" << op->vector_width << "(";
       break;
+    case ir::SIMDOpr::Opr::kFma:
+      os_ << "simd_fma_" << op->vector_width << "(";
+      break;
+    case ir::SIMDOpr::Opr::kExp:
+      os_ << "simd_exp_" << op->vector_width << "(";
+      break;
+    case ir::SIMDOpr::Opr::kTanh:
+      os_ << "simd_tanh_" << op->vector_width << "(";
+      break;
+    case ir::SIMDOpr::Opr::kSigmoid:
+      os_ << "simd_sigmoid_" << op->vector_width << "(";
+      break;
+    case ir::SIMDOpr::Opr::kGather:
+      os_ << "simd_gather_" << op->vector_width << "(";
+      break;
   }
 
-  if (op->opr == ir::SIMDOpr::Opr::kLoad) {
+  if (!op->b.valid()) {
+    Print(op->a);
+    os_ << ")";
+  } else if (op->opr == ir::SIMDOpr::Opr::kFma) {
     Print(op->a);
+    os_ << ", ";
+    Print(op->b);
+    os_ << ", ";
+    Print(op->c);
     os_ << ")";
   } else {
     Print(op->a);
@@ -49,6 +49,7 @@ class IRPrinter : public IRVisitor {
   void Visit(const Mod *op) override;
   void Visit(const Minus *op) override;
   void Visit(const Exp *op) override;
+  void Visit(const Sqrt *op) override;
   void Visit(const Min *op) override;
   void Visit(const Max *op) override;
   void Visit(const NE *op) override;
@@ -77,8 +78,8 @@ class IRPrinter : public IRVisitor {
   void Visit(const ir::Function *op) override;
   void Visit(const Allocate *op) override;
 
-  void Visit(const Tanh *op) override { NOT_IMPLEMENT; }
-  void Visit(const Sigmoid *op) override { NOT_IMPLEMENT; }
+  void Visit(const Tanh *op) override;
+  void Visit(const Sigmoid *op) override;
   void Visit(const SumAssign *op) override;
   void Visit(const SubAssign *op) override;
   void Visit(const MulAssign *op) override;
@@ -75,6 +75,10 @@ void IRVisitor::Visit(const Exp *op) {
   CHECK(op->a.valid());
   Visit(&op->a);
 }
+void IRVisitor::Visit(const Sqrt *op) {
+  CHECK(op->a.valid());
+  Visit(&op->a);
+}
 void IRVisitor::Visit(const Reference *op) {
   Visit(&op->target);
   for (auto &iter : op->iterators) {
@@ -89,7 +93,8 @@ void IRVisitor::Visit(const Cast *op) {}
 void IRVisitor::Visit(const Array *op) {}
 void IRVisitor::Visit(const SIMDOpr *op) {
   Visit(&op->a);
-  Visit(&op->b);
+  if (op->b.valid()) Visit(&op->b);
+  if (op->c.valid()) Visit(&op->c);
 }
 
 void IRVisitor::Visit(const Not *op) { Visit(&op->a); }
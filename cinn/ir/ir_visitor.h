@@ -53,6 +53,7 @@ struct IRVisitorBase {
       __(Not);
 
       __(Exp);
+      __(Sqrt);
       __(Assign);
       __(SumAssign);
       __(SubAssign);
@@ -99,6 +100,7 @@ struct IRVisitorBase {
 
   virtual RetTy Visit(const Minus* op, Args... args) = 0;
   virtual RetTy Visit(const Exp* op, Args... args) = 0;
+  virtual RetTy Visit(const Sqrt* op, Args... args) = 0;
 
   virtual RetTy Visit(const Min* op, Args... args) = 0;
   virtual RetTy Visit(const Max* op, Args... args) = 0;
@@ -164,6 +166,7 @@ class IRVisitor : public IRVisitorBase<void> {
 
   virtual void Visit(const Minus* op);
   virtual void Visit(const Exp* op);
+  virtual void Visit(const Sqrt* op);
 
   virtual void Visit(const Min* op);
   virtual void Visit(const Max* op);
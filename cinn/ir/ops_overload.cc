@@ -3,11 +3,12 @@
 namespace cinn {
 namespace ir {
 
-ir::Expr Tanh_(const ir::Expr &e) { return ir::Max_(e, Expr(0.f)); }
+ir::Expr Tanh_(const ir::Expr &e) { return ir::Tanh::make(e); }
 ir::Expr Sigmoid_(const ir::Expr &e) { return ir::Sigmoid::make(e); }
 ir::Expr Max_(const ir::Expr &a, const ir::Expr &b) { return ir::Max::make(a, b); }
 ir::Expr Min_(const ir::Expr &a, const ir::Expr &b) { return ir::Min::make(a, b); }
 ir::Expr Exp_(const ir::Expr &a) { return ir::Exp::make(a); }
+ir::Expr Sqrt_(const ir::Expr &a) { return ir::Sqrt::make(a); }
 
 }  // namespace ir
 }  // namespace cinn
@@ -66,6 +66,7 @@ inline Expr operator||(Expr a, T b) {
 
 ir::Expr Tanh_(const ir::Expr &e);
 ir::Expr Exp_(const ir::Expr &e);
+ir::Expr Sqrt_(const ir::Expr &e);
 ir::Expr Sigmoid_(const ir::Expr &e);
 ir::Expr Max_(const ir::Expr &a, const ir::Expr &b);
 ir::Expr Min_(const ir::Expr &a, const ir::Expr &b);
@@ -1,3 +1,115 @@
 #include "cinn/target.h"
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+#include <string>
+#include <utility>
+#include <vector>
 
-namespace cinn {}  // namespace cinn
+namespace cinn {
+
+namespace {
+
+const std::vector<std::pair<Target::Feature, const char *>> &FeatureNames() {
+  static std::vector<std::pair<Target::Feature, const char *>> names({
+      {Target::Feature::kSSE42, "sse4.2"},
+      {Target::Feature::kAVX, "avx"},
+      {Target::Feature::kAVX2, "avx2"},
+      {Target::Feature::kFMA, "fma"},
+      {Target::Feature::kF16C, "f16c"},
+      {Target::Feature::kAVX512F, "avx512f"},
+      {Target::Feature::kAVX512BW, "avx512bw"},
+      {Target::Feature::kAVX512VL, "avx512vl"},
+      {Target::Feature::kAVX512DQ, "avx512dq"},
+      {Target::Feature::kAVX512VNNI, "avx512vnni"},
+  });
+  return names;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+//! Read the extended control register 0, which tells the register states enabled by the OS.
+uint64_t ReadXCR0() {
+  uint32_t eax, edx;
+  __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+  return (static_cast<uint64_t>(edx) << 32) | eax;
+}
+#endif
+
+}  // namespace
+
+Target Target::Host() {
+  Target target(OS::Linux, Arch::X86, sizeof(void *) == 8 ? Bits::k64 : Bits::k32);
+#if defined(__x86_64__) || defined(__i386__)
+  unsigned int eax, ebx, ecx, edx;
+  if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) return target;
+  target.set_feature(Feature::kSSE42, ecx & bit_SSE4_2);
+
+  // The XMM and YMM states (bits 1 and 2) should be enabled to use AVX, and also the opmask and ZMM states (bits 5 to
+  // 7) to use AVX-512.
+  bool os_avx = (ecx & bit_OSXSAVE) && (ReadXCR0() & 0x6) == 0x6;
+  bool os_avx512 = os_avx && (ReadXCR0() & 0xe0) == 0xe0;
+  target.set_feature(Feature::kAVX, os_avx && (ecx & bit_AVX));
+  target.set_feature(Feature::kFMA, os_avx && (ecx & bit_FMA));
+  target.set_feature(Feature::kF16C, os_avx && (ecx & bit_F16C));
+
+  if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+    target.set_feature(Feature::kAVX2, os_avx && (ebx & bit_AVX2));
+    target.set_feature(Feature::kAVX512F, os_avx512 && (ebx & bit_AVX512F));
+    target.set_feature(Feature::kAVX512BW, os_avx512 && (ebx & bit_AVX512BW));
+    target.set_feature(Feature::kAVX512VL, os_avx512 && (ebx & bit_AVX512VL));
+    target.set_feature(Feature::kAVX512DQ, os_avx512 && (ebx & bit_AVX512DQ));
+    target.set_feature(Feature::kAVX512VNNI, os_avx512 && (ecx & bit_AVX512VNNI));
+  }
+#else
+  target = Target(OS::Linux, Arch::ARM, sizeof(void *) == 8 ? Bits::k64 : Bits::k32);
+#endif
+  return target;
+}
+
+std::string Target::HostCPUName() {
+  std::string name;
+#if defined(__x86_64__) || defined(__i386__)
+  if (__get_cpuid_max(0x80000000, nullptr) >= 0x80000004) {
+    unsigned int regs[12];
+    for (unsigned int i = 0; i < 3; i++) {
+      __get_cpuid(0x80000002 + i, &regs[4 * i], &regs[4 * i + 1], &regs[4 * i + 2], &regs[4 * i + 3]);
+    }
+    name.assign(reinterpret_cast<const char *>(regs), sizeof(regs));
+    name = name.substr(0, name.find('\0'));
+    // The brand string is padded with spaces.
+    auto begin = name.find_first_not_of(' ');
+    auto end = name.find_last_not_of(' ');
+    name = begin == std::string::npos ? "" : name.substr(begin, end - begin + 1);
+  }
+
+  unsigned int eax, ebx, ecx, edx;
+  if (__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+    // The extended family and model are added to the base ones, see the cpuid reference of Intel.
+    unsigned int family = (eax >> 8) & 0xf;
+    unsigned int model = (eax >> 4) & 0xf;
+    if (family == 0xf) family += (eax >> 20) & 0xff;
+    if (family == 0x6 || family >= 0xf) model += ((eax >> 16) & 0xf) << 4;
+    if (!name.empty()) name += " ";
+    name += "family " + std::to_string(family) + " model " + std::to_string(model);
+  }
+#endif
+  return name;
+}
+
+int Target::vector_width() const {
+  if (has(Feature::kAVX)) return 8;
+  if (has(Feature::kSSE42)) return 4;
+  return 1;
+}
+
+std::string Target::features_str() const {
+  std::string result;
+  for (auto &item : FeatureNames()) {
+    if (!has(item.first)) continue;
+    if (!result.empty()) result += ",";
+    result += item.second;
+  }
+  return result;
+}
+
+}  // namespace cinn
@@ -1,4 +1,6 @@
 #pragma once
+#include <cstdint>
+#include <string>
 
 namespace cinn {
 
@@ -17,17 +19,65 @@ struct Target {
     k64 = 64,
   };
 
+  //! The x86 instruction set extensions the generated code might use.
+  enum class Feature : uint32_t {
+    kSSE42 = 1 << 0,
+    kAVX = 1 << 1,
+    kAVX2 = 1 << 2,
+    kFMA = 1 << 3,
+    kF16C = 1 << 4,
+    kAVX512F = 1 << 5,
+    kAVX512BW = 1 << 6,
+    kAVX512VL = 1 << 7,
+    kAVX512DQ = 1 << 8,
+    kAVX512VNNI = 1 << 9,
+  };
+
  private:
   OS os_;
   Arch arch_;
   Bits bits_;
+  uint32_t features_;
 
  public:
-  Target(OS os = OS::UNK, Arch arch = Arch::X86, Bits bits = Bits::k64) : os_(os), arch_(arch), bits_(bits) {}
+  Target(OS os = OS::UNK, Arch arch = Arch::X86, Bits bits = Bits::k64, uint32_t features = 0)
+      : os_(os), arch_(arch), bits_(bits), features_(features) {}
+
+  /**
+   * Get the target of the host, with the features detected by cpuid. A feature is reported only if the OS saves the
+   * registers it uses, for example the AVX-512 features require the OS to enable the ZMM state.
+   */
+  static Target Host();
+
+  /**
+   * Get the name of the host CPU, the brand string and the family and model reported by cpuid, such as
+   * "Intel(R) Xeon(R) Gold 6148 CPU @ 2.40GHz family 6 model 85". The model selects the tuning of -march=native, the
+   * brand string alone is too generic on some virtual machines. Empty if unknown.
+   */
+  static std::string HostCPUName();
 
   OS os() const { return os_; }
   Arch arch() const { return arch_; }
   Bits bits() const { return bits_; }
+
+  bool has(Feature feature) const { return features_ & static_cast<uint32_t>(feature); }
+  void set_feature(Feature feature, bool enabled = true) {
+    if (enabled) {
+      features_ |= static_cast<uint32_t>(feature);
+    } else {
+      features_ &= ~static_cast<uint32_t>(feature);
+    }
+  }
+  uint32_t features() const { return features_; }
+
+  /**
+   * The number of float32 lanes to vectorize by, 8 for AVX, 4 for SSE, 1 otherwise. The IR supports the SIMD data up to
+   * 256 bits, so the AVX-512 targets vectorize by 8 too, and leave the wider instructions to the backend compiler.
+   */
+  int vector_width() const;
+
+  //! The features in the syntax of the GCC target options, such as "sse4.2,avx,avx2,fma".
+  std::string features_str() const;
 };
 
 }  // namespace cinn
@@ -0,0 +1,40 @@
+#include "cinn/target.h"
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+namespace cinn {
+
+TEST(Target, Host) {
+  Target host = Target::Host();
+  LOG(INFO) << "host " << Target::HostCPUName() << ", features: " << host.features_str();
+#ifdef __AVX__
+  // The tests are compiled with AVX, they run on a CPU supports it.
+  EXPECT_TRUE(host.has(Target::Feature::kAVX));
+  EXPECT_EQ(host.vector_width(), 8);
+#endif
+}
+
+TEST(Target, vector_width) {
+  using F = Target::Feature;
+  Target target(Target::OS::Linux, Target::Arch::X86, Target::Bits::k64);
+  EXPECT_EQ(target.vector_width(), 1);
+  target.set_feature(F::kSSE42);
+  EXPECT_EQ(target.vector_width(), 4);
+  target.set_feature(F::kAVX);
+  EXPECT_EQ(target.vector_width(), 8);
+  // The IR supports the SIMD data up to 256 bits.
+  target.set_feature(F::kAVX512F);
+  EXPECT_EQ(target.vector_width(), 8);
+}
+
+TEST(Target, features_str) {
+  Target target(Target::OS::Linux, Target::Arch::X86, Target::Bits::k64);
+  EXPECT_EQ(target.features_str(), "");
+  target.set_feature(Target::Feature::kAVX2);
+  target.set_feature(Target::Feature::kSSE42);
+  EXPECT_EQ(target.features_str(), "sse4.2,avx2");
+  target.set_feature(Target::Feature::kSSE42, false);
+  EXPECT_EQ(target.features_str(), "avx2");
+}
+
+}  // namespace cinn
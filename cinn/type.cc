@@ -10,6 +10,8 @@ int primitive_bytes(primitive_t type) {
       return 1;
     case primitive_t::int16:
     case primitive_t::uint16:
+    case primitive_t::float16:
+    case primitive_t::bfloat16:
       return 2;
     case primitive_t::int32:
     case primitive_t::uint32:
@@ -43,6 +45,8 @@ std::ostream &operator<<(std::ostream &os, primitive_t t) {
     __(int64);
     __(float32);
     __(float64);
+    __(float16);
+    __(bfloat16);
     __(boolean);
 #undef __
     default:
@@ -30,6 +30,8 @@ enum class primitive_t : int {
   int64,
   float32,
   float64,
+  float16,   // IEEE half precision, stored in 16 bits
+  bfloat16,  // the upper 16 bits of a float32
   boolean,
   void_,  // control statement without primitive return, such as function, for, if, allocate and so on.
 };
@@ -82,6 +84,8 @@ static bool is_integer(primitive_t ptype) {
          ptype == primitive_t::int64;
 }
 static bool is_float(primitive_t ptype) { return ptype == primitive_t::float32 || ptype == primitive_t::float64; }
+//! The 16-bit floats are only used for storage, they are widened to float32 in the computation.
+static bool is_half_float(primitive_t ptype) { return ptype == primitive_t::float16 || ptype == primitive_t::bfloat16; }
 
 std::ostream& operator<<(std::ostream& os, primitive_t t);
 std::ostream& operator<<(std::ostream& os, composite_t t);
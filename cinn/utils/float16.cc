@@ -0,0 +1,67 @@
+#include "cinn/utils/float16.h"
+#include <cstring>
+
+namespace cinn {
+
+namespace {
+
+uint32_t FloatBits(float x) {
+  uint32_t bits;
+  std::memcpy(&bits, &x, sizeof(bits));
+  return bits;
+}
+
+float BitsToFloat(uint32_t bits) {
+  float x;
+  std::memcpy(&x, &bits, sizeof(x));
+  return x;
+}
+
+}  // namespace
+
+uint16_t Float32ToFloat16(float x) {
+  uint32_t bits = FloatBits(x);
+  uint16_t sign = (bits >> 16) & 0x8000;
+  uint32_t abs_bits = bits & 0x7fffffff;
+
+  if (abs_bits >= 0x7f800000) {  // inf or nan
+    return sign | 0x7c00 | (abs_bits > 0x7f800000 ? 0x200 : 0);
+  }
+  if (abs_bits >= 0x477ff000) {  // rounds to a value out of the range of float16
+    return sign | 0x7c00;
+  }
+  if (abs_bits < 0x38800000) {  // subnormal in float16
+    // Shift the value so that the subnormal bits are rounded by the float addition.
+    float shifted = BitsToFloat(abs_bits) + 0.5f;
+    return sign | static_cast<uint16_t>(FloatBits(shifted) - FloatBits(0.5f));
+  }
+
+  uint32_t mantissa_odd = (abs_bits >> 13) & 1;
+  abs_bits += 0xc8000fff + mantissa_odd;  // rebias the exponent and round to the nearest even
+  return sign | static_cast<uint16_t>(abs_bits >> 13);
+}
+
+float Float16ToFloat32(uint16_t x) {
+  uint32_t sign = static_cast<uint32_t>(x & 0x8000) << 16;
+  uint32_t exponent = (x >> 10) & 0x1f;
+  uint32_t mantissa = x & 0x3ff;
+
+  if (exponent == 0x1f) return BitsToFloat(sign | 0x7f800000 | (mantissa << 13));
+  if (exponent == 0) {
+    // zero or subnormal, the value is mantissa * 2^-24
+    float value = static_cast<float>(mantissa) * BitsToFloat(0x33800000);
+    return BitsToFloat(sign | FloatBits(value));
+  }
+  return BitsToFloat(sign | ((exponent + 112) << 23) | (mantissa << 13));
+}
+
+uint16_t Float32ToBFloat16(float x) {
+  uint32_t bits = FloatBits(x);
+  if ((bits & 0x7fffffff) > 0x7f800000) return static_cast<uint16_t>((bits >> 16) | 0x40);  // keep nan quiet
+  bits += 0x7fff + ((bits >> 16) & 1);
+  return static_cast<uint16_t>(bits >> 16);
+}
+
+float BFloat16ToFloat32(uint16_t x) { return BitsToFloat(static_cast<uint32_t>(x) << 16); }
+
+}  // namespace cinn
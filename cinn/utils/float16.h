@@ -0,0 +1,19 @@
+#pragma once
+#include <cstdint>
+
+namespace cinn {
+
+/**
+ * Conversions between float32 and the 16-bit floats, used to store the weights in half precision at build time.
+ *
+ * - float16 is the IEEE 754 half precision, the conversion rounds to the nearest even, overflows to infinity and keeps
+ *   the subnormals.
+ * - bfloat16 is the upper 16 bits of a float32, the conversion rounds to the nearest even.
+ */
+uint16_t Float32ToFloat16(float x);
+float Float16ToFloat32(uint16_t x);
+
+uint16_t Float32ToBFloat16(float x);
+float BFloat16ToFloat32(uint16_t x);
+
+}  // namespace cinn
@@ -0,0 +1,46 @@
+#include "cinn/utils/float16.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <limits>
+
+namespace cinn {
+
+TEST(float16, convert) {
+  EXPECT_EQ(Float32ToFloat16(0.f), 0x0000);
+  EXPECT_EQ(Float32ToFloat16(-0.f), 0x8000);
+  EXPECT_EQ(Float32ToFloat16(1.f), 0x3c00);
+  EXPECT_EQ(Float32ToFloat16(-2.f), 0xc000);
+  EXPECT_EQ(Float32ToFloat16(65504.f), 0x7bff);
+  EXPECT_EQ(Float32ToFloat16(1e6f), 0x7c00);
+  EXPECT_EQ(Float32ToFloat16(std::numeric_limits<float>::infinity()), 0x7c00);
+  // the smallest subnormal
+  EXPECT_EQ(Float32ToFloat16(std::pow(2.f, -24)), 0x0001);
+  // 1 + 2^-11 is a tie between 1 and 1 + 2^-10, rounds to the even one
+  EXPECT_EQ(Float32ToFloat16(1.f + std::pow(2.f, -11)), 0x3c00);
+  EXPECT_EQ(Float32ToFloat16(1.f + 3 * std::pow(2.f, -11)), 0x3c02);
+  EXPECT_TRUE(std::isnan(Float16ToFloat32(Float32ToFloat16(std::nanf("")))));
+
+  for (float x : {0.1f, -3.14159f, 1000.5f, 6e-5f, 1e-7f}) {
+    EXPECT_NEAR(Float16ToFloat32(Float32ToFloat16(x)), x, std::abs(x) * 1e-3 + 6e-8);
+  }
+  // every float16 value survives the round trip
+  for (uint32_t bits = 0; bits < 0x7c00; bits++) {
+    ASSERT_EQ(Float32ToFloat16(Float16ToFloat32(bits)), bits);
+  }
+}
+
+TEST(bfloat16, convert) {
+  EXPECT_EQ(Float32ToBFloat16(1.f), 0x3f80);
+  EXPECT_EQ(Float32ToBFloat16(-2.f), 0xc000);
+  EXPECT_EQ(BFloat16ToFloat32(0x3f80), 1.f);
+  // 1 + 2^-8 is a tie, rounds to the even one
+  EXPECT_EQ(Float32ToBFloat16(1.f + std::pow(2.f, -8)), 0x3f80);
+  EXPECT_EQ(Float32ToBFloat16(1.f + 3 * std::pow(2.f, -8)), 0x3f82);
+  EXPECT_TRUE(std::isnan(BFloat16ToFloat32(Float32ToBFloat16(std::nanf("")))));
+
+  for (float x : {0.1f, -3.14159f, 1000.5f, 1e-30f, 1e30f}) {
+    EXPECT_NEAR(BFloat16ToFloat32(Float32ToBFloat16(x)), x, std::abs(x) * 4e-3);
+  }
+}
+
+}  // namespace cinn
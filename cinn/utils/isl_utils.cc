@@ -1,6 +1,7 @@
 #include "cinn/utils/isl_utils.h"
 #include <glog/logging.h>
 #include <isl/space.h>
+#include <mutex>  // NOLINT
 #include <string>
 #include <vector>
 #include "cinn/utils/string.h"
@@ -56,6 +57,43 @@ isl_map *isl_map_set_dim_names(isl_map *map, isl_dim_type type, const std::vecto
 
 namespace isl_utils {
 
+namespace {
+
+// The context of the innermost IslContextScope of the current thread.
+thread_local isl_ctx *scoped_ctx{};
+
+std::mutex pool_mutex;
+// The contexts not used by any scope.
+std::vector<isl_ctx *> pool;
+
+}  // namespace
+
+isl_ctx *global_isl_ctx() {
+  if (scoped_ctx) return scoped_ctx;
+  thread_local isl_ctx *x = isl_ctx_alloc();
+  return x;
+}
+
+IslContextScope::IslContextScope() {
+  isl_ctx *ctx{};
+  {
+    std::lock_guard<std::mutex> lock(pool_mutex);
+    if (!pool.empty()) {
+      ctx = pool.back();
+      pool.pop_back();
+    }
+  }
+  if (!ctx) ctx = isl_ctx_alloc();
+  ctx_ = std::shared_ptr<isl_ctx>(ctx, [](isl_ctx *ctx) {
+    std::lock_guard<std::mutex> lock(pool_mutex);
+    pool.push_back(ctx);
+  });
+  parent_ = scoped_ctx;
+  scoped_ctx = ctx;
+}
+
+IslContextScope::~IslContextScope() { scoped_ctx = parent_; }
+
 __isl_give
 
     bool
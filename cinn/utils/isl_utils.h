@@ -193,10 +193,31 @@ class union_map : public isl::union_map {
   void union_inplace(isl::union_map &&m) { ptr = isl_union_map_union(ptr, m.release()); }
 };
 
-static isl_ctx *global_isl_ctx() {
-  thread_local isl_ctx *x = isl_ctx_alloc();
-  return x;
-}
+//! Get the isl context of the current thread, the one of the IslContextScope of the thread if any.
+isl_ctx *global_isl_ctx();
+
+/**
+ * IslContextScope makes the current thread use an isl context of a process-wide pool in a scope, such as a worker
+ * thread that compiles a function.
+ *
+ * The contexts are never freed. A context is taken back to the pool and reused by the next scope when the scope ends
+ * and the holders of the context, see holder(), are all released, so a context is never shared by two threads while
+ * the isl objects created in it are alive. The number of the contexts is bounded by the max number of the scopes alive
+ * at the same time, while a thread-local context would leak for each thread created.
+ */
+class IslContextScope {
+ public:
+  IslContextScope();
+  ~IslContextScope();
+
+  isl_ctx *ctx() const { return ctx_.get(); }
+  //! Hold the context to keep it out of the pool, the owner of the isl objects created in the scope should hold it.
+  const std::shared_ptr<isl_ctx> &holder() const { return ctx_; }
+
+ private:
+  std::shared_ptr<isl_ctx> ctx_;
+  isl_ctx *parent_{};
+};
 
 //! Check whether the set has the dimension having a specific name.
 bool isl_set_has_dim_name(isl_set *__isl_keep set, const std::string &name);
@@ -1,6 +1,8 @@
 #include "cinn/utils/isl_utils.h"
 #include <glog/logging.h>
 #include <gtest/gtest.h>
+#include <memory>
+#include <thread>  // NOLINT
 
 namespace cinn {
 
@@ -13,4 +15,43 @@ TEST(isl_set_to_identity_map, basic) {
   // LOG(INFO) << "map: " << isl_map_to_str(map);
 }
 
+TEST(IslContextScope, reuse) {
+  isl_ctx* thread_ctx = isl_utils::global_isl_ctx();
+  isl_ctx* scoped_ctx{};
+  {
+    isl_utils::IslContextScope scope;
+    scoped_ctx = scope.ctx();
+    EXPECT_NE(scoped_ctx, thread_ctx);
+    EXPECT_EQ(isl_utils::global_isl_ctx(), scoped_ctx);
+  }
+  EXPECT_EQ(isl_utils::global_isl_ctx(), thread_ctx);
+
+  // A thread created later takes the context back from the pool instead of allocating one.
+  std::thread([&] {
+    isl_utils::IslContextScope scope;
+    EXPECT_EQ(scope.ctx(), scoped_ctx);
+  }).join();
+}
+
+TEST(IslContextScope, holder) {
+  std::shared_ptr<isl_ctx> holder;
+  {
+    isl_utils::IslContextScope scope;
+    holder = scope.holder();
+  }
+
+  // The context is held, the other scopes don't take it.
+  std::thread([&] {
+    isl_utils::IslContextScope scope;
+    EXPECT_NE(scope.ctx(), holder.get());
+  }).join();
+
+  isl_ctx* held = holder.get();
+  holder.reset();
+  std::thread([&] {
+    isl_utils::IslContextScope scope;
+    EXPECT_EQ(scope.ctx(), held);
+  }).join();
+}
+
 }  // namespace cinn
@@ -24,7 +24,8 @@ namespace utils {
   ::cinn::utils::Log(__FILE__, __LINE__, ::cinn::utils::__cinn_log_indent__, level).stream()
 
 extern int __cinn_log_level__;
-extern int __cinn_log_indent__;
+// The indents are per thread, the functions might be compiled in multiple threads.
+extern thread_local int __cinn_log_indent__;
 
 struct Log {
   Log(const char* file, int lineno, int indent, int level)
@@ -57,9 +58,9 @@ struct Log {
 
 //! This value controls the indent size of a block. It is reset by LOG_INDENT macro, all the CINN_DEBUG macro in a block
 //! will calcuate their indent size from this as base.
-extern int cur_log_indent_debug_level;
+extern thread_local int cur_log_indent_debug_level;
 
-static std::stack<int> log_levels;
+static thread_local std::stack<int> log_levels;
 
 struct LogIndentGuard {
   LogIndentGuard(int level) {
@@ -24,6 +24,7 @@
   macro__(Or)                       \
   macro__(Not)                      \
   macro__(Exp)                      \
+  macro__(Sqrt)                     \
   macro__(Assign)                   \
   macro__(Let)                      \
   macro__(SumAssign)                \
@@ -90,6 +91,7 @@
 #define OP_1_ARGS_FOR_EACH(macro__) \
   macro__(Minus)                    \
   macro__(Exp)                      \
+  macro__(Sqrt)                     \
   macro__(Tanh)                     \
   macro__(Sigmoid)
 
@@ -118,5 +120,5 @@ macro__(Function)
 #define NOT_IMPLEMENT LOG(FATAL) << "Not Implemented";
 
 // clang-format off
-#define PRIMITIVE_TYPE_FOR_EACH(macro__) macro__(uint8) macro__(uint16) macro__(uint32) macro__(uint64) macro__(int8) macro__(int16) macro__(int32) macro__(int64) macro__(float32) macro__(float64) macro__(boolean)  // NOLINT
+#define PRIMITIVE_TYPE_FOR_EACH(macro__) macro__(uint8) macro__(uint16) macro__(uint32) macro__(uint64) macro__(int8) macro__(int16) macro__(int32) macro__(int64) macro__(float32) macro__(float64) macro__(float16) macro__(bfloat16) macro__(boolean)  // NOLINT
 // clang-format on
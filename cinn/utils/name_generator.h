@@ -6,17 +6,19 @@ namespace cinn {
 
 class NameGenerator {
  public:
-  std::string NewNamed(const std::string& x) { return x + "_" + std::to_string(named_counter_++); }
-  std::string NewFuncionName() { return "func" + std::to_string(func_counter_++); }
-  std::string NewStageName() { return "S" + std::to_string(func_counter_++); }
-  std::string NewIteratorName() { return "i" + std::to_string(func_counter_++); }
-  std::string NewParameterName() { return "p" + std::to_string(parameter_counter_++); }
-  std::string NewVarName() { return "var" + std::to_string(var_counter_++); }
-  std::string NewBuffer() { return "buf" + std::to_string(buffer_counter_++); }
-  std::string NewArray() { return "arr" + std::to_string(array_counter_++); }
-  std::string NewTmpVar() { return "tmp" + std::to_string(tmp_var_counter_++); }
+  std::string NewNamed(const std::string& x) { return prefix_ + x + "_" + std::to_string(named_counter_++); }
+  std::string NewFuncionName() { return prefix_ + "func" + std::to_string(func_counter_++); }
+  std::string NewStageName() { return prefix_ + "S" + std::to_string(func_counter_++); }
+  std::string NewIteratorName() { return prefix_ + "i" + std::to_string(func_counter_++); }
+  std::string NewParameterName() { return prefix_ + "p" + std::to_string(parameter_counter_++); }
+  std::string NewVarName() { return prefix_ + "var" + std::to_string(var_counter_++); }
+  std::string NewBuffer() { return prefix_ + "buf" + std::to_string(buffer_counter_++); }
+  std::string NewArray() { return prefix_ + "arr" + std::to_string(array_counter_++); }
+  std::string NewTmpVar() { return prefix_ + "tmp" + std::to_string(tmp_var_counter_++); }
 
  private:
+  //! Prepended to all the names, to make the names of a scope unique, see NameScope.
+  std::string prefix_;
   size_t func_counter_{};
   size_t stage_counter_{};
   size_t iterator_counter_{};
@@ -27,10 +29,11 @@ class NameGenerator {
   size_t array_counter_{};
   size_t tmp_var_counter_{};
 
-  NameGenerator() = default;
+  explicit NameGenerator(const std::string& prefix = "") : prefix_(prefix) {}
   NameGenerator(const NameGenerator&) = delete;
 
   friend class CINNContext;
+  friend class NameScope;
 };
 
 }  // namespace cinn
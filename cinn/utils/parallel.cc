@@ -0,0 +1,31 @@
+#include "cinn/utils/parallel.h"
+#include <glog/logging.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>  // NOLINT
+#include <vector>
+
+namespace cinn {
+
+void ParallelFor(int num_tasks, int num_threads, const std::function<void(int)>& task) {
+  CHECK_GE(num_tasks, 0);
+  CHECK_GT(num_threads, 0);
+  num_threads = std::min(num_threads, num_tasks);
+  if (num_threads <= 1) {
+    for (int i = 0; i < num_tasks; i++) task(i);
+    return;
+  }
+
+  std::atomic<int> next{0};
+  auto worker = [&] {
+    for (int i = next++; i < num_tasks; i = next++) task(i);
+  };
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads - 1; i++) threads.emplace_back(worker);
+  // The current thread works too.
+  worker();
+  for (auto& thread : threads) thread.join();
+}
+
+}  // namespace cinn
@@ -0,0 +1,14 @@
+#pragma once
+#include <functional>
+
+namespace cinn {
+
+/**
+ * Run `task(0)`, ..., `task(num_tasks - 1)` on a pool of `num_threads` threads, and return when all of them finish.
+ *
+ * The tasks are dispatched one by one to the idle threads, so that the threads keep busy when the tasks take different
+ * time, such as compiling the functions of different sizes. The tasks run in the current thread if `num_threads` is 1.
+ */
+void ParallelFor(int num_tasks, int num_threads, const std::function<void(int)>& task);
+
+}  // namespace cinn
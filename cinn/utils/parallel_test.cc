@@ -0,0 +1,19 @@
+#include "cinn/utils/parallel.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <vector>
+
+namespace cinn {
+
+TEST(ParallelFor, run_all_tasks) {
+  for (int num_threads : {1, 3, 8}) {
+    std::vector<std::atomic<int>> counts(100);
+    for (auto& count : counts) count = 0;
+    ParallelFor(counts.size(), num_threads, [&](int i) { counts[i]++; });
+    for (auto& count : counts) ASSERT_EQ(count, 1);
+  }
+  // No tasks.
+  ParallelFor(0, 4, [](int i) { FAIL(); });
+}
+
+}  // namespace cinn
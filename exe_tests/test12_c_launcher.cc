@@ -1,3 +1,4 @@
+#include <cmath>
 #include <glog/logging.h>
 #include <gtest/gtest.h>
 #include <vector>
@@ -16,7 +17,7 @@ void FC(float* A, float* B, float* C, float* bias, int M, int N, int K) {
       }
 
       C[i * N + j] += bias[j];
-      C[i * N + j] = std::max(0.f, C[i * N + j]);
+      C[i * N + j] = std::tanh(C[i * N + j]);
     }
   }
 }
@@ -0,0 +1,39 @@
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+#include <vector>
+#include "cinn/hlir/network_test_util.h"
+#include "cinn/utils/math.h"
+#include "cinn/utils/timer.h"
+#include "exe_tests/exe_test13.cc"
+
+TEST(exe, test) {
+  cinn::hlir::Conv2dNetworkBuilder builder;
+
+  std::vector<float> input(builder.x0_shape.num_elements());
+  std::vector<float> output(builder.out_shape.num_elements(), 0.f);
+  cinn::RandomVec(input.data(), input.size());
+
+  set_input_x0(input.data());
+  main_();
+  // The padded inputs and the columns of the two convolutions take tmp0, tmp1, tmp3 and tmp4.
+  get_output_tmp5(&output[0]);
+
+  auto output1 = builder.ManualTest(input);
+
+  ASSERT_EQ(output.size(), output1.size());
+  for (int i = 0; i < output.size(); i++) {
+    EXPECT_NEAR(output[i], output1[i], 1e-4);
+  }
+
+  const int repeat = 100;
+  cinn::Timer timer;
+  timer.Start();
+  for (int i = 0; i < repeat; i++) main_();
+  timer.Stop();
+  LOG(INFO) << "conv2d: " << static_cast<float>(timer.duration()) / repeat << " ms";
+
+  timer.Start();
+  for (int i = 0; i < repeat; i++) builder.ManualTest(input);
+  timer.Stop();
+  LOG(INFO) << "naive conv2d: " << static_cast<float>(timer.duration()) / repeat << " ms";
+}
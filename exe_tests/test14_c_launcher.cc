@@ -0,0 +1,31 @@
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+#include <vector>
+#include "cinn/hlir/network_test_util.h"
+#include "cinn/utils/math.h"
+#include "cinn/utils/timer.h"
+#include "exe_tests/exe_test14.cc"
+
+TEST(exe, test) {
+  cinn::hlir::DepthwiseConv2dNetworkBuilder builder;
+
+  std::vector<float> input(builder.x0_shape.num_elements());
+  cinn::RandomVec(input.data(), input.size());
+  auto output1 = builder.ManualTest(input);
+  std::vector<float> output(output1.size(), 0.f);
+
+  set_input_x0(input.data());
+  main_();
+  get_output_tmp3(&output[0]);
+
+  for (int i = 0; i < output.size(); i++) {
+    EXPECT_NEAR(output[i], output1[i], 1e-5);
+  }
+
+  const int repeat = 100;
+  cinn::Timer timer;
+  timer.Start();
+  for (int i = 0; i < repeat; i++) main_();
+  timer.Stop();
+  LOG(INFO) << "depthwise depthwise conv2d: " << static_cast<float>(timer.duration()) / repeat << " ms";
+}
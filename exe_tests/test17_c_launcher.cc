@@ -0,0 +1,33 @@
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+#include <vector>
+#include "cinn/hlir/network_test_util.h"
+#include "cinn/utils/math.h"
+#include "cinn/utils/timer.h"
+#include "exe_tests/exe_test17.cc"
+
+TEST(exe, test) {
+  cinn::hlir::ConvPoolNetworkBuilder builder;
+
+  std::vector<float> input(builder.x0_shape.num_elements());
+  std::vector<float> output(builder.out_shape.num_elements(), 0.f);
+  cinn::RandomVec(input.data(), input.size());
+
+  set_input_x0(input.data());
+  main_();
+  // The padded input and the columns of the convolution take tmp0 and tmp1, and its output is tmp2.
+  get_output_tmp3(&output[0]);
+
+  auto output1 = builder.ManualTest(input);
+  ASSERT_EQ(output.size(), output1.size());
+  for (int i = 0; i < output.size(); i++) {
+    EXPECT_NEAR(output[i], output1[i], 1e-4);
+  }
+
+  const int repeat = 100;
+  cinn::Timer timer;
+  timer.Start();
+  for (int i = 0; i < repeat; i++) main_();
+  timer.Stop();
+  LOG(INFO) << "conv2d + max pool2d: " << static_cast<float>(timer.duration()) / repeat << " ms";
+}
@@ -0,0 +1,36 @@
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+#include <vector>
+#include "cinn/hlir/network_test_util.h"
+#include "cinn/utils/math.h"
+#include "cinn/utils/timer.h"
+#include "exe_tests/exe_test18.cc"
+
+TEST(exe, test) {
+  cinn::hlir::NormalizationNetworkBuilder builder;
+
+  std::vector<float> input(builder.x0_shape.num_elements());
+  std::vector<float> output(builder.out_shape.num_elements(), 0.f);
+  cinn::RandomVec(input.data(), input.size());
+  // An offset large compared to the deviation, the variance should be still accurate.
+  for (auto& v : input) v += 100.f;
+
+  set_input_x0(input.data());
+  main_();
+  // The mean and the variance of layer_norm take tmp0 and tmp1, and its output is tmp2, the lanes, the maximum and the
+  // sum of softmax take tmp3, tmp4 and tmp5.
+  get_output_tmp6(&output[0]);
+
+  auto output1 = builder.ManualTest(input);
+  ASSERT_EQ(output.size(), output1.size());
+  for (int i = 0; i < output.size(); i++) {
+    EXPECT_NEAR(output[i], output1[i], 1e-4);
+  }
+
+  const int repeat = 100;
+  cinn::Timer timer;
+  timer.Start();
+  for (int i = 0; i < repeat; i++) main_();
+  timer.Stop();
+  LOG(INFO) << "layer_norm + softmax: " << static_cast<float>(timer.duration()) / repeat << " ms";
+}
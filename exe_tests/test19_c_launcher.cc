@@ -0,0 +1,34 @@
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+#include <vector>
+#include "cinn/hlir/network_test_util.h"
+#include "cinn/utils/math.h"
+#include "cinn/utils/timer.h"
+#include "exe_tests/exe_test19.cc"
+
+TEST(exe, test) {
+  cinn::hlir::BatchNormNetworkBuilder builder;
+
+  std::vector<float> input(builder.x0_shape.num_elements());
+  std::vector<float> output(builder.out_shape.num_elements(), 0.f);
+  cinn::RandomVec(input.data(), input.size());
+
+  set_input_x0(input.data());
+  main_();
+  // The padded input and the columns of conv2d take tmp0 and tmp1, its output tmp2 and the output tmp3 of batch_norm
+  // are folded away, the convolution writes the output tmp4 of the affine transform directly.
+  get_output_tmp4(&output[0]);
+
+  auto output1 = builder.ManualTest(input);
+  ASSERT_EQ(output.size(), output1.size());
+  for (int i = 0; i < output.size(); i++) {
+    EXPECT_NEAR(output[i], output1[i], 1e-4);
+  }
+
+  const int repeat = 100;
+  cinn::Timer timer;
+  timer.Start();
+  for (int i = 0; i < repeat; i++) main_();
+  timer.Stop();
+  LOG(INFO) << "conv2d + batch_norm folded: " << static_cast<float>(timer.duration()) / repeat << " ms";
+}